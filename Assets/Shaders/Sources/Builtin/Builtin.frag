@@ -1,8 +1,10 @@
-#version 460 core
+﻿#version 460 core
+#extension GL_ARB_bindless_texture : enable
 
 layout(location = 0) in vec3 vNormal;
 layout(location = 1) in vec2 vTexcoord;
 layout(location = 2) in vec3 vTangent;
+layout(location = 3) flat in uint vMaterialIndex;
 
 layout(set = 0, binding = 0, std140) uniform MaterialUBO{
     vec4 albedo;
@@ -10,8 +12,61 @@ layout(set = 0, binding = 0, std140) uniform MaterialUBO{
     vec4 metallic_roughness_ao;
 } material;
 
+// Per-material texture table, indexed by the draw's material index
+struct MaterialEntry {
+    uvec2 Textures[8];   // bindless handles, or (layer, array) for texture array slots, indexed by texture slot
+    uint TextureMask;    // bit i: slot i has a texture, bit 8 + i: slot i is in a texture array, bit 31: handles are valid
+    uint Padding0;
+    uint Padding1;
+    uint Padding2;
+};
+
+layout(std430, binding = 2) readonly buffer MaterialTableSSBO {
+    MaterialEntry Materials[];
+};
+
+// Bound to the unit matching its texture slot when bindless textures are unavailable
+layout(binding = 0) uniform sampler2D AlbedoMap;
+
+// Persistent mips of textures sharing format and size when bindless textures are unavailable,
+// binding and length match RENDER_TEXTURE_ARRAY_FIRST_UNIT and RENDER_TEXTURE_ARRAY_COUNT
+layout(binding = 12) uniform sampler2DArray TextureArrays[4];
+
+const uint TEXTURE_SLOT_ALBEDO = 0u;
+const uint TEXTURE_ARRAY_SHIFT = 8u;
+const uint TEXTURE_BINDLESS_BIT = 0x80000000u;
+
+// Sampler arrays need constant indices without non-uniform indexing support
+vec4 SampleTextureArray(uvec2 Location) {
+    vec3 Coord = vec3(vTexcoord, float(Location.x));
+    switch (Location.y) {
+    case 0u: return texture(TextureArrays[0], Coord);
+    case 1u: return texture(TextureArrays[1], Coord);
+    case 2u: return texture(TextureArrays[2], Coord);
+    default: return texture(TextureArrays[3], Coord);
+    }
+}
+
+vec4 SampleAlbedo(MaterialEntry Entry) {
+#ifdef GL_ARB_bindless_texture
+    if ((Entry.TextureMask & TEXTURE_BINDLESS_BIT) != 0u) {
+        return texture(sampler2D(Entry.Textures[TEXTURE_SLOT_ALBEDO]), vTexcoord);
+    }
+#endif
+    if ((Entry.TextureMask & (1u << (TEXTURE_ARRAY_SHIFT + TEXTURE_SLOT_ALBEDO))) != 0u) {
+        return SampleTextureArray(Entry.Textures[TEXTURE_SLOT_ALBEDO]);
+    }
+    return texture(AlbedoMap, vTexcoord);
+}
+
 layout(location = 0) out vec4 FragColor;
 
 void main() {
+    MaterialEntry Entry = Materials[vMaterialIndex];
+    if ((Entry.TextureMask & (1u << TEXTURE_SLOT_ALBEDO)) != 0u) {
+        FragColor = material.albedo * SampleAlbedo(Entry);
+        return;
+    }
+
     FragColor = vec4(material.metallic_roughness_ao.xyz, 1.0);
 }
@@ -3,19 +3,52 @@
 layout(location = 0) in vec3 iPosition;
 layout(location = 1) in vec3 iNormal;
 layout(location = 2) in vec2 iTexcoord;
-layout(location = 3) in vec3 iTangent;
+layout(location = 3) in vec4 iTangent;
 
 layout(location = 0) out vec3 vNormal;
 layout(location = 1) out vec2 vTexcoord;
 layout(location = 2) out vec3 vTangent;
+layout(location = 3) flat out uint vMaterialIndex;
 
-uniform mat4 ModelMat;
-uniform mat4 ViewMat;
-uniform mat4 ProjMat;
+layout(std140, binding = 1) uniform FrameUBO {
+	mat4 ViewMat;
+	mat4 ProjMat;
+};
+
+// Per-draw data, indexed by gl_DrawID for multi-draw indirect
+struct DrawData {
+	mat4 ModelMat;
+	vec4 PosScale;   // xyz: position dequantization scale, w: vertex format
+	vec4 PosBias;    // xyz: position dequantization bias, w: material table index
+};
+
+layout(std430, binding = 0) readonly buffer DrawDataSSBO {
+	DrawData Draws[];
+};
+
+// Octahedral encoding used by the compact vertex formats
+vec3 OctDecode(vec2 Oct) {
+	vec3 N = vec3(Oct, 1.0 - abs(Oct.x) - abs(Oct.y));
+	float T = max(-N.z, 0.0);
+	N.xy += mix(vec2(T), vec2(-T), greaterThanEqual(N.xy, vec2(0.0)));
+	return normalize(N);
+}
 
 void main() {
-	gl_Position = ProjMat * ViewMat * ModelMat * vec4(iPosition, 1.0);
-	vNormal = iNormal;
+	DrawData Draw = Draws[gl_DrawID];
+
+	// Identity scale/bias for non-quantized formats
+	vec3 Position = iPosition * Draw.PosScale.xyz + Draw.PosBias.xyz;
+	vec3 Normal = iNormal;
+	vec3 Tangent = iTangent.xyz;
+	if (Draw.PosScale.w > 0.5) {
+		Normal = OctDecode(iNormal.xy);
+		Tangent = OctDecode(iTangent.xy);
+	}
+
+	gl_Position = ProjMat * ViewMat * Draw.ModelMat * vec4(Position, 1.0);
+	vNormal = Normal;
 	vTexcoord = iTexcoord;
-	vTangent = iTangent;
+	vTangent = Tangent;
+	vMaterialIndex = uint(Draw.PosBias.w);
 }
\ No newline at end of file
@@ -0,0 +1,390 @@
+﻿#include "AABBTree.h"
+
+#include <algorithm>
+
+static FBoundingBox Union(const FBoundingBox& A, const FBoundingBox& B) {
+	return FBoundingBox(A.Min.cwiseMin(B.Min), A.Max.cwiseMax(B.Max));
+}
+
+AABBTree::AABBTree(float Margin) {
+	Root_ = NULL_NODE;
+	FreeList_ = NULL_NODE;
+	NodeCount_ = 0;
+	ProxyCount_ = 0;
+	Margin_ = Margin;
+	ReinsertCount_ = 0;
+	RefitCount_ = 0;
+}
+
+void AABBTree::Clear() {
+	Nodes_.clear();
+	Root_ = NULL_NODE;
+	FreeList_ = NULL_NODE;
+	NodeCount_ = 0;
+	ProxyCount_ = 0;
+	ResetCounters();
+}
+
+int32_t AABBTree::AllocateNode() {
+	int32_t NodeID = FreeList_;
+	if (NodeID != NULL_NODE) {
+		FreeList_ = Nodes_[NodeID].Parent;
+	}
+	else {
+		NodeID = (int32_t)Nodes_.size();
+		Nodes_.emplace_back();
+	}
+
+	Node& NewNode = Nodes_[NodeID];
+	NewNode = Node();
+	NewNode.Height = 0;
+	NodeCount_++;
+	return NodeID;
+}
+
+void AABBTree::FreeNode(int32_t NodeID) {
+	Node& Freed = Nodes_[NodeID];
+	Freed.Parent = FreeList_;
+	Freed.Child1 = NULL_NODE;
+	Freed.Child2 = NULL_NODE;
+	Freed.UserData = nullptr;
+	Freed.Height = -1;
+	FreeList_ = NodeID;
+	NodeCount_--;
+}
+
+FBoundingBox AABBTree::MakeFatBounds(const FBoundingBox& Bounds, const FVector3& Displacement) const {
+	FBoundingBox Fat(Bounds.Min - FVector3::Constant(Margin_), Bounds.Max + FVector3::Constant(Margin_));
+
+	// 沿运动方向多留一些余量，持续移动的物体不必每帧重新插入
+	const FVector3 Predicted = Displacement * AABB_TREE_DISPLACEMENT_MULTIPLIER;
+	for (int i = 0; i < 3; ++i) {
+		if (Predicted[i] < 0.0f) {
+			Fat.Min[i] += Predicted[i];
+		}
+		else {
+			Fat.Max[i] += Predicted[i];
+		}
+	}
+	return Fat;
+}
+
+int32_t AABBTree::CreateProxy(const FBoundingBox& Bounds, void* UserData) {
+	const int32_t Proxy = AllocateNode();
+	Nodes_[Proxy].Bounds = MakeFatBounds(Bounds, FVector3::Zero());
+	Nodes_[Proxy].UserData = UserData;
+
+	InsertLeaf(Proxy);
+	ProxyCount_++;
+	return Proxy;
+}
+
+void AABBTree::DestroyProxy(int32_t Proxy) {
+	RemoveLeaf(Proxy);
+	FreeNode(Proxy);
+	ProxyCount_--;
+}
+
+bool AABBTree::MoveProxy(int32_t Proxy, const FBoundingBox& Bounds, const FVector3& Displacement) {
+	const FBoundingBox& TreeBounds = Nodes_[Proxy].Bounds;
+	if (TreeBounds.Contains(Bounds)) {
+		// 胖包围盒过大（物体缩小或预测外扩过多）时才收紧
+		const FVector3 Huge = FVector3::Constant(4.0f * Margin_);
+		const FBoundingBox HugeBounds(Bounds.Min - Huge - Displacement.cwiseAbs() * AABB_TREE_DISPLACEMENT_MULTIPLIER,
+			Bounds.Max + Huge + Displacement.cwiseAbs() * AABB_TREE_DISPLACEMENT_MULTIPLIER);
+		if (HugeBounds.Contains(TreeBounds)) {
+			return false;
+		}
+	}
+
+	const FBoundingBox Fat = MakeFatBounds(Bounds, Displacement);
+
+	// 仍在父节点内时结构不变，原地更新叶节点
+	const int32_t Parent = Nodes_[Proxy].Parent;
+	if (Parent != NULL_NODE && Nodes_[Parent].Bounds.Contains(Fat)) {
+		Nodes_[Proxy].Bounds = Fat;
+		RefitCount_++;
+		return true;
+	}
+
+	RemoveLeaf(Proxy);
+	Nodes_[Proxy].Bounds = Fat;
+	InsertLeaf(Proxy);
+	ReinsertCount_++;
+	return true;
+}
+
+void AABBTree::InsertLeaf(int32_t Leaf) {
+	if (Root_ == NULL_NODE) {
+		Root_ = Leaf;
+		Nodes_[Root_].Parent = NULL_NODE;
+		return;
+	}
+
+	// 按表面积代价自上而下寻找最佳兄弟节点
+	const FBoundingBox LeafBounds = Nodes_[Leaf].Bounds;
+	int32_t Index = Root_;
+	while (!Nodes_[Index].IsLeaf()) {
+		const Node& Current = Nodes_[Index];
+		const int32_t Child1 = Current.Child1;
+		const int32_t Child2 = Current.Child2;
+
+		const float Area = Current.Bounds.GetSurfaceArea();
+		const float CombinedArea = Union(Current.Bounds, LeafBounds).GetSurfaceArea();
+
+		// 在这里新建父节点的代价
+		const float Cost = 2.0f * CombinedArea;
+		// 继续下降时祖先节点增大的代价
+		const float InheritanceCost = 2.0f * (CombinedArea - Area);
+
+		auto ChildCost = [&](int32_t Child) {
+			const Node& ChildNode = Nodes_[Child];
+			const float NewArea = Union(LeafBounds, ChildNode.Bounds).GetSurfaceArea();
+			return ChildNode.IsLeaf() ? NewArea + InheritanceCost : NewArea - ChildNode.Bounds.GetSurfaceArea() + InheritanceCost;
+		};
+		const float Cost1 = ChildCost(Child1);
+		const float Cost2 = ChildCost(Child2);
+
+		if (Cost < Cost1 && Cost < Cost2) {
+			break;
+		}
+		Index = Cost1 < Cost2 ? Child1 : Child2;
+	}
+
+	const int32_t Sibling = Index;
+	const int32_t OldParent = Nodes_[Sibling].Parent;
+	const int32_t NewParent = AllocateNode();
+	Nodes_[NewParent].Parent = OldParent;
+	Nodes_[NewParent].Bounds = Union(LeafBounds, Nodes_[Sibling].Bounds);
+	Nodes_[NewParent].Height = Nodes_[Sibling].Height + 1;
+	Nodes_[NewParent].Child1 = Sibling;
+	Nodes_[NewParent].Child2 = Leaf;
+	Nodes_[Sibling].Parent = NewParent;
+	Nodes_[Leaf].Parent = NewParent;
+
+	if (OldParent != NULL_NODE) {
+		if (Nodes_[OldParent].Child1 == Sibling) {
+			Nodes_[OldParent].Child1 = NewParent;
+		}
+		else {
+			Nodes_[OldParent].Child2 = NewParent;
+		}
+	}
+	else {
+		Root_ = NewParent;
+	}
+
+	FixUpwards(Nodes_[Leaf].Parent);
+}
+
+void AABBTree::RemoveLeaf(int32_t Leaf) {
+	if (Leaf == Root_) {
+		Root_ = NULL_NODE;
+		return;
+	}
+
+	const int32_t Parent = Nodes_[Leaf].Parent;
+	const int32_t GrandParent = Nodes_[Parent].Parent;
+	const int32_t Sibling = Nodes_[Parent].Child1 == Leaf ? Nodes_[Parent].Child2 : Nodes_[Parent].Child1;
+
+	if (GrandParent != NULL_NODE) {
+		// 删除父节点，兄弟节点接到祖父节点上
+		if (Nodes_[GrandParent].Child1 == Parent) {
+			Nodes_[GrandParent].Child1 = Sibling;
+		}
+		else {
+			Nodes_[GrandParent].Child2 = Sibling;
+		}
+		Nodes_[Sibling].Parent = GrandParent;
+		FreeNode(Parent);
+		FixUpwards(GrandParent);
+	}
+	else {
+		Root_ = Sibling;
+		Nodes_[Sibling].Parent = NULL_NODE;
+		FreeNode(Parent);
+	}
+}
+
+void AABBTree::FixUpwards(int32_t NodeID) {
+	// 沿路径向上更新高度和包围盒，并按表面积代价旋转
+	while (NodeID != NULL_NODE) {
+		Node& Current = Nodes_[NodeID];
+		const Node& Child1 = Nodes_[Current.Child1];
+		const Node& Child2 = Nodes_[Current.Child2];
+		Current.Height = 1 + std::max(Child1.Height, Child2.Height);
+		Current.Bounds = Union(Child1.Bounds, Child2.Bounds);
+
+		Rotate(NodeID);
+		NodeID = Current.Parent;
+	}
+}
+
+void AABBTree::Rotate(int32_t IndexA) {
+	Node& A = Nodes_[IndexA];
+	if (A.Height < 2) {
+		return;
+	}
+
+	// 交换子节点与孙节点，A的包围盒不变，只有被换入孙节点的那个子节点包围盒变化，
+	// 选择使该子节点表面积最小的交换
+	const int32_t IndexB = A.Child1;
+	const int32_t IndexC = A.Child2;
+	Node& B = Nodes_[IndexB];
+	Node& C = Nodes_[IndexC];
+
+	enum class RotateType { eNone, eBF, eBG, eCD, eCE };
+	RotateType Best = RotateType::eNone;
+	float BestCost = 0.0f;
+	FBoundingBox BestBounds;
+	auto Consider = [&](RotateType Type, float Delta, const FBoundingBox& NewBounds) {
+		if (Delta < BestCost) {
+			Best = Type;
+			BestCost = Delta;
+			BestBounds = NewBounds;
+		}
+	};
+
+	// B与C的子节点交换，C变为另一个孙节点与B的并集
+	if (!C.IsLeaf()) {
+		const float AreaC = C.Bounds.GetSurfaceArea();
+		const FBoundingBox BG = Union(B.Bounds, Nodes_[C.Child2].Bounds);
+		const FBoundingBox BF = Union(B.Bounds, Nodes_[C.Child1].Bounds);
+		Consider(RotateType::eBF, BG.GetSurfaceArea() - AreaC, BG);
+		Consider(RotateType::eBG, BF.GetSurfaceArea() - AreaC, BF);
+	}
+	// C与B的子节点交换
+	if (!B.IsLeaf()) {
+		const float AreaB = B.Bounds.GetSurfaceArea();
+		const FBoundingBox CE = Union(C.Bounds, Nodes_[B.Child2].Bounds);
+		const FBoundingBox CD = Union(C.Bounds, Nodes_[B.Child1].Bounds);
+		Consider(RotateType::eCD, CE.GetSurfaceArea() - AreaB, CE);
+		Consider(RotateType::eCE, CD.GetSurfaceArea() - AreaB, CD);
+	}
+
+	switch (Best) {
+	case RotateType::eBF: {
+		const int32_t IndexF = C.Child1;
+		Node& F = Nodes_[IndexF];
+		A.Child1 = IndexF;
+		C.Child1 = IndexB;
+		B.Parent = IndexC;
+		F.Parent = IndexA;
+		C.Bounds = BestBounds;
+		C.Height = 1 + std::max(B.Height, Nodes_[C.Child2].Height);
+		A.Height = 1 + std::max(C.Height, F.Height);
+		break;
+	}
+	case RotateType::eBG: {
+		const int32_t IndexG = C.Child2;
+		Node& G = Nodes_[IndexG];
+		A.Child1 = IndexG;
+		C.Child2 = IndexB;
+		B.Parent = IndexC;
+		G.Parent = IndexA;
+		C.Bounds = BestBounds;
+		C.Height = 1 + std::max(B.Height, Nodes_[C.Child1].Height);
+		A.Height = 1 + std::max(C.Height, G.Height);
+		break;
+	}
+	case RotateType::eCD: {
+		const int32_t IndexD = B.Child1;
+		Node& D = Nodes_[IndexD];
+		A.Child2 = IndexD;
+		B.Child1 = IndexC;
+		C.Parent = IndexB;
+		D.Parent = IndexA;
+		B.Bounds = BestBounds;
+		B.Height = 1 + std::max(C.Height, Nodes_[B.Child2].Height);
+		A.Height = 1 + std::max(B.Height, D.Height);
+		break;
+	}
+	case RotateType::eCE: {
+		const int32_t IndexE = B.Child2;
+		Node& E = Nodes_[IndexE];
+		A.Child2 = IndexE;
+		B.Child2 = IndexC;
+		C.Parent = IndexB;
+		E.Parent = IndexA;
+		B.Bounds = BestBounds;
+		B.Height = 1 + std::max(C.Height, Nodes_[B.Child1].Height);
+		A.Height = 1 + std::max(B.Height, E.Height);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void AABBTree::Refit() {
+	if (Root_ == NULL_NODE) {
+		return;
+	}
+
+	// 先序收集内部节点，逆序处理时子节点总在父节点之前
+	std::vector<int32_t> Internal;
+	Internal.reserve(NodeCount_ / 2 + 1);
+	AABBTreeStack Stack;
+	Stack.Push(Root_);
+	while (!Stack.IsEmpty()) {
+		const int32_t NodeID = Stack.Pop();
+		const Node& Current = Nodes_[NodeID];
+		if (!Current.IsLeaf()) {
+			Internal.push_back(NodeID);
+			Stack.Push(Current.Child1);
+			Stack.Push(Current.Child2);
+		}
+	}
+
+	for (auto It = Internal.rbegin(); It != Internal.rend(); ++It) {
+		Node& Current = Nodes_[*It];
+		Current.Bounds = Union(Nodes_[Current.Child1].Bounds, Nodes_[Current.Child2].Bounds);
+	}
+}
+
+int32_t AABBTree::GetHeight() const {
+	return Root_ == NULL_NODE ? 0 : Nodes_[Root_].Height;
+}
+
+float AABBTree::GetAreaRatio() const {
+	if (Root_ == NULL_NODE) {
+		return 0.0f;
+	}
+
+	float TotalArea = 0.0f;
+	for (const Node& Current : Nodes_) {
+		if (Current.Height >= 0) {
+			TotalArea += Current.Bounds.GetSurfaceArea();
+		}
+	}
+
+	const float RootArea = Nodes_[Root_].Bounds.GetSurfaceArea();
+	return RootArea > 0.0f ? TotalArea / RootArea : 0.0f;
+}
+
+bool AABBTree::Validate() const {
+	if (Root_ != NULL_NODE && Nodes_[Root_].Parent != NULL_NODE) {
+		return false;
+	}
+	return Root_ == NULL_NODE || ValidateNode(Root_);
+}
+
+bool AABBTree::ValidateNode(int32_t NodeID) const {
+	const Node& Current = Nodes_[NodeID];
+	if (Current.IsLeaf()) {
+		return Current.Child2 == NULL_NODE && Current.Height == 0;
+	}
+
+	const Node& Child1 = Nodes_[Current.Child1];
+	const Node& Child2 = Nodes_[Current.Child2];
+	if (Child1.Parent != NodeID || Child2.Parent != NodeID) {
+		return false;
+	}
+	if (Current.Height != 1 + std::max(Child1.Height, Child2.Height)) {
+		return false;
+	}
+	if (!Current.Bounds.Contains(Child1.Bounds) || !Current.Bounds.Contains(Child2.Bounds)) {
+		return false;
+	}
+	return ValidateNode(Current.Child1) && ValidateNode(Current.Child2);
+}
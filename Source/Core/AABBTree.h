@@ -0,0 +1,243 @@
+﻿#pragma once
+
+#include "CoreModuleAPI.h"
+#include "Bounds.h"
+#include <cstdint>
+#include <vector>
+
+// 叶节点胖包围盒的外扩量（世界单位）
+#ifndef AABB_TREE_MARGIN
+#define AABB_TREE_MARGIN 0.1f
+#endif
+// 按位移预测外扩胖包围盒的倍数
+#ifndef AABB_TREE_DISPLACEMENT_MULTIPLIER
+#define AABB_TREE_DISPLACEMENT_MULTIPLIER 2.0f
+#endif
+
+// 遍历用栈，较浅时不分配堆内存
+class AABBTreeStack {
+public:
+	void Push(int32_t Node) {
+		if (Count_ < INLINE_SIZE) {
+			Inline_[Count_] = Node;
+		}
+		else {
+			Overflow_.push_back(Node);
+		}
+		Count_++;
+	}
+
+	int32_t Pop() {
+		Count_--;
+		if (Count_ < INLINE_SIZE) {
+			return Inline_[Count_];
+		}
+		const int32_t Node = Overflow_.back();
+		Overflow_.pop_back();
+		return Node;
+	}
+
+	bool IsEmpty() const { return Count_ == 0; }
+
+private:
+	static constexpr uint32_t INLINE_SIZE = 256;
+	int32_t Inline_[INLINE_SIZE];
+	std::vector<int32_t> Overflow_;
+	uint32_t Count_ = 0;
+};
+
+/**
+ * 动态AABB树（增量维护的BVH）。
+ * 叶节点保存外扩后的胖包围盒，物体在胖包围盒内移动时树结构不变；
+ * 移出后若新胖包围盒仍在父节点内则原地更新（refit），否则删除后按表面积代价重新插入，
+ * 插入/删除路径上按表面积代价旋转节点以保持树的质量，查询为O(log n + k)。
+ * 代理ID在删除前保持不变，可直接作为外部对象的索引。
+ */
+class AABBTree {
+public:
+	static constexpr int32_t NULL_NODE = -1;
+
+public:
+	ENGINE_CORE_API explicit AABBTree(float Margin = AABB_TREE_MARGIN);
+
+public:
+	ENGINE_CORE_API int32_t CreateProxy(const FBoundingBox& Bounds, void* UserData);
+	ENGINE_CORE_API void DestroyProxy(int32_t Proxy);
+	/**
+	 * 更新代理的包围盒。
+	 * @param Displacement 本次位移，用于沿运动方向预先外扩胖包围盒。
+	 * @returns 胖包围盒是否发生变化。
+	 */
+	ENGINE_CORE_API bool MoveProxy(int32_t Proxy, const FBoundingBox& Bounds, const FVector3& Displacement = FVector3::Zero());
+	// 自底向上重新计算所有内部节点的包围盒，收紧多次原地更新后变松的父节点
+	ENGINE_CORE_API void Refit();
+	ENGINE_CORE_API void Clear();
+
+	void* GetUserData(int32_t Proxy) const { return Nodes_[Proxy].UserData; }
+	const FBoundingBox& GetFatBounds(int32_t Proxy) const { return Nodes_[Proxy].Bounds; }
+
+	// Callback(int32_t Proxy) -> bool，返回false时停止查询
+	template<typename Callback>
+	void QueryBox(const FBoundingBox& Box, Callback&& Fn) const;
+	// 完全在视锥内的子树不再逐个测试
+	template<typename Callback>
+	void QueryFrustum(const FFrustum& Frustum, Callback&& Fn) const;
+	// Callback(int32_t Proxy, float Distance) -> float，返回新的最大距离：0停止，小于当前值则裁剪射线
+	template<typename Callback>
+	void RayCast(const FRay& Ray, Callback&& Fn) const;
+
+	// 统计
+	uint32_t GetProxyCount() const { return ProxyCount_; }
+	uint32_t GetNodeCount() const { return NodeCount_; }
+	ENGINE_CORE_API int32_t GetHeight() const;
+	// 所有节点表面积之和 / 根节点表面积，越小树的质量越好
+	ENGINE_CORE_API float GetAreaRatio() const;
+	uint32_t GetReinsertCount() const { return ReinsertCount_; }
+	uint32_t GetRefitCount() const { return RefitCount_; }
+	void ResetCounters() { ReinsertCount_ = 0; RefitCount_ = 0; }
+	// 检查父子关系、高度和包围关系，调试用
+	ENGINE_CORE_API bool Validate() const;
+
+private:
+	struct Node {
+		FBoundingBox Bounds;
+		void* UserData = nullptr;
+		int32_t Parent = NULL_NODE;     // 空闲节点中为下一个空闲节点
+		int32_t Child1 = NULL_NODE;
+		int32_t Child2 = NULL_NODE;
+		int32_t Height = -1;            // 叶节点为0，空闲节点为-1
+
+		bool IsLeaf() const { return Child1 == NULL_NODE; }
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t NodeID);
+	void InsertLeaf(int32_t Leaf);
+	void RemoveLeaf(int32_t Leaf);
+	void Rotate(int32_t NodeID);
+	void FixUpwards(int32_t NodeID);
+	FBoundingBox MakeFatBounds(const FBoundingBox& Bounds, const FVector3& Displacement) const;
+	bool ValidateNode(int32_t NodeID) const;
+
+private:
+	std::vector<Node> Nodes_;
+	int32_t Root_;
+	int32_t FreeList_;
+	uint32_t NodeCount_;
+	uint32_t ProxyCount_;
+	float Margin_;
+
+	uint32_t ReinsertCount_;
+	uint32_t RefitCount_;
+};
+
+template<typename Callback>
+void AABBTree::QueryBox(const FBoundingBox& Box, Callback&& Fn) const {
+	AABBTreeStack Stack;
+	Stack.Push(Root_);
+	while (!Stack.IsEmpty()) {
+		const int32_t NodeID = Stack.Pop();
+		if (NodeID == NULL_NODE) {
+			continue;
+		}
+
+		const Node& Current = Nodes_[NodeID];
+		if (!Current.Bounds.Intersects(Box)) {
+			continue;
+		}
+
+		if (Current.IsLeaf()) {
+			if (!Fn(NodeID)) {
+				return;
+			}
+		}
+		else {
+			Stack.Push(Current.Child1);
+			Stack.Push(Current.Child2);
+		}
+	}
+}
+
+template<typename Callback>
+void AABBTree::QueryFrustum(const FFrustum& Frustum, Callback&& Fn) const {
+	// 子节点继承父节点尚未完全通过的平面掩码；第二个栈保存完全可见的子树，其中的叶节点直接报告
+	AABBTreeStack Stack;
+	AABBTreeStack MaskStack;
+	AABBTreeStack InsideStack;
+	Stack.Push(Root_);
+	MaskStack.Push(0x3F);
+	while (!Stack.IsEmpty()) {
+		const int32_t NodeID = Stack.Pop();
+		uint32_t PlaneMask = (uint32_t)MaskStack.Pop();
+		if (NodeID == NULL_NODE) {
+			continue;
+		}
+
+		const Node& Current = Nodes_[NodeID];
+		const FrustumContainment Containment = Frustum.Classify(Current.Bounds, PlaneMask);
+		if (Containment == FrustumContainment::eOutside) {
+			continue;
+		}
+
+		if (Containment == FrustumContainment::eInside) {
+			InsideStack.Push(NodeID);
+		}
+		else if (Current.IsLeaf()) {
+			if (!Fn(NodeID)) {
+				return;
+			}
+		}
+		else {
+			Stack.Push(Current.Child1);
+			Stack.Push(Current.Child2);
+			MaskStack.Push((int32_t)PlaneMask);
+			MaskStack.Push((int32_t)PlaneMask);
+		}
+	}
+
+	while (!InsideStack.IsEmpty()) {
+		const Node& Current = Nodes_[InsideStack.Pop()];
+		if (Current.IsLeaf()) {
+			if (!Fn((int32_t)(&Current - Nodes_.data()))) {
+				return;
+			}
+		}
+		else {
+			InsideStack.Push(Current.Child1);
+			InsideStack.Push(Current.Child2);
+		}
+	}
+}
+
+template<typename Callback>
+void AABBTree::RayCast(const FRay& Ray, Callback&& Fn) const {
+	const FVector3 InvDirection = Ray.GetInvDirection();
+	float MaxDistance = Ray.MaxDistance;
+
+	AABBTreeStack Stack;
+	Stack.Push(Root_);
+	while (!Stack.IsEmpty()) {
+		const int32_t NodeID = Stack.Pop();
+		if (NodeID == NULL_NODE) {
+			continue;
+		}
+
+		const Node& Current = Nodes_[NodeID];
+		float Distance = 0.0f;
+		if (!Current.Bounds.IntersectRay(Ray.Origin, InvDirection, MaxDistance, Distance)) {
+			continue;
+		}
+
+		if (Current.IsLeaf()) {
+			const float NewMaxDistance = Fn(NodeID, Distance);
+			if (NewMaxDistance <= 0.0f) {
+				return;
+			}
+			MaxDistance = NewMaxDistance < MaxDistance ? NewMaxDistance : MaxDistance;
+		}
+		else {
+			Stack.Push(Current.Child1);
+			Stack.Push(Current.Child2);
+		}
+	}
+}
@@ -0,0 +1,181 @@
+﻿#pragma once
+
+#include "BaseMath.h"
+#include <cfloat>
+#include <cstdint>
+#include <utility>
+
+// 轴对齐包围盒，默认构造为空（Min > Max）
+struct FBoundingBox {
+	FVector3 Min = FVector3::Constant(FLT_MAX);
+	FVector3 Max = FVector3::Constant(-FLT_MAX);
+
+	FBoundingBox() = default;
+	FBoundingBox(const FVector3& InMin, const FVector3& InMax) : Min(InMin), Max(InMax) {}
+
+	static FBoundingBox FromCenterExtent(const FVector3& Center, const FVector3& HalfExtent) {
+		return FBoundingBox(Center - HalfExtent, Center + HalfExtent);
+	}
+
+	bool IsValid() const { return Min.x() <= Max.x() && Min.y() <= Max.y() && Min.z() <= Max.z(); }
+	FVector3 GetCenter() const { return (Min + Max) * 0.5f; }
+	FVector3 GetHalfExtent() const { return (Max - Min) * 0.5f; }
+	float GetRadius() const { return GetHalfExtent().norm(); }
+
+	void Expand(const FVector3& Point) {
+		Min = Min.cwiseMin(Point);
+		Max = Max.cwiseMax(Point);
+	}
+
+	void Expand(const FBoundingBox& Other) {
+		Min = Min.cwiseMin(Other.Min);
+		Max = Max.cwiseMax(Other.Max);
+	}
+
+	bool Contains(const FBoundingBox& Other) const {
+		return (Min.array() <= Other.Min.array()).all() && (Max.array() >= Other.Max.array()).all();
+	}
+
+	bool Intersects(const FBoundingBox& Other) const {
+		return (Min.array() <= Other.Max.array()).all() && (Max.array() >= Other.Min.array()).all();
+	}
+
+	float GetSurfaceArea() const {
+		const FVector3 Size = Max - Min;
+		return 2.0f * (Size.x() * Size.y() + Size.y() * Size.z() + Size.z() * Size.x());
+	}
+
+	// 射线与包围盒的最近交点距离（slab测试），起点在盒内时为0
+	bool IntersectRay(const FVector3& Origin, const FVector3& InvDirection, float MaxDistance, float& OutDistance) const {
+		float TMin = 0.0f;
+		float TMax = MaxDistance;
+		for (int i = 0; i < 3; ++i) {
+			float T1 = (Min[i] - Origin[i]) * InvDirection[i];
+			float T2 = (Max[i] - Origin[i]) * InvDirection[i];
+			if (T1 > T2) {
+				std::swap(T1, T2);
+			}
+			// 方向分量为0且起点在slab外时T1/T2同为无穷，下面的比较会排除
+			TMin = T1 > TMin ? T1 : TMin;
+			TMax = T2 < TMax ? T2 : TMax;
+			if (TMin > TMax) {
+				return false;
+			}
+		}
+		OutDistance = TMin;
+		return true;
+	}
+
+	// 仿射变换后重新包围（Arvo），结果仍是轴对齐的
+	FBoundingBox Transform(const FMatrix4& Matrix) const {
+		const FMatrix3 Basis = Matrix.block<3, 3>(0, 0);
+		const FVector3 Center = Basis * GetCenter() + Matrix.block<3, 1>(0, 3);
+		const FVector3 HalfExtent = Basis.cwiseAbs() * GetHalfExtent();
+		return FromCenterExtent(Center, HalfExtent);
+	}
+};
+
+// 射线，Direction需归一化
+struct FRay {
+	FVector3 Origin = FVector3::Zero();
+	FVector3 Direction = FVector3(0.0f, 0.0f, -1.0f);
+	float MaxDistance = FLT_MAX;
+
+	FRay() = default;
+	FRay(const FVector3& InOrigin, const FVector3& InDirection, float InMaxDistance = FLT_MAX)
+		: Origin(InOrigin), Direction(InDirection.normalized()), MaxDistance(InMaxDistance) {}
+
+	FVector3 GetInvDirection() const { return Direction.cwiseInverse(); }
+};
+
+// 包围盒与视锥的关系
+enum class FrustumContainment : uint8_t {
+	eOutside,
+	eIntersect,
+	eInside
+};
+
+// 视锥体，六个平面的法线指向内侧：Dot(N, P) + D >= 0 为内侧
+struct FFrustum {
+	enum PlaneIndex { eLeft = 0, eRight, eBottom, eTop, eNear, eFar, eCount };
+
+	FVector4 Planes[eCount];
+
+	// 默认不裁剪任何物体
+	FFrustum() {
+		for (FVector4& Plane : Planes) {
+			Plane = FVector4(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+	}
+	explicit FFrustum(const FMatrix4& ViewProj) { SetFromMatrix(ViewProj); }
+
+	// 从列向量约定的ViewProj矩阵提取（OpenGL裁剪空间，-W <= Z <= W）
+	void SetFromMatrix(const FMatrix4& ViewProj) {
+		const FVector4 Row0 = ViewProj.row(0);
+		const FVector4 Row1 = ViewProj.row(1);
+		const FVector4 Row2 = ViewProj.row(2);
+		const FVector4 Row3 = ViewProj.row(3);
+
+		Planes[eLeft] = Row3 + Row0;
+		Planes[eRight] = Row3 - Row0;
+		Planes[eBottom] = Row3 + Row1;
+		Planes[eTop] = Row3 - Row1;
+		Planes[eNear] = Row3 + Row2;
+		Planes[eFar] = Row3 - Row2;
+
+		for (FVector4& Plane : Planes) {
+			const float Length = Plane.head<3>().norm();
+			if (Length > 0.0f) {
+				Plane /= Length;
+			}
+		}
+	}
+
+	bool Intersects(const FVector3& Center, float Radius) const {
+		for (const FVector4& Plane : Planes) {
+			if (Plane.head<3>().dot(Center) + Plane.w() < -Radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	FrustumContainment Classify(const FBoundingBox& Box) const {
+		uint32_t PlaneMask = 0x3F;
+		return Classify(Box, PlaneMask);
+	}
+
+	// 只测试PlaneMask中的平面，并清除包围盒完全位于其内侧的平面位（子节点可继承）
+	FrustumContainment Classify(const FBoundingBox& Box, uint32_t& PlaneMask) const {
+		const FVector3 Center = Box.GetCenter();
+		const FVector3 HalfExtent = Box.GetHalfExtent();
+		for (uint32_t i = 0; i < 6; ++i) {
+			if (!(PlaneMask & (1u << i))) {
+				continue;
+			}
+			const FVector4& Plane = Planes[i];
+			const float Distance = Plane.head<3>().dot(Center) + Plane.w();
+			const float Radius = Plane.head<3>().cwiseAbs().dot(HalfExtent);
+			if (Distance < -Radius) {
+				return FrustumContainment::eOutside;
+			}
+			if (Distance >= Radius) {
+				PlaneMask &= ~(1u << i);
+			}
+		}
+		return PlaneMask ? FrustumContainment::eIntersect : FrustumContainment::eInside;
+	}
+
+	bool Intersects(const FBoundingBox& Box) const {
+		const FVector3 Center = Box.GetCenter();
+		const FVector3 HalfExtent = Box.GetHalfExtent();
+		for (const FVector4& Plane : Planes) {
+			const float Distance = Plane.head<3>().dot(Center) + Plane.w();
+			const float Radius = Plane.head<3>().cwiseAbs().dot(HalfExtent);
+			if (Distance < -Radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
@@ -0,0 +1,146 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+
+/**
+ * 基于空闲链表的区间分配器。
+ * 只管理偏移量，不持有实际内存，用于在大块GPU Buffer中划分子区间。
+ * 分配采用First-Fit，释放时与相邻空闲块合并。
+ */
+class FreeListAllocator {
+public:
+	static constexpr uint64_t InvalidOffset = UINT64_MAX;
+
+public:
+	explicit FreeListAllocator(uint64_t Capacity = 0) { Reset(Capacity); }
+
+	void Reset(uint64_t Capacity) {
+		FreeBlocks_.clear();
+		Capacity_ = Capacity;
+		UsedSize_ = 0;
+		AllocationCount_ = 0;
+		if (Capacity > 0) {
+			FreeBlocks_[0] = Capacity;
+		}
+	}
+
+	/**
+	 * 分配一段区间。
+	 * @returns 对齐后的偏移量，空间不足时返回InvalidOffset。
+	 */
+	uint64_t Allocate(uint64_t Size, uint64_t Alignment = 1) {
+		if (Size == 0) {
+			return InvalidOffset;
+		}
+
+		for (auto It = FreeBlocks_.begin(); It != FreeBlocks_.end(); ++It) {
+			const uint64_t BlockOffset = It->first;
+			const uint64_t BlockSize = It->second;
+			const uint64_t Aligned = AlignUp(BlockOffset, Alignment);
+			const uint64_t Padding = Aligned - BlockOffset;
+			if (Padding + Size > BlockSize) {
+				continue;
+			}
+
+			FreeBlocks_.erase(It);
+			// 对齐产生的头部空隙仍然是空闲块
+			if (Padding > 0) {
+				FreeBlocks_[BlockOffset] = Padding;
+			}
+			const uint64_t Tail = BlockSize - Padding - Size;
+			if (Tail > 0) {
+				FreeBlocks_[Aligned + Size] = Tail;
+			}
+
+			UsedSize_ += Size;
+			AllocationCount_++;
+			return Aligned;
+		}
+
+		return InvalidOffset;
+	}
+
+	// 释放区间，Size必须与分配时一致
+	void Free(uint64_t Offset, uint64_t Size) {
+		if (Offset == InvalidOffset || Size == 0) {
+			return;
+		}
+
+		UsedSize_ -= Size;
+		AllocationCount_--;
+
+		auto Next = FreeBlocks_.lower_bound(Offset);
+		// 与后一个空闲块合并
+		if (Next != FreeBlocks_.end() && Offset + Size == Next->first) {
+			Size += Next->second;
+			Next = FreeBlocks_.erase(Next);
+		}
+
+		// 与前一个空闲块合并
+		if (Next != FreeBlocks_.begin()) {
+			auto Prev = std::prev(Next);
+			if (Prev->first + Prev->second == Offset) {
+				Prev->second += Size;
+				return;
+			}
+		}
+
+		FreeBlocks_[Offset] = Size;
+	}
+
+	// 扩容，新增部分作为空闲块追加在末尾
+	void Grow(uint64_t NewCapacity) {
+		if (NewCapacity <= Capacity_) {
+			return;
+		}
+
+		const uint64_t Extra = NewCapacity - Capacity_;
+		const uint64_t OldCapacity = Capacity_;
+		Capacity_ = NewCapacity;
+
+		// 借用Free完成与尾部空闲块的合并
+		UsedSize_ += Extra;
+		AllocationCount_++;
+		Free(OldCapacity, Extra);
+	}
+
+public:
+	uint64_t GetCapacity() const { return Capacity_; }
+	uint64_t GetUsedSize() const { return UsedSize_; }
+	uint64_t GetFreeSize() const { return Capacity_ - UsedSize_; }
+	uint32_t GetAllocationCount() const { return AllocationCount_; }
+	uint32_t GetFreeBlockCount() const { return static_cast<uint32_t>(FreeBlocks_.size()); }
+
+	uint64_t GetLargestFreeBlock() const {
+		uint64_t Largest = 0;
+		for (const auto& Block : FreeBlocks_) {
+			Largest = Block.second > Largest ? Block.second : Largest;
+		}
+		return Largest;
+	}
+
+	// 碎片率：1 - 最大空闲块 / 总空闲空间，0表示空闲空间完全连续
+	float GetFragmentation() const {
+		const uint64_t FreeSize = GetFreeSize();
+		if (FreeSize == 0) {
+			return 0.0f;
+		}
+		return 1.0f - static_cast<float>(GetLargestFreeBlock()) / static_cast<float>(FreeSize);
+	}
+
+	static uint64_t AlignUp(uint64_t Value, uint64_t Alignment) {
+		if (Alignment <= 1) {
+			return Value;
+		}
+		return (Value + Alignment - 1) / Alignment * Alignment;
+	}
+
+private:
+	// Offset -> Size
+	std::map<uint64_t, uint64_t> FreeBlocks_;
+	uint64_t Capacity_;
+	uint64_t UsedSize_;
+	uint32_t AllocationCount_;
+};
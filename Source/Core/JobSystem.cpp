@@ -0,0 +1,135 @@
+﻿#include "JobSystem.h"
+#include "Logger.hpp"
+#include <algorithm>
+#include <memory>
+
+JobSystem& JobSystem::Instance() {
+	static JobSystem GlobalJobSystem;
+	return GlobalJobSystem;
+}
+
+bool JobSystem::Initialize(uint32_t WorkerCount) {
+	if (!Workers_.empty()) {
+		return true;
+	}
+
+	if (WorkerCount == 0) {
+		const uint32_t HardwareThreads = std::thread::hardware_concurrency();
+		WorkerCount = HardwareThreads > 1 ? HardwareThreads - 1 : 1;
+	}
+
+	Stopping_ = false;
+	Workers_.reserve(WorkerCount);
+	for (uint32_t i = 0; i < WorkerCount; ++i) {
+		Workers_.emplace_back(&JobSystem::WorkerLoop, this);
+	}
+
+	LOG_INFO << "Job system started with " << WorkerCount << " workers.";
+	return true;
+}
+
+void JobSystem::Shutdown() {
+	if (Workers_.empty()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(QueueMutex_);
+		Stopping_ = true;
+	}
+	QueueCondition_.notify_all();
+
+	for (std::thread& Worker : Workers_) {
+		if (Worker.joinable()) {
+			Worker.join();
+		}
+	}
+	Workers_.clear();
+}
+
+void JobSystem::Submit(Job Task) {
+	if (!Task) {
+		return;
+	}
+
+	// 没有工作线程时同步执行
+	if (Workers_.empty()) {
+		Task();
+		return;
+	}
+
+	PendingJobs_++;
+	{
+		std::lock_guard<std::mutex> Lock(QueueMutex_);
+		Jobs_.push(std::move(Task));
+	}
+	QueueCondition_.notify_one();
+}
+
+void JobSystem::WaitIdle() {
+	std::unique_lock<std::mutex> Lock(QueueMutex_);
+	IdleCondition_.wait(Lock, [this]() { return PendingJobs_.load() == 0; });
+}
+
+void JobSystem::ParallelFor(uint32_t Count, const std::function<void(uint32_t)>& Func) {
+	if (Workers_.empty() || Count <= 1) {
+		for (uint32_t i = 0; i < Count; ++i) {
+			Func(i);
+		}
+		return;
+	}
+
+	struct ParallelState {
+		std::atomic<uint32_t> Next{ 0 };
+		std::atomic<uint32_t> Done{ 0 };
+		std::mutex DoneMutex;
+		std::condition_variable DoneCondition;
+	};
+	std::shared_ptr<ParallelState> State = std::make_shared<ParallelState>();
+
+	// 调用线程完成全部工作后，迟到的任务取不到索引，不会访问Func
+	auto Run = [State, &Func, Count]() {
+		uint32_t Finished = 0;
+		for (uint32_t i = State->Next.fetch_add(1); i < Count; i = State->Next.fetch_add(1)) {
+			Func(i);
+			Finished++;
+		}
+		if (Finished > 0 && State->Done.fetch_add(Finished) + Finished == Count) {
+			std::lock_guard<std::mutex> Lock(State->DoneMutex);
+			State->DoneCondition.notify_all();
+		}
+	};
+
+	const uint32_t HelperCount = std::min((uint32_t)Workers_.size(), Count - 1);
+	for (uint32_t i = 0; i < HelperCount; ++i) {
+		Submit(Run);
+	}
+	Run();
+
+	std::unique_lock<std::mutex> Lock(State->DoneMutex);
+	State->DoneCondition.wait(Lock, [&State, Count]() { return State->Done.load() == Count; });
+}
+
+void JobSystem::WorkerLoop() {
+	for (;;) {
+		Job Task;
+		{
+			std::unique_lock<std::mutex> Lock(QueueMutex_);
+			QueueCondition_.wait(Lock, [this]() { return Stopping_ || !Jobs_.empty(); });
+			// 退出前先把队列中的任务执行完
+			if (Jobs_.empty()) {
+				return;
+			}
+			Task = std::move(Jobs_.front());
+			Jobs_.pop();
+		}
+
+		Task();
+
+		{
+			std::lock_guard<std::mutex> Lock(QueueMutex_);
+			PendingJobs_--;
+		}
+		IdleCondition_.notify_all();
+	}
+}
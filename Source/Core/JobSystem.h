@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include "CoreModuleAPI.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * 固定数量工作线程的任务系统，用于文件读取、解析等不涉及图形API的后台任务。
+ * 任务按提交顺序执行；未初始化时Submit直接在调用线程执行。
+ */
+class JobSystem {
+public:
+	using Job = std::function<void()>;
+
+	ENGINE_CORE_API static JobSystem& Instance();
+
+public:
+	// WorkerCount为0时使用硬件线程数-1（至少1个）
+	ENGINE_CORE_API bool Initialize(uint32_t WorkerCount = 0);
+	// 执行完已提交的任务后退出工作线程
+	ENGINE_CORE_API void Shutdown();
+
+	ENGINE_CORE_API void Submit(Job Task);
+	// 阻塞直到队列为空且没有正在执行的任务
+	ENGINE_CORE_API void WaitIdle();
+	// 将[0, Count)分给工作线程和调用线程并行执行，返回时全部完成
+	ENGINE_CORE_API void ParallelFor(uint32_t Count, const std::function<void(uint32_t)>& Func);
+
+	ENGINE_CORE_API uint32_t GetWorkerCount() const { return (uint32_t)Workers_.size(); }
+	ENGINE_CORE_API uint32_t GetPendingJobCount() const { return PendingJobs_.load(); }
+
+private:
+	JobSystem() : Stopping_(false), PendingJobs_(0) {}
+	~JobSystem() { Shutdown(); }
+
+	// 禁止拷贝
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread> Workers_;
+	std::queue<Job> Jobs_;
+	std::mutex QueueMutex_;
+	std::condition_variable QueueCondition_;
+	std::condition_variable IdleCondition_;
+	bool Stopping_;
+	// 已提交但未执行完的任务数
+	std::atomic<uint32_t> PendingJobs_;
+};
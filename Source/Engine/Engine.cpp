@@ -3,6 +3,7 @@
 
 #include "Core/IApplication.h"
 #include "Core/EventManager.h"
+#include "Core/JobSystem.h"
 #include "Platform/Window/Window.h"
 
 #include "Rendering/Renderer/Renderer.h"
@@ -74,6 +75,9 @@ bool Engine::Initialize(IApplication* app) {
 		return false;
 	}
 
+	// 后台任务（资源导入等）
+	JobSystem::Instance().Initialize();
+
 	ResourceManager& ResourceSys = ResourceManager::Instance();
 	if (!ResourceSys.Initialize()) {
 		LOG_ERROR << "ResourceSystem init failed!";
@@ -96,6 +100,8 @@ bool Engine::Initialize(IApplication* app) {
 void Engine::Run() {
 	// 加载场景
 	Application_->InitScene(*Scene_);
+	// 场景加载完成后由渲染线程接管图形上下文
+	CoreRenderer->SetRenderThread(RENDER_THREAD != 0);
 	// 帧率控制
 	FrameRateController Frc(144, 60);
 
@@ -115,6 +121,7 @@ void Engine::Run() {
 		Window_->ProcessMessages();
 		// 处理全局事件队列
 		AEventManager::Instance().ProcessEvents();
+		CoreRenderer->MarkInputSampled();
 
 		Tick(Frc.GetDeltaTime());
 
@@ -138,11 +145,16 @@ void Engine::Tick(float DeltaTime) {
 }
 
 void Engine::Render() {
+	// 创建后台已导入完成的资源，限制每帧耗时
+	ResourceManager::Instance().ProcessUploads();
+
 	CommandList CmdList;
 	CoreRenderer->BeginCommand(CmdList);
-	std::vector<std::shared_ptr<AActor>> AllActors = Scene_->GetAllActors();
+	const std::vector<std::shared_ptr<AActor>>& AllActors = Scene_->GetAllActors();
 
 	// 先摄像机
+	FFrustum Frustum;
+	FMatrix4 ViewProj = FMatrix4::Identity();
 	for (auto& Act : AllActors) {
 		ACameraActor* Camera = DynamicCast<ACameraActor>(Act).get();
 		if (Camera) {
@@ -150,18 +162,68 @@ void Engine::Render() {
 			const FMatrix4& ProjMatrix = Camera->GetProjectionMatrix();
 
 			CmdList.SetViewProjection(ViewMatrix, ProjMatrix);
+			ViewProj = ProjMatrix * ViewMatrix;
+			Frustum.SetFromMatrix(ViewProj);
 			break;
 		}
 	}
 
-	// 后网格
-	for (auto& Act : AllActors) {
-		UMeshComponent* MeshComp = Act.get()->GetComponent<UMeshComponent>();
-		if (MeshComp) {
-			MeshComp->Draw(CmdList);
+	// 后网格：先由场景BVH按胖包围盒层次剔除，再对候选的精确包围盒批量剔除，只录制可见的网格
+	Scene_->UpdateBounds();
+	MeshComponents_.clear();
+	FrustumCuller& Culler = CoreRenderer->GetFrustumCuller();
+	// 被BVH剔除的图元数，关闭剔除时网格列表来自全部Actor，与场景图元无关
+	uint32_t TreeCulled = 0;
+	if (Culler.IsEnabled()) {
+		Scene_->QueryFrustum(Frustum, MeshComponents_);
+		TreeCulled = Scene_->GetPrimitiveCount() - (uint32_t)MeshComponents_.size();
+	}
+	else {
+		for (auto& Act : AllActors) {
+			UMeshComponent* MeshComp = Act.get()->GetComponent<UMeshComponent>();
+			if (MeshComp) {
+				MeshComponents_.push_back(MeshComp);
+			}
 		}
 	}
 
+	Culler.Reset();
+	for (UMeshComponent* MeshComp : MeshComponents_) {
+		Culler.Add(MeshComp->GetWorldBounds());
+	}
+	Culler.Cull(Frustum, FrustumTest::eBox, TreeCulled);
+
+	// 视锥内的遮挡体先光栅化到遮挡深度，再剔除被挡住的对象（遮挡体也可能被更近的遮挡体挡住）
+	OcclusionCuller& Occlusion = CoreRenderer->GetOcclusionCuller();
+	Occlusion.BeginFrame(ViewProj);
+	if (Occlusion.IsEnabled()) {
+		for (uint32_t i = 0; i < (uint32_t)MeshComponents_.size(); ++i) {
+			UMeshComponent* MeshComp = MeshComponents_[i];
+			const OccluderGeometry* Geometry = Culler.IsVisible(i) ? MeshComp->GetOccluderGeometry() : nullptr;
+			if (Geometry) {
+				Occlusion.AddOccluder(*Geometry, MeshComp->GetModelMatrix(), MeshComp->GetWorldBounds());
+			}
+		}
+		Occlusion.RasterizeOccluders();
+		Culler.CullOccluded(Occlusion);
+	}
+
+	// 场景Pass：清除后台缓冲并录制可见网格，帧图编译后执行
+	CoreRenderer->GetFrameGraph().AddPass("Scene",
+		[&](FrameGraphBuilder& Builder) {
+			Builder.Write(CoreRenderer->GetBackbuffer());
+			Builder.Write(CoreRenderer->GetBackbufferDepth());
+			Builder.SetClearColor(FVector4(0.2f, 0.3f, 0.3f, 1.0f));
+			Builder.SetClearDepth(1.0f);
+		},
+		[&](CommandList& Cmd, const FrameGraph&) {
+			for (uint32_t i = 0; i < (uint32_t)MeshComponents_.size(); ++i) {
+				if (Culler.IsVisible(i)) {
+					MeshComponents_[i]->Draw(Cmd);
+				}
+			}
+		});
+
 	CoreRenderer->DrawScene(CmdList);
 	CoreRenderer->EndCommand(CmdList);
 }
@@ -218,6 +280,7 @@ void Engine::Shutdown() {
 
 	ResourceManager& ResourceSys = ResourceManager::Instance();
 	ResourceSys.Shutdown();
+	JobSystem::Instance().Shutdown();
 
 	if (CoreRenderer) {
 		CoreRenderer->Destroy();
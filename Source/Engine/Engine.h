@@ -1,11 +1,13 @@
 ﻿#pragma once
 
 #include "EngineModuleAPI.h"
+#include <vector>
 
 class Window;
 class IApplication;
 class Renderer;
 class Scene;
+class UMeshComponent;
 
 class Engine {
 public:
@@ -39,4 +41,7 @@ protected:
 	Renderer* CoreRenderer;
 
 	Scene* Scene_;
+
+	// 每帧参与剔除的网格组件，与剔除器中的包围盒一一对应
+	std::vector<UMeshComponent*> MeshComponents_;
 };
@@ -1,7 +1,9 @@
 ﻿#include "Scene.h"
 #include "Framework/Actors/Actor.h"
+#include "Framework/Components/MeshComponent.h"
 
 #include <Logger.hpp>
+#include <chrono>
 
 bool Scene::Initialize() {
 	Name_ = "Default";
@@ -12,13 +14,112 @@ bool Scene::Initialize() {
 
 void Scene::AddToScene(std::shared_ptr<AActor> Act) { 
 	AllActrors_.push_back(Act); 
+
+	// 包围盒在UpdateBounds中就绪后再插入BVH
+	UMeshComponent* MeshComp = Act ? Act->GetComponent<UMeshComponent>() : nullptr;
+	if (MeshComp) {
+		ScenePrimitive Primitive;
+		Primitive.Mesh = MeshComp;
+		Primitive.Owner = Act.get();
+		Primitives_.push_back(Primitive);
+	}
 }
 
-std::vector<std::shared_ptr<AActor>> Scene::GetAllActors() const { 
+const std::vector<std::shared_ptr<AActor>>& Scene::GetAllActors() const { 
 	return AllActrors_; 
 }
 
+void Scene::UpdateBounds() {
+	auto UpdateStart = std::chrono::high_resolution_clock::now();
+	SpatialTree_.ResetCounters();
+	QueryStats_.UnboundedPrimitives = 0;
+	QueryStats_.MovedProxies = 0;
+
+	for (uint32_t i = 0; i < (uint32_t)Primitives_.size(); ++i) {
+		ScenePrimitive& Primitive = Primitives_[i];
+		// 变换和Mesh未变化时直接返回缓存
+		const FBoundingBox& Bounds = Primitive.Mesh->GetWorldBounds();
+		if (!Bounds.IsValid()) {
+			if (Primitive.Proxy != AABBTree::NULL_NODE) {
+				SpatialTree_.DestroyProxy(Primitive.Proxy);
+				Primitive.Proxy = AABBTree::NULL_NODE;
+			}
+			QueryStats_.UnboundedPrimitives++;
+			continue;
+		}
+
+		const FVector3 Center = Bounds.GetCenter();
+		if (Primitive.Proxy == AABBTree::NULL_NODE) {
+			Primitive.Proxy = SpatialTree_.CreateProxy(Bounds, (void*)(uintptr_t)i);
+		}
+		else if (SpatialTree_.MoveProxy(Primitive.Proxy, Bounds, Center - Primitive.LastCenter)) {
+			QueryStats_.MovedProxies++;
+		}
+		Primitive.LastCenter = Center;
+	}
+
+	QueryStats_.Primitives = (uint32_t)Primitives_.size();
+	QueryStats_.ReinsertedProxies = SpatialTree_.GetReinsertCount();
+	QueryStats_.TreeHeight = SpatialTree_.GetHeight();
+
+	auto UpdateEnd = std::chrono::high_resolution_clock::now();
+	QueryStats_.UpdateTimeMs = std::chrono::duration<double, std::milli>(UpdateEnd - UpdateStart).count();
+}
+
+void Scene::QueryFrustum(const FFrustum& Frustum, std::vector<UMeshComponent*>& OutMeshes) {
+	auto QueryStart = std::chrono::high_resolution_clock::now();
+
+	SpatialTree_.QueryFrustum(Frustum, [&](int32_t Proxy) {
+		OutMeshes.push_back(Primitives_[(uintptr_t)SpatialTree_.GetUserData(Proxy)].Mesh);
+		return true;
+	});
+
+	// 没有包围盒的无法剔除
+	if (QueryStats_.UnboundedPrimitives > 0) {
+		for (const ScenePrimitive& Primitive : Primitives_) {
+			if (Primitive.Proxy == AABBTree::NULL_NODE) {
+				OutMeshes.push_back(Primitive.Mesh);
+			}
+		}
+	}
+
+	auto QueryEnd = std::chrono::high_resolution_clock::now();
+	QueryStats_.QueryTimeMs = std::chrono::duration<double, std::milli>(QueryEnd - QueryStart).count();
+}
+
+void Scene::QueryBox(const FBoundingBox& Box, std::vector<UMeshComponent*>& OutMeshes) {
+	SpatialTree_.QueryBox(Box, [&](int32_t Proxy) {
+		OutMeshes.push_back(Primitives_[(uintptr_t)SpatialTree_.GetUserData(Proxy)].Mesh);
+		return true;
+	});
+}
+
+AActor* Scene::RayCast(const FRay& Ray, float* OutDistance) {
+	AActor* HitActor = nullptr;
+	float Closest = Ray.MaxDistance;
+	const FVector3 InvDirection = Ray.GetInvDirection();
+
+	SpatialTree_.RayCast(Ray, [&](int32_t Proxy, float) {
+		// 胖包围盒命中后再用精确包围盒测试，命中时裁剪射线
+		ScenePrimitive& Primitive = Primitives_[(uintptr_t)SpatialTree_.GetUserData(Proxy)];
+		float Distance = 0.0f;
+		if (Primitive.Mesh->GetWorldBounds().IntersectRay(Ray.Origin, InvDirection, Closest, Distance) && Distance < Closest) {
+			Closest = Distance;
+			HitActor = Primitive.Owner;
+		}
+		return Closest;
+	});
+
+	if (HitActor && OutDistance) {
+		*OutDistance = Closest;
+	}
+	return HitActor;
+}
+
 void Scene::Clear() {
+	Primitives_.clear();
+	SpatialTree_.Clear();
+
 	for (auto& Act : AllActrors_) {
 		if (Act) {
 			Act.reset();
@@ -1,11 +1,24 @@
 ﻿#pragma once
 
 #include "EngineModuleAPI.h"
+#include "Core/AABBTree.h"
 #include <vector>
 #include <string>
 #include <memory>
 
 class AActor;
+class UMeshComponent;
+
+// 场景空间查询统计
+struct SceneQueryStats {
+	uint32_t Primitives = 0;           // 带网格组件的Actor数
+	uint32_t UnboundedPrimitives = 0;  // 包围盒未就绪，查询时总是返回
+	uint32_t MovedProxies = 0;         // 本次UpdateBounds中胖包围盒变化的数量
+	uint32_t ReinsertedProxies = 0;    // 其中需要重新插入的数量
+	int32_t TreeHeight = 0;
+	double UpdateTimeMs = 0.0;
+	double QueryTimeMs = 0.0;          // 最近一次视锥查询的耗时
+};
 
 class Scene {
 public:
@@ -13,13 +26,39 @@ public:
 
 public:
 	ENGINE_ENGINE_API void AddToScene(std::shared_ptr<AActor> Act);
-	ENGINE_ENGINE_API std::vector<std::shared_ptr<AActor>> GetAllActors() const;
+	ENGINE_ENGINE_API const std::vector<std::shared_ptr<AActor>>& GetAllActors() const;
 	ENGINE_ENGINE_API void Clear();
 
 	ENGINE_ENGINE_API const std::string& GetName() const { return Name_; }
 
+public:
+	// 空间查询。查询前调用UpdateBounds把网格组件的世界包围盒同步到BVH
+	ENGINE_ENGINE_API void UpdateBounds();
+	// 胖包围盒与视锥相交的网格组件（保守结果，可再用精确包围盒剔除）
+	ENGINE_ENGINE_API void QueryFrustum(const FFrustum& Frustum, std::vector<UMeshComponent*>& OutMeshes);
+	ENGINE_ENGINE_API void QueryBox(const FBoundingBox& Box, std::vector<UMeshComponent*>& OutMeshes);
+	// 拾取：返回世界包围盒最先被射线击中的Actor
+	ENGINE_ENGINE_API AActor* RayCast(const FRay& Ray, float* OutDistance = nullptr);
+
+	ENGINE_ENGINE_API uint32_t GetPrimitiveCount() const { return (uint32_t)Primitives_.size(); }
+	ENGINE_ENGINE_API const SceneQueryStats& GetQueryStats() const { return QueryStats_; }
+	ENGINE_ENGINE_API const AABBTree& GetSpatialTree() const { return SpatialTree_; }
+
+private:
+	struct ScenePrimitive {
+		UMeshComponent* Mesh = nullptr;
+		AActor* Owner = nullptr;
+		int32_t Proxy = AABBTree::NULL_NODE;
+		FVector3 LastCenter = FVector3::Zero();
+	};
+
 private:
 	std::string Name_;
 	std::vector<std::shared_ptr<AActor>> AllActrors_;
 
+	// 代理的UserData为Primitives_中的序号
+	std::vector<ScenePrimitive> Primitives_;
+	AABBTree SpatialTree_;
+	SceneQueryStats QueryStats_;
+
 };
\ No newline at end of file
@@ -1,11 +1,13 @@
 ﻿#include "MeshComponent.h"
 
 #include "Rendering/Renderer/Renderer.h"
+#include "Rendering/Culling/MeshLODSelector.h"
 #include "Rendering/Resource/IMesh.h"
 #include "Rendering/Resource/IMaterial.h"
 #include "Platform/File/JsonObject.h"
 #include "Rendering/Resource/Manager/ResourceManager.h"
 #include "Framework/Actors/Actor.h"
+#include <Logger.hpp>
 
 #ifndef DynmicCast
 #define DynmicCast std::dynamic_pointer_cast
@@ -14,42 +16,159 @@
 UMeshComponent::UMeshComponent() : UBaseComponent() {}
 UMeshComponent::UMeshComponent(AActor* Owner, const std::string& Name) : UBaseComponent(Owner, Name) {}
 UMeshComponent::~UMeshComponent() {
+	ResourceManager::Instance().Release(MeshHandle_);
+	MeshHandle_ = MeshHandle();
+}
+
+IMesh* UMeshComponent::ResolveMesh() {
 	ResourceManager& RS = ResourceManager::Instance();
-	if (MeshAsset_) {
-		RS.Release(MeshAsset_->GetID());
-		MeshAsset_.reset();
+
+	// 后台加载完成后替换占位Mesh，失败时继续使用占位
+	if (PendingMesh_.IsValid() && PendingMesh_.IsDone()) {
+		std::shared_ptr<IResource> Mesh = PendingMesh_.Get();
+		if (PendingMesh_.IsReady() && Mesh) {
+			SetMesh(MeshHandle::FromValue(Mesh->GetHandleValue()));
+		}
+		PendingMesh_ = ResourceLoadHandle();
+	}
+
+	return RS.Get(MeshHandle_.IsValid() ? MeshHandle_ : PlaceholderHandle_);
+}
+
+const FBoundingBox& UMeshComponent::GetWorldBounds() {
+	const IMesh* Mesh = ResolveMesh();
+	AActor* Owner = GetOwner();
+	UTransformComponent* TransformComp = Owner ? Owner->GetComponent<UTransformComponent>() : nullptr;
+	const uint32_t TransformVersion = TransformComp ? TransformComp->GetVersion() : 0;
+	if (Mesh == BoundsMesh_ && TransformVersion == BoundsVersion_) {
+		return WorldBounds_;
+	}
+
+	WorldBounds_ = FBoundingBox();
+	if (Mesh && Mesh->HasBounds()) {
+		WorldBounds_ = TransformComp ? Mesh->GetBounds().Transform(TransformComp->GetModelMatrix()) : Mesh->GetBounds();
+	}
+	BoundsMesh_ = Mesh;
+	BoundsVersion_ = TransformVersion;
+	return WorldBounds_;
+}
+
+FMatrix4 UMeshComponent::GetModelMatrix() const {
+	AActor* Owner = GetOwner();
+	UTransformComponent* TransformComp = Owner ? Owner->GetComponent<UTransformComponent>() : nullptr;
+	return TransformComp ? TransformComp->GetModelMatrix() : FMatrix4::Identity();
+}
+
+void UMeshComponent::SetOccluder(bool Occluder) {
+	Occluder_ = Occluder;
+	if (!Occluder_) {
+		OccluderGeometry_ = OccluderGeometry();
+		OccluderMesh_ = nullptr;
+	}
+}
+
+const OccluderGeometry* UMeshComponent::GetOccluderGeometry() {
+	// 占位Mesh不作为遮挡体
+	IMesh* Mesh = ResolveMesh();
+	if (!Occluder_ || !Mesh || !MeshHandle_.IsValid()) {
+		return nullptr;
+	}
+
+	if (Mesh != OccluderMesh_) {
+		OccluderMesh_ = Mesh;
+		if (!OcclusionCuller::ExtractOccluder(*Mesh, OccluderGeometry_)) {
+			LOG_WARN << "Mesh '" << Mesh->GetName() << "' has no CPU geometry, it won't be used as an occluder.";
+		}
 	}
+	return OccluderGeometry_.IsValid() ? &OccluderGeometry_ : nullptr;
 }
 
 void UMeshComponent::Draw(CommandList& CmdList) {
 	AActor* Owner = GetOwner();
-	if (!Owner || !MeshAsset_) {
+	IMesh* Mesh = ResolveMesh();
+	if (!Owner || !Mesh) {
 		return;
 	}
 
-	FMatrix4 ModelMatrix = FMatrix4::Identity();
-	UTransformComponent* TransformComp = Owner->GetComponent<UTransformComponent>();
-	if (TransformComp) ModelMatrix = TransformComp->GetModelMatrix();
+	const FMatrix4 ModelMatrix = GetModelMatrix();
 
-	const std::vector<SubMeshDesc>& SubMeshes = MeshAsset_->GetSubMeshes();
+	// 按包围盒的屏幕尺寸选择LOD
+	uint32_t LOD = 0;
+	bool Switched = false;
+	MeshLODSelector* LODSelector = CmdList.GetLODSelector();
+	if (LODSelector) {
+		// Mesh变化后重新选择，不算切换
+		const bool NewMesh = Mesh != LODMesh_;
+		LOD = LODSelector->Select(*Mesh, GetWorldBounds(), CmdList.GetViewMatrix(), CmdList.GetProjMatrix(), NewMesh ? 0 : CurrentLOD_);
+		Switched = !NewMesh && LOD != CurrentLOD_;
+		LODMesh_ = Mesh;
+		CurrentLOD_ = LOD;
+	}
+
+	const std::vector<SubMeshDesc>& SubMeshes = Mesh->GetSubMeshes(LOD);
 	for (const SubMeshDesc& SubMesh : SubMeshes) {
-		IMaterial* Material = MeshAsset_->GetMaterial(SubMesh.MaterialIndex).get();
+		IMaterial* Material = Mesh->GetMaterialPtr(SubMesh.MaterialIndex);
 		if (!Material) {
 			continue;
 		}
 
-		CmdList.DrawIndexed(MeshAsset_.get(), Material, ModelMatrix, SubMesh.IndexCount, SubMesh.BaseIndex);
+		CmdList.DrawIndexed(Mesh, Material, ModelMatrix, SubMesh.IndexCount, SubMesh.BaseIndex);
+	}
+
+	if (LODSelector) {
+		LODSelector->RecordDraw(*Mesh, LOD, Switched);
 	}
 }
 
 bool UMeshComponent::LoadFromFile(const std::string& FilePath) {
 	
-	// 加载资产
+	// 加载资产，名称只在这里解析一次
+	ResourceManager& RS = ResourceManager::Instance();
+	std::shared_ptr<IResource> Mesh = RS.LoadResource(ResourceType::eMesh, FilePath);
+	if (!Mesh || Mesh->GetResourceType() != ResourceType::eMesh) {
+		return false;
+	}
+
+	SetMesh(MeshHandle::FromValue(Mesh->GetHandleValue()));
+	return MeshHandle_.IsValid();
+}
+
+bool UMeshComponent::LoadFromFileAsync(const std::string& FilePath) {
 	ResourceManager& RS = ResourceManager::Instance();
-	MeshAsset_ = DynmicCast<IMesh>(RS.LoadResource(ResourceType::eMesh, FilePath));
-	if (!MeshAsset_) {
+	PendingMesh_ = RS.LoadResourceAsync(ResourceType::eMesh, FilePath);
+	if (!PendingMesh_.IsValid()) {
 		return false;
 	}
 
+	// 占位Mesh不计入句柄引用
+	std::shared_ptr<IResource> Placeholder = PendingMesh_.Get();
+	PlaceholderHandle_ = Placeholder ? MeshHandle::FromValue(Placeholder->GetHandleValue()) : MeshHandle();
 	return true;
+}
+
+std::shared_ptr<IMesh> UMeshComponent::GetMesh() {
+	IMesh* Mesh = ResourceManager::Instance().Get(MeshHandle_);
+	if (!Mesh) {
+		return nullptr;
+	}
+	return DynmicCast<IMesh>(ResourceManager::Instance().Acquire(Mesh->GetID()));
+}
+
+void UMeshComponent::SetMesh(std::shared_ptr<IResource> Mesh) {
+	if (!Mesh || Mesh->GetResourceType() != ResourceType::eMesh) {
+		SetMesh(MeshHandle());
+		return;
+	}
+	SetMesh(MeshHandle::FromValue(Mesh->GetHandleValue()));
+}
+
+void UMeshComponent::SetMesh(MeshHandle Mesh) {
+	if (Mesh == MeshHandle_) {
+		return;
+	}
+
+	ResourceManager& RS = ResourceManager::Instance();
+	RS.AddRef(Mesh);
+	RS.Release(MeshHandle_);
+	MeshHandle_ = RS.Get(Mesh) ? Mesh : MeshHandle();
 }
\ No newline at end of file
@@ -2,7 +2,11 @@
 
 #include "BaseComponent.h"
 #include <memory>
+#include "Core/Bounds.h"
 #include "Rendering/Command/CommandList.h"
+#include "Rendering/Culling/OcclusionCuller.h"
+#include "Rendering/Resource/Manager/ResourceLoadHandle.h"
+#include "Rendering/Resource/ResourceHandle.h"
 
 class IMesh;
 class IMaterial;
@@ -17,14 +21,45 @@ public:
 	ENGINE_FRAMEWORK_API void Draw(CommandList& CmdList);
 
 	ENGINE_FRAMEWORK_API bool LoadFromFile(const std::string& FilePath);
+	// 后台加载，就绪前绘制占位Mesh
+	ENGINE_FRAMEWORK_API bool LoadFromFileAsync(const std::string& FilePath);
+	ENGINE_FRAMEWORK_API bool IsLoading() const { return PendingMesh_.IsValid(); }
 
-	ENGINE_FRAMEWORK_API std::shared_ptr<IMesh> GetMesh() { return DynamicCast<IMesh>(MeshAsset_); }
-	ENGINE_FRAMEWORK_API void SetMesh(std::shared_ptr<IResource> Mesh) {
-		if (MeshAsset_) MeshAsset_.reset();
-		MeshAsset_ = DynamicCast<IMesh>(MeshAsset_); 
-	}
+	ENGINE_FRAMEWORK_API std::shared_ptr<IMesh> GetMesh();
+	ENGINE_FRAMEWORK_API MeshHandle GetMeshHandle() const { return MeshHandle_; }
+	ENGINE_FRAMEWORK_API void SetMesh(std::shared_ptr<IResource> Mesh);
+	ENGINE_FRAMEWORK_API void SetMesh(MeshHandle Mesh);
+
+	// 世界空间包围盒，Mesh或变换变化时重新计算；Mesh未就绪时无效
+	ENGINE_FRAMEWORK_API const FBoundingBox& GetWorldBounds();
+	ENGINE_FRAMEWORK_API FMatrix4 GetModelMatrix() const;
+
+	// 作为遮挡体参与遮挡剔除，适合墙体、地形等大而简单的网格
+	ENGINE_FRAMEWORK_API void SetOccluder(bool Occluder);
+	ENGINE_FRAMEWORK_API bool IsOccluder() const { return Occluder_; }
+	// 首次使用时从Mesh的CPU副本提取，Mesh加载完成前为空
+	ENGINE_FRAMEWORK_API const OccluderGeometry* GetOccluderGeometry();
+
+private:
+	// 当前绘制的Mesh（加载完成前为占位Mesh）
+	IMesh* ResolveMesh();
 
 private:
-	std::shared_ptr<IMesh> MeshAsset_;
+	// 绘制时通过句柄取Mesh，不复制shared_ptr
+	MeshHandle MeshHandle_;
+	MeshHandle PlaceholderHandle_;
+	ResourceLoadHandle PendingMesh_;
+
+	FBoundingBox WorldBounds_;
+	const IMesh* BoundsMesh_ = nullptr;
+	uint32_t BoundsVersion_ = UINT32_MAX;
+
+	bool Occluder_ = false;
+	OccluderGeometry OccluderGeometry_;
+	const IMesh* OccluderMesh_ = nullptr;
+
+	// 上一帧选择的LOD，Mesh变化时重置
+	uint32_t CurrentLOD_ = 0;
+	const IMesh* LODMesh_ = nullptr;
 
 };
\ No newline at end of file
@@ -6,12 +6,12 @@ UTransformComponent::~UTransformComponent() {}
 
 void UTransformComponent::SetPosition(const FVector3& p) {
 	Position_ = p;
-	IsDirty_ = true;
+	MarkDirty();
 }
 
 void UTransformComponent::SetRotationQuat(const FQuaternion& q) {
 	Rotation_ = q.normalized();
-	IsDirty_ = true;
+	MarkDirty();
 }
 
 void UTransformComponent::SetRotationEuler(const FVector3& eulerDeg) {
@@ -21,7 +21,7 @@ void UTransformComponent::SetRotationEuler(const FVector3& eulerDeg) {
 		AngleAxis(rad.y(), FVector3::UnitY()) *
 		AngleAxis(rad.x(), FVector3::UnitX()));
 	Rotation_.normalize();
-	IsDirty_ = true;
+	MarkDirty();
 }
 
 FVector3 UTransformComponent::GetRotationEuler() const {
@@ -35,7 +35,7 @@ void UTransformComponent::RotateWorld(const FVector3& axis, float deg) {
 	float rad = deg * (M_PI / 180.0f);
 	FQuaternion dq(AngleAxis(rad, axis.normalized()));
 	Rotation_ = (dq * Rotation_).normalized();
-	IsDirty_ = true;
+	MarkDirty();
 }
 
 // 局部旋转（与当前朝向对齐）
@@ -45,7 +45,7 @@ void UTransformComponent::RotateLocal(const FVector3& axis, float deg) {
 	FVector3 localAxis = Rotation_ * axis.normalized();
 	FQuaternion dq(AngleAxis(rad, localAxis));
 	Rotation_ = (dq * Rotation_).normalized();
-	IsDirty_ = true;
+	MarkDirty();
 }
 
 // World
@@ -60,7 +60,12 @@ void UTransformComponent::RotateLocalZ(float deg) { RotateLocal(FVector3::UnitZ(
 
 void UTransformComponent::SetScale(const FVector3& s) {
 	Scale_ = s;
+	MarkDirty();
+}
+
+void UTransformComponent::MarkDirty() {
 	IsDirty_ = true;
+	++Version_;
 }
 
 const FMatrix4& UTransformComponent::GetModelMatrix() const {
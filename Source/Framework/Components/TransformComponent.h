@@ -39,8 +39,11 @@ public:
 
 	// Matrix
 	ENGINE_FRAMEWORK_API const FMatrix4& GetModelMatrix() const;
+	// 每次变换修改后递增，供依赖变换的缓存（如世界包围盒）判断是否过期
+	ENGINE_FRAMEWORK_API uint32_t GetVersion() const { return Version_; }
 
 private:
+	void MarkDirty();
 	void UpdateModelMatrix() const;
 
 private:
@@ -50,4 +53,5 @@ private:
 
 	mutable FMatrix4 ModelMatrix_ = FMatrix4::Identity();
 	mutable bool IsDirty_ = true;
+	uint32_t Version_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "PlatformMoudleAPI.h"
+
+#include <cstdint>
+#include <string>
+
+// 只读内存映射文件，映射期间数据指针保持有效
+class MappedFile {
+public:
+	ENGINE_PLATFORM_API MappedFile() = default;
+	ENGINE_PLATFORM_API virtual ~MappedFile();
+
+	// 禁止拷贝
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// 映射整个文件
+	ENGINE_PLATFORM_API bool Open(const std::string& path);
+	// 解除映射
+	ENGINE_PLATFORM_API void Close();
+
+	ENGINE_PLATFORM_API bool IsOpen() const { return m_Data != nullptr; }
+	ENGINE_PLATFORM_API const uint8_t* GetData() const { return m_Data; }
+	ENGINE_PLATFORM_API uint64_t GetSize() const { return m_Size; }
+	ENGINE_PLATFORM_API std::string GetLastError() const { return m_LastError; }
+
+private:
+	const uint8_t* m_Data = nullptr;
+	uint64_t m_Size = 0;
+	// 平台句柄（Windows为文件和映射句柄）
+	void* m_FileHandle = nullptr;
+	void* m_MappingHandle = nullptr;
+	std::string m_LastError;
+};
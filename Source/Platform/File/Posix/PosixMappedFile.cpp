@@ -0,0 +1,54 @@
+﻿#ifndef _WIN32
+
+#include "File/MappedFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+	Close();
+
+	int FileDescriptor = open(path.c_str(), O_RDONLY);
+	if (FileDescriptor < 0) {
+		m_LastError = "Open file '" + path + "' failed.";
+		return false;
+	}
+
+	struct stat FileStat;
+	if (fstat(FileDescriptor, &FileStat) != 0 || FileStat.st_size == 0) {
+		close(FileDescriptor);
+		m_LastError = "File '" + path + "' is empty.";
+		return false;
+	}
+
+	void* Data = mmap(nullptr, (size_t)FileStat.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+	// 映射建立后即可关闭文件描述符
+	close(FileDescriptor);
+	if (Data == MAP_FAILED) {
+		m_LastError = "Map file '" + path + "' failed.";
+		return false;
+	}
+
+	// 数据将被顺序读取
+	madvise(Data, (size_t)FileStat.st_size, MADV_SEQUENTIAL);
+
+	m_Data = (const uint8_t*)Data;
+	m_Size = (uint64_t)FileStat.st_size;
+	m_LastError.clear();
+	return true;
+}
+
+void MappedFile::Close() {
+	if (m_Data) {
+		munmap((void*)m_Data, (size_t)m_Size);
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+}
+
+#endif
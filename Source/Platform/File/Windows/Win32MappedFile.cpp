@@ -0,0 +1,66 @@
+﻿#ifdef _WIN32
+
+#include "File/MappedFile.h"
+#include <windows.h>
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+	Close();
+
+	HANDLE FileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (FileHandle == INVALID_HANDLE_VALUE) {
+		m_LastError = "Open file '" + path + "' failed.";
+		return false;
+	}
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(FileHandle, &FileSize) || FileSize.QuadPart == 0) {
+		CloseHandle(FileHandle);
+		m_LastError = "File '" + path + "' is empty.";
+		return false;
+	}
+
+	HANDLE MappingHandle = CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!MappingHandle) {
+		CloseHandle(FileHandle);
+		m_LastError = "Create file mapping for '" + path + "' failed.";
+		return false;
+	}
+
+	void* Data = MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (!Data) {
+		CloseHandle(MappingHandle);
+		CloseHandle(FileHandle);
+		m_LastError = "Map view of '" + path + "' failed.";
+		return false;
+	}
+
+	m_FileHandle = FileHandle;
+	m_MappingHandle = MappingHandle;
+	m_Data = (const uint8_t*)Data;
+	m_Size = (uint64_t)FileSize.QuadPart;
+	m_LastError.clear();
+	return true;
+}
+
+void MappedFile::Close() {
+	if (m_Data) {
+		UnmapViewOfFile(m_Data);
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+	if (m_MappingHandle) {
+		CloseHandle((HANDLE)m_MappingHandle);
+		m_MappingHandle = nullptr;
+	}
+	if (m_FileHandle) {
+		CloseHandle((HANDLE)m_FileHandle);
+		m_FileHandle = nullptr;
+	}
+}
+
+#endif
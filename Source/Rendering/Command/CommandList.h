@@ -2,6 +2,11 @@
 
 #include "RenderCommand.h"
 
+#include <algorithm>
+#include <cstring>
+
+class MeshLODSelector;
+
 class CommandList {
 public:
 	CommandList() = default;
@@ -33,10 +38,21 @@ public:
 		dc.resources.material = Material;
 		dc.modelMatrix = modelMatrix;
 		dc.GenerateSortKey();
-
 		Draw(dc);
 	}
 
+	// 写入逐绘制数据（目标通常是持久映射的瞬态内存）
+	static void WriteDrawData(GPUDrawData* Dst, const FMatrix4& ModelMatrix, const IMesh* Mesh, const IMaterial* Material) {
+		const FVector3& Scale = Mesh->GetPositionScale();
+		const FVector3& Bias = Mesh->GetPositionBias();
+		const FVector4 PositionScale(Scale.x(), Scale.y(), Scale.z(), (float)Mesh->GetVertexFormat());
+		const FVector4 PositionBias(Bias.x(), Bias.y(), Bias.z(), Material ? (float)Material->GetMaterialIndex() : 0.0f);
+
+		memcpy(Dst->ModelMatrix.data(), ModelMatrix.data(), sizeof(FMatrix4));
+		memcpy(Dst->PositionScale.data(), PositionScale.data(), sizeof(FVector4));
+		memcpy(Dst->PositionBias.data(), PositionBias.data(), sizeof(FVector4));
+	}
+
 	// 添加实例化绘制
 	void DrawInstanced(IMesh* Mesh, IMaterial* Material,
 		const std::vector<FMatrix4>& instanceMatrices) {
@@ -69,6 +85,23 @@ public:
 		Commands_.push_back(std::make_unique<ClearCommand>(Color, ClearColor, clearDepth, depth));
 	}
 
+	// 渲染通道，通常由帧图生成
+	void BeginRenderPass(const RenderPassDesc& Desc) {
+		if (!IsRecording_) return;
+		Commands_.push_back(std::make_unique<BeginRenderPassCommand>(Desc));
+	}
+
+	void EndRenderPass(uint32_t DiscardColorMask = 0, bool DiscardDepth = false) {
+		if (!IsRecording_) return;
+		Commands_.push_back(std::make_unique<EndRenderPassCommand>(DiscardColorMask, DiscardDepth));
+	}
+
+	// 将前面Pass写入的渲染目标绑定到纹理单元供采样
+	void BindTexture(uint32_t Slot, uint32_t Target) {
+		if (!IsRecording_) return;
+		Commands_.push_back(std::make_unique<BindTextureCommand>(Slot, Target));
+	}
+
 	// 开始记录
 	void Begin() {
 		Commands_.clear();
@@ -95,15 +128,33 @@ public:
 		if (IsSorted_) return;
 
 		// 按sortKey排序（Material > Pipeline > Mesh > Depth）
-		std::sort(DrawCalls_.begin(), DrawCalls_.end(),
-			[](const DrawCall& a, const DrawCall& b) {
-				return a.sortKey < b.sortKey;
-			});
+		// 只在连续的绘制命令之间排序，清除、视口等命令保持原有位置
+		auto IsDraw = [](const std::unique_ptr<RenderCommand>& Cmd) {
+			return Cmd->Type_ == CommandType::eDrawIndexed;
+		};
+		auto ByKey = [](const std::unique_ptr<RenderCommand>& a, const std::unique_ptr<RenderCommand>& b) {
+			return static_cast<const DrawIndexedCommand*>(a.get())->DrawCall_.sortKey <
+				static_cast<const DrawIndexedCommand*>(b.get())->DrawCall_.sortKey;
+		};
+
+		auto It = Commands_.begin();
+		while (It != Commands_.end()) {
+			if (!IsDraw(*It)) {
+				++It;
+				continue;
+			}
+
+			auto SegmentEnd = std::find_if_not(It, Commands_.end(), IsDraw);
+			std::stable_sort(It, SegmentEnd, ByKey);
+			It = SegmentEnd;
+		}
 
-		// 重建命令列表（仅包含DrawCommand）
-		Commands_.clear();
-		for (const auto& dc : DrawCalls_) {
-			Commands_.push_back(std::make_unique<DrawIndexedCommand>(dc));
+		// 同步DrawCall列表顺序
+		DrawCalls_.clear();
+		for (const auto& Cmd : Commands_) {
+			if (IsDraw(Cmd)) {
+				DrawCalls_.push_back(static_cast<const DrawIndexedCommand*>(Cmd.get())->DrawCall_);
+			}
 		}
 
 		IsSorted_ = true;
@@ -114,6 +165,10 @@ public:
 		ProjMatrix_ = Projection;
 	}
 
+	// 录制时选择网格LOD，未设置时总是绘制LOD0
+	void SetLODSelector(MeshLODSelector* Selector) { LODSelector_ = Selector; }
+	MeshLODSelector* GetLODSelector() const { return LODSelector_; }
+
 	void SetViewMatrix(const FMatrix4& View) { ViewMatrix_ = View; }
 	void SetProjMatrix(const FMatrix4& Proj) { ProjMatrix_ = Proj; }
 	const FMatrix4& GetViewMatrix() const { return ViewMatrix_; }
@@ -139,6 +194,8 @@ private:
 	FMatrix4 ViewMatrix_;
 	FMatrix4 ProjMatrix_;
 
+	MeshLODSelector* LODSelector_ = nullptr;
+
 	bool IsSorted_ = false;
 	bool IsRecording_ = true;
 
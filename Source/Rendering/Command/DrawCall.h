@@ -19,6 +19,13 @@ enum class CommandType : uint8_t {
 	eBindTexture,        // 绑定纹理
 };
 
+// 逐绘制数据，与Shader中DrawData(std430)布局一致
+struct GPUDrawData {
+	FMatrix4 ModelMatrix;
+	FVector4 PositionScale;   // xyz: 位置反量化缩放，w: 顶点格式
+	FVector4 PositionBias;    // xyz: 位置反量化偏移，w: 材质表索引
+};
+
 struct DrawCall {
 	// 绘制参数
 	uint32_t vertexCount = 0;
@@ -3,6 +3,7 @@
 #include "DrawCall.h"
 #include "Resource/IMesh.h"
 #include "Resource/IMaterial.h"
+#include "Graphics/RenderTarget.h"
 
 class RenderCommand {
 public:
@@ -48,4 +49,34 @@ public:
 	ClearCommand(const FVector4& c, bool ccolor = true, bool depth = true, float dv = 1.0f)
 		: RenderCommand(CommandType::eClear),
 		Color_(c), ClearColor_(ccolor), ClearDepth_(depth), DepthValue_(dv) {}
+};
+
+// 开始渲染通道：绑定渲染目标，设置视口并按需清除
+class BeginRenderPassCommand : public RenderCommand {
+public:
+	RenderPassDesc Desc_;
+
+	BeginRenderPassCommand(const RenderPassDesc& Desc)
+		: RenderCommand(CommandType::eBeginRenderPass), Desc_(Desc) {}
+};
+
+// 结束渲染通道，之后不再使用的附件内容可以丢弃
+class EndRenderPassCommand : public RenderCommand {
+public:
+	uint32_t DiscardColorMask_;   // 第i位对应第i个颜色目标
+	bool DiscardDepth_;
+
+	EndRenderPassCommand(uint32_t DiscardColorMask = 0, bool DiscardDepth = false)
+		: RenderCommand(CommandType::eEndRenderPass),
+		DiscardColorMask_(DiscardColorMask), DiscardDepth_(DiscardDepth) {}
+};
+
+// 绑定渲染目标到纹理单元
+class BindTextureCommand : public RenderCommand {
+public:
+	uint32_t Slot_;
+	uint32_t Target_;
+
+	BindTextureCommand(uint32_t Slot, uint32_t Target)
+		: RenderCommand(CommandType::eBindTexture), Slot_(Slot), Target_(Target) {}
 };
\ No newline at end of file
@@ -0,0 +1,229 @@
+﻿#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CULLING_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULLING_SIMD_WIDTH 4
+#else
+#define CULLING_SIMD_WIDTH 1
+#endif
+
+// 无效包围盒的半尺寸，足够大使其总是可见，又不会在乘0时产生NaN
+static const float UNBOUNDED_EXTENT = 1e30f;
+
+FrustumCuller::FrustumCuller() {
+	Count_ = 0;
+	Enabled_ = RENDER_FRUSTUM_CULLING != 0;
+	SIMDEnabled_ = true;
+}
+
+uint32_t FrustumCuller::GetSIMDWidth() {
+	return CULLING_SIMD_WIDTH;
+}
+
+void FrustumCuller::Reset() {
+	Count_ = 0;
+	CenterX_.clear();
+	CenterY_.clear();
+	CenterZ_.clear();
+	ExtentX_.clear();
+	ExtentY_.clear();
+	ExtentZ_.clear();
+	Radius_.clear();
+}
+
+void FrustumCuller::Reserve(uint32_t Count) {
+	const size_t Capacity = (size_t)Count + CULLING_SIMD_WIDTH;
+	CenterX_.reserve(Capacity);
+	CenterY_.reserve(Capacity);
+	CenterZ_.reserve(Capacity);
+	ExtentX_.reserve(Capacity);
+	ExtentY_.reserve(Capacity);
+	ExtentZ_.reserve(Capacity);
+	Radius_.reserve(Capacity);
+	Visible_.reserve(Capacity);
+}
+
+uint32_t FrustumCuller::Add(const FBoundingBox& WorldBounds) {
+	FVector3 Center = FVector3::Zero();
+	FVector3 HalfExtent = FVector3::Constant(UNBOUNDED_EXTENT);
+	if (WorldBounds.IsValid()) {
+		Center = WorldBounds.GetCenter();
+		HalfExtent = WorldBounds.GetHalfExtent();
+	}
+
+	CenterX_.push_back(Center.x());
+	CenterY_.push_back(Center.y());
+	CenterZ_.push_back(Center.z());
+	ExtentX_.push_back(HalfExtent.x());
+	ExtentY_.push_back(HalfExtent.y());
+	ExtentZ_.push_back(HalfExtent.z());
+	Radius_.push_back(WorldBounds.IsValid() ? HalfExtent.norm() : UNBOUNDED_EXTENT);
+	return Count_++;
+}
+
+void FrustumCuller::Cull(const FFrustum& Frustum, FrustumTest Test, uint32_t HierarchyCulled) {
+	auto CullStart = std::chrono::high_resolution_clock::now();
+
+	// 补齐到SIMD宽度，整批加载不越界
+	const size_t Padded = ((size_t)Count_ + CULLING_SIMD_WIDTH - 1) / CULLING_SIMD_WIDTH * CULLING_SIMD_WIDTH;
+	CenterX_.resize(Padded, 0.0f);
+	CenterY_.resize(Padded, 0.0f);
+	CenterZ_.resize(Padded, 0.0f);
+	ExtentX_.resize(Padded, 0.0f);
+	ExtentY_.resize(Padded, 0.0f);
+	ExtentZ_.resize(Padded, 0.0f);
+	Radius_.resize(Padded, 0.0f);
+	Visible_.assign(Padded, 1);
+
+	if (Enabled_) {
+		const uint32_t Processed = SIMDEnabled_ ? CullSIMD(Frustum, Test) : 0;
+		CullScalar(Frustum, Test, Processed);
+	}
+
+	Stats_ = CullingStats();
+	Stats_.TotalObjects = Count_ + HierarchyCulled;
+	for (uint32_t i = 0; i < Count_; ++i) {
+		Stats_.VisibleObjects += Visible_[i];
+	}
+	Stats_.CulledObjects = Stats_.TotalObjects - Stats_.VisibleObjects;
+
+	auto CullEnd = std::chrono::high_resolution_clock::now();
+	Stats_.CullTimeMs = std::chrono::duration<double, std::milli>(CullEnd - CullStart).count();
+}
+
+void FrustumCuller::CullOccluded(OcclusionCuller& Occlusion) {
+	if (!Occlusion.HasOccluders()) {
+		return;
+	}
+
+	auto OcclusionStart = std::chrono::high_resolution_clock::now();
+
+	uint32_t Occluded = 0;
+	for (uint32_t i = 0; i < Count_; ++i) {
+		if (!Visible_[i] || ExtentX_[i] >= UNBOUNDED_EXTENT) {
+			continue;
+		}
+		const FVector3 Center(CenterX_[i], CenterY_[i], CenterZ_[i]);
+		const FVector3 HalfExtent(ExtentX_[i], ExtentY_[i], ExtentZ_[i]);
+		if (!Occlusion.TestVisible(FBoundingBox::FromCenterExtent(Center, HalfExtent))) {
+			Visible_[i] = 0;
+			Occluded++;
+		}
+	}
+	Stats_.OccludedObjects += Occluded;
+	Stats_.VisibleObjects -= Occluded;
+
+	auto OcclusionEnd = std::chrono::high_resolution_clock::now();
+	Stats_.OcclusionTimeMs += std::chrono::duration<double, std::milli>(OcclusionEnd - OcclusionStart).count();
+}
+
+void FrustumCuller::CullScalar(const FFrustum& Frustum, FrustumTest Test, uint32_t Begin) {
+	for (uint32_t i = Begin; i < Count_; ++i) {
+		bool Inside = true;
+		for (int p = 0; p < FFrustum::eCount && Inside; ++p) {
+			const FVector4& Plane = Frustum.Planes[p];
+			const float Distance = Plane.x() * CenterX_[i] + Plane.y() * CenterY_[i] + Plane.z() * CenterZ_[i] + Plane.w();
+			const float Radius = Test == FrustumTest::eSphere ? Radius_[i] :
+				std::fabs(Plane.x()) * ExtentX_[i] + std::fabs(Plane.y()) * ExtentY_[i] + std::fabs(Plane.z()) * ExtentZ_[i];
+			Inside = Distance >= -Radius;
+		}
+		Visible_[i] = Inside ? 1 : 0;
+	}
+}
+
+uint32_t FrustumCuller::CullSIMD(const FFrustum& Frustum, FrustumTest Test) {
+#if CULLING_SIMD_WIDTH == 8
+	__m256 PlaneX[FFrustum::eCount], PlaneY[FFrustum::eCount], PlaneZ[FFrustum::eCount], PlaneW[FFrustum::eCount];
+	__m256 AbsX[FFrustum::eCount], AbsY[FFrustum::eCount], AbsZ[FFrustum::eCount];
+	for (int p = 0; p < FFrustum::eCount; ++p) {
+		const FVector4& Plane = Frustum.Planes[p];
+		PlaneX[p] = _mm256_set1_ps(Plane.x());
+		PlaneY[p] = _mm256_set1_ps(Plane.y());
+		PlaneZ[p] = _mm256_set1_ps(Plane.z());
+		PlaneW[p] = _mm256_set1_ps(Plane.w());
+		AbsX[p] = _mm256_set1_ps(std::fabs(Plane.x()));
+		AbsY[p] = _mm256_set1_ps(std::fabs(Plane.y()));
+		AbsZ[p] = _mm256_set1_ps(std::fabs(Plane.z()));
+	}
+
+	const __m256 Zero = _mm256_setzero_ps();
+	for (uint32_t i = 0; i < Count_; i += 8) {
+		const __m256 CX = _mm256_loadu_ps(&CenterX_[i]);
+		const __m256 CY = _mm256_loadu_ps(&CenterY_[i]);
+		const __m256 CZ = _mm256_loadu_ps(&CenterZ_[i]);
+		const __m256 EX = _mm256_loadu_ps(&ExtentX_[i]);
+		const __m256 EY = _mm256_loadu_ps(&ExtentY_[i]);
+		const __m256 EZ = _mm256_loadu_ps(&ExtentZ_[i]);
+		const __m256 SR = _mm256_loadu_ps(&Radius_[i]);
+
+		__m256 Inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int p = 0; p < FFrustum::eCount; ++p) {
+			__m256 Distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(CX, PlaneX[p]), _mm256_mul_ps(CY, PlaneY[p])),
+				_mm256_add_ps(_mm256_mul_ps(CZ, PlaneZ[p]), PlaneW[p]));
+			__m256 Radius = Test == FrustumTest::eSphere ? SR :
+				_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(EX, AbsX[p]), _mm256_mul_ps(EY, AbsY[p])), _mm256_mul_ps(EZ, AbsZ[p]));
+			// Distance + Radius >= 0
+			Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(_mm256_add_ps(Distance, Radius), Zero, _CMP_GE_OQ));
+		}
+
+		const int Mask = _mm256_movemask_ps(Inside);
+		for (int k = 0; k < 8; ++k) {
+			Visible_[i + k] = (uint8_t)((Mask >> k) & 1);
+		}
+	}
+	return Count_;
+#elif CULLING_SIMD_WIDTH == 4
+	__m128 PlaneX[FFrustum::eCount], PlaneY[FFrustum::eCount], PlaneZ[FFrustum::eCount], PlaneW[FFrustum::eCount];
+	__m128 AbsX[FFrustum::eCount], AbsY[FFrustum::eCount], AbsZ[FFrustum::eCount];
+	for (int p = 0; p < FFrustum::eCount; ++p) {
+		const FVector4& Plane = Frustum.Planes[p];
+		PlaneX[p] = _mm_set1_ps(Plane.x());
+		PlaneY[p] = _mm_set1_ps(Plane.y());
+		PlaneZ[p] = _mm_set1_ps(Plane.z());
+		PlaneW[p] = _mm_set1_ps(Plane.w());
+		AbsX[p] = _mm_set1_ps(std::fabs(Plane.x()));
+		AbsY[p] = _mm_set1_ps(std::fabs(Plane.y()));
+		AbsZ[p] = _mm_set1_ps(std::fabs(Plane.z()));
+	}
+
+	const __m128 Zero = _mm_setzero_ps();
+	for (uint32_t i = 0; i < Count_; i += 4) {
+		const __m128 CX = _mm_loadu_ps(&CenterX_[i]);
+		const __m128 CY = _mm_loadu_ps(&CenterY_[i]);
+		const __m128 CZ = _mm_loadu_ps(&CenterZ_[i]);
+		const __m128 EX = _mm_loadu_ps(&ExtentX_[i]);
+		const __m128 EY = _mm_loadu_ps(&ExtentY_[i]);
+		const __m128 EZ = _mm_loadu_ps(&ExtentZ_[i]);
+		const __m128 SR = _mm_loadu_ps(&Radius_[i]);
+
+		__m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < FFrustum::eCount; ++p) {
+			__m128 Distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(CX, PlaneX[p]), _mm_mul_ps(CY, PlaneY[p])),
+				_mm_add_ps(_mm_mul_ps(CZ, PlaneZ[p]), PlaneW[p]));
+			__m128 Radius = Test == FrustumTest::eSphere ? SR :
+				_mm_add_ps(_mm_add_ps(_mm_mul_ps(EX, AbsX[p]), _mm_mul_ps(EY, AbsY[p])), _mm_mul_ps(EZ, AbsZ[p]));
+			// Distance + Radius >= 0
+			Inside = _mm_and_ps(Inside, _mm_cmpge_ps(_mm_add_ps(Distance, Radius), Zero));
+		}
+
+		const int Mask = _mm_movemask_ps(Inside);
+		Visible_[i + 0] = (uint8_t)(Mask & 1);
+		Visible_[i + 1] = (uint8_t)((Mask >> 1) & 1);
+		Visible_[i + 2] = (uint8_t)((Mask >> 2) & 1);
+		Visible_[i + 3] = (uint8_t)((Mask >> 3) & 1);
+	}
+	return Count_;
+#else
+	(void)Frustum;
+	(void)Test;
+	return 0;
+#endif
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Core/Bounds.h"
+#include "Graphics/RenderStats.h"
+#include <cstdint>
+#include <vector>
+
+class OcclusionCuller;
+
+enum class FrustumTest : uint8_t {
+	eSphere,   // 包围球，最快但更保守
+	eBox       // 世界空间AABB
+};
+
+/**
+ * 批量视锥剔除。
+ * 每帧按录制顺序Add世界空间包围盒，以SoA存放中心/半尺寸/半径，Cull时一次测试4个（SSE）或8个（AVX）。
+ * 无效包围盒（如尚未加载完成的Mesh）视为总是可见。
+ */
+class FrustumCuller {
+public:
+	ENGINE_RENDERING_API FrustumCuller();
+
+public:
+	ENGINE_RENDERING_API void Reset();
+	ENGINE_RENDERING_API void Reserve(uint32_t Count);
+	// 返回包围盒序号，Cull之后用它查询可见性
+	ENGINE_RENDERING_API uint32_t Add(const FBoundingBox& WorldBounds);
+	// HierarchyCulled: 已被场景层次结构剔除、未Add的对象数，只计入统计
+	ENGINE_RENDERING_API void Cull(const FFrustum& Frustum, FrustumTest Test = FrustumTest::eBox, uint32_t HierarchyCulled = 0);
+	// 在Cull和遮挡体光栅化之后调用，将视锥内被遮挡的包围盒标记为不可见
+	ENGINE_RENDERING_API void CullOccluded(OcclusionCuller& Occlusion);
+
+	bool IsVisible(uint32_t Index) const { return Visible_[Index] != 0; }
+	uint32_t GetCount() const { return Count_; }
+	const CullingStats& GetStats() const { return Stats_; }
+
+	// 关闭后Cull将全部标记为可见，便于对比
+	void SetEnabled(bool Enable) { Enabled_ = Enable; }
+	bool IsEnabled() const { return Enabled_; }
+	// 关闭后使用逐个标量测试
+	void SetSIMDEnabled(bool Enable) { SIMDEnabled_ = Enable; }
+	ENGINE_RENDERING_API static uint32_t GetSIMDWidth();
+
+private:
+	void CullScalar(const FFrustum& Frustum, FrustumTest Test, uint32_t Begin);
+	uint32_t CullSIMD(const FFrustum& Frustum, FrustumTest Test);
+
+private:
+	uint32_t Count_;
+	bool Enabled_;
+	bool SIMDEnabled_;
+
+	// 按SIMD宽度补齐，补齐部分的结果被忽略
+	std::vector<float> CenterX_;
+	std::vector<float> CenterY_;
+	std::vector<float> CenterZ_;
+	std::vector<float> ExtentX_;
+	std::vector<float> ExtentY_;
+	std::vector<float> ExtentZ_;
+	std::vector<float> Radius_;
+	std::vector<uint8_t> Visible_;
+
+	CullingStats Stats_;
+};
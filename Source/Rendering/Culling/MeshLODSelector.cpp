@@ -0,0 +1,69 @@
+﻿#include "MeshLODSelector.h"
+#include "Resource/IMesh.h"
+
+#include <algorithm>
+
+MeshLODSelector::MeshLODSelector() : Enabled_(RENDER_MESH_LOD != 0), Hysteresis_(RENDER_MESH_LOD_HYSTERESIS), ScreenSizeScale_(1.0f) {}
+
+void MeshLODSelector::BeginFrame() {
+	Stats_ = MeshLODStats();
+}
+
+float MeshLODSelector::ComputeScreenSize(const FBoundingBox& WorldBounds, const FMatrix4& View, const FMatrix4& Projection) {
+	const float Radius = WorldBounds.GetRadius();
+	const FVector3 Center = WorldBounds.GetCenter();
+
+	// 正交投影与距离无关
+	if (Projection(3, 3) != 0.0f) {
+		return Radius * Projection(1, 1);
+	}
+
+	const FVector3 ViewCenter = (View * FVector4(Center.x(), Center.y(), Center.z(), 1.0f)).head<3>();
+	const float Distance = ViewCenter.norm();
+	if (Distance <= Radius) {
+		return FLT_MAX;
+	}
+	return Radius * Projection(1, 1) / Distance;
+}
+
+uint32_t MeshLODSelector::Select(const IMesh& Mesh, const FBoundingBox& WorldBounds,
+	const FMatrix4& View, const FMatrix4& Projection, uint32_t CurrentLOD) const {
+	const uint32_t LODCount = Mesh.GetLODCount();
+	if (!Enabled_ || LODCount <= 1 || !WorldBounds.IsValid()) {
+		return 0;
+	}
+
+	const float ScreenSize = ComputeScreenSize(WorldBounds, View, Projection) * ScreenSizeScale_;
+	CurrentLOD = std::min(CurrentLOD, LODCount - 1);
+
+	// 变粗时按放大的尺寸判断，变细时按缩小的尺寸判断，两者之间保持不变
+	const uint32_t Coarser = Mesh.SelectLOD(ScreenSize * (1.0f + Hysteresis_));
+	if (Coarser > CurrentLOD) {
+		return Coarser;
+	}
+	const uint32_t Finer = Mesh.SelectLOD(ScreenSize * (1.0f - Hysteresis_));
+	if (Finer < CurrentLOD) {
+		return Finer;
+	}
+	return CurrentLOD;
+}
+
+void MeshLODSelector::RecordDraw(const IMesh& Mesh, uint32_t LOD, bool Switched) {
+	uint64_t Triangles = 0;
+	for (const SubMeshDesc& SubMesh : Mesh.GetSubMeshes(LOD)) {
+		Triangles += SubMesh.IndexCount / 3;
+	}
+	uint64_t FullDetailTriangles = Triangles;
+	if (LOD > 0) {
+		FullDetailTriangles = 0;
+		for (const SubMeshDesc& SubMesh : Mesh.GetSubMeshes()) {
+			FullDetailTriangles += SubMesh.IndexCount / 3;
+		}
+	}
+
+	Stats_.DrawnMeshes++;
+	Stats_.MeshesPerLOD[std::min<uint32_t>(LOD, MESH_MAX_LOD_COUNT - 1)]++;
+	Stats_.LODSwitches += Switched;
+	Stats_.Triangles += Triangles;
+	Stats_.FullDetailTriangles += FullDetailTriangles;
+}
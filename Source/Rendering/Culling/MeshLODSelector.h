@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Core/Bounds.h"
+#include "Graphics/RenderStats.h"
+#include <cstdint>
+
+class IMesh;
+
+/**
+ * 录制时的网格LOD选择。
+ * 屏幕尺寸为世界包围盒外接球的直径占视口高度的比例，与导入时按像素误差计算的各级阈值比较；
+ * 调用方保存上一帧的选择，屏幕尺寸需越过阈值Hysteresis比例才切换，避免在阈值附近来回跳变。
+ */
+class MeshLODSelector {
+public:
+	ENGINE_RENDERING_API MeshLODSelector();
+
+public:
+	// 每帧录制前调用，重置统计
+	ENGINE_RENDERING_API void BeginFrame();
+	ENGINE_RENDERING_API uint32_t Select(const IMesh& Mesh, const FBoundingBox& WorldBounds,
+		const FMatrix4& View, const FMatrix4& Projection, uint32_t CurrentLOD) const;
+	ENGINE_RENDERING_API void RecordDraw(const IMesh& Mesh, uint32_t LOD, bool Switched);
+
+	ENGINE_RENDERING_API static float ComputeScreenSize(const FBoundingBox& WorldBounds, const FMatrix4& View, const FMatrix4& Projection);
+
+	// 关闭后总是使用LOD0，便于对比
+	void SetEnabled(bool Enable) { Enabled_ = Enable; }
+	bool IsEnabled() const { return Enabled_; }
+	void SetHysteresis(float Hysteresis) { Hysteresis_ = Hysteresis; }
+	float GetHysteresis() const { return Hysteresis_; }
+	// 屏幕尺寸的缩放，大于1偏向更精细的LOD
+	void SetScreenSizeScale(float Scale) { ScreenSizeScale_ = Scale; }
+	float GetScreenSizeScale() const { return ScreenSizeScale_; }
+
+	const MeshLODStats& GetStats() const { return Stats_; }
+
+private:
+	bool Enabled_;
+	float Hysteresis_;
+	float ScreenSizeScale_;
+	MeshLODStats Stats_;
+};
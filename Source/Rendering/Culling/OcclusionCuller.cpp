@@ -0,0 +1,373 @@
+﻿#include "OcclusionCuller.h"
+#include "Resource/IMesh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+
+// 测试时从覆盖矩形不超过该纹素数的层级开始
+static const int32_t HIERARCHY_START_TEXELS = 4;
+// w不大于该值的顶点视为在相机平面上或其后
+static const float MIN_CLIP_W = 1e-5f;
+
+OcclusionCuller::OcclusionCuller() {
+	Width_ = 0;
+	Height_ = 0;
+	Enabled_ = RENDER_OCCLUSION_CULLING != 0;
+	HierarchyValid_ = false;
+	TriangleBudget_ = RENDER_OCCLUSION_TRIANGLE_BUDGET;
+	ViewProj_ = FMatrix4::Identity();
+	Resize(RENDER_OCCLUSION_BUFFER_WIDTH, RENDER_OCCLUSION_BUFFER_HEIGHT);
+}
+
+void OcclusionCuller::Resize(uint32_t Width, uint32_t Height) {
+	Width_ = std::max(1u, Width);
+	Height_ = std::max(1u, Height);
+
+	// 每层取上一层2x2的最大值，直到1x1
+	Levels_.clear();
+	uint32_t LevelWidth = Width_;
+	uint32_t LevelHeight = Height_;
+	while (true) {
+		DepthLevel Level;
+		Level.Width = LevelWidth;
+		Level.Height = LevelHeight;
+		Level.Depth.assign((size_t)LevelWidth * LevelHeight, 1.0f);
+		Levels_.push_back(std::move(Level));
+		if (LevelWidth == 1 && LevelHeight == 1) {
+			break;
+		}
+		LevelWidth = std::max(1u, (LevelWidth + 1) / 2);
+		LevelHeight = std::max(1u, (LevelHeight + 1) / 2);
+	}
+	HierarchyValid_ = false;
+}
+
+void OcclusionCuller::BeginFrame(const FMatrix4& ViewProj) {
+	ViewProj_ = ViewProj;
+	Candidates_.clear();
+	HierarchyValid_ = false;
+	Stats_ = OcclusionStats();
+	if (Enabled_) {
+		std::fill(Levels_[0].Depth.begin(), Levels_[0].Depth.end(), 1.0f);
+	}
+}
+
+void OcclusionCuller::AddOccluder(const OccluderGeometry& Geometry, const FMatrix4& Model, const FBoundingBox& WorldBounds) {
+	if (!Enabled_ || !Geometry.IsValid()) {
+		return;
+	}
+
+	// 跨过近平面的遮挡体离相机最近，优先光栅化
+	float MinX, MinY, MaxX, MaxY, MinDepth;
+	float ScreenArea = FLT_MAX;
+	if (ProjectBounds(WorldBounds, MinX, MinY, MaxX, MaxY, MinDepth)) {
+		if (MaxX <= 0.0f || MaxY <= 0.0f || MinX >= Width_ || MinY >= Height_ || MinDepth > 1.0f) {
+			return;
+		}
+		ScreenArea = (std::min(MaxX, (float)Width_) - std::max(MinX, 0.0f)) * (std::min(MaxY, (float)Height_) - std::max(MinY, 0.0f));
+	}
+	Candidates_.push_back({ &Geometry, Model, ScreenArea });
+}
+
+void OcclusionCuller::RasterizeOccluders() {
+	if (!Enabled_) {
+		return;
+	}
+
+	auto RasterStart = std::chrono::high_resolution_clock::now();
+
+	std::sort(Candidates_.begin(), Candidates_.end(), [](const OccluderCandidate& A, const OccluderCandidate& B) {
+		return A.ScreenArea > B.ScreenArea;
+	});
+
+	uint32_t Triangles = 0;
+	for (const OccluderCandidate& Candidate : Candidates_) {
+		const uint32_t Count = Candidate.Geometry->GetTriangleCount();
+		if (Triangles + Count > TriangleBudget_) {
+			Stats_.SkippedOccluders++;
+			continue;
+		}
+		Triangles += Count;
+		RenderOccluder(*Candidate.Geometry, Candidate.Model);
+	}
+	Candidates_.clear();
+
+	if (Stats_.Occluders > 0) {
+		BuildHierarchy();
+	}
+
+	auto RasterEnd = std::chrono::high_resolution_clock::now();
+	Stats_.RasterTimeMs += std::chrono::duration<double, std::milli>(RasterEnd - RasterStart).count();
+}
+
+void OcclusionCuller::RenderOccluder(const OccluderGeometry& Geometry, const FMatrix4& Model) {
+	if (!Geometry.IsValid()) {
+		return;
+	}
+
+	const FMatrix4 ModelViewProj = ViewProj_ * Model;
+	ClipVertices_.resize(Geometry.Positions.size());
+	for (size_t i = 0; i < Geometry.Positions.size(); ++i) {
+		ClipVertices_[i] = ModelViewProj * Geometry.Positions[i].homogeneous();
+	}
+
+	const uint32_t VertexCount = (uint32_t)ClipVertices_.size();
+	const size_t IndexCount = Geometry.Indices.size() / 3 * 3;
+	for (size_t i = 0; i < IndexCount; i += 3) {
+		const uint32_t I0 = Geometry.Indices[i];
+		const uint32_t I1 = Geometry.Indices[i + 1];
+		const uint32_t I2 = Geometry.Indices[i + 2];
+		if (I0 >= VertexCount || I1 >= VertexCount || I2 >= VertexCount) {
+			continue;
+		}
+		RasterizeTriangle(ClipVertices_[I0], ClipVertices_[I1], ClipVertices_[I2]);
+	}
+	Stats_.Occluders++;
+}
+
+void OcclusionCuller::RasterizeTriangle(const FVector4& A, const FVector4& B, const FVector4& C) {
+	// 三个顶点都在同一裁剪平面外侧时直接丢弃
+	if ((A.x() > A.w() && B.x() > B.w() && C.x() > C.w()) || (A.x() < -A.w() && B.x() < -B.w() && C.x() < -C.w()) ||
+		(A.y() > A.w() && B.y() > B.w() && C.y() > C.w()) || (A.y() < -A.w() && B.y() < -B.w() && C.y() < -C.w()) ||
+		(A.z() > A.w() && B.z() > B.w() && C.z() > C.w())) {
+		return;
+	}
+
+	// 对近平面(z + w >= 0)裁剪，得到至多4个顶点的凸多边形
+	const FVector4 Input[3] = { A, B, C };
+	FVector4 Polygon[4];
+	uint32_t Count = 0;
+	for (uint32_t i = 0; i < 3; ++i) {
+		const FVector4& Current = Input[i];
+		const FVector4& Next = Input[(i + 1) % 3];
+		const float CurrentDistance = Current.z() + Current.w();
+		const float NextDistance = Next.z() + Next.w();
+		if (CurrentDistance >= 0.0f) {
+			Polygon[Count++] = Current;
+		}
+		if ((CurrentDistance >= 0.0f) != (NextDistance >= 0.0f)) {
+			const float T = CurrentDistance / (CurrentDistance - NextDistance);
+			Polygon[Count++] = Current + (Next - Current) * T;
+		}
+	}
+	if (Count < 3) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < Count; ++i) {
+		if (Polygon[i].w() <= MIN_CLIP_W) {
+			return;
+		}
+	}
+
+	const ScreenVertex V0 = ToScreen(Polygon[0]);
+	for (uint32_t i = 1; i + 1 < Count; ++i) {
+		RasterizeScreenTriangle(V0, ToScreen(Polygon[i]), ToScreen(Polygon[i + 1]));
+	}
+}
+
+OcclusionCuller::ScreenVertex OcclusionCuller::ToScreen(const FVector4& Clip) const {
+	const float InvW = 1.0f / Clip.w();
+	return {
+		(Clip.x() * InvW * 0.5f + 0.5f) * Width_,
+		(Clip.y() * InvW * 0.5f + 0.5f) * Height_,
+		Clip.z() * InvW * 0.5f + 0.5f
+	};
+}
+
+void OcclusionCuller::RasterizeScreenTriangle(ScreenVertex V0, ScreenVertex V1, ScreenVertex V2) {
+	float Area = (V1.X - V0.X) * (V2.Y - V0.Y) - (V1.Y - V0.Y) * (V2.X - V0.X);
+	if (std::fabs(Area) < 1e-8f) {
+		return;
+	}
+	// 不做背面剔除，统一为逆时针
+	if (Area < 0.0f) {
+		std::swap(V1, V2);
+		Area = -Area;
+	}
+
+	// 覆盖像素中心的范围
+	const int32_t MinX = std::max(0, (int32_t)std::ceil(std::min({ V0.X, V1.X, V2.X }) - 0.5f));
+	const int32_t MaxX = std::min((int32_t)Width_ - 1, (int32_t)std::floor(std::max({ V0.X, V1.X, V2.X }) - 0.5f));
+	const int32_t MinY = std::max(0, (int32_t)std::ceil(std::min({ V0.Y, V1.Y, V2.Y }) - 0.5f));
+	const int32_t MaxY = std::min((int32_t)Height_ - 1, (int32_t)std::floor(std::max({ V0.Y, V1.Y, V2.Y }) - 0.5f));
+	if (MinX > MaxX || MinY > MaxY) {
+		return;
+	}
+	Stats_.OccluderTriangles++;
+
+	// 边函数E(P) = (Vb - Va) x (P - Va)，三个都非负时在三角形内；深度按重心坐标线性插值
+	const float StepX0 = V1.Y - V2.Y, StepY0 = V2.X - V1.X;
+	const float StepX1 = V2.Y - V0.Y, StepY1 = V0.X - V2.X;
+	const float StepX2 = V0.Y - V1.Y, StepY2 = V1.X - V0.X;
+	const float InvArea = 1.0f / Area;
+	const float DepthStepX = (StepX0 * V0.Depth + StepX1 * V1.Depth + StepX2 * V2.Depth) * InvArea;
+	const float DepthStepY = (StepY0 * V0.Depth + StepY1 * V1.Depth + StepY2 * V2.Depth) * InvArea;
+
+	const float StartX = MinX + 0.5f;
+	const float StartY = MinY + 0.5f;
+	float Row0 = StepY0 * (StartY - V1.Y) + StepX0 * (StartX - V1.X);
+	float Row1 = StepY1 * (StartY - V2.Y) + StepX1 * (StartX - V2.X);
+	float Row2 = StepY2 * (StartY - V0.Y) + StepX2 * (StartX - V0.X);
+	float RowDepth = (Row0 * V0.Depth + Row1 * V1.Depth + Row2 * V2.Depth) * InvArea;
+
+	std::vector<float>& Depth = Levels_[0].Depth;
+	for (int32_t y = MinY; y <= MaxY; ++y) {
+		float E0 = Row0, E1 = Row1, E2 = Row2, D = RowDepth;
+		float* Line = Depth.data() + (size_t)y * Width_;
+		for (int32_t x = MinX; x <= MaxX; ++x) {
+			if (E0 >= 0.0f && E1 >= 0.0f && E2 >= 0.0f && D < Line[x]) {
+				Line[x] = D;
+			}
+			E0 += StepX0;
+			E1 += StepX1;
+			E2 += StepX2;
+			D += DepthStepX;
+		}
+		Row0 += StepY0;
+		Row1 += StepY1;
+		Row2 += StepY2;
+		RowDepth += DepthStepY;
+	}
+}
+
+void OcclusionCuller::BuildHierarchy() {
+	for (size_t l = 1; l < Levels_.size(); ++l) {
+		const DepthLevel& Src = Levels_[l - 1];
+		DepthLevel& Dst = Levels_[l];
+		for (uint32_t y = 0; y < Dst.Height; ++y) {
+			const uint32_t SrcY0 = y * 2;
+			const uint32_t SrcY1 = std::min(SrcY0 + 1, Src.Height - 1);
+			for (uint32_t x = 0; x < Dst.Width; ++x) {
+				const uint32_t SrcX0 = x * 2;
+				const uint32_t SrcX1 = std::min(SrcX0 + 1, Src.Width - 1);
+				const float Max0 = std::max(Src.Depth[SrcY0 * Src.Width + SrcX0], Src.Depth[SrcY0 * Src.Width + SrcX1]);
+				const float Max1 = std::max(Src.Depth[SrcY1 * Src.Width + SrcX0], Src.Depth[SrcY1 * Src.Width + SrcX1]);
+				Dst.Depth[y * Dst.Width + x] = std::max(Max0, Max1);
+			}
+		}
+	}
+	HierarchyValid_ = true;
+}
+
+bool OcclusionCuller::ProjectBounds(const FBoundingBox& WorldBounds, float& MinX, float& MinY, float& MaxX, float& MaxY, float& MinDepth) const {
+	MinX = MinY = MinDepth = FLT_MAX;
+	MaxX = MaxY = -FLT_MAX;
+
+	// 角点的裁剪坐标 = Min角点 + 沿各轴的边长向量组合，只做一次矩阵乘
+	const FVector3 Size = WorldBounds.Max - WorldBounds.Min;
+	const FVector4 Origin = ViewProj_ * WorldBounds.Min.homogeneous();
+	const FVector4 AxisX = ViewProj_.col(0) * Size.x();
+	const FVector4 AxisY = ViewProj_.col(1) * Size.y();
+	const FVector4 AxisZ = ViewProj_.col(2) * Size.z();
+	for (uint32_t i = 0; i < 8; ++i) {
+		FVector4 Clip = Origin;
+		if (i & 1) Clip += AxisX;
+		if (i & 2) Clip += AxisY;
+		if (i & 4) Clip += AxisZ;
+		// 跨过相机平面的包围盒无法投影为矩形
+		if (Clip.w() <= MIN_CLIP_W) {
+			return false;
+		}
+		const ScreenVertex Screen = ToScreen(Clip);
+		MinX = std::min(MinX, Screen.X);
+		MaxX = std::max(MaxX, Screen.X);
+		MinY = std::min(MinY, Screen.Y);
+		MaxY = std::max(MaxY, Screen.Y);
+		MinDepth = std::min(MinDepth, Screen.Depth);
+	}
+	return true;
+}
+
+bool OcclusionCuller::TestVisible(const FBoundingBox& WorldBounds) {
+	if (!Enabled_ || !HierarchyValid_ || !WorldBounds.IsValid()) {
+		return true;
+	}
+
+	Stats_.TestedObjects++;
+
+	bool Visible = true;
+	float MinX, MinY, MaxX, MaxY, MinDepth;
+	if (ProjectBounds(WorldBounds, MinX, MinY, MaxX, MaxY, MinDepth) && MinDepth > 0.0f) {
+		// 与矩形有交集的所有像素
+		const int32_t X0 = std::max(0, (int32_t)std::floor(MinX));
+		const int32_t Y0 = std::max(0, (int32_t)std::floor(MinY));
+		const int32_t X1 = std::min((int32_t)Width_ - 1, (int32_t)std::ceil(MaxX) - 1);
+		const int32_t Y1 = std::min((int32_t)Height_ - 1, (int32_t)std::ceil(MaxY) - 1);
+		if (X0 <= X1 && Y0 <= Y1) {
+			uint32_t Level = 0;
+			while (Level + 1 < Levels_.size() &&
+				((X1 >> Level) - (X0 >> Level) >= HIERARCHY_START_TEXELS || (Y1 >> Level) - (Y0 >> Level) >= HIERARCHY_START_TEXELS)) {
+				Level++;
+			}
+
+			Visible = false;
+			for (int32_t y = Y0 >> Level; y <= (Y1 >> Level) && !Visible; ++y) {
+				for (int32_t x = X0 >> Level; x <= (X1 >> Level) && !Visible; ++x) {
+					Visible = !IsRegionOccluded(Level, x, y, X0, Y0, X1, Y1, MinDepth);
+				}
+			}
+		}
+	}
+
+	if (!Visible) {
+		Stats_.OccludedObjects++;
+	}
+	return Visible;
+}
+
+bool OcclusionCuller::IsRegionOccluded(uint32_t Level, uint32_t X, uint32_t Y, int32_t X0, int32_t Y0, int32_t X1, int32_t Y1, float Depth) const {
+	// 纹素内最远的遮挡体深度也比包围盒最近点近，则整块被遮挡
+	const DepthLevel& Current = Levels_[Level];
+	if (Current.Depth[Y * Current.Width + X] < Depth) {
+		return true;
+	}
+	if (Level == 0) {
+		return false;
+	}
+
+	// 只下降到与矩形重叠的子纹素
+	const uint32_t ChildLevel = Level - 1;
+	const DepthLevel& Child = Levels_[ChildLevel];
+	const uint32_t BeginX = std::max(X * 2, (uint32_t)(X0 >> ChildLevel));
+	const uint32_t EndX = std::min({ X * 2 + 1, (uint32_t)(X1 >> ChildLevel), Child.Width - 1 });
+	const uint32_t BeginY = std::max(Y * 2, (uint32_t)(Y0 >> ChildLevel));
+	const uint32_t EndY = std::min({ Y * 2 + 1, (uint32_t)(Y1 >> ChildLevel), Child.Height - 1 });
+	for (uint32_t y = BeginY; y <= EndY; ++y) {
+		for (uint32_t x = BeginX; x <= EndX; ++x) {
+			if (!IsRegionOccluded(ChildLevel, x, y, X0, Y0, X1, Y1, Depth)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool OcclusionCuller::ExtractOccluder(IMesh& Mesh, OccluderGeometry& OutGeometry) {
+	OutGeometry = OccluderGeometry();
+	if (!Mesh.RetainCPUData()) {
+		return false;
+	}
+
+	std::vector<Vertex> Vertices;
+	if (Mesh.DecodeVertices(Vertices)) {
+		OutGeometry.Positions.reserve(Vertices.size());
+		for (const Vertex& V : Vertices) {
+			OutGeometry.Positions.push_back(V.position);
+		}
+		// 索引中还有各级LOD，只取LOD0的区间，简化后的网格可能超出原轮廓
+		const std::vector<uint32_t>& Indices = Mesh.GetIndices();
+		for (const SubMeshDesc& SubMesh : Mesh.GetSubMeshes()) {
+			if ((size_t)SubMesh.BaseIndex + SubMesh.IndexCount > Indices.size()) {
+				continue;
+			}
+			for (uint32_t i = 0; i < SubMesh.IndexCount; ++i) {
+				OutGeometry.Indices.push_back(Indices[SubMesh.BaseIndex + i]);
+			}
+		}
+	}
+	Mesh.ReleaseCPUData();
+	return OutGeometry.IsValid();
+}
@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Core/Bounds.h"
+#include "Graphics/RenderStats.h"
+#include <cstdint>
+#include <vector>
+
+class IMesh;
+
+// 遮挡体几何，局部空间的位置和三角形索引
+struct OccluderGeometry {
+	std::vector<FVector3> Positions;
+	std::vector<uint32_t> Indices;
+
+	bool IsValid() const { return !Positions.empty() && Indices.size() >= 3; }
+	uint32_t GetTriangleCount() const { return (uint32_t)(Indices.size() / 3); }
+};
+
+/**
+ * CPU遮挡剔除。
+ * 每帧把选中的遮挡体光栅化到低分辨率深度缓冲（像素中心采样，取最近深度），
+ * 再逐级取2x2最大值构建层次深度（Hi-Z）；测试时将包围盒投影为屏幕矩形和最近深度，
+ * 从覆盖矩形不超过若干纹素的层级开始，只在该层无法判定的纹素上向细层级下降。
+ * 与GPU查询相比没有帧延迟，代价是遮挡体需要CPU几何，且在轮廓处有半个像素的误差。
+ */
+class OcclusionCuller {
+public:
+	ENGINE_RENDERING_API OcclusionCuller();
+
+public:
+	ENGINE_RENDERING_API void Resize(uint32_t Width, uint32_t Height);
+
+	// 清空深度和遮挡体列表，ViewProj为OpenGL裁剪空间的观察投影矩阵
+	ENGINE_RENDERING_API void BeginFrame(const FMatrix4& ViewProj);
+	// 登记遮挡体候选，Geometry须在RasterizeOccluders之前保持有效
+	ENGINE_RENDERING_API void AddOccluder(const OccluderGeometry& Geometry, const FMatrix4& Model, const FBoundingBox& WorldBounds);
+	// 按屏幕占比从大到小光栅化候选，直到用完三角形预算，然后构建层次深度
+	ENGINE_RENDERING_API void RasterizeOccluders();
+	// 返回false表示包围盒被完全遮挡；关闭或本帧没有遮挡体时总是返回true
+	ENGINE_RENDERING_API bool TestVisible(const FBoundingBox& WorldBounds);
+	bool HasOccluders() const { return Enabled_ && HierarchyValid_; }
+
+	// 直接光栅化一个遮挡体，不受预算限制
+	ENGINE_RENDERING_API void RenderOccluder(const OccluderGeometry& Geometry, const FMatrix4& Model);
+	ENGINE_RENDERING_API void BuildHierarchy();
+
+	// 从Mesh的CPU副本（必要时从GPU读回）提取遮挡体几何
+	ENGINE_RENDERING_API static bool ExtractOccluder(IMesh& Mesh, OccluderGeometry& OutGeometry);
+
+	const OcclusionStats& GetStats() const { return Stats_; }
+	void SetEnabled(bool Enable) { Enabled_ = Enable; }
+	bool IsEnabled() const { return Enabled_; }
+	void SetTriangleBudget(uint32_t Budget) { TriangleBudget_ = Budget; }
+	uint32_t GetTriangleBudget() const { return TriangleBudget_; }
+
+	uint32_t GetWidth() const { return Width_; }
+	uint32_t GetHeight() const { return Height_; }
+	// 第0层为光栅化结果，[0, 1]，1为远平面，行0在屏幕底部
+	const std::vector<float>& GetDepth(uint32_t Level = 0) const { return Levels_[Level].Depth; }
+	uint32_t GetLevelCount() const { return (uint32_t)Levels_.size(); }
+
+private:
+	struct ScreenVertex {
+		float X, Y, Depth;
+	};
+
+	struct DepthLevel {
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<float> Depth;
+	};
+
+	struct OccluderCandidate {
+		const OccluderGeometry* Geometry;
+		FMatrix4 Model;
+		float ScreenArea;
+	};
+
+	void RasterizeTriangle(const FVector4& A, const FVector4& B, const FVector4& C);
+	void RasterizeScreenTriangle(ScreenVertex V0, ScreenVertex V1, ScreenVertex V2);
+	ScreenVertex ToScreen(const FVector4& Clip) const;
+	bool ProjectBounds(const FBoundingBox& WorldBounds, float& MinX, float& MinY, float& MaxX, float& MaxY, float& MinDepth) const;
+	bool IsRegionOccluded(uint32_t Level, uint32_t X, uint32_t Y, int32_t X0, int32_t Y0, int32_t X1, int32_t Y1, float Depth) const;
+
+private:
+	uint32_t Width_;
+	uint32_t Height_;
+	bool Enabled_;
+	bool HierarchyValid_;
+	uint32_t TriangleBudget_;
+
+	FMatrix4 ViewProj_;
+	std::vector<DepthLevel> Levels_;
+	std::vector<OccluderCandidate> Candidates_;
+	std::vector<FVector4> ClipVertices_;
+
+	OcclusionStats Stats_;
+};
@@ -0,0 +1,420 @@
+﻿#include "FrameGraph.h"
+#include "Command/CommandList.h"
+#include "Graphics/IGraphicsDevice.h"
+#include "Renderer/RenderThread.h"
+
+#include <Logger.hpp>
+#include <algorithm>
+#include <chrono>
+
+static const uint32_t INVALID_PASS = UINT32_MAX;
+
+FrameGraphResource FrameGraphBuilder::Create(const std::string& Name, const RenderTargetDesc& Desc) {
+	FrameGraph::ResourceEntry Entry;
+	Entry.Name = Name;
+	Entry.Desc = Desc;
+
+	const uint32_t Index = (uint32_t)Graph_.Resources_.size();
+	Graph_.Resources_.push_back(Entry);
+	Graph_.Resources_[Index].LatestNode = Graph_.CreateNode(Index, INVALID_PASS);
+	return FrameGraphResource{ Index };
+}
+
+FrameGraphResource FrameGraphBuilder::Read(FrameGraphResource Resource) {
+	if (!Resource.IsValid()) {
+		return Resource;
+	}
+
+	std::vector<uint32_t>& Reads = Graph_.Passes_[Pass_].Reads;
+	const uint32_t Node = Graph_.Resources_[Resource.Index].LatestNode;
+	if (std::find(Reads.begin(), Reads.end(), Node) == Reads.end()) {
+		Reads.push_back(Node);
+	}
+	return Resource;
+}
+
+FrameGraphResource FrameGraphBuilder::Write(FrameGraphResource Resource) {
+	if (!Resource.IsValid()) {
+		return Resource;
+	}
+
+	FrameGraph::ResourceEntry& Entry = Graph_.Resources_[Resource.Index];
+	const uint32_t Previous = Entry.LatestNode;
+	if (Graph_.Nodes_[Previous].Producer == Pass_) {
+		return Resource;
+	}
+
+	const uint32_t Node = Graph_.CreateNode(Resource.Index, Pass_);
+	Graph_.Resources_[Resource.Index].LatestNode = Node;
+	Graph_.Passes_[Pass_].Writes.push_back(Node);
+	Graph_.Passes_[Pass_].Previous.push_back(Previous);
+	return Resource;
+}
+
+void FrameGraphBuilder::SetClearColor(const FVector4& Color) {
+	Graph_.Passes_[Pass_].ClearColor = true;
+	Graph_.Passes_[Pass_].Color = Color;
+}
+
+void FrameGraphBuilder::SetClearDepth(float Depth) {
+	Graph_.Passes_[Pass_].ClearDepth = true;
+	Graph_.Passes_[Pass_].Depth = Depth;
+}
+
+void FrameGraphBuilder::SetSideEffect() {
+	Graph_.Passes_[Pass_].SideEffect = true;
+}
+
+FrameGraph::FrameGraph() {
+	Device_ = nullptr;
+	Frame_ = 0;
+	NextTarget_ = 1;
+	Aliasing_ = RENDER_FRAME_GRAPH_ALIASING != 0;
+	Compiled_ = false;
+}
+
+FrameGraph::~FrameGraph() {
+
+}
+
+void FrameGraph::Reset() {
+	Resources_.clear();
+	Nodes_.clear();
+	Passes_.clear();
+	Compiled_ = false;
+	Frame_++;
+}
+
+FrameGraphResource FrameGraph::Import(const std::string& Name, const RenderTargetDesc& Desc, uint32_t Target) {
+	ResourceEntry Entry;
+	Entry.Name = Name;
+	Entry.Desc = Desc;
+	Entry.Imported = true;
+	Entry.Target = Target;
+
+	const uint32_t Index = (uint32_t)Resources_.size();
+	Resources_.push_back(Entry);
+	Resources_[Index].LatestNode = CreateNode(Index, INVALID_PASS);
+	return FrameGraphResource{ Index };
+}
+
+void FrameGraph::AddPass(const std::string& Name, const std::function<void(FrameGraphBuilder&)>& Setup, ExecuteFunc Execute) {
+	const uint32_t Index = (uint32_t)Passes_.size();
+	Passes_.emplace_back();
+	Passes_[Index].Name = Name;
+	Passes_[Index].Execute = std::move(Execute);
+
+	FrameGraphBuilder Builder(*this, Index);
+	if (Setup) {
+		Setup(Builder);
+	}
+
+	// 未清除的附件要保留之前写入的内容，依赖写入前版本的生产者
+	PassEntry& Pass = Passes_[Index];
+	for (size_t i = 0; i < Pass.Writes.size(); ++i) {
+		const ResourceNode& Previous = Nodes_[Pass.Previous[i]];
+		const bool Cleared = Resources_[Previous.Resource].Desc.IsDepth() ? Pass.ClearDepth : Pass.ClearColor;
+		if (!Cleared && Previous.Producer != INVALID_PASS &&
+			std::find(Pass.Reads.begin(), Pass.Reads.end(), Pass.Previous[i]) == Pass.Reads.end()) {
+			Pass.Reads.push_back(Pass.Previous[i]);
+		}
+	}
+	Compiled_ = false;
+}
+
+void FrameGraph::MarkOutput(FrameGraphResource Resource) {
+	if (Resource.IsValid()) {
+		Resources_[Resource.Index].Output = true;
+	}
+}
+
+uint32_t FrameGraph::CreateNode(uint32_t Resource, uint32_t Producer) {
+	ResourceNode Node;
+	Node.Resource = Resource;
+	Node.Producer = Producer;
+	Nodes_.push_back(Node);
+	return (uint32_t)Nodes_.size() - 1;
+}
+
+void FrameGraph::Compile() {
+	auto Start = std::chrono::high_resolution_clock::now();
+	Stats_ = FrameGraphStats();
+	Stats_.Passes = (uint32_t)Passes_.size();
+
+	CullPasses();
+	AllocateTargets();
+	TrimPool();
+	Compiled_ = true;
+
+	auto End = std::chrono::high_resolution_clock::now();
+	Stats_.CompileTimeMs = std::chrono::duration<double, std::milli>(End - Start).count();
+}
+
+void FrameGraph::CullPasses() {
+	for (ResourceNode& Node : Nodes_) {
+		Node.RefCount = 0;
+	}
+	for (PassEntry& Pass : Passes_) {
+		Pass.RefCount = (uint32_t)Pass.Writes.size();
+		Pass.Culled = false;
+		for (uint32_t Node : Pass.Reads) {
+			Nodes_[Node].RefCount++;
+		}
+	}
+	// 导入资源和输出资源的最终版本在帧图之外被使用
+	for (const ResourceEntry& Entry : Resources_) {
+		if (Entry.Imported || Entry.Output) {
+			Nodes_[Entry.LatestNode].RefCount++;
+		}
+	}
+
+	std::vector<uint32_t> Unused;
+	for (uint32_t i = 0; i < (uint32_t)Nodes_.size(); ++i) {
+		if (Nodes_[i].RefCount == 0) {
+			Unused.push_back(i);
+		}
+	}
+
+	auto CullPass = [&](PassEntry& Pass) {
+		Pass.Culled = true;
+		Stats_.CulledPasses++;
+		for (uint32_t Node : Pass.Reads) {
+			if (--Nodes_[Node].RefCount == 0) {
+				Unused.push_back(Node);
+			}
+		}
+	};
+
+	// 不写入任何资源的Pass没有可见结果
+	for (PassEntry& Pass : Passes_) {
+		if (Pass.Writes.empty() && !Pass.SideEffect) {
+			CullPass(Pass);
+		}
+	}
+
+	// 反向传播：生产者的所有输出都未被使用时剔除，并释放它对输入的引用
+	while (!Unused.empty()) {
+		const uint32_t Producer = Nodes_[Unused.back()].Producer;
+		Unused.pop_back();
+		if (Producer == INVALID_PASS) {
+			continue;
+		}
+
+		PassEntry& Pass = Passes_[Producer];
+		if (Pass.SideEffect || Pass.Culled || Pass.RefCount == 0) {
+			continue;
+		}
+		if (--Pass.RefCount == 0) {
+			CullPass(Pass);
+		}
+	}
+}
+
+void FrameGraph::AllocateTargets() {
+	for (ResourceEntry& Entry : Resources_) {
+		Entry.FirstPass = INVALID_PASS;
+		Entry.LastPass = 0;
+	}
+	for (PooledTarget& Pooled : Pool_) {
+		Pooled.InUse = false;
+	}
+
+	// 生命周期：第一个到最后一个使用该资源的存活Pass
+	for (uint32_t i = 0; i < (uint32_t)Passes_.size(); ++i) {
+		const PassEntry& Pass = Passes_[i];
+		if (Pass.Culled) {
+			continue;
+		}
+		for (const std::vector<uint32_t>* Nodes : { &Pass.Reads, &Pass.Writes }) {
+			for (uint32_t Node : *Nodes) {
+				ResourceEntry& Entry = Resources_[Nodes_[Node].Resource];
+				Entry.FirstPass = std::min(Entry.FirstPass, i);
+				Entry.LastPass = std::max(Entry.LastPass, i);
+			}
+		}
+	}
+
+	std::vector<std::vector<uint32_t>> Acquires(Passes_.size());
+	std::vector<std::vector<uint32_t>> Releases(Passes_.size());
+	for (uint32_t i = 0; i < (uint32_t)Resources_.size(); ++i) {
+		const ResourceEntry& Entry = Resources_[i];
+		if (Entry.Imported || Entry.FirstPass == INVALID_PASS) {
+			continue;
+		}
+		Acquires[Entry.FirstPass].push_back(i);
+		if (!Entry.Output) {
+			Releases[Entry.LastPass].push_back(i);
+		}
+	}
+
+	// 按执行顺序分配，最后一次使用后归还到池中供后续Pass复用
+	for (uint32_t i = 0; i < (uint32_t)Passes_.size(); ++i) {
+		for (uint32_t Index : Acquires[i]) {
+			ResourceEntry& Entry = Resources_[Index];
+			Entry.Target = AcquireTarget(Entry.Desc);
+			Stats_.TransientTargets++;
+			Stats_.TransientBytes += Entry.Desc.GetSize();
+		}
+		if (Aliasing_) {
+			for (uint32_t Index : Releases[i]) {
+				ReleaseTarget(Resources_[Index].Target);
+			}
+		}
+	}
+}
+
+uint32_t FrameGraph::AcquireTarget(const RenderTargetDesc& Desc) {
+	for (PooledTarget& Pooled : Pool_) {
+		if (Pooled.InUse || Pooled.Desc != Desc) {
+			continue;
+		}
+
+		Pooled.InUse = true;
+		if (Pooled.LastUsedFrame != Frame_) {
+			Pooled.LastUsedFrame = Frame_;
+			Stats_.PhysicalTargets++;
+			Stats_.AllocatedBytes += Desc.GetSize();
+		}
+		return Pooled.Target;
+	}
+
+	PooledTarget Pooled;
+	Pooled.Desc = Desc;
+	if (Device_) {
+		// 只在池扩大时同步等待渲染线程
+		RenderThread::Instance().ExecuteAndWait([&]() { Pooled.Target = Device_->CreateRenderTarget(Desc); });
+	}
+	else {
+		Pooled.Target = NextTarget_++;
+	}
+	Pooled.LastUsedFrame = Frame_;
+	Pooled.InUse = true;
+	Pool_.push_back(Pooled);
+
+	Stats_.CreatedTargets++;
+	Stats_.PhysicalTargets++;
+	Stats_.AllocatedBytes += Desc.GetSize();
+	return Pooled.Target;
+}
+
+void FrameGraph::ReleaseTarget(uint32_t Target) {
+	for (PooledTarget& Pooled : Pool_) {
+		if (Pooled.Target == Target) {
+			Pooled.InUse = false;
+			return;
+		}
+	}
+}
+
+void FrameGraph::TrimPool() {
+	for (auto It = Pool_.begin(); It != Pool_.end();) {
+		if (Frame_ - It->LastUsedFrame > RENDER_FRAME_GRAPH_IDLE_FRAMES) {
+			if (Device_) {
+				// 排在引用它的帧之后销毁
+				IGraphicsDevice* Device = Device_;
+				const uint32_t Target = It->Target;
+				RenderThread::Instance().Enqueue([Device, Target]() { Device->DestroyRenderTarget(Target); });
+			}
+			It = Pool_.erase(It);
+		}
+		else {
+			++It;
+		}
+	}
+
+	for (const PooledTarget& Pooled : Pool_) {
+		Stats_.PooledTargets++;
+		Stats_.PooledBytes += Pooled.Desc.GetSize();
+	}
+
+	if (Stats_.CreatedTargets > 0) {
+		LOG_INFO << "Frame graph created " << Stats_.CreatedTargets << " render targets, pool: " << Stats_.PooledTargets
+			<< " targets, " << Stats_.PooledBytes / (1024.0 * 1024.0) << " MB (aliasing saved "
+			<< Stats_.GetAliasedBytes() / (1024.0 * 1024.0) << " MB this frame).";
+	}
+}
+
+void FrameGraph::Execute(CommandList& CmdList) {
+	if (!Compiled_) {
+		Compile();
+	}
+
+	for (uint32_t i = 0; i < (uint32_t)Passes_.size(); ++i) {
+		const PassEntry& Pass = Passes_[i];
+		if (Pass.Culled) {
+			continue;
+		}
+
+		// 之后不再使用的瞬态附件可以丢弃
+		RenderPassDesc Desc;
+		uint32_t DiscardColorMask = 0;
+		bool DiscardDepth = false;
+		for (uint32_t Node : Pass.Writes) {
+			const ResourceEntry& Entry = Resources_[Nodes_[Node].Resource];
+			const bool Discard = !Entry.Imported && !Entry.Output && Entry.LastPass == i;
+			if (Entry.Desc.IsDepth()) {
+				Desc.DepthTarget = Entry.Target;
+				Desc.HasDepth = true;
+				DiscardDepth = Discard;
+			}
+			else if (Desc.ColorCount < RENDER_PASS_MAX_COLOR_TARGETS) {
+				if (Discard) {
+					DiscardColorMask |= 1u << Desc.ColorCount;
+				}
+				Desc.ColorTargets[Desc.ColorCount++] = Entry.Target;
+			}
+			else {
+				LOG_WARN << "Frame graph pass '" << Pass.Name << "' writes more than " << RENDER_PASS_MAX_COLOR_TARGETS << " color targets.";
+				continue;
+			}
+
+			if (Desc.Width == 0) {
+				Desc.Width = Entry.Desc.Width;
+				Desc.Height = Entry.Desc.Height;
+			}
+		}
+		Desc.ClearColor = Pass.ClearColor;
+		Desc.Color = Pass.Color;
+		Desc.ClearDepth = Pass.ClearDepth;
+		Desc.Depth = Pass.Depth;
+
+		const bool HasAttachments = Desc.ColorCount > 0 || Desc.HasDepth;
+		if (HasAttachments) {
+			CmdList.BeginRenderPass(Desc);
+		}
+		if (Pass.Execute) {
+			Pass.Execute(CmdList, *this);
+		}
+		if (HasAttachments) {
+			CmdList.EndRenderPass(DiscardColorMask, DiscardDepth);
+		}
+	}
+}
+
+void FrameGraph::Destroy() {
+	if (Device_) {
+		IGraphicsDevice* Device = Device_;
+		for (const PooledTarget& Pooled : Pool_) {
+			const uint32_t Target = Pooled.Target;
+			RenderThread::Instance().Enqueue([Device, Target]() { Device->DestroyRenderTarget(Target); });
+		}
+	}
+	Pool_.clear();
+}
+
+uint32_t FrameGraph::GetRenderTarget(FrameGraphResource Resource) const {
+	return Resource.IsValid() ? Resources_[Resource.Index].Target : BACKBUFFER_RENDER_TARGET;
+}
+
+const RenderTargetDesc& FrameGraph::GetDesc(FrameGraphResource Resource) const {
+	return Resources_[Resource.Index].Desc;
+}
+
+bool FrameGraph::IsPassCulled(const std::string& Name) const {
+	for (const PassEntry& Pass : Passes_) {
+		if (Pass.Name == Name) {
+			return Pass.Culled;
+		}
+	}
+	return false;
+}
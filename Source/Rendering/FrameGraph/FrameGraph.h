@@ -0,0 +1,149 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Graphics/RenderTarget.h"
+#include "Graphics/RenderStats.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class CommandList;
+class IGraphicsDevice;
+class FrameGraph;
+
+// 帧图中的虚拟资源句柄，只在当前帧有效
+struct FrameGraphResource {
+	uint32_t Index = UINT32_MAX;
+
+	bool IsValid() const { return Index != UINT32_MAX; }
+};
+
+// Pass声明阶段使用，记录Pass读写的资源
+class FrameGraphBuilder {
+public:
+	FrameGraphBuilder(FrameGraph& Graph, uint32_t Pass) : Graph_(Graph), Pass_(Pass) {}
+
+	// 创建瞬态渲染目标，物理目标在编译时从池中分配
+	ENGINE_RENDERING_API FrameGraphResource Create(const std::string& Name, const RenderTargetDesc& Desc);
+	// 作为纹理采样
+	ENGINE_RENDERING_API FrameGraphResource Read(FrameGraphResource Resource);
+	// 作为渲染目标写入，深度格式绑定为深度附件
+	ENGINE_RENDERING_API FrameGraphResource Write(FrameGraphResource Resource);
+
+	// 开始时清除写入的附件，未清除的附件保留之前Pass写入的内容
+	ENGINE_RENDERING_API void SetClearColor(const FVector4& Color);
+	ENGINE_RENDERING_API void SetClearDepth(float Depth);
+	// 有副作用的Pass（如回读）即使输出未被使用也不剔除
+	ENGINE_RENDERING_API void SetSideEffect();
+
+private:
+	FrameGraph& Graph_;
+	uint32_t Pass_;
+};
+
+/**
+ * 帧图：每帧重新声明所有Pass及其读写的渲染目标，编译后生成命令。
+ * 1. 编译时从导入资源（后台缓冲）和标记为输出的资源反向引用计数，剔除输出未被使用的Pass；
+ * 2. 按存活Pass的顺序计算瞬态目标的生命周期，生命周期不重叠且描述相同的目标复用同一个物理目标；
+ * 3. 执行时为每个Pass生成BeginRenderPass/EndRenderPass，最后一次使用的瞬态附件标记为可丢弃。
+ * 物理目标保存在池中跨帧复用，连续RENDER_FRAME_GRAPH_IDLE_FRAMES帧未使用才释放。
+ * 每次写入都会产生资源的新版本，Pass按声明顺序执行，因此声明顺序即为依赖顺序。
+ */
+class FrameGraph {
+public:
+	using ExecuteFunc = std::function<void(CommandList&, const FrameGraph&)>;
+
+	ENGINE_RENDERING_API FrameGraph();
+	ENGINE_RENDERING_API ~FrameGraph();
+
+public:
+	// 未设置设备时只分配句柄，便于离线统计
+	void SetDevice(IGraphicsDevice* Device) { Device_ = Device; }
+
+	// 每帧声明Pass前调用
+	ENGINE_RENDERING_API void Reset();
+	ENGINE_RENDERING_API FrameGraphResource Import(const std::string& Name, const RenderTargetDesc& Desc, uint32_t Target);
+	ENGINE_RENDERING_API void AddPass(const std::string& Name, const std::function<void(FrameGraphBuilder&)>& Setup, ExecuteFunc Execute);
+	// 整帧都不被复用的瞬态资源（如调试查看、回读），其生产者不会被剔除
+	ENGINE_RENDERING_API void MarkOutput(FrameGraphResource Resource);
+
+	ENGINE_RENDERING_API void Compile();
+	ENGINE_RENDERING_API void Execute(CommandList& CmdList);
+	// 释放池中的所有物理目标
+	ENGINE_RENDERING_API void Destroy();
+
+	// 执行阶段查询资源对应的物理目标
+	ENGINE_RENDERING_API uint32_t GetRenderTarget(FrameGraphResource Resource) const;
+	ENGINE_RENDERING_API const RenderTargetDesc& GetDesc(FrameGraphResource Resource) const;
+	ENGINE_RENDERING_API bool IsPassCulled(const std::string& Name) const;
+
+	// 关闭后每个瞬态目标独占一个物理目标，便于对比
+	void SetAliasing(bool Enable) { Aliasing_ = Enable; }
+	bool IsAliasingEnabled() const { return Aliasing_; }
+
+	const FrameGraphStats& GetStats() const { return Stats_; }
+
+private:
+	friend class FrameGraphBuilder;
+
+	struct ResourceEntry {
+		std::string Name;
+		RenderTargetDesc Desc;
+		bool Imported = false;
+		bool Output = false;
+		uint32_t Target = BACKBUFFER_RENDER_TARGET;
+		uint32_t LatestNode = 0;
+		uint32_t FirstPass = UINT32_MAX;
+		uint32_t LastPass = 0;
+	};
+
+	// 资源的一个版本，每次写入产生新版本
+	struct ResourceNode {
+		uint32_t Resource = 0;
+		uint32_t Producer = UINT32_MAX;
+		uint32_t RefCount = 0;
+	};
+
+	struct PassEntry {
+		std::string Name;
+		std::vector<uint32_t> Reads;       // 读取的版本
+		std::vector<uint32_t> Writes;      // 写入产生的版本
+		std::vector<uint32_t> Previous;    // 写入前的版本，未清除时需保留其内容
+		ExecuteFunc Execute;
+		bool ClearColor = false;
+		bool ClearDepth = false;
+		FVector4 Color = FVector4(0.0f, 0.0f, 0.0f, 1.0f);
+		float Depth = 1.0f;
+		bool SideEffect = false;
+		bool Culled = false;
+		uint32_t RefCount = 0;
+	};
+
+	struct PooledTarget {
+		RenderTargetDesc Desc;
+		uint32_t Target = 0;
+		uint64_t LastUsedFrame = 0;
+		bool InUse = false;
+	};
+
+	uint32_t CreateNode(uint32_t Resource, uint32_t Producer);
+	void CullPasses();
+	void AllocateTargets();
+	uint32_t AcquireTarget(const RenderTargetDesc& Desc);
+	void ReleaseTarget(uint32_t Target);
+	void TrimPool();
+
+private:
+	IGraphicsDevice* Device_;
+	std::vector<ResourceEntry> Resources_;
+	std::vector<ResourceNode> Nodes_;
+	std::vector<PassEntry> Passes_;
+	std::vector<PooledTarget> Pool_;
+	uint64_t Frame_;
+	uint32_t NextTarget_;  // 未设置设备时分配的句柄
+	bool Aliasing_;
+	bool Compiled_;
+	FrameGraphStats Stats_;
+};
@@ -8,18 +8,51 @@
 #include "Window/Window.h"
 #include "GLMesh.h"
 #include "GLMaterial.h"
+#include "GLMaterialBuffer.h"
+#include "GLMaterialTable.h"
+#include "GLMeshHeap.h"
 #include "GLShader.h"
+#include "GLShaderCompiler.h"
 #include "GLTexture.h"
+#include "GLTextureArrays.h"
+#include "GLTextureStreamer.h"
 #include "Command/CommandList.h"
+#include "Resource/Manager/ResourceManager.h"
+
+#include <algorithm>
+#include <chrono>
 
 static const double aspect_ratio = 16.0 / 9.0;
 static const int WIDTH = 1200;
 static const int HEIGHT = static_cast<int>(WIDTH / aspect_ratio);
 
+// 与Shader中layout(binding = X)保持一致
+static const GLuint FRAME_UBO_BINDING = 1;
+static const GLuint DRAW_DATA_SSBO_BINDING = 0;
+// 环形Buffer每帧区域大小
+static const uint64_t TRANSIENT_FRAME_SIZE = 8 * 1024 * 1024;
+
+// glMultiDrawElementsIndirect参数布局
+struct DrawElementsIndirectCommand {
+	uint32_t Count;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	int32_t BaseVertex;
+	uint32_t BaseInstance;
+};
+
 GLDevice::GLDevice() {
 	BackendAPI_ = BackendAPI::eUnknown;
 	Window_ = nullptr;
 	BuiltinShader_ = nullptr;
+	UniformAlignment_ = 256;
+	StorageAlignment_ = 256;
+	FallbackFrameUBO_ = 0;
+	FallbackDrawDataSSBO_ = 0;
+	MultiDrawIndirect_ = true;
+	BoundMaterial_ = nullptr;
+	BoundVAO_ = 0;
+	BoundFramebuffer_ = 0;
 }
 
 bool GLDevice::Initialize(Window* Win){
@@ -36,37 +69,75 @@ bool GLDevice::Initialize(Window* Win){
 		return false;
 	}
 
-	//初始化FBO
-	glGenFramebuffers(1, &FBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
-
-	// 初始化Texture
-	glGenTextures(1, &textureID);
-	glBindTexture(GL_TEXTURE_2D, textureID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, WIDTH, HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureID, 0);
-
-	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-		std::cerr << "Framebuffer is incomplete!" << std::endl;
-	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	// 异步Shader编译
+	GLShaderCompiler::Instance().Initialize();
 
 	glViewport(0, 0, WIDTH, HEIGHT);
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
 	glEnableVertexAttribArray(0);
 
+	// 共享材质常量Buffer
+	if (!GLMaterialBuffer::Instance().Initialize()) {
+		LOG_ERROR << "Init material buffer failed!";
+		return false;
+	}
+	// 材质纹理表，按逐绘制数据中的索引访问
+	if (!GLMaterialTable::Instance().Initialize()) {
+		LOG_ERROR << "Init material table failed!";
+		return false;
+	}
+
+	// 三缓冲的瞬态数据Buffer
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformAlignment_);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &StorageAlignment_);
+	if (!RingBuffer_.Initialize(TRANSIENT_FRAME_SIZE, 3)) {
+		LOG_ERROR << "Init transient ring buffer failed!";
+		return false;
+	}
+
+	glCreateBuffers(1, &FallbackFrameUBO_);
+	glNamedBufferData(FallbackFrameUBO_, sizeof(FMatrix4) * 2, nullptr, GL_DYNAMIC_DRAW);
+	glCreateBuffers(1, &FallbackDrawDataSSBO_);
+	glNamedBufferData(FallbackDrawDataSSBO_, sizeof(GPUDrawData), nullptr, GL_DYNAMIC_DRAW);
+
+	// 所有Mesh共享的顶点/索引Buffer
+	if (!GLMeshHeap::Instance().Initialize()) {
+		LOG_ERROR << "Init mesh heap failed!";
+		return false;
+	}
+
+	// 纹理Mip流式加载
+	GLTextureStreamer::Instance().Initialize();
+
 	LOG_INFO << "OpenGL device create successfully.";
 	return true;
 }
 
+void GLDevice::BeginFrame() {
+	RingBuffer_.BeginFrame();
+	GLShaderCompiler::Instance().Poll();
+	GLTextureStreamer::Instance().Update();
+}
+
 void GLDevice::ExecuteCommandList(const CommandList& CmdList) {
+	auto SubmitStart = std::chrono::high_resolution_clock::now();
+	FrameStats_ = RenderStats();
+	BoundMaterial_ = nullptr;
+	BoundVAO_ = 0;
+
+	BindFrameData(CmdList);
+	GLMaterialTable::Instance().Bind();
+	FrameStats_.BindlessTextures = GLMaterialTable::Instance().IsBindless();
+	FrameStats_.TextureArrays = GLTextureArrays::Instance().IsEnabled();
+	// 像素/世界单位的投影比例，用于估算纹理的屏幕尺寸
+	const float ProjScale = CmdList.GetProjMatrix()(1, 1) * HEIGHT * 0.5f;
+
 	for (const auto& Cmd : CmdList.GetCommands()) {
 		switch (Cmd->Type_)
 		{
 		case CommandType::eClear: {
+			FlushDrawBatch();
 			ClearCommand* ClearCmd = static_cast<ClearCommand*>(Cmd.get());
 
 			// 翻译成OpenGL调用
@@ -81,55 +152,326 @@ void GLDevice::ExecuteCommandList(const CommandList& CmdList) {
 			glClear(ClearType);
 			break;
 		}
+		case CommandType::eBeginRenderPass: {
+			FlushDrawBatch();
+			BeginRenderPass(static_cast<BeginRenderPassCommand*>(Cmd.get())->Desc_);
+			break;
+		}
+		case CommandType::eEndRenderPass: {
+			FlushDrawBatch();
+			const EndRenderPassCommand* EndCmd = static_cast<EndRenderPassCommand*>(Cmd.get());
+			EndRenderPass(EndCmd->DiscardColorMask_, EndCmd->DiscardDepth_);
+			break;
+		}
+		case CommandType::eBindTexture: {
+			FlushDrawBatch();
+			const BindTextureCommand* BindCmd = static_cast<BindTextureCommand*>(Cmd.get());
+			glBindTextureUnit(BindCmd->Slot_, BindCmd->Target_);
+			FrameStats_.TextureBinds++;
+			break;
+		}
 		case CommandType::eDrawIndexed: {
-			DrawIndexedCommand* DrawCmd = static_cast<DrawIndexedCommand*>(Cmd.get());
-
-			// 1. 从句柄获取OpenGL资源
-			GLMesh* Mesh = (GLMesh*)DrawCmd->DrawCall_.resources.mesh;
-			if (!Mesh) {
-				return;
+			const DrawCall& Call = static_cast<DrawIndexedCommand*>(Cmd.get())->DrawCall_;
+			if (!Call.resources.mesh || !Call.resources.material) {
+				break;
 			}
 
-			GLMaterial* Material = (GLMaterial*)DrawCmd->DrawCall_.resources.material;
-			if (!Material) {
-				return;
+			FrameStats_.DrawCommands++;
+			if (!((const GLMaterial*)Call.resources.material)->IsReady()) {
+				FrameStats_.FallbackDraws++;
 			}
-
-			// 2. 绑定状态
-			Material->Apply();
-			Mesh->Bind();
-
-			// 3. 设置Uniform
-			GLShader* Shader = (GLShader*)Material->GetShader().get();
-			if (Shader) {
-				const FMatrix4& ModelMatrix = DrawCmd->DrawCall_.modelMatrix;
-				const FMatrix4& ViewMatrix = CmdList.GetViewMatrix();
-				const FMatrix4& ProjMatrix = CmdList.GetProjMatrix();
-
-				GLint ModelMatrixLoc = glGetUniformLocation(Shader->GetProgramID(), "ModelMat");
-				GLint ViewMatrixatrixLoc = glGetUniformLocation(Shader->GetProgramID(), "ViewMat");
-				GLint ProjMatrixatrixLoc = glGetUniformLocation(Shader->GetProgramID(), "ProjMat");
-				glUniformMatrix4fv(ModelMatrixLoc, 1, GL_FALSE, ModelMatrix.data());
-				glUniformMatrix4fv(ViewMatrixatrixLoc, 1, GL_FALSE, ViewMatrix.data());
-				glUniformMatrix4fv(ProjMatrixatrixLoc, 1, GL_FALSE, ProjMatrix.data());
+			RequestTextureMips(Call, CmdList.GetViewMatrix(), ProjScale);
+			if (MultiDrawIndirect_) {
+				AppendDrawBatch(Call);
+			}
+			else {
+				SubmitDraw(Call);
 			}
-		
-			// 4. 绘制
-			glDrawElements(GL_TRIANGLES, DrawCmd->DrawCall_.indexCount, GL_UNSIGNED_INT, 0);
 			break;
 		}
 		}
 	}
-	// Object pass
+	FlushDrawBatch();
+	if (BoundFramebuffer_ != 0) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		BoundFramebuffer_ = 0;
+	}
+
+	auto SubmitEnd = std::chrono::high_resolution_clock::now();
+	FrameStats_.SubmitTimeMs = std::chrono::duration<double, std::milli>(SubmitEnd - SubmitStart).count();
 
+	RingBuffer_.EndFrame();
+	GLTextureStreamer::Instance().EndFrame();
 	SwapBuffers();
 }
 
+void GLDevice::BindFrameData(const CommandList& CmdList) {
+	const FMatrix4& ViewMatrix = CmdList.GetViewMatrix();
+	const FMatrix4& ProjMatrix = CmdList.GetProjMatrix();
+
+	TransientAllocation FrameData = AllocateTransient(sizeof(FMatrix4) * 2);
+	if (FrameData.IsValid()) {
+		uint8_t* Dst = (uint8_t*)FrameData.Data;
+		memcpy(Dst, ViewMatrix.data(), sizeof(FMatrix4));
+		memcpy(Dst + sizeof(FMatrix4), ProjMatrix.data(), sizeof(FMatrix4));
+		glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_UBO_BINDING, FrameData.Buffer, FrameData.Offset, FrameData.Size);
+		return;
+	}
+
+	glNamedBufferSubData(FallbackFrameUBO_, 0, sizeof(FMatrix4), ViewMatrix.data());
+	glNamedBufferSubData(FallbackFrameUBO_, sizeof(FMatrix4), sizeof(FMatrix4), ProjMatrix.data());
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UBO_BINDING, FallbackFrameUBO_);
+}
+
+const GLMaterial* GLDevice::ResolveMaterial(const GLMaterial* Material) {
+	if (Material->IsReady()) {
+		return Material;
+	}
+
+	if (!FallbackMaterial_) {
+		FallbackMaterial_ = DynamicCast<IMaterial>(ResourceManager::Instance().Acquire(ResourceType::eMaterial, BUILTIN_PBR_MATERIAL));
+	}
+	return FallbackMaterial_ ? (const GLMaterial*)FallbackMaterial_.get() : Material;
+}
+
+void GLDevice::ApplyMaterial(const GLMaterial* Material) {
+	Material = ResolveMaterial(Material);
+
+	// 连续相同材质时跳过
+	if (Material == BoundMaterial_) {
+		return;
+	}
+
+	Material->Apply();
+	BoundMaterial_ = Material;
+	FrameStats_.MaterialBinds++;
+	FrameStats_.TextureBinds += Material->GetTextureBindCount();
+}
+
+void GLDevice::RequestTextureMips(const DrawCall& Call, const FMatrix4& ViewMatrix, float ProjScale) {
+	const GLMaterial* Material = (const GLMaterial*)Call.resources.material;
+	if (Material->GetTextures().empty()) {
+		return;
+	}
+
+	// 包围球投影到屏幕上的直径（像素），相机在球内时请求最高Mip
+	const GLMesh* Mesh = (const GLMesh*)Call.resources.mesh;
+	const FVector4 Center = ViewMatrix * Call.modelMatrix * FVector4(Mesh->GetCenter()[0], Mesh->GetCenter()[1], Mesh->GetCenter()[2], 1.0f);
+	const FMatrix3 Basis = Call.modelMatrix.block<3, 3>(0, 0);
+	const float Scale = std::max(Basis.col(0).norm(), std::max(Basis.col(1).norm(), Basis.col(2).norm()));
+	const float Radius = Mesh->GetRadius() * Scale;
+	const float Depth = -Center[2];
+	const float ScreenSize = Depth > Radius ? 2.0f * Radius * ProjScale / Depth : FLT_MAX;
+
+	GLTextureStreamer& Streamer = GLTextureStreamer::Instance();
+	for (const auto& [Slot, Texture] : Material->GetTextures()) {
+		if (Texture) {
+			Streamer.Request(static_cast<GLTexture*>(Texture.get()), ScreenSize);
+		}
+	}
+}
+
+void GLDevice::BindMeshHeap(const GLMesh* Mesh) {
+	// 同一顶点格式的Mesh共用一个VAO
+	GLMeshHeap& MeshHeap = GLMeshHeap::Instance(Mesh->GetVertexFormat());
+	if (MeshHeap.GetVAO() == BoundVAO_) {
+		return;
+	}
+
+	MeshHeap.Bind();
+	BoundVAO_ = MeshHeap.GetVAO();
+}
+
+void GLDevice::SubmitDraw(const DrawCall& Call) {
+	const GLMesh* Mesh = (const GLMesh*)Call.resources.mesh;
+	// 逐绘制数据中的材质索引必须与实际绑定的材质一致
+	const GLMaterial* Material = ResolveMaterial((const GLMaterial*)Call.resources.material);
+	ApplyMaterial(Material);
+	BindMeshHeap(Mesh);
+
+	TransientAllocation DrawData = AllocateTransient(sizeof(GPUDrawData), TransientUsage::eStorage);
+	if (DrawData.IsValid()) {
+		CommandList::WriteDrawData((GPUDrawData*)DrawData.Data, Call.modelMatrix, Mesh, Material);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_SSBO_BINDING, DrawData.Buffer, DrawData.Offset, DrawData.Size);
+	}
+	else {
+		GPUDrawData FallbackData;
+		CommandList::WriteDrawData(&FallbackData, Call.modelMatrix, Mesh, Material);
+		glNamedBufferSubData(FallbackDrawDataSSBO_, 0, sizeof(GPUDrawData), &FallbackData);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_SSBO_BINDING, FallbackDrawDataSSBO_);
+	}
+
+	const uintptr_t IndexOffset = (uintptr_t)(Mesh->GetBaseIndex() + Call.firstIndex) * sizeof(uint32_t);
+	glDrawElementsBaseVertex(GL_TRIANGLES, Call.indexCount, GL_UNSIGNED_INT,
+		(void*)IndexOffset, (GLint)Mesh->GetBaseVertex());
+	FrameStats_.DrawCalls++;
+}
+
+void GLDevice::AppendDrawBatch(const DrawCall& Call) {
+	// 材质或顶点格式不同则无法合并
+	if (!PendingDraws_.empty()) {
+		const DrawCall* Front = PendingDraws_.front();
+		if (ResolveMaterial((const GLMaterial*)Front->resources.material) != ResolveMaterial((const GLMaterial*)Call.resources.material) ||
+			((const GLMesh*)Front->resources.mesh)->GetVertexFormat() != ((const GLMesh*)Call.resources.mesh)->GetVertexFormat()) {
+			FlushDrawBatch();
+		}
+	}
+
+	PendingDraws_.push_back(&Call);
+}
+
+void GLDevice::FlushDrawBatch() {
+	if (PendingDraws_.empty()) {
+		return;
+	}
+
+	const uint32_t DrawCount = (uint32_t)PendingDraws_.size();
+	TransientAllocation DrawData = GatherDrawData();
+	TransientAllocation Indirect = AllocateTransient(DrawCount * sizeof(DrawElementsIndirectCommand), TransientUsage::eIndirect);
+
+	// 瞬态空间不足时退回逐个绘制
+	if (!DrawData.IsValid() || !Indirect.IsValid()) {
+		for (const DrawCall* Call : PendingDraws_) {
+			SubmitDraw(*Call);
+		}
+		PendingDraws_.clear();
+		return;
+	}
+
+	DrawElementsIndirectCommand* Commands = (DrawElementsIndirectCommand*)Indirect.Data;
+	for (uint32_t i = 0; i < DrawCount; ++i) {
+		const DrawCall* Call = PendingDraws_[i];
+		const GLMesh* Mesh = (const GLMesh*)Call->resources.mesh;
+
+		DrawElementsIndirectCommand Command;
+		Command.Count = Call->indexCount;
+		Command.InstanceCount = 1;
+		Command.FirstIndex = Mesh->GetBaseIndex() + Call->firstIndex;
+		Command.BaseVertex = (int32_t)Mesh->GetBaseVertex();
+		Command.BaseInstance = 0;
+		Commands[i] = Command;
+	}
+
+	ApplyMaterial((const GLMaterial*)PendingDraws_.front()->resources.material);
+	BindMeshHeap((const GLMesh*)PendingDraws_.front()->resources.mesh);
+
+	// Shader中通过gl_DrawID索引逐绘制数据
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_SSBO_BINDING, DrawData.Buffer, DrawData.Offset, DrawData.Size);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, Indirect.Buffer);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(uintptr_t)Indirect.Offset, DrawCount, 0);
+
+	FrameStats_.DrawCalls++;
+	FrameStats_.MultiDrawBatches++;
+	PendingDraws_.clear();
+}
+
+TransientAllocation GLDevice::GatherDrawData() {
+	const uint32_t DrawCount = (uint32_t)PendingDraws_.size();
+
+	// 按批次顺序一次性写入一段连续内存，与gl_DrawID一一对应
+	TransientAllocation DrawData = AllocateTransient(DrawCount * sizeof(GPUDrawData), TransientUsage::eStorage);
+	if (!DrawData.IsValid()) {
+		return DrawData;
+	}
+
+	// 批次按解析后的材质合并，材质索引同样取解析后的材质
+	GPUDrawData* Dst = (GPUDrawData*)DrawData.Data;
+	for (uint32_t i = 0; i < DrawCount; ++i) {
+		const DrawCall* Call = PendingDraws_[i];
+		CommandList::WriteDrawData(&Dst[i], Call->modelMatrix, (const GLMesh*)Call->resources.mesh, ResolveMaterial((const GLMaterial*)Call->resources.material));
+	}
+	return DrawData;
+}
+
+void GLDevice::BeginRenderPass(const RenderPassDesc& Desc) {
+	const GLuint Framebuffer = GetFramebuffer(Desc);
+	if (Framebuffer != BoundFramebuffer_) {
+		glBindFramebuffer(GL_FRAMEBUFFER, Framebuffer);
+		BoundFramebuffer_ = Framebuffer;
+	}
+	CurrentPass_ = Desc;
+	glViewport(0, 0, Desc.Width, Desc.Height);
+
+	if (Desc.ClearColor) {
+		for (uint32_t i = 0; i < Desc.ColorCount; ++i) {
+			glClearNamedFramebufferfv(Framebuffer, GL_COLOR, i, Desc.Color.data());
+		}
+	}
+	if (Desc.ClearDepth && Desc.HasDepth) {
+		glClearNamedFramebufferfv(Framebuffer, GL_DEPTH, 0, &Desc.Depth);
+	}
+}
+
+void GLDevice::EndRenderPass(uint32_t DiscardColorMask, bool DiscardDepth) {
+	// 后台缓冲的内容需要呈现，不丢弃
+	if (BoundFramebuffer_ == 0) {
+		return;
+	}
+
+	GLenum Attachments[RENDER_PASS_MAX_COLOR_TARGETS + 1];
+	GLsizei AttachmentCount = 0;
+	for (uint32_t i = 0; i < CurrentPass_.ColorCount; ++i) {
+		if (DiscardColorMask & (1u << i)) {
+			Attachments[AttachmentCount++] = GL_COLOR_ATTACHMENT0 + i;
+		}
+	}
+	if (DiscardDepth && CurrentPass_.HasDepth) {
+		const bool Stencil = RenderTargets_[CurrentPass_.DepthTarget].Format == RenderTargetFormat::eDepth24Stencil8;
+		Attachments[AttachmentCount++] = Stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+	}
+	if (AttachmentCount > 0) {
+		glInvalidateNamedFramebufferData(BoundFramebuffer_, AttachmentCount, Attachments);
+	}
+}
+
+GLuint GLDevice::GetFramebuffer(const RenderPassDesc& Desc) {
+	std::vector<GLuint> Key(Desc.ColorTargets, Desc.ColorTargets + Desc.ColorCount);
+	Key.push_back(Desc.HasDepth ? Desc.DepthTarget : 0);
+
+	const bool Backbuffer = std::all_of(Key.begin(), Key.end(), [](GLuint Target) { return Target == BACKBUFFER_RENDER_TARGET; });
+	if (Backbuffer) {
+		return 0;
+	}
+
+	auto It = Framebuffers_.find(Key);
+	if (It != Framebuffers_.end()) {
+		return It->second;
+	}
+
+	GLuint Framebuffer = 0;
+	glCreateFramebuffers(1, &Framebuffer);
+	GLenum DrawBuffers[RENDER_PASS_MAX_COLOR_TARGETS];
+	for (uint32_t i = 0; i < Desc.ColorCount; ++i) {
+		glNamedFramebufferTexture(Framebuffer, GL_COLOR_ATTACHMENT0 + i, Desc.ColorTargets[i], 0);
+		DrawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+	}
+	if (Desc.ColorCount > 0) {
+		glNamedFramebufferDrawBuffers(Framebuffer, Desc.ColorCount, DrawBuffers);
+	}
+	else {
+		glNamedFramebufferDrawBuffer(Framebuffer, GL_NONE);
+	}
+	if (Desc.HasDepth) {
+		const bool Stencil = RenderTargets_[Desc.DepthTarget].Format == RenderTargetFormat::eDepth24Stencil8;
+		glNamedFramebufferTexture(Framebuffer, Stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, Desc.DepthTarget, 0);
+	}
+
+	if (glCheckNamedFramebufferStatus(Framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		LOG_ERROR << "Framebuffer is incomplete! Render targets must be created by this device and must not mix with the backbuffer.";
+	}
+
+	Framebuffers_[Key] = Framebuffer;
+	return Framebuffer;
+}
 
 void GLDevice::MakeCurrent() {
 	wglMakeCurrent(m_hDC, m_hRC);
 }
 
+void GLDevice::ReleaseCurrent() {
+	wglMakeCurrent(nullptr, nullptr);
+}
+
 void GLDevice::SwapBuffers() {
 	::SwapBuffers(m_hDC);
 }
@@ -193,6 +535,34 @@ void GLDevice::Destroy() {
 		BuiltinShader_->Unload();
 	}
 
+	FallbackMaterial_.reset();
+	GLShaderCompiler::Instance().Destroy();
+	GLTextureStreamer::Instance().Destroy();
+
+	for (auto& It : Framebuffers_) {
+		glDeleteFramebuffers(1, &It.second);
+	}
+	Framebuffers_.clear();
+	for (auto& It : RenderTargets_) {
+		glDeleteTextures(1, &It.first);
+	}
+	RenderTargets_.clear();
+
+	GLMaterialBuffer::Instance().Destroy();
+	GLMaterialTable::Instance().Destroy();
+	RingBuffer_.Destroy();
+	if (FallbackFrameUBO_ != 0) {
+		glDeleteBuffers(1, &FallbackFrameUBO_);
+		FallbackFrameUBO_ = 0;
+	}
+	if (FallbackDrawDataSSBO_ != 0) {
+		glDeleteBuffers(1, &FallbackDrawDataSSBO_);
+		FallbackDrawDataSSBO_ = 0;
+	}
+	for (uint32_t i = 0; i < (uint32_t)VertexFormat::eCount; ++i) {
+		GLMeshHeap::Instance((VertexFormat)i).Destroy();
+	}
+
 	if (m_hRC) {
 		wglMakeCurrent(nullptr, nullptr);
 		wglDeleteContext(m_hRC);
@@ -210,6 +580,10 @@ std::shared_ptr<IMesh> GLDevice::CreateMesh(const struct MeshDesc& AssetDesc) {
 	return std::make_shared<GLMesh>(AssetDesc);
 }
 
+std::shared_ptr<IMesh> GLDevice::CreateMesh(struct MeshDesc&& AssetDesc) {
+	return std::make_shared<GLMesh>(std::move(AssetDesc));
+}
+
 std::shared_ptr<IMaterial> GLDevice::CreateMaterial(const struct MaterialDesc& AssetDesc) {
 	return std::make_shared<GLMaterial>(AssetDesc);
 }
@@ -218,8 +592,110 @@ std::shared_ptr<IShader> GLDevice::CreateShader(const struct ShaderDesc& AssetDe
 	return std::make_shared<GLShader>(AssetDesc);
 }
 
-std::shared_ptr<ITexture> GLDevice::CreateTexture(const std::string& AssetPath) {
-	return std::make_shared<GLTexture>(AssetPath);
+std::shared_ptr<ITexture> GLDevice::CreateTexture(const struct TextureDesc& AssetDesc) {
+	return std::make_shared<GLTexture>(AssetDesc);
+}
+
+uint32_t GLDevice::CreateRenderTarget(const RenderTargetDesc& Desc) {
+	GLenum InternalFormat = GL_RGBA8;
+	switch (Desc.Format)
+	{
+	case RenderTargetFormat::eRGBA8: InternalFormat = GL_RGBA8; break;
+	case RenderTargetFormat::eRGBA16F: InternalFormat = GL_RGBA16F; break;
+	case RenderTargetFormat::eR11G11B10F: InternalFormat = GL_R11F_G11F_B10F; break;
+	case RenderTargetFormat::eRG16F: InternalFormat = GL_RG16F; break;
+	case RenderTargetFormat::eR8: InternalFormat = GL_R8; break;
+	case RenderTargetFormat::eR32F: InternalFormat = GL_R32F; break;
+	case RenderTargetFormat::eDepth24Stencil8: InternalFormat = GL_DEPTH24_STENCIL8; break;
+	case RenderTargetFormat::eDepth32F: InternalFormat = GL_DEPTH_COMPONENT32F; break;
+	default: break;
+	}
+
+	GLuint Texture = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &Texture);
+	glTextureStorage2D(Texture, 1, InternalFormat, Desc.Width, Desc.Height);
+	glTextureParameteri(Texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(Texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	RenderTargets_[Texture] = Desc;
+	return Texture;
+}
+
+void GLDevice::DestroyRenderTarget(uint32_t Target) {
+	if (RenderTargets_.erase(Target) == 0) {
+		return;
+	}
+
+	// 删除引用该目标的FBO
+	for (auto It = Framebuffers_.begin(); It != Framebuffers_.end();) {
+		if (std::find(It->first.begin(), It->first.end(), Target) != It->first.end()) {
+			glDeleteFramebuffers(1, &It->second);
+			It = Framebuffers_.erase(It);
+		}
+		else {
+			++It;
+		}
+	}
+	GLuint Texture = Target;
+	glDeleteTextures(1, &Texture);
+}
+
+void GLDevice::GetBackbufferSize(uint32_t& Width, uint32_t& Height) const {
+	Width = WIDTH;
+	Height = HEIGHT;
+}
+
+TransientAllocation GLDevice::AllocateTransient(uint64_t Size, TransientUsage Usage) {
+	uint64_t Alignment = 4;
+	switch (Usage)
+	{
+	case TransientUsage::eUniform: Alignment = UniformAlignment_; break;
+	case TransientUsage::eStorage: Alignment = StorageAlignment_; break;
+	case TransientUsage::eIndirect: Alignment = 4; break;
+	}
+
+	return RingBuffer_.Allocate(Size, Alignment);
+}
+
+TransientBufferStats GLDevice::GetTransientStats() const {
+	return RingBuffer_.GetStats();
+}
+
+GeometryMemoryStats GLDevice::GetGeometryStats() const {
+	// 汇总所有顶点格式的堆
+	GeometryMemoryStats Total;
+	uint64_t VertexFreeBytes = 0, IndexFreeBytes = 0;
+	float VertexFragmented = 0.0f, IndexFragmented = 0.0f;
+	for (uint32_t i = 0; i < (uint32_t)VertexFormat::eCount; ++i) {
+		const GeometryMemoryStats Stats = GLMeshHeap::Instance((VertexFormat)i).GetStats();
+		Total.VertexCapacityBytes += Stats.VertexCapacityBytes;
+		Total.VertexUsedBytes += Stats.VertexUsedBytes;
+		Total.IndexCapacityBytes += Stats.IndexCapacityBytes;
+		Total.IndexUsedBytes += Stats.IndexUsedBytes;
+		Total.AllocationCount += Stats.AllocationCount;
+		Total.FreeBlockCount += Stats.FreeBlockCount;
+
+		// 碎片率按空闲空间加权
+		const uint64_t VertexFree = Stats.VertexCapacityBytes - Stats.VertexUsedBytes;
+		const uint64_t IndexFree = Stats.IndexCapacityBytes - Stats.IndexUsedBytes;
+		VertexFreeBytes += VertexFree;
+		IndexFreeBytes += IndexFree;
+		VertexFragmented += Stats.VertexFragmentation * VertexFree;
+		IndexFragmented += Stats.IndexFragmentation * IndexFree;
+	}
+	Total.VertexFragmentation = VertexFreeBytes > 0 ? VertexFragmented / VertexFreeBytes : 0.0f;
+	Total.IndexFragmentation = IndexFreeBytes > 0 ? IndexFragmented / IndexFreeBytes : 0.0f;
+	return Total;
+}
+
+ShaderCompileStats GLDevice::GetShaderCompileStats() const {
+	return GLShaderCompiler::Instance().GetStats();
+}
+
+TextureStreamingStats GLDevice::GetTextureStreamingStats() const {
+	return GLTextureStreamer::Instance().GetStats();
 }
 
 #endif
\ No newline at end of file
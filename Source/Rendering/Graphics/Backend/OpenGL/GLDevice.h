@@ -1,40 +1,102 @@
 ﻿#pragma once
 #include "Graphics/IGraphicsDevice.h"
+#include "Core/BaseMath.h"
 
 #ifdef _WIN32
 
 #include "glad/glad.h"
 #include <windows.h>
 #include "glad/wglext.h"
+#include "GLRingBuffer.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 class IShader;
 class IMesh;
 class IMaterial;
+class GLMaterial;
 
 class GLDevice : public IGraphicsDevice {
 public:
 	GLDevice();
 	virtual bool Initialize(Window* Win) override;
+	virtual void BeginFrame() override;
 	virtual void ExecuteCommandList(const CommandList& cmdList) override;
 	virtual void MakeCurrent() override;
+	virtual void ReleaseCurrent() override;
 	virtual void SwapBuffers() override;
 	virtual void Destroy() override;
 
 	virtual std::shared_ptr<IMesh> CreateMesh(const struct MeshDesc& AssetDesc) override;
+	virtual std::shared_ptr<IMesh> CreateMesh(struct MeshDesc&& AssetDesc) override;
 	virtual std::shared_ptr<IMaterial> CreateMaterial(const struct MaterialDesc& AssetDesc) override;
 	virtual std::shared_ptr<IShader> CreateShader(const struct ShaderDesc& AssetDesc) override;
-	virtual std::shared_ptr<ITexture> CreateTexture(const std::string& AssetPath) override;
+	virtual std::shared_ptr<ITexture> CreateTexture(const struct TextureDesc& AssetDesc) override;
+
+	virtual uint32_t CreateRenderTarget(const RenderTargetDesc& Desc) override;
+	virtual void DestroyRenderTarget(uint32_t Target) override;
+	virtual void GetBackbufferSize(uint32_t& Width, uint32_t& Height) const override;
+
+	virtual TransientAllocation AllocateTransient(uint64_t Size, TransientUsage Usage = TransientUsage::eUniform) override;
+	virtual TransientBufferStats GetTransientStats() const override;
+
+	virtual void SetMultiDrawIndirect(bool Enable) override { MultiDrawIndirect_ = Enable; }
+	virtual bool IsMultiDrawIndirectEnabled() const override { return MultiDrawIndirect_; }
+	virtual const RenderStats& GetRenderStats() const override { return FrameStats_; }
+	virtual GeometryMemoryStats GetGeometryStats() const override;
+	virtual ShaderCompileStats GetShaderCompileStats() const override;
+	virtual TextureStreamingStats GetTextureStreamingStats() const override;
 
 private:
 	bool InitOpenGLContext();
+	void BindFrameData(const CommandList& CmdList);
+	void ApplyMaterial(const GLMaterial* Material);
+	// Shader未编译完成的材质替换为内建材质
+	const GLMaterial* ResolveMaterial(const GLMaterial* Material);
+	void BindMeshHeap(const class GLMesh* Mesh);
+	// 按网格包围球的屏幕尺寸请求材质纹理的Mip
+	void RequestTextureMips(const struct DrawCall& Call, const FMatrix4& ViewMatrix, float ProjScale);
+
+	// 逐个绘制
+	void SubmitDraw(const struct DrawCall& Call);
+	// 合并为MultiDrawIndirect
+	void AppendDrawBatch(const struct DrawCall& Call);
+	void FlushDrawBatch();
+	TransientAllocation GatherDrawData();
+
+	// 渲染通道
+	void BeginRenderPass(const RenderPassDesc& Desc);
+	void EndRenderPass(uint32_t DiscardColorMask, bool DiscardDepth);
+	// 按附件组合缓存FBO，全部为后台缓冲时返回0
+	GLuint GetFramebuffer(const RenderPassDesc& Desc);
 
 private:
 	Window* Window_;
 	IShader* BuiltinShader_;
 
-	// OpenGL properties
-	GLuint textureID;
-	GLuint FBO;
+	// 渲染目标及按附件组合缓存的FBO
+	std::unordered_map<GLuint, RenderTargetDesc> RenderTargets_;
+	std::map<std::vector<GLuint>, GLuint> Framebuffers_;
+	GLuint BoundFramebuffer_;
+	RenderPassDesc CurrentPass_;
+
+	// 逐帧/逐绘制数据的持久映射环形Buffer
+	GLRingBuffer RingBuffer_;
+	GLint UniformAlignment_;
+	GLint StorageAlignment_;
+	// 环形Buffer空间不足时使用的后备Buffer
+	GLuint FallbackFrameUBO_;
+	GLuint FallbackDrawDataSSBO_;
+
+	// 绘制批次
+	bool MultiDrawIndirect_;
+	std::vector<const struct DrawCall*> PendingDraws_;
+	const GLMaterial* BoundMaterial_;
+	std::shared_ptr<IMaterial> FallbackMaterial_;
+	GLuint BoundVAO_;
+	RenderStats FrameStats_;
 
 	// OpenGL handle
 	HGLRC m_hRC;
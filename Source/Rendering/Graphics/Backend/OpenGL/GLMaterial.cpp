@@ -3,12 +3,23 @@
 #include "Resource/IShader.h"
 #include "Resource/ITexture.h"
 #include "GLShader.h"
+#include "GLMaterialBuffer.h"
+#include "GLMaterialTable.h"
+#include "GLTexture.h"
 #include "Platform/File/JsonObject.h"
 #include "Resource/Manager/ResourceManager.h"
 #include <Logger.hpp>
 
-GLMaterial::GLMaterial() { Name_ = ""; }
-GLMaterial::GLMaterial(const MaterialDesc& Desc) {
+GLMaterial::GLMaterial() {
+	Name_ = "";
+	BlockOffset_ = 0;
+	BlockSize_ = 0;
+	BlockBinding_ = 0;
+	WaitingShader_ = false;
+	TextureBindCount_ = 0;
+}
+
+GLMaterial::GLMaterial(const MaterialDesc& Desc) : GLMaterial() {
 	if (!Load(Desc)) {
 		return;
 	}
@@ -39,18 +50,63 @@ bool GLMaterial::Load(const MaterialDesc& Desc) {
 		Shader_ = DynamicCast<IShader>(ResourceManager::Instance().Acquire(ResourceType::eShader, BUILTIN_PBR_SHADER));
 	}
 
-	// 加载Texture资产
-	Desc.TexturePaths;
+	// Shader编译完成前没有反射布局，完成后再打包材质常量
+	if (Shader_ && !Shader_->IsReady()) {
+		WaitingShader_ = true;
+		static_cast<GLShader*>(Shader_.get())->AddWaitingMaterial(this);
+	}
+	// 打包材质常量数据，之后只在参数变化时重新上传
+	else if (!BuildUniformBlock()) {
+		LOG_WARN << "Material '" << Name_ << "' has no uniform block.";
+	}
+
+	// 加载Texture资产，像素数据已在工作线程解码时直接从资源表取得
+	for (const auto& [Slot, TexturePath] : Desc.TexturePaths) {
+		std::shared_ptr<ITexture> Texture = DynamicCast<ITexture>(ResourceManager::Instance().Acquire(ResourceType::eTexture, TexturePath));
+		if (!Texture) {
+			Texture = DynamicCast<ITexture>(ResourceManager::Instance().LoadResource(ResourceType::eTexture, TexturePath));
+		}
+
+		if (!Texture) {
+			LOG_WARN << "Load texture '" << TexturePath << "' of material '" << Desc.Name << "' failed!";
+			continue;
+		}
+		Textures_[Slot] = Texture;
+	}
+
+	// 纹理槽位和句柄写入材质表
+	MaterialIndex_ = GLMaterialTable::Instance().Allocate(this);
 
 	LOG_DEBUG << "Material '" << Name_ << "' loaded.";
 	IsValid_ = true;
 	return true;
 }
 
+void GLMaterial::OnShaderReady() {
+	WaitingShader_ = false;
+	if (!Shader_->IsValid()) {
+		LOG_WARN << "Compile shader of material '" << Name_ << "' failed! Use built-in shader!";
+		Shader_ = DynamicCast<IShader>(ResourceManager::Instance().Acquire(ResourceType::eShader, BUILTIN_PBR_SHADER));
+	}
+
+	if (!BuildUniformBlock()) {
+		LOG_WARN << "Material '" << Name_ << "' has no uniform block.";
+	}
+}
+
 void GLMaterial::Unload() {
+	if (WaitingShader_ && Shader_) {
+		static_cast<GLShader*>(Shader_.get())->RemoveWaitingMaterial(this);
+		WaitingShader_ = false;
+	}
+	ReleaseUniformBlock();
+	GLMaterialTable::Instance().Free(MaterialIndex_);
+	MaterialIndex_ = 0;
+
 	if (Shader_) {
 		Shader_.reset();
 	}
+	Textures_.clear();
 
 	LOG_DEBUG << "Material '" << Name_ << "' unloaded.";
 }
@@ -66,49 +122,83 @@ void GLMaterial::Apply() const {
 	ApplyTextures();
 }
 
+void GLMaterial::SetUniform(const std::string& Name, const MaterialValue& Value) {
+	IMaterial::SetUniform(Name, Value);
+	BuildUniformBlock();
+}
+
+bool GLMaterial::BuildUniformBlock() {
+	if (!Shader_) {
+		return false;
+	}
+
+	std::vector<uint8_t> Block;
+	if (!Shader_->PackMaterial(*this, Block)) {
+		return false;
+	}
+
+	// 布局变化时重新分配区间
+	GLMaterialBuffer& MaterialBuffer = GLMaterialBuffer::Instance();
+	const uint32_t Size = static_cast<uint32_t>(Block.size());
+	if (Size != BlockSize_) {
+		ReleaseUniformBlock();
+		if (!MaterialBuffer.Allocate(Size, BlockOffset_)) {
+			return false;
+		}
+		BlockSize_ = Size;
+	}
+
+	BlockBinding_ = Shader_->GetMaterialLayout().binding;
+	MaterialBuffer.Upload(BlockOffset_, BlockSize_, Block.data());
+	return true;
+}
+
+void GLMaterial::ReleaseUniformBlock() {
+	if (BlockSize_ > 0) {
+		GLMaterialBuffer::Instance().Free(BlockOffset_, BlockSize_);
+		BlockOffset_ = 0;
+		BlockSize_ = 0;
+	}
+}
+
 void GLMaterial::ApplyUniformBuffer() const {
-	Shader_->UploadMaterial(*this);
+	if (BlockSize_ == 0) {
+		return;
+	}
+
+	glBindBufferRange(GL_UNIFORM_BUFFER, BlockBinding_,
+		GLMaterialBuffer::Instance().GetBuffer(), BlockOffset_, BlockSize_);
 }
 
 void GLMaterial::ApplyTextures() const {
-	for (const auto& [slot, texture] : Textures_) {
-		if (texture && texture->IsValid()) {
-			uint32_t binding = static_cast<uint32_t>(slot);
-
-			// 核心：直接使用槽位枚举值作为binding
-			texture->Bind(binding);
+	// 无绑定纹理由Shader从材质表取句柄，纹理启用标志也来自材质表
+	TextureBindCount_ = 0;
+	if (GLMaterialTable::Instance().IsBindless()) {
+		return;
+	}
 
-			// 设置纹理启用标志
-			SetTextureFlag(slot, true);
+	for (const auto& [slot, texture] : Textures_) {
+		if (!texture || !texture->IsValid()) {
+			continue;
 		}
-		else {
-			SetTextureFlag(slot, false);
+		// 只驻留常驻Mip的纹理由Shader按材质表从纹理数组采样
+		if (static_cast<uint32_t>(slot) < MATERIAL_TABLE_TEXTURE_COUNT && static_cast<const GLTexture*>(texture.get())->IsInTextureArray()) {
+			continue;
 		}
+		// 直接使用槽位枚举值作为binding
+		texture->Bind(static_cast<uint32_t>(slot));
+		++TextureBindCount_;
 	}
 }
 
-void GLMaterial::SetTextureFlag(TextureSlot slot, bool enabled) const {
-	switch (slot) {
-	case TextureSlot::eAlbedo:
-		Shader_->SetInt("material.hasAlbedoMap", enabled ? 1 : 0);
-		break;
-	case TextureSlot::eNormal:
-		Shader_->SetInt("material.hasNormalMap", enabled ? 1 : 0);
-		break;
-	case TextureSlot::eMetallic:
-		Shader_->SetInt("material.hasMetallicMap", enabled ? 1 : 0);
-		break;
-	case TextureSlot::eRoughness:
-		Shader_->SetInt("material.hasRoughnessMap", enabled ? 1 : 0);
-		break;
-	case TextureSlot::eAO:
-		Shader_->SetInt("material.hasAOMap", enabled ? 1 : 0);
-		break;
-	case TextureSlot::eEmissive:
-		Shader_->SetInt("material.hasEmissiveMap", enabled ? 1 : 0);
-		break;
-		// ... 其他纹理类型
-	}
+void GLMaterial::SetTexture(TextureSlot slot, std::shared_ptr<ITexture> texture) {
+	IMaterial::SetTexture(slot, texture);
+	GLMaterialTable::Instance().MarkDirty(MaterialIndex_);
+}
+
+void GLMaterial::RemoveTexture(TextureSlot slot) {
+	IMaterial::RemoveTexture(slot);
+	GLMaterialTable::Instance().MarkDirty(MaterialIndex_);
 }
 
 void GLMaterial::Unbind() const {
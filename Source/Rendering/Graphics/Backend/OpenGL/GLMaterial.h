@@ -15,10 +15,30 @@ public:
 
 	virtual void Apply() const override;
 	virtual void Unbind() const override;
+	virtual void SetUniform(const std::string& Name, const MaterialValue& Value) override;
+	virtual uint64_t GetGPUMemorySize() const override { return BlockSize_; }
+	virtual void SetTexture(TextureSlot slot, std::shared_ptr<ITexture> texture) override;
+	virtual void RemoveTexture(TextureSlot slot) override;
+
+	// 本次Apply绑定的纹理数，无绑定纹理时为0
+	uint32_t GetTextureBindCount() const { return TextureBindCount_; }
+
+	// Shader仍在后台编译时不可绘制，由设备改用内建材质
+	bool IsReady() const { return !WaitingShader_; }
+	void OnShaderReady();
 
 private:
+	bool BuildUniformBlock();
+	void ReleaseUniformBlock();
 	void ApplyUniformBuffer() const;
 	void ApplyTextures() const;
-	void SetTextureFlag(TextureSlot slot, bool enabled) const;
+
+private:
+	// 材质常量数据在共享材质Buffer中的区间
+	uint32_t BlockOffset_;
+	uint32_t BlockSize_;
+	uint32_t BlockBinding_;
+	bool WaitingShader_;
+	mutable uint32_t TextureBindCount_;
 
 };
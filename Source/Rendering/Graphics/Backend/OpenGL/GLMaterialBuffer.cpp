@@ -0,0 +1,88 @@
+﻿#include "GLMaterialBuffer.h"
+#include <Logger.hpp>
+
+GLMaterialBuffer& GLMaterialBuffer::Instance() {
+	static GLMaterialBuffer MaterialBuffer;
+	return MaterialBuffer;
+}
+
+GLMaterialBuffer::GLMaterialBuffer() {
+	Buffer_ = 0;
+	Alignment_ = 256;
+}
+
+bool GLMaterialBuffer::Initialize(uint32_t InitialSize) {
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &Alignment_);
+	if (Alignment_ <= 0) {
+		Alignment_ = 256;
+	}
+
+	glCreateBuffers(1, &Buffer_);
+	glNamedBufferData(Buffer_, InitialSize, nullptr, GL_DYNAMIC_DRAW);
+	Allocator_.Reset(InitialSize);
+
+	LOG_DEBUG << "Material buffer created, size: " << InitialSize << " alignment: " << Alignment_;
+	return Buffer_ != 0;
+}
+
+void GLMaterialBuffer::Destroy() {
+	if (Buffer_ != 0) {
+		glDeleteBuffers(1, &Buffer_);
+		Buffer_ = 0;
+	}
+	Allocator_.Reset(0);
+}
+
+bool GLMaterialBuffer::Allocate(uint32_t Size, uint32_t& OutOffset) {
+	if (Buffer_ == 0 || Size == 0) {
+		return false;
+	}
+
+	uint64_t Offset = Allocator_.Allocate(Size, Alignment_);
+	if (Offset == FreeListAllocator::InvalidOffset) {
+		if (!Grow(Allocator_.GetCapacity() + Size + Alignment_)) {
+			return false;
+		}
+		Offset = Allocator_.Allocate(Size, Alignment_);
+	}
+
+	if (Offset == FreeListAllocator::InvalidOffset) {
+		LOG_ERROR << "Material buffer allocate " << Size << " bytes failed!";
+		return false;
+	}
+
+	OutOffset = static_cast<uint32_t>(Offset);
+	return true;
+}
+
+void GLMaterialBuffer::Free(uint32_t Offset, uint32_t Size) {
+	Allocator_.Free(Offset, Size);
+}
+
+void GLMaterialBuffer::Upload(uint32_t Offset, uint32_t Size, const void* Data) {
+	if (Buffer_ == 0 || Data == nullptr) {
+		return;
+	}
+
+	glNamedBufferSubData(Buffer_, Offset, Size, Data);
+}
+
+bool GLMaterialBuffer::Grow(uint64_t MinCapacity) {
+	uint64_t NewCapacity = Allocator_.GetCapacity() * 2;
+	while (NewCapacity < MinCapacity) {
+		NewCapacity *= 2;
+	}
+
+	// 新建Buffer并拷贝旧数据，已分配的偏移保持不变
+	GLuint NewBuffer = 0;
+	glCreateBuffers(1, &NewBuffer);
+	glNamedBufferData(NewBuffer, NewCapacity, nullptr, GL_DYNAMIC_DRAW);
+	glCopyNamedBufferSubData(Buffer_, NewBuffer, 0, 0, Allocator_.GetCapacity());
+	glDeleteBuffers(1, &Buffer_);
+
+	Buffer_ = NewBuffer;
+	Allocator_.Grow(NewCapacity);
+
+	LOG_INFO << "Material buffer grow to " << NewCapacity << " bytes.";
+	return true;
+}
@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include "Core/FreeListAllocator.h"
+
+/**
+ * 所有材质共享的大UBO。
+ * 每个材质在加载或参数变化时把std140数据块打包写入自己的子区间，
+ * 绘制时只需glBindBufferRange，不再逐次构建和上传。
+ */
+class GLMaterialBuffer {
+public:
+	static GLMaterialBuffer& Instance();
+
+public:
+	bool Initialize(uint32_t InitialSize = 64 * 1024);
+	void Destroy();
+
+	// 分配/释放一个材质数据块，偏移按GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT对齐
+	bool Allocate(uint32_t Size, uint32_t& OutOffset);
+	void Free(uint32_t Offset, uint32_t Size);
+	void Upload(uint32_t Offset, uint32_t Size, const void* Data);
+
+	GLuint GetBuffer() const { return Buffer_; }
+	uint64_t GetCapacity() const { return Allocator_.GetCapacity(); }
+	uint64_t GetUsedSize() const { return Allocator_.GetUsedSize(); }
+
+private:
+	GLMaterialBuffer();
+	bool Grow(uint64_t MinCapacity);
+
+private:
+	GLuint Buffer_;
+	GLint Alignment_;
+	FreeListAllocator Allocator_;
+};
@@ -0,0 +1,181 @@
+﻿#include "GLMaterialTable.h"
+#include "GLMaterial.h"
+#include "GLTexture.h"
+#include "GLTextureArrays.h"
+#include "RenderModuleAPI.h"
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+static_assert(sizeof(GPUMaterialEntry) == 80, "GPUMaterialEntry must match MaterialEntry in shaders.");
+
+static const GLuint MATERIAL_TABLE_SSBO_BINDING = 2;
+
+GLMaterialTable& GLMaterialTable::Instance() {
+	static GLMaterialTable MaterialTable;
+	return MaterialTable;
+}
+
+GLMaterialTable::GLMaterialTable() {
+	Buffer_ = 0;
+	Capacity_ = 0;
+	Bindless_ = false;
+}
+
+bool GLMaterialTable::Initialize(uint32_t InitialCount) {
+	Bindless_ = RENDER_BINDLESS_TEXTURES && GLAD_GL_ARB_bindless_texture;
+	GLTextureArrays::Instance().Initialize(!Bindless_ && RENDER_TEXTURE_ARRAYS);
+
+	Capacity_ = std::max(InitialCount, 1u);
+	glCreateBuffers(1, &Buffer_);
+	glNamedBufferData(Buffer_, (GLsizeiptr)Capacity_ * sizeof(GPUMaterialEntry), nullptr, GL_DYNAMIC_DRAW);
+
+	// 索引0为空项
+	const GPUMaterialEntry Empty = {};
+	glNamedBufferSubData(Buffer_, 0, sizeof(GPUMaterialEntry), &Empty);
+	Materials_.assign(1, nullptr);
+	FreeIndices_.clear();
+	DirtyIndices_.clear();
+
+	LOG_INFO << "Material table created, bindless textures " << (Bindless_ ? "enabled." : GLTextureArrays::Instance().IsEnabled()
+		? "not supported, sample persistent mips from texture arrays." : "not supported, bind textures per material.");
+	return Buffer_ != 0;
+}
+
+void GLMaterialTable::Destroy() {
+	if (Buffer_ != 0) {
+		glDeleteBuffers(1, &Buffer_);
+		Buffer_ = 0;
+	}
+	Capacity_ = 0;
+	GLTextureArrays::Instance().Destroy();
+	Materials_.clear();
+	FreeIndices_.clear();
+	DirtyIndices_.clear();
+}
+
+uint32_t GLMaterialTable::Allocate(GLMaterial* Material) {
+	if (Buffer_ == 0) {
+		return 0;
+	}
+
+	uint32_t Index = 0;
+	if (!FreeIndices_.empty()) {
+		Index = FreeIndices_.back();
+		FreeIndices_.pop_back();
+		Materials_[Index] = Material;
+	}
+	else {
+		Index = (uint32_t)Materials_.size();
+		Materials_.push_back(Material);
+	}
+
+	MarkDirty(Index);
+	return Index;
+}
+
+void GLMaterialTable::Free(uint32_t Index) {
+	if (Index == 0 || Index >= Materials_.size() || !Materials_[Index]) {
+		return;
+	}
+
+	Materials_[Index] = nullptr;
+	FreeIndices_.push_back(Index);
+	// 清空表项，释放后不再引用纹理句柄
+	MarkDirty(Index);
+}
+
+void GLMaterialTable::MarkDirty(uint32_t Index) {
+	if (Index == 0 || Index >= Materials_.size()) {
+		return;
+	}
+	DirtyIndices_.push_back(Index);
+}
+
+void GLMaterialTable::OnTextureChanged(const GLTexture* Texture) {
+	if (!Bindless_ && !GLTextureArrays::Instance().IsEnabled()) {
+		return;
+	}
+
+	for (uint32_t i = 1; i < (uint32_t)Materials_.size(); ++i) {
+		if (!Materials_[i]) {
+			continue;
+		}
+		for (const auto& [Slot, MaterialTexture] : Materials_[i]->GetTextures()) {
+			if (MaterialTexture.get() == Texture) {
+				MarkDirty(i);
+				break;
+			}
+		}
+	}
+}
+
+void GLMaterialTable::Bind() {
+	if (Buffer_ == 0) {
+		return;
+	}
+
+	if (!DirtyIndices_.empty()) {
+		std::sort(DirtyIndices_.begin(), DirtyIndices_.end());
+		DirtyIndices_.erase(std::unique(DirtyIndices_.begin(), DirtyIndices_.end()), DirtyIndices_.end());
+		if (Materials_.size() > Capacity_) {
+			Grow((uint32_t)Materials_.size());
+		}
+
+		for (uint32_t Index : DirtyIndices_) {
+			GPUMaterialEntry Entry = {};
+			if (Materials_[Index]) {
+				BuildEntry(Materials_[Index], Entry);
+			}
+			glNamedBufferSubData(Buffer_, (GLintptr)Index * sizeof(GPUMaterialEntry), sizeof(GPUMaterialEntry), &Entry);
+		}
+		DirtyIndices_.clear();
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_TABLE_SSBO_BINDING, Buffer_);
+	GLTextureArrays::Instance().Bind();
+}
+
+void GLMaterialTable::BuildEntry(const GLMaterial* Material, GPUMaterialEntry& Entry) const {
+	for (const auto& [Slot, Texture] : Material->GetTextures()) {
+		const uint32_t SlotIndex = (uint32_t)Slot;
+		if (SlotIndex >= MATERIAL_TABLE_TEXTURE_COUNT || !Texture || !Texture->IsValid()) {
+			continue;
+		}
+
+		GLTexture* SlotTexture = static_cast<GLTexture*>(Texture.get());
+		Entry.TextureMask |= 1u << SlotIndex;
+		if (Bindless_) {
+			Entry.Textures[SlotIndex] = SlotTexture->GetBindlessHandle();
+		}
+		else if (SlotTexture->IsInTextureArray()) {
+			const GLTextureArrayLayer& Layer = SlotTexture->GetArrayLayer();
+			Entry.Textures[SlotIndex] = ((uint64_t)Layer.Array << 32) | Layer.Layer;
+			Entry.TextureMask |= 1u << (MATERIAL_TABLE_ARRAY_SHIFT + SlotIndex);
+		}
+	}
+
+	if (Bindless_) {
+		Entry.TextureMask |= MATERIAL_TABLE_BINDLESS_BIT;
+	}
+}
+
+void GLMaterialTable::Grow(uint32_t MinCount) {
+	uint32_t NewCapacity = Capacity_ * 2;
+	while (NewCapacity < MinCount) {
+		NewCapacity *= 2;
+	}
+
+	// 新建Buffer并拷贝旧数据，已分配的索引保持不变
+	GLuint NewBuffer = 0;
+	glCreateBuffers(1, &NewBuffer);
+	glNamedBufferData(NewBuffer, (GLsizeiptr)NewCapacity * sizeof(GPUMaterialEntry), nullptr, GL_DYNAMIC_DRAW);
+	glCopyNamedBufferSubData(Buffer_, NewBuffer, 0, 0, (GLsizeiptr)Capacity_ * sizeof(GPUMaterialEntry));
+	glDeleteBuffers(1, &Buffer_);
+
+	Buffer_ = NewBuffer;
+	Capacity_ = NewCapacity;
+
+	LOG_INFO << "Material table grow to " << NewCapacity << " entries.";
+}
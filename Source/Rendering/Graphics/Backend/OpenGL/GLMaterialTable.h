@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include <cstdint>
+#include <vector>
+
+class GLMaterial;
+class GLTexture;
+
+#define MATERIAL_TABLE_TEXTURE_COUNT 8
+// TextureMask最高位表示纹理以无绑定句柄提供
+#define MATERIAL_TABLE_BINDLESS_BIT (1u << 31)
+// TextureMask从该位起第i位表示槽位i从纹理数组采样
+#define MATERIAL_TABLE_ARRAY_SHIFT 8
+
+// 与Shader中MaterialEntry(std430)布局一致
+struct GPUMaterialEntry {
+	uint64_t Textures[MATERIAL_TABLE_TEXTURE_COUNT];   // 按TextureSlot排列的无绑定纹理句柄，或低32位为层、高32位为数组的纹理数组位置
+	uint32_t TextureMask;                              // 第i位表示槽位i有纹理
+	uint32_t Padding[3];
+};
+
+/**
+ * GPU材质表，每个材质占一项，绘制时Shader按逐绘制数据中的材质索引查表。
+ * 支持ARB_bindless_texture时表中保存常驻的纹理句柄，切换材质不再绑定纹理；
+ * 不支持时只驻留常驻Mip的纹理由表中记录的纹理数组位置采样（见GLTextureArrays），
+ * 换入了更高Mip或放不进数组的纹理仍按槽位绑定到纹理单元。
+ * 索引0保留为没有纹理的空项。
+ */
+class GLMaterialTable {
+public:
+	static GLMaterialTable& Instance();
+
+public:
+	bool Initialize(uint32_t InitialCount = 256);
+	void Destroy();
+
+	bool IsBindless() const { return Bindless_; }
+
+	uint32_t Allocate(GLMaterial* Material);
+	void Free(uint32_t Index);
+	// 材质纹理变化时标记，绘制前统一上传
+	void MarkDirty(uint32_t Index);
+	// 纹理重新分配存储后句柄失效，或进出纹理数组，更新引用它的材质
+	void OnTextureChanged(const GLTexture* Texture);
+
+	// 上传变化的表项并绑定到Shader
+	void Bind();
+
+	uint32_t GetMaterialCount() const { return (uint32_t)(Materials_.size() - FreeIndices_.size()) - 1; }
+
+private:
+	GLMaterialTable();
+	void Grow(uint32_t MinCount);
+	void BuildEntry(const GLMaterial* Material, GPUMaterialEntry& Entry) const;
+
+private:
+	GLuint Buffer_;
+	uint32_t Capacity_;
+	bool Bindless_;
+
+	// 按索引存放，空闲项为nullptr
+	std::vector<GLMaterial*> Materials_;
+	std::vector<uint32_t> FreeIndices_;
+	std::vector<uint32_t> DirtyIndices_;
+};
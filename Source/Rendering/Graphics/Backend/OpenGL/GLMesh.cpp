@@ -4,21 +4,29 @@
 #include "Resource/Manager/ResourceManager.h"
 #include <Logger.hpp>
 #include "Renderer/Renderer.h"
+#include <cstring>
 
 GLMesh::GLMesh(const MeshDesc& AssetDesc) {
+	IsLoaded_ = false;
 	if (!Load(AssetDesc)) {
 		return;
 	}
 }
 
+GLMesh::GLMesh(MeshDesc&& AssetDesc) {
+	IsLoaded_ = false;
+	if (!Load(std::move(AssetDesc))) {
+		return;
+	}
+}
+
 GLMesh::~GLMesh() {
 	Unload();
 }
 
 void GLMesh::Bind() const {
 	if (IsLoaded_) {
-		glBindVertexArray(VAO_);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
+		GLMeshHeap::Instance(Format_).Bind();
 	}
 }
 
@@ -29,6 +37,11 @@ void GLMesh::Unbind() const {
 }
 
 bool GLMesh::Load(const struct MeshDesc& AssetDesc) {
+	MeshDesc Desc = AssetDesc;
+	return Load(std::move(Desc));
+}
+
+bool GLMesh::Load(struct MeshDesc&& AssetDesc) {
 	// 基础信息
 	Name_ = AssetDesc.Name;
 
@@ -50,75 +63,142 @@ bool GLMesh::Load(const struct MeshDesc& AssetDesc) {
 		Materials_.push_back(Mat);
 	}
 
-	// 顶点数据
-	Vertices_ = AssetDesc.Vertices;
-	Indices_ = AssetDesc.Indices;
-	SubMeshes_ = AssetDesc.SubMeshes;
-	if (Vertices_.size() == 0 || Indices_.size() == 0 || SubMeshes_.size() == 0) {
-		LOG_ERROR << "Invalid vertex data.";
-		return false;
+	Format_ = AssetDesc.Format;
+	PositionScale_ = AssetDesc.PositionScale;
+	PositionBias_ = AssetDesc.PositionBias;
+	SubMeshes_ = std::move(AssetDesc.SubMeshes);
+	LODs_ = std::move(AssetDesc.LODs);
+	Residency_ = AssetDesc.Residency;
+
+	if (AssetDesc.HasDataView()) {
+		// 外部数据视图已是目标格式，直接从视图上传，不做逐顶点转换
+		VertexCount_ = AssetDesc.ViewVertexCount;
+		IndexCount_ = AssetDesc.ViewIndexCount;
+		if (VertexCount_ == 0 || IndexCount_ == 0 || SubMeshes_.size() == 0) {
+			LOG_ERROR << "Invalid vertex data.";
+			return false;
+		}
+		if (!Setup(AssetDesc.VertexView, AssetDesc.IndexView)) {
+			LOG_ERROR << "Upload mesh '" << Name_ << "' failed.";
+			return false;
+		}
+
+		// 视图只在加载期间有效，需要CPU副本时复制一份
+		if (Residency_ == MeshResidency::eKeepCPUData) {
+			const uint8_t* VertexBytes = (const uint8_t*)AssetDesc.VertexView;
+			if (Format_ == VertexFormat::eStandard) {
+				Vertices_.resize(VertexCount_);
+				memcpy(static_cast<void*>(Vertices_.data()), VertexBytes, (size_t)VertexCount_ * sizeof(Vertex));
+			}
+			else {
+				PackedVertices_.assign(VertexBytes, VertexBytes + (size_t)VertexCount_ * GetVertexStride());
+			}
+			Indices_.assign(AssetDesc.IndexView, AssetDesc.IndexView + IndexCount_);
+		}
+	}
+	else {
+		// 顶点数据，直接接管描述中的数组
+		if (Format_ == VertexFormat::eStandard) {
+			Vertices_ = std::move(AssetDesc.Vertices);
+		}
+		else if (!AssetDesc.PackedVertices.empty()) {
+			PackedVertices_ = std::move(AssetDesc.PackedVertices);
+		}
+		else {
+			// 只提供了标准顶点时在这里打包
+			VertexPacker::PackVertices(Format_, AssetDesc.Vertices, PackedVertices_, PositionScale_, PositionBias_);
+			std::vector<Vertex>().swap(AssetDesc.Vertices);
+		}
+		Indices_ = std::move(AssetDesc.Indices);
+		if (!HasCPUData() || SubMeshes_.size() == 0 || PackedVertices_.size() % GetVertexStride() != 0) {
+			LOG_ERROR << "Invalid vertex data.";
+			return false;
+		}
+
+		VertexCount_ = Format_ == VertexFormat::eStandard ? (uint32_t)Vertices_.size() : (uint32_t)(PackedVertices_.size() / GetVertexStride());
+		IndexCount_ = (uint32_t)Indices_.size();
+		const void* VertexData = Format_ == VertexFormat::eStandard ? (const void*)Vertices_.data() : (const void*)PackedVertices_.data();
+		if (!Setup(VertexData, Indices_.data())) {
+			LOG_ERROR << "Upload mesh '" << Name_ << "' failed.";
+			return false;
+		}
 	}
 
-	Setup();
+	// 局部空间包围盒，描述中没有时由顶点计算
+	Bounds_ = FBoundingBox(AssetDesc.BoundsMin, AssetDesc.BoundsMax);
+	if (!Bounds_.IsValid()) {
+		if (Format_ == VertexFormat::eStandard) {
+			for (const Vertex& V : Vertices_) {
+				Bounds_.Expand(V.position);
+			}
+		}
+		else {
+			// 量化范围即位置范围
+			Bounds_ = FBoundingBox(PositionBias_, PositionBias_ + PositionScale_);
+		}
+	}
 
-	LOG_DEBUG << "Mesh '" << Name_ << "' loaded.";
+	// 上传后GPU端已有完整数据，默认不再保留CPU副本
+	if (Residency_ == MeshResidency::eGPUOnly) {
+		DropCPUData();
+	}
+
+	LOG_DEBUG << "Mesh '" << Name_ << "' loaded, " << VertexCount_ << " vertices ("
+		<< VertexPacker::GetFormatName(Format_) << ", " << GetVertexStride() << " bytes), "
+		<< IndexCount_ << " indices, CPU copy " << (HasCPUData() ? "kept." : "released.");
 	IsLoaded_ = true;
 	IsValid_ = true;
 	return true;
 }
 
-void GLMesh::Setup(){
-	glGenVertexArrays(1, &VAO_);
-	glGenBuffers(1, &VBO_);
-	glGenBuffers(1, &EBO_);
-
-	glBindVertexArray(VAO_);
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-	glBufferData(GL_ARRAY_BUFFER, Vertices_.size() * sizeof(Vertex),
-		Vertices_.data(), GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices_.size() * sizeof(unsigned int),
-		Indices_.data(), GL_STATIC_DRAW);
-
-	// Position
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+bool GLMesh::Setup(const void* VertexData, const uint32_t* IndexData){
+	// 上传到对应顶点格式的共享Mesh Buffer，顶点格式由共享VAO描述
+	GLMeshHeap& MeshHeap = GLMeshHeap::Instance(Format_);
+	// 非标准格式的堆按需创建
+	if (!MeshHeap.IsInitialized() && !MeshHeap.Initialize(1 << 18, 1 << 20)) {
+		return false;
+	}
+	if (!MeshHeap.Allocate(VertexCount_, IndexCount_, Range_)) {
+		return false;
+	}
 
-	// Normal
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, normal));
+	MeshHeap.Upload(Range_, VertexData, IndexData);
+	return true;
+}
 
-	// TexCoord
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, texCoord));
+bool GLMesh::ReadbackCPUData() {
+	if (!IsLoaded_) {
+		return false;
+	}
 
-	// Tangent
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		(void*)offsetof(Vertex, tangent));
+	// 读回需要图形上下文，在渲染线程执行
+	RenderThread::Instance().ExecuteAndWait([this]() {
+		void* VertexData = nullptr;
+		if (Format_ == VertexFormat::eStandard) {
+			Vertices_.resize(VertexCount_);
+			VertexData = Vertices_.data();
+		}
+		else {
+			PackedVertices_.resize((size_t)VertexCount_ * GetVertexStride());
+			VertexData = PackedVertices_.data();
+		}
+		Indices_.resize(IndexCount_);
+		GLMeshHeap::Instance(Format_).Download(Range_, VertexData, Indices_.data());
+	});
 
-	glBindVertexArray(0);
+	LOG_DEBUG << "Mesh '" << Name_ << "' read back CPU copy from GPU.";
+	return true;
 }
 
 void GLMesh::Unload() {
-	for (auto& Material : Materials_) {
-		Material.reset();
-	}
+	Materials_.clear();
 
+	// 归还共享Mesh Buffer中的区间
 	if (IsLoaded_) {
-		glDeleteVertexArrays(1, &VAO_);
-		VAO_ = NULL;
-
-		glDeleteBuffers(1, &VBO_);
-		VBO_ = NULL;
-
-		glDeleteBuffers(1, &EBO_);
-		EBO_ = NULL;
+		GLMeshHeap::Instance(Format_).Free(Range_);
+		IsLoaded_ = false;
 	}
+	DropCPUData();
 
 	LOG_DEBUG << "Mesh '" << Name_ << "' unloaded.";
 }
@@ -2,24 +2,33 @@
 
 #include "glad/glad.h"
 #include "Resource/IMesh.h"
+#include "GLMeshHeap.h"
 
 class GLMesh : public IMesh {
 public:
 	GLMesh(const struct MeshDesc& AssetDesc);
+	GLMesh(struct MeshDesc&& AssetDesc);
 	virtual ~GLMesh();
 
 public:
 	virtual bool Load(const struct MeshDesc& AssetDesc) override;
+	virtual bool Load(struct MeshDesc&& AssetDesc) override;
 	virtual void Unload() override;
 
 	virtual void Bind() const override;
 	virtual void Unbind() const override;
 
+	// 在共享Mesh Buffer中的位置
+	const GLMeshRange& GetRange() const { return Range_; }
+	uint32_t GetBaseVertex() const { return Range_.VertexOffset; }
+	uint32_t GetBaseIndex() const { return Range_.IndexOffset; }
+
 protected:
-	void Setup();
+	bool Setup(const void* VertexData, const uint32_t* IndexData);
+	virtual bool ReadbackCPUData() override;
 
 private:
-	GLuint VAO_, VBO_, EBO_;
+	GLMeshRange Range_;
 	bool IsLoaded_;
 
 };
\ No newline at end of file
@@ -0,0 +1,224 @@
+﻿#include "GLMeshHeap.h"
+#include <Logger.hpp>
+
+static const GLuint VERTEX_BUFFER_BINDING = 0;
+
+GLMeshHeap& GLMeshHeap::Instance(VertexFormat Format) {
+	static GLMeshHeap MeshHeaps[] = {
+		GLMeshHeap(VertexFormat::eStandard),
+		GLMeshHeap(VertexFormat::eCompact),
+		GLMeshHeap(VertexFormat::eCompactQuantized)
+	};
+	static_assert(sizeof(MeshHeaps) / sizeof(MeshHeaps[0]) == (size_t)VertexFormat::eCount, "Missing mesh heap.");
+
+	return MeshHeaps[(size_t)Format];
+}
+
+GLMeshHeap::GLMeshHeap(VertexFormat Format) {
+	VAO_ = 0;
+	VertexBuffer_ = 0;
+	IndexBuffer_ = 0;
+	Format_ = Format;
+	VertexStride_ = VertexLayout::GetStride(Format);
+}
+
+static void SetupAttribute(GLuint VAO, const VertexAttribute& Attribute) {
+	glEnableVertexArrayAttrib(VAO, Attribute.Location);
+	switch (Attribute.Type)
+	{
+	case VertexAttributeType::eFloat32:
+		glVertexArrayAttribFormat(VAO, Attribute.Location, Attribute.Components, GL_FLOAT, GL_FALSE, Attribute.Offset);
+		break;
+	case VertexAttributeType::eFloat16:
+		glVertexArrayAttribFormat(VAO, Attribute.Location, Attribute.Components, GL_HALF_FLOAT, GL_FALSE, Attribute.Offset);
+		break;
+	case VertexAttributeType::eSNorm16:
+		glVertexArrayAttribFormat(VAO, Attribute.Location, Attribute.Components, GL_SHORT, GL_TRUE, Attribute.Offset);
+		break;
+	case VertexAttributeType::eUNorm16:
+		glVertexArrayAttribFormat(VAO, Attribute.Location, Attribute.Components, GL_UNSIGNED_SHORT, GL_TRUE, Attribute.Offset);
+		break;
+	case VertexAttributeType::eSNorm10_10_10_2:
+		glVertexArrayAttribFormat(VAO, Attribute.Location, 4, GL_INT_2_10_10_10_REV, GL_TRUE, Attribute.Offset);
+		break;
+	}
+	glVertexArrayAttribBinding(VAO, Attribute.Location, VERTEX_BUFFER_BINDING);
+}
+
+bool GLMeshHeap::Initialize(uint32_t VertexCapacity, uint32_t IndexCapacity) {
+	VertexAllocator_.Reset(VertexCapacity);
+	IndexAllocator_.Reset(IndexCapacity);
+
+	glCreateBuffers(1, &VertexBuffer_);
+	glNamedBufferData(VertexBuffer_, (GLsizeiptr)VertexCapacity * VertexStride_, nullptr, GL_STATIC_DRAW);
+	glCreateBuffers(1, &IndexBuffer_);
+	glNamedBufferData(IndexBuffer_, (GLsizeiptr)IndexCapacity * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+
+	// 顶点格式与Buffer分离，扩容时只需要重新绑定Buffer
+	glCreateVertexArrays(1, &VAO_);
+	for (const VertexAttribute& Attribute : VertexLayout::Get(Format_).Attributes) {
+		SetupAttribute(VAO_, Attribute);
+	}
+
+	glVertexArrayVertexBuffer(VAO_, VERTEX_BUFFER_BINDING, VertexBuffer_, 0, VertexStride_);
+	glVertexArrayElementBuffer(VAO_, IndexBuffer_);
+
+	LOG_DEBUG << "Mesh heap (" << VertexPacker::GetFormatName(Format_) << ") created, vertices: "
+		<< VertexCapacity << " indices: " << IndexCapacity;
+	return VAO_ != 0;
+}
+
+void GLMeshHeap::Destroy() {
+	if (VAO_ != 0) {
+		glDeleteVertexArrays(1, &VAO_);
+		VAO_ = 0;
+	}
+	if (VertexBuffer_ != 0) {
+		glDeleteBuffers(1, &VertexBuffer_);
+		VertexBuffer_ = 0;
+	}
+	if (IndexBuffer_ != 0) {
+		glDeleteBuffers(1, &IndexBuffer_);
+		IndexBuffer_ = 0;
+	}
+
+	VertexAllocator_.Reset(0);
+	IndexAllocator_.Reset(0);
+}
+
+bool GLMeshHeap::Allocate(uint32_t VertexCount, uint32_t IndexCount, GLMeshRange& OutRange) {
+	if (VAO_ == 0 || VertexCount == 0 || IndexCount == 0) {
+		return false;
+	}
+
+	uint64_t VertexOffset = VertexAllocator_.Allocate(VertexCount);
+	if (VertexOffset == FreeListAllocator::InvalidOffset) {
+		if (!GrowVertexBuffer(VertexAllocator_.GetCapacity() + VertexCount)) {
+			return false;
+		}
+		VertexOffset = VertexAllocator_.Allocate(VertexCount);
+	}
+
+	uint64_t IndexOffset = IndexAllocator_.Allocate(IndexCount);
+	if (IndexOffset == FreeListAllocator::InvalidOffset) {
+		if (!GrowIndexBuffer(IndexAllocator_.GetCapacity() + IndexCount)) {
+			VertexAllocator_.Free(VertexOffset, VertexCount);
+			return false;
+		}
+		IndexOffset = IndexAllocator_.Allocate(IndexCount);
+	}
+
+	if (VertexOffset == FreeListAllocator::InvalidOffset || IndexOffset == FreeListAllocator::InvalidOffset) {
+		LOG_ERROR << "Mesh heap allocate failed, vertices: " << VertexCount << " indices: " << IndexCount;
+		VertexAllocator_.Free(VertexOffset, VertexCount);
+		IndexAllocator_.Free(IndexOffset, IndexCount);
+		return false;
+	}
+
+	OutRange.VertexOffset = (uint32_t)VertexOffset;
+	OutRange.VertexCount = VertexCount;
+	OutRange.IndexOffset = (uint32_t)IndexOffset;
+	OutRange.IndexCount = IndexCount;
+	return true;
+}
+
+void GLMeshHeap::Free(GLMeshRange& Range) {
+	// 堆已销毁（例如退出时）则不再回收
+	if (VAO_ == 0 || Range.VertexCount == 0) {
+		return;
+	}
+
+	VertexAllocator_.Free(Range.VertexOffset, Range.VertexCount);
+	IndexAllocator_.Free(Range.IndexOffset, Range.IndexCount);
+	Range = GLMeshRange();
+}
+
+void GLMeshHeap::Upload(const GLMeshRange& Range, const void* Vertices, const uint32_t* Indices) {
+	if (Vertices) {
+		glNamedBufferSubData(VertexBuffer_, (GLintptr)Range.VertexOffset * VertexStride_,
+			(GLsizeiptr)Range.VertexCount * VertexStride_, Vertices);
+	}
+	if (Indices) {
+		glNamedBufferSubData(IndexBuffer_, (GLintptr)Range.IndexOffset * sizeof(uint32_t),
+			(GLsizeiptr)Range.IndexCount * sizeof(uint32_t), Indices);
+	}
+}
+
+void GLMeshHeap::Download(const GLMeshRange& Range, void* Vertices, uint32_t* Indices) const {
+	if (Vertices) {
+		glGetNamedBufferSubData(VertexBuffer_, (GLintptr)Range.VertexOffset * VertexStride_,
+			(GLsizeiptr)Range.VertexCount * VertexStride_, Vertices);
+	}
+	if (Indices) {
+		glGetNamedBufferSubData(IndexBuffer_, (GLintptr)Range.IndexOffset * sizeof(uint32_t),
+			(GLsizeiptr)Range.IndexCount * sizeof(uint32_t), Indices);
+	}
+}
+
+void GLMeshHeap::Bind() const {
+	glBindVertexArray(VAO_);
+}
+
+// 扩容后末尾新增的空闲块至少能容纳本次请求
+bool GLMeshHeap::GrowVertexBuffer(uint64_t MinCapacity) {
+	const uint64_t OldCapacity = VertexAllocator_.GetCapacity();
+	uint64_t NewCapacity = OldCapacity * 2;
+	while (NewCapacity < MinCapacity) {
+		NewCapacity *= 2;
+	}
+
+	VertexBuffer_ = ReallocateBuffer(VertexBuffer_, OldCapacity * VertexStride_, NewCapacity * VertexStride_);
+	VertexAllocator_.Grow(NewCapacity);
+	glVertexArrayVertexBuffer(VAO_, VERTEX_BUFFER_BINDING, VertexBuffer_, 0, VertexStride_);
+
+	LOG_INFO << "Mesh heap (" << VertexPacker::GetFormatName(Format_) << ") vertex buffer grow to " << NewCapacity << " vertices.";
+	LogStats();
+	return VertexBuffer_ != 0;
+}
+
+bool GLMeshHeap::GrowIndexBuffer(uint64_t MinCapacity) {
+	const uint64_t OldCapacity = IndexAllocator_.GetCapacity();
+	uint64_t NewCapacity = OldCapacity * 2;
+	while (NewCapacity < MinCapacity) {
+		NewCapacity *= 2;
+	}
+
+	IndexBuffer_ = ReallocateBuffer(IndexBuffer_, OldCapacity * sizeof(uint32_t), NewCapacity * sizeof(uint32_t));
+	IndexAllocator_.Grow(NewCapacity);
+	glVertexArrayElementBuffer(VAO_, IndexBuffer_);
+
+	LOG_INFO << "Mesh heap (" << VertexPacker::GetFormatName(Format_) << ") index buffer grow to " << NewCapacity << " indices.";
+	LogStats();
+	return IndexBuffer_ != 0;
+}
+
+GeometryMemoryStats GLMeshHeap::GetStats() const {
+	GeometryMemoryStats Stats;
+	Stats.VertexCapacityBytes = VertexAllocator_.GetCapacity() * VertexStride_;
+	Stats.VertexUsedBytes = VertexAllocator_.GetUsedSize() * VertexStride_;
+	Stats.IndexCapacityBytes = IndexAllocator_.GetCapacity() * sizeof(uint32_t);
+	Stats.IndexUsedBytes = IndexAllocator_.GetUsedSize() * sizeof(uint32_t);
+	Stats.AllocationCount = VertexAllocator_.GetAllocationCount();
+	Stats.FreeBlockCount = VertexAllocator_.GetFreeBlockCount() + IndexAllocator_.GetFreeBlockCount();
+	Stats.VertexFragmentation = VertexAllocator_.GetFragmentation();
+	Stats.IndexFragmentation = IndexAllocator_.GetFragmentation();
+	return Stats;
+}
+
+void GLMeshHeap::LogStats() const {
+	const GeometryMemoryStats Stats = GetStats();
+	LOG_INFO << "Mesh heap (" << VertexPacker::GetFormatName(Format_) << "): " << Stats.AllocationCount << " meshes, vertex "
+		<< Stats.VertexUsedBytes / 1024 << "/" << Stats.VertexCapacityBytes / 1024 << " KB (frag "
+		<< Stats.VertexFragmentation * 100.0f << "%), index "
+		<< Stats.IndexUsedBytes / 1024 << "/" << Stats.IndexCapacityBytes / 1024 << " KB (frag "
+		<< Stats.IndexFragmentation * 100.0f << "%), free blocks " << Stats.FreeBlockCount;
+}
+
+GLuint GLMeshHeap::ReallocateBuffer(GLuint OldBuffer, uint64_t OldSize, uint64_t NewSize) {
+	GLuint NewBuffer = 0;
+	glCreateBuffers(1, &NewBuffer);
+	glNamedBufferData(NewBuffer, (GLsizeiptr)NewSize, nullptr, GL_STATIC_DRAW);
+	glCopyNamedBufferSubData(OldBuffer, NewBuffer, 0, 0, (GLsizeiptr)OldSize);
+	glDeleteBuffers(1, &OldBuffer);
+	return NewBuffer;
+}
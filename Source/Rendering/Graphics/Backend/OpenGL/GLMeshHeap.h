@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include "Core/FreeListAllocator.h"
+#include "Graphics/RenderStats.h"
+#include "Resource/VertexFormat.h"
+#include <cstdint>
+
+// Mesh在共享Buffer中的区间，偏移以元素个数计
+struct GLMeshRange {
+	uint32_t VertexOffset = 0;
+	uint32_t VertexCount = 0;
+	uint32_t IndexOffset = 0;
+	uint32_t IndexCount = 0;
+};
+
+/**
+ * 所有Mesh共享的顶点/索引Buffer以及VAO。
+ * 各Mesh只占用其中一段区间，绘制时通过baseVertex/firstIndex定位，
+ * 因此不同Mesh之间无需切换VAO，也可以合并为一次MultiDrawIndirect。
+ * 区间由空闲链表分配，Mesh卸载后可被复用，空间不足时整体扩容。
+ * 每种顶点格式各有一个堆，VAO的属性格式由VertexLayout描述。
+ */
+class GLMeshHeap {
+public:
+	static GLMeshHeap& Instance(VertexFormat Format = VertexFormat::eStandard);
+
+public:
+	bool Initialize(uint32_t VertexCapacity = 1 << 20, uint32_t IndexCapacity = 1 << 22);
+	void Destroy();
+	bool IsInitialized() const { return VAO_ != 0; }
+	VertexFormat GetFormat() const { return Format_; }
+
+	bool Allocate(uint32_t VertexCount, uint32_t IndexCount, GLMeshRange& OutRange);
+	void Free(GLMeshRange& Range);
+	void Upload(const GLMeshRange& Range, const void* Vertices, const uint32_t* Indices);
+	// 读回区间数据（同步，仅用于按需恢复CPU副本）
+	void Download(const GLMeshRange& Range, void* Vertices, uint32_t* Indices) const;
+
+	void Bind() const;
+	GLuint GetVAO() const { return VAO_; }
+
+	GeometryMemoryStats GetStats() const;
+	void LogStats() const;
+
+private:
+	GLMeshHeap(VertexFormat Format);
+	bool GrowVertexBuffer(uint64_t MinCapacity);
+	bool GrowIndexBuffer(uint64_t MinCapacity);
+	static GLuint ReallocateBuffer(GLuint OldBuffer, uint64_t OldSize, uint64_t NewSize);
+
+private:
+	GLuint VAO_;
+	GLuint VertexBuffer_;
+	GLuint IndexBuffer_;
+
+	VertexFormat Format_;
+	uint32_t VertexStride_;
+	// 以元素个数为单位的区间分配
+	FreeListAllocator VertexAllocator_;
+	FreeListAllocator IndexAllocator_;
+};
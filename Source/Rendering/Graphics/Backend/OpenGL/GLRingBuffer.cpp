@@ -0,0 +1,150 @@
+﻿#include "GLRingBuffer.h"
+#include "Core/FreeListAllocator.h"
+#include <Logger.hpp>
+
+#include <chrono>
+
+GLRingBuffer::GLRingBuffer() {
+	Buffer_ = 0;
+	MappedData_ = nullptr;
+	FrameSize_ = 0;
+	FrameCount_ = 0;
+	FrameIndex_ = 0;
+	Head_ = 0;
+	IsFrameActive_ = false;
+}
+
+GLRingBuffer::~GLRingBuffer() {
+	Destroy();
+}
+
+bool GLRingBuffer::Initialize(uint64_t FrameSize, uint32_t FrameCount) {
+	FrameSize_ = FrameSize;
+	FrameCount_ = FrameCount;
+	FrameIndex_ = 0;
+	Head_ = 0;
+	IsFrameActive_ = false;
+	Fences_.assign(FrameCount, nullptr);
+
+	const uint64_t TotalSize = FrameSize_ * FrameCount_;
+	const GLbitfield Flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	// 不可变存储，整个生命周期内保持映射
+	glCreateBuffers(1, &Buffer_);
+	glNamedBufferStorage(Buffer_, TotalSize, nullptr, Flags);
+	MappedData_ = (uint8_t*)glMapNamedBufferRange(Buffer_, 0, TotalSize, Flags);
+	if (!MappedData_) {
+		LOG_ERROR << "Map persistent ring buffer failed!";
+		Destroy();
+		return false;
+	}
+
+	Stats_ = TransientBufferStats();
+	Stats_.FrameCapacity = FrameSize_;
+
+	LOG_DEBUG << "Ring buffer created, " << FrameCount_ << " x " << FrameSize_ << " bytes.";
+	return true;
+}
+
+void GLRingBuffer::Destroy() {
+	for (GLsync& Fence : Fences_) {
+		if (Fence) {
+			glDeleteSync(Fence);
+			Fence = nullptr;
+		}
+	}
+
+	if (Buffer_ != 0) {
+		if (MappedData_) {
+			glUnmapNamedBuffer(Buffer_);
+			MappedData_ = nullptr;
+		}
+		glDeleteBuffers(1, &Buffer_);
+		Buffer_ = 0;
+	}
+}
+
+void GLRingBuffer::BeginFrame() {
+	if (!MappedData_ || IsFrameActive_) {
+		return;
+	}
+
+	WaitFence(Fences_[FrameIndex_]);
+	Head_ = 0;
+	IsFrameActive_ = true;
+}
+
+void GLRingBuffer::EndFrame() {
+	if (!MappedData_ || !IsFrameActive_) {
+		return;
+	}
+
+	Stats_.FrameBytes = Head_;
+	Stats_.PeakFrameBytes = Head_ > Stats_.PeakFrameBytes ? Head_ : Stats_.PeakFrameBytes;
+
+	if (Fences_[FrameIndex_]) {
+		glDeleteSync(Fences_[FrameIndex_]);
+	}
+	Fences_[FrameIndex_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	FrameIndex_ = (FrameIndex_ + 1) % FrameCount_;
+	Head_ = 0;
+	IsFrameActive_ = false;
+}
+
+TransientAllocation GLRingBuffer::Allocate(uint64_t Size, uint64_t Alignment) {
+	TransientAllocation Allocation;
+	if (!MappedData_ || Size == 0) {
+		return Allocation;
+	}
+
+	if (!IsFrameActive_) {
+		BeginFrame();
+	}
+
+	const uint64_t Offset = FreeListAllocator::AlignUp(Head_, Alignment);
+	if (Offset + Size > FrameSize_) {
+		Stats_.OverflowCount++;
+		return Allocation;
+	}
+
+	Head_ = Offset + Size;
+
+	const uint64_t BufferOffset = FrameIndex_ * FrameSize_ + Offset;
+	Allocation.Data = MappedData_ + BufferOffset;
+	Allocation.Buffer = Buffer_;
+	Allocation.Offset = BufferOffset;
+	Allocation.Size = Size;
+	return Allocation;
+}
+
+void GLRingBuffer::WaitFence(GLsync& Fence) {
+	if (!Fence) {
+		return;
+	}
+
+	auto Start = std::chrono::high_resolution_clock::now();
+	Stats_.FenceWaits++;
+
+	// 先不阻塞地查询一次，未完成才计为Stall
+	GLenum Result = glClientWaitSync(Fence, 0, 0);
+	if (Result == GL_TIMEOUT_EXPIRED) {
+		Stats_.FenceStalls++;
+		do {
+			Result = glClientWaitSync(Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		} while (Result == GL_TIMEOUT_EXPIRED);
+	}
+
+	if (Result == GL_WAIT_FAILED) {
+		LOG_ERROR << "Wait ring buffer fence failed!";
+	}
+
+	glDeleteSync(Fence);
+	Fence = nullptr;
+
+	auto End = std::chrono::high_resolution_clock::now();
+	double WaitMs = std::chrono::duration<double, std::milli>(End - Start).count();
+	Stats_.LastWaitMs = WaitMs;
+	Stats_.TotalWaitMs += WaitMs;
+	Stats_.MaxWaitMs = WaitMs > Stats_.MaxWaitMs ? WaitMs : Stats_.MaxWaitMs;
+}
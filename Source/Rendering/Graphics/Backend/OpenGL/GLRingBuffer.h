@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include "Graphics/TransientAllocation.h"
+
+#include <vector>
+
+/**
+ * 持久映射的环形Buffer（GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT）。
+ * Buffer被划分为多个帧区域，每帧结束时插入Fence，
+ * 再次使用某个区域前等待对应Fence，保证GPU已经读取完毕。
+ */
+class GLRingBuffer {
+public:
+	GLRingBuffer();
+	~GLRingBuffer();
+
+public:
+	bool Initialize(uint64_t FrameSize, uint32_t FrameCount = 3);
+	void Destroy();
+
+	// 开始新的一帧，等待当前区域上一次使用的Fence（未调用时由首次分配触发）
+	void BeginFrame();
+	// 结束当前帧，插入Fence并切换到下一个区域
+	void EndFrame();
+
+	TransientAllocation Allocate(uint64_t Size, uint64_t Alignment);
+
+	GLuint GetBuffer() const { return Buffer_; }
+	const TransientBufferStats& GetStats() const { return Stats_; }
+
+private:
+	void WaitFence(GLsync& Fence);
+
+private:
+	GLuint Buffer_;
+	uint8_t* MappedData_;
+
+	uint64_t FrameSize_;
+	uint32_t FrameCount_;
+	uint32_t FrameIndex_;
+	uint64_t Head_;
+	bool IsFrameActive_;
+
+	std::vector<GLsync> Fences_;
+	TransientBufferStats Stats_;
+};
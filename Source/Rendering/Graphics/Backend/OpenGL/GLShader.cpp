@@ -1,16 +1,50 @@
 ﻿#include "GLShader.h"
 #include "GLMaterial.h"
+#include "GLShaderCompiler.h"
 #include "Platform/File/JsonObject.h"
 #include "Resource/Manager/ResourceManager.h"
+#include "Resource/Manager/DerivedDataCache.h"
+#include "Resource/Manager/Loader/AssetSerializer.h"
 #include <Logger.hpp>
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+static double GetElapsedMs(const std::chrono::high_resolution_clock::time_point& StartTime) {
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - StartTime).count();
+}
+
+// 程序二进制只在同一驱动和显卡上有效，驱动信息参与缓存键
+static const std::string& GetDriverString() {
+	static const std::string Driver = [] {
+		std::string Result;
+		for (GLenum Name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+			const GLubyte* Value = glGetString(Name);
+			Result += Value ? (const char*)Value : "";
+			Result += '|';
+		}
+		return Result;
+	}();
+	return Driver;
+}
+
+static bool IsProgramBinarySupported() {
+	GLint FormatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &FormatCount);
+	return FormatCount > 0;
+}
 
 GLShader::GLShader() {
 	ProgramID_ = NULL;
+	ProgramBinaryLength_ = 0;
+	Pending_ = false;
+	Cacheable_ = false;
+	CacheKey_ = 0;
 	Name_ = "";
 	IsValid_ = false;
 }
 
-GLShader::GLShader(const ShaderDesc& Desc) {
+GLShader::GLShader(const ShaderDesc& Desc) : GLShader() {
 	if (!Load(Desc)) {
 		return;
 	}
@@ -23,29 +57,137 @@ GLShader::~GLShader() {
 }
 
 bool GLShader::Load(const ShaderDesc& Desc) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
 	Name_ = Desc.Name;
-	for (const auto& StageDesc : Desc.Stages) {
-		// 添加阶段
-		const ShaderStage Type = StageDesc.first;
-		const std::string& Source = StageDesc.second;
-		std::string StageSource = SHADER_ASSET_PATH + Source;
 
-		if (!AddStage(StageSource, Type)) {
+	// 读取各阶段源码，按阶段顺序和驱动信息一起组成程序二进制的缓存键
+	std::map<ShaderStage, std::string> Sources;
+	for (const auto& StageDesc : Desc.Stages) {
+		File SourceFile(SHADER_ASSET_PATH + StageDesc.second);
+		if (!SourceFile.IsExist()) {
+			LOG_WARN << "Shader file '" << StageDesc.second << "' not exist!";
 			continue;
 		}
+		Sources[StageDesc.first] = SourceFile.ReadBytes();
+	}
+
+	DerivedDataKey Key;
+	Key.Append((uint32_t)SHADER_PROGRAM_CACHE_VERSION);
+	Key.AppendString(GetDriverString());
+	for (const auto& [Stage, Source] : Sources) {
+		Key.Append((uint32_t)Stage);
+		Key.AppendString(Source);
 	}
 
-	// 初始化Buffer
-	glGenBuffers(1, &MaterialUBO_);
-	glBindBuffer(GL_UNIFORM_BUFFER, MaterialUBO_);
+	DerivedDataCache& Cache = DerivedDataCache::Instance();
+	const bool Cacheable = Cache.IsEnabled() && IsProgramBinarySupported();
+	if (Cacheable && LoadProgramBinary(Key.Get())) {
+		Cache.RecordHit(DerivedDataType::eShaderProgram, GetElapsedMs(StartTime));
+		Bind();
+		LOG_DEBUG << "Shader '" << Name_ << "' loaded from program binary cache.";
+		return true;
+	}
+
+	// 一次性提交所有阶段和程序，编译和链接结果在完成后再检查，避免立即阻塞
+	for (const auto& [Stage, Source] : Sources) {
+		// 添加阶段
+		if (!AddStage(Source, Stage)) {
+			continue;
+		}
+	}
 
 	// 初始化ShaderProgram
 	ProgramID_ = glCreateProgram();
 	for (auto Stage : ShaderStages_) {
 		glAttachShader(ProgramID_, Stage.second);
 	}
+	// 链接前声明需要取回程序二进制
+	if (Cacheable) {
+		glProgramParameteri(ProgramID_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
 	glLinkProgram(ProgramID_);
 
+	Cacheable_ = Cacheable;
+	CacheKey_ = Key.Get();
+	SubmitTime_ = StartTime;
+	Pending_ = true;
+	GLShaderCompiler::Instance().Submit(this);
+
+	LOG_DEBUG << "Shader '" << Name_ << "' submitted.";
+	return true;
+}
+
+bool GLShader::IsCompileComplete() const {
+	if (!Pending_ || !GLShaderCompiler::Instance().IsParallelCompileSupported()) {
+		return true;
+	}
+
+	GLint Complete = GL_FALSE;
+	glGetProgramiv(ProgramID_, GL_COMPLETION_STATUS_KHR, &Complete);
+	return Complete == GL_TRUE;
+}
+
+bool GLShader::FinishCompile() {
+	if (!Pending_) {
+		return IsValid_;
+	}
+
+	GLShaderCompiler::Instance().Remove(this);
+	Pending_ = false;
+
+	bool Success = true;
+	for (const auto& Stage : ShaderStages_) {
+		Success = CheckCompileStatus(Stage.second, Stage.first) && Success;
+	}
+	Success = Success && CheckProgramStatus();
+
+	// 包含提交后等待的帧
+	const double CompileTimeMs = GetElapsedMs(SubmitTime_);
+	if (Success) {
+		// 程序二进制大小作为显存占用的估计
+		ProgramBinaryLength_ = 0;
+		glGetProgramiv(ProgramID_, GL_PROGRAM_BINARY_LENGTH, &ProgramBinaryLength_);
+
+		// 反射Uniform，材质数据存放在共享的材质Buffer中
+		ReflectUnifromBlock();
+
+		if (Cacheable_) {
+			StoreProgramBinary(CacheKey_);
+			DerivedDataCache::Instance().RecordMiss(DerivedDataType::eShaderProgram, CompileTimeMs);
+		}
+
+		// 绑定Shader
+		Bind();
+	}
+
+	IsValid_ = Success;
+	GLShaderCompiler::Instance().RecordCompile(CompileTimeMs, Success);
+	if (Success) {
+		LOG_DEBUG << "Shader '" << Name_ << "' loaded in " << CompileTimeMs << " ms.";
+	}
+
+	// 回调中材质可能改用内建Shader，先取出等待列表
+	std::vector<GLMaterial*> Materials;
+	Materials.swap(WaitingMaterials_);
+	for (GLMaterial* Material : Materials) {
+		Material->OnShaderReady();
+	}
+	return Success;
+}
+
+bool GLShader::WaitUntilReady() {
+	return Pending_ ? FinishCompile() : IsValid_;
+}
+
+void GLShader::AddWaitingMaterial(GLMaterial* Material) {
+	WaitingMaterials_.push_back(Material);
+}
+
+void GLShader::RemoveWaitingMaterial(GLMaterial* Material) {
+	WaitingMaterials_.erase(std::remove(WaitingMaterials_.begin(), WaitingMaterials_.end(), Material), WaitingMaterials_.end());
+}
+
+bool GLShader::CheckProgramStatus() {
 	// 检测连接结果
 	GLint Success;
 	glGetProgramiv(ProgramID_, GL_LINK_STATUS, &Success);
@@ -65,19 +207,16 @@ bool GLShader::Load(const ShaderDesc& Desc) {
 		return false;
 	}
 
-	// 反射Uniform
-	ReflectUnifromBlock();
-	// 反射后可以知道BlockSize，初始化Buffer大小
-	glBufferData(GL_UNIFORM_BUFFER, MaterialLayout_.blockSize, nullptr, GL_DYNAMIC_DRAW);
-
-	// 绑定Shader
-	Bind();
-
-	LOG_DEBUG << "Shader '" << Name_ << "' loaded.";
 	return true;
 }
 
 void GLShader::Unload() {
+	if (Pending_) {
+		GLShaderCompiler::Instance().Remove(this);
+		Pending_ = false;
+	}
+	WaitingMaterials_.clear();
+
 	if (ProgramID_ != NULL) {
 		for (auto& Stage : ShaderStages_) {
 			glDetachShader(ProgramID_, Stage.second);
@@ -87,11 +226,6 @@ void GLShader::Unload() {
 		glDeleteProgram(ProgramID_);
 	}
 
-
-	if (MaterialUBO_ != NULL) {
-		glDeleteBuffers(1, &MaterialUBO_);
-	}
-
 	LOG_DEBUG << "Shader '" << Name_ << "' unloaded.";
 }
 
@@ -128,7 +262,7 @@ bool GLShader::AddStage(const std::string& source, ShaderStage stage) {
 
 	if (!CompileShader(source, shaderObj)) {
 		glDeleteShader(shaderObj);
-		LOG_ERROR << "Error compiling shader '" << source << "' Type: " << (int)stage;
+		LOG_ERROR << "Error compiling shader '" << Name_ << "' Type: " << (int)stage;
 		return false;
 	}
 
@@ -138,21 +272,18 @@ bool GLShader::AddStage(const std::string& source, ShaderStage stage) {
 
 bool GLShader::CompileShader(const std::string& source, GLuint& Obj)
 {
-	File shaderSrc(source);
-	if (!shaderSrc.IsExist()) {
-		LOG_WARN << "Shader file not exist!";
-		return false;
-	}
-
-	const std::string& context = shaderSrc.ReadBytes();
-	const char* data = context.c_str();
-	if (!data) {
+	const char* data = source.c_str();
+	if (source.empty()) {
 		return false;
 	}
 
+	// 只提交编译，结果在FinishCompile中检查
 	glShaderSource(Obj, 1, &data, NULL);
 	glCompileShader(Obj);
+	return true;
+}
 
+bool GLShader::CheckCompileStatus(GLuint Obj, ShaderStage stage) {
 	// 检查编译结果
 	GLint success;
 	glGetShaderiv(Obj, GL_COMPILE_STATUS, &success);
@@ -164,14 +295,76 @@ bool GLShader::CompileShader(const std::string& source, GLuint& Obj)
 		if (len > 0) {
 			InfoLog[len - 1] = ' ';
 		}
-		
-		LOG_ERROR << "Compile info: " << InfoLog;
+
+		LOG_ERROR << "Error compiling shader '" << Name_ << "' Type: " << (int)stage << ", compile info: " << InfoLog;
+		return false;
+	}
+
+	return true;
+}
+
+bool GLShader::LoadProgramBinary(uint64_t Key) {
+	std::vector<uint8_t> CachedData;
+	if (!DerivedDataCache::Instance().Load(DerivedDataType::eShaderProgram, Key, CachedData)) {
+		return false;
+	}
+
+	// 条目布局：反射布局 | 二进制格式 | 二进制长度 | 程序二进制
+	BinaryReader Reader(CachedData.data(), CachedData.size());
+	ShaderUniformLayout Layout;
+	uint32_t BinaryFormat = 0;
+	uint32_t BinaryLength = 0;
+	if (!AssetSerializer::ReadShaderLayout(Reader, Layout) || !Reader.Read(BinaryFormat) || !Reader.Read(BinaryLength) || BinaryLength == 0) {
+		LOG_WARN << "Corrupted program binary cache of shader '" << Name_ << "'.";
+		return false;
+	}
+
+	std::vector<uint8_t> Binary(BinaryLength);
+	if (!Reader.ReadBytes(Binary.data(), BinaryLength)) {
+		LOG_WARN << "Corrupted program binary cache of shader '" << Name_ << "'.";
+		return false;
+	}
+
+	GLuint Program = glCreateProgram();
+	glProgramBinary(Program, (GLenum)BinaryFormat, Binary.data(), (GLsizei)BinaryLength);
+
+	// 驱动拒绝二进制时（例如驱动更新后）回退到从源码编译
+	GLint Success = 0;
+	glGetProgramiv(Program, GL_LINK_STATUS, &Success);
+	if (Success == 0) {
+		glDeleteProgram(Program);
+		LOG_DEBUG << "Program binary of shader '" << Name_ << "' rejected by driver, recompiling.";
 		return false;
 	}
 
+	ProgramID_ = Program;
+	ProgramBinaryLength_ = (GLint)BinaryLength;
+	MaterialLayout_ = std::move(Layout);
 	return true;
 }
 
+void GLShader::StoreProgramBinary(uint64_t Key) {
+	if (ProgramBinaryLength_ <= 0) {
+		return;
+	}
+
+	std::vector<uint8_t> Binary(ProgramBinaryLength_);
+	GLenum BinaryFormat = 0;
+	GLsizei Length = 0;
+	glGetProgramBinary(ProgramID_, ProgramBinaryLength_, &Length, &BinaryFormat, Binary.data());
+	if (Length <= 0) {
+		return;
+	}
+
+	std::vector<uint8_t> CachedData;
+	BinaryWriter Writer(CachedData);
+	AssetSerializer::WriteShaderLayout(Writer, MaterialLayout_);
+	Writer.Write((uint32_t)BinaryFormat);
+	Writer.Write((uint32_t)Length);
+	Writer.WriteBytes(Binary.data(), (size_t)Length);
+	DerivedDataCache::Instance().Store(DerivedDataType::eShaderProgram, Key, CachedData);
+}
+
 // -------------------------------- 设置Uniform ----------------------------------
 void GLShader::SetInt(const std::string& name, int value){ glUniform1i(GetUniformLocation(name), value); }
 void GLShader::SetFloat(const std::string& name, float value){ glUniform1f(GetUniformLocation(name), value); }
@@ -182,31 +375,31 @@ void GLShader::SetVec4(const std::string& name, const FVector4& value){ glUnifor
 void GLShader::SetMat3(const std::string& name, const FMatrix3& value){ glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, value.data()); }
 void GLShader::SetMat4(const std::string& name, const FMatrix4& value) { glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, value.data()); }
 
-void GLShader::UploadMaterial(const IMaterial& Mat) {
+bool GLShader::PackMaterial(const IMaterial& Mat, std::vector<uint8_t>& OutBlock) const {
 	const ShaderUniformLayout& layout = MaterialLayout_;
+	if (layout.blockSize <= 0) {
+		return false;
+	}
 
-	// 构建 CPU 端 buffer
-	std::vector<uint8_t> buffer(layout.blockSize);
+	OutBlock.assign(layout.blockSize, 0);
 
-	// 遍历 material 的参数
-	for (auto& kv : Mat.GetUniforms())
+	// 遍历 material 的参数，写入对应的 offset
+	for (const auto& kv : Mat.GetUniforms())
 	{
-		const std::string& name = kv.first;
-		const MaterialValue& value = kv.second;
-
-		if (!layout.uniforms.count(name))
+		auto It = layout.uniforms.find(kv.first);
+		if (It == layout.uniforms.end())
 			continue;
 
-		const UniformInfo& info = layout.uniforms.at(name);
+		const UniformInfo& info = It->second;
+		const MaterialValue& value = kv.second;
 
-		// 写入对应的 offset
-		memcpy(buffer.data() + info.offset, value.data.data(), info.size);
+		// 参数数据可能小于std140对齐后的大小（例如vec3）
+		size_t CopySize = value.data.size() * sizeof(float);
+		CopySize = CopySize < (size_t)info.size ? CopySize : (size_t)info.size;
+		memcpy(OutBlock.data() + info.offset, value.data.data(), CopySize);
 	}
 
-	// 上传 GPU
-	glBindBuffer(GL_UNIFORM_BUFFER, MaterialUBO_);
-	glBufferSubData(GL_UNIFORM_BUFFER, 0, layout.blockSize, buffer.data());
-	glBindBufferBase(GL_UNIFORM_BUFFER, layout.binding, MaterialUBO_);
+	return true;
 }
 
 void GLShader::ReflectUnifromBlock() {
@@ -2,7 +2,14 @@
 #include "Resource/IShader.h"
 #include "glad/glad.h"
 
+#include <chrono>
 #include <unordered_map>
+#include <vector>
+
+// 程序二进制缓存格式版本，缓存条目布局变化时递增
+#define SHADER_PROGRAM_CACHE_VERSION 1
+
+class GLMaterial;
 
 class GLShader : public IShader {
 public:
@@ -16,6 +23,8 @@ public:
 	virtual void Unload() override;
 	virtual void Bind() override;
 	virtual void Unbind() override;
+	virtual bool IsReady() const override { return !Pending_; }
+	virtual bool WaitUntilReady() override;
 
 	// Uniform设置
 	virtual void SetInt(const std::string& name, int value) override;
@@ -25,23 +34,43 @@ public:
 	virtual void SetVec4(const std::string& name, const FVector4& value) override;
 	virtual void SetMat3(const std::string& name, const FMatrix3& value) override;
 	virtual void SetMat4(const std::string& name, const FMatrix4& value) override;
-	virtual void UploadMaterial(const IMaterial& Mat) override;
+	virtual bool PackMaterial(const IMaterial& Mat, std::vector<uint8_t>& OutBlock) const override;
 
 public:
 	uint32_t GetProgramID() const { return ProgramID_; }
+	virtual uint64_t GetGPUMemorySize() const override { return (uint64_t)ProgramBinaryLength_; }
+
+	// 异步编译，由GLShaderCompiler每帧轮询
+	bool IsCompileComplete() const;
+	bool FinishCompile();
+
+	// 编译完成后通知材质打包常量数据
+	void AddWaitingMaterial(GLMaterial* Material);
+	void RemoveWaitingMaterial(GLMaterial* Material);
 
 private:
 	GLint GetUniformLocation(const std::string& name) const;
 	bool AddStage(const std::string& source, ShaderStage stage);
 	bool CompileShader(const std::string& source, GLuint& Obj);
+	bool CheckCompileStatus(GLuint Obj, ShaderStage stage);
+	bool CheckProgramStatus();
+	// 程序二进制缓存，命中时跳过编译、链接和反射
+	bool LoadProgramBinary(uint64_t Key);
+	void StoreProgramBinary(uint64_t Key);
 	void ReflectUnifromBlock();
 	MaterialValue::Type MapStd140Type(GLenum Type);
 	int ComputeTypeSize(MaterialValue::Type Type);
 
 private:
 	GLuint ProgramID_;
-	GLuint MaterialUBO_;
-	ShaderUniformLayout MaterialLayout_;
+	GLint ProgramBinaryLength_;
 	std::unordered_map<ShaderStage, GLuint> ShaderStages_;
 
+	// 后台编译状态
+	bool Pending_;
+	bool Cacheable_;
+	uint64_t CacheKey_;
+	std::chrono::high_resolution_clock::time_point SubmitTime_;
+	std::vector<GLMaterial*> WaitingMaterials_;
+
 };
\ No newline at end of file
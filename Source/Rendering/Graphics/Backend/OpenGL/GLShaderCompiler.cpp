@@ -0,0 +1,81 @@
+﻿#include "GLShaderCompiler.h"
+#include "GLShader.h"
+#include <Logger.hpp>
+#include <algorithm>
+
+GLShaderCompiler& GLShaderCompiler::Instance() {
+	static GLShaderCompiler GlobalShaderCompiler;
+	return GlobalShaderCompiler;
+}
+
+GLShaderCompiler::GLShaderCompiler() {
+	ParallelCompile_ = false;
+}
+
+void GLShaderCompiler::Initialize() {
+	// 0xFFFFFFFF表示由驱动决定编译线程数
+	if (GLAD_GL_KHR_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		ParallelCompile_ = true;
+	}
+	else if (GLAD_GL_ARB_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+		ParallelCompile_ = true;
+	}
+
+	Stats_ = ShaderCompileStats();
+	Stats_.ParallelCompile = ParallelCompile_;
+	LOG_INFO << "Parallel shader compile " << (ParallelCompile_ ? "enabled." : "not supported, shaders finish on next frame.");
+}
+
+void GLShaderCompiler::Destroy() {
+	LogStats();
+	Pending_.clear();
+}
+
+void GLShaderCompiler::Submit(GLShader* Shader) {
+	Pending_.push_back(Shader);
+	Stats_.Submitted++;
+}
+
+void GLShaderCompiler::Remove(GLShader* Shader) {
+	Pending_.erase(std::remove(Pending_.begin(), Pending_.end(), Shader), Pending_.end());
+}
+
+uint32_t GLShaderCompiler::Poll() {
+	if (Pending_.empty()) {
+		return 0;
+	}
+
+	// 完成时会回调等待中的材质，先取出本帧完成的Shader
+	std::vector<GLShader*> Ready;
+	for (GLShader* Shader : Pending_) {
+		if (Shader->IsCompileComplete()) {
+			Ready.push_back(Shader);
+		}
+	}
+
+	for (GLShader* Shader : Ready) {
+		Shader->FinishCompile();
+	}
+	return (uint32_t)Ready.size();
+}
+
+void GLShaderCompiler::RecordCompile(double CompileTimeMs, bool Success) {
+	Success ? Stats_.Completed++ : Stats_.Failed++;
+	Stats_.TotalCompileMs += CompileTimeMs;
+	Stats_.MaxCompileMs = std::max(Stats_.MaxCompileMs, CompileTimeMs);
+}
+
+ShaderCompileStats GLShaderCompiler::GetStats() const {
+	ShaderCompileStats Stats = Stats_;
+	Stats.Pending = (uint32_t)Pending_.size();
+	return Stats;
+}
+
+void GLShaderCompiler::LogStats() const {
+	const ShaderCompileStats Stats = GetStats();
+	LOG_INFO << "Shader compile: " << Stats.Submitted << " submitted, " << Stats.Pending << " pending, "
+		<< Stats.Completed << " completed, " << Stats.Failed << " failed, avg " << Stats.GetAverageCompileMs()
+		<< " ms, max " << Stats.MaxCompileMs << " ms" << (Stats.ParallelCompile ? " (parallel)." : ".");
+}
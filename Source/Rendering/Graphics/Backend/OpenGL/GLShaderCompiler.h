@@ -0,0 +1,42 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include "Graphics/RenderStats.h"
+#include <vector>
+
+class GLShader;
+
+/**
+ * 异步Shader编译队列。
+ * 加载时一次性提交所有阶段和程序，不立即查询编译/链接结果。
+ * 支持GL_KHR_parallel_shader_compile时由驱动在后台线程编译，每帧查询GL_COMPLETION_STATUS_KHR，
+ * 完成后再检查结果并反射；不支持时在下一帧统一完成。
+ */
+class GLShaderCompiler {
+public:
+	static GLShaderCompiler& Instance();
+
+public:
+	void Initialize();
+	void Destroy();
+
+	bool IsParallelCompileSupported() const { return ParallelCompile_; }
+
+	void Submit(GLShader* Shader);
+	void Remove(GLShader* Shader);
+
+	// 每帧调用，完成已编译好的Shader，返回本次完成的数量
+	uint32_t Poll();
+
+	void RecordCompile(double CompileTimeMs, bool Success);
+	ShaderCompileStats GetStats() const;
+	void LogStats() const;
+
+private:
+	GLShaderCompiler();
+
+private:
+	bool ParallelCompile_;
+	std::vector<GLShader*> Pending_;
+	ShaderCompileStats Stats_;
+};
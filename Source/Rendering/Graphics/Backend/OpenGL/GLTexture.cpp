@@ -1,27 +1,283 @@
 ﻿#include "GLTexture.h"
+#include "GLTextureStreamer.h"
+#include "GLMaterialTable.h"
+#include "RenderModuleAPI.h"
+#include "Platform/File/MappedFile.h"
+#include <Logger.hpp>
+#include <algorithm>
 
-GLTexture::GLTexture() {}
-GLTexture::GLTexture(const std::string& AssetPath) {
-	Load(AssetPath);
+GLTexture::GLTexture() {
+	Format_ = TextureFormat::eRGBA8;
+	TextureID_ = 0;
+	ResidentMip_ = 0;
+	PersistentMip_ = 0;
+	BoundUnit_ = 0;
+	BindlessHandle_ = 0;
+	SourceOffset_ = 0;
+	CookedSize_ = 0;
 }
+
+GLTexture::GLTexture(const TextureDesc& Desc) : GLTexture() {
+	if (!Load(Desc)) {
+		return;
+	}
+
+	IsValid_ = true;
+}
+
 GLTexture::~GLTexture() {
 	Unload();
 }
 
-bool GLTexture::Load(const std::string& AssetPath) {
+bool GLTexture::Load(const TextureDesc& Desc) {
+	Name_ = Desc.Name;
+	if (Desc.Format >= TextureFormat::eCount || Desc.Mips.empty() || !Desc.Data) {
+		LOG_ERROR << "Texture '" << Name_ << "' has no pixel data!";
+		return false;
+	}
+
+	for (const TextureMipDesc& Mip : Desc.Mips) {
+		if (Mip.Offset + Mip.Size > Desc.Data->size() || Mip.Size != TextureLayout::GetMipSize(Desc.Format, Mip.Width, Mip.Height)) {
+			LOG_ERROR << "Texture '" << Name_ << "' has invalid mip data!";
+			return false;
+		}
+	}
+
+	Format_ = Desc.Format;
+	Width_ = Desc.Width;
+	Height_ = Desc.Height;
+	MipCount_ = (uint32_t)Desc.Mips.size();
+	Mips_ = Desc.Mips;
+	Source_ = Desc.Data;
+	SourceOffset_ = 0;
+	CookedPath_ = Desc.CookedPath;
+	CookedSize_ = Desc.Data->size();
 
+	// 第一个不超过常驻尺寸的Mip
+	PersistentMip_ = MipCount_ - 1;
+	for (uint32_t i = 0; i < MipCount_; ++i) {
+		if (std::max(Mips_[i].Width, Mips_[i].Height) <= TEXTURE_STREAMING_MIN_SIZE) {
+			PersistentMip_ = i;
+			break;
+		}
+	}
+
+	// 先只上传低Mip，之后按需换入
+	ResidentMip_ = MipCount_;
+	if (!SetResidentMip(PersistentMip_)) {
+		return false;
+	}
+
+	AddToTextureArray();
+
+	// 烘焙纹理只保留常驻Mip（文件中最小的Mip在前，连续存放），高Mip之后从文件读取
+	if (!CookedPath_.empty() && PersistentMip_ > 0) {
+		uint64_t Begin = Mips_[PersistentMip_].Offset;
+		uint64_t End = 0;
+		for (uint32_t i = PersistentMip_; i < MipCount_; ++i) {
+			Begin = std::min(Begin, Mips_[i].Offset);
+			End = std::max(End, Mips_[i].Offset + Mips_[i].Size);
+		}
+		Source_ = std::make_shared<const std::vector<uint8_t>>(Source_->begin() + Begin, Source_->begin() + End);
+		SourceOffset_ = Begin;
+	}
+
+	GLTextureStreamer::Instance().Register(this);
+	LOG_DEBUG << "Texture '" << Name_ << "' loaded, " << Width_ << "x" << Height_ << " " << TextureLayout::GetFormatName(Format_)
+		<< ", " << MipCount_ << " mips.";
+	IsValid_ = true;
 	return true;
 }
 
 void GLTexture::Unload() {
+	if (TextureID_ == 0) {
+		return;
+	}
+
+	GLTextureStreamer::Instance().Unregister(this);
+	ReleaseBindlessHandle();
+	RemoveFromTextureArray();
+	glDeleteTextures(1, &TextureID_);
+	TextureID_ = 0;
+	ResidentMip_ = MipCount_;
+	Source_.reset();
+	CookedPath_.clear();
 
+	LOG_DEBUG << "Texture '" << Name_ << "' unloaded.";
 }
 
 void GLTexture::Bind(uint32_t binding) const {
-
+	glBindTextureUnit(binding, TextureID_);
+	BoundUnit_ = binding;
 }
 
 void GLTexture::Unbind() const {
+	glBindTextureUnit(BoundUnit_, 0);
+}
+
+uint64_t GLTexture::GetGPUMemorySize() const {
+	// 纹理数组中的常驻Mip副本也占显存
+	return GetMipRangeSize(ResidentMip_) + (ArrayLayer_.IsValid() ? GetMipRangeSize(PersistentMip_) : 0);
+}
 
+uint64_t GLTexture::GetCPUMemorySize() const {
+	return Source_ ? Source_->size() : 0;
 }
 
+GLenum GLTexture::GetInternalFormat(TextureFormat Format) {
+	switch (Format)
+	{
+	case TextureFormat::eBC1:
+		return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case TextureFormat::eBC3:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case TextureFormat::eBC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	case TextureFormat::eBC7:
+		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default:
+		return GL_RGBA8;
+	}
+}
+
+uint64_t GLTexture::GetUncompressedSize(uint32_t FirstMip) const {
+	uint64_t Size = 0;
+	for (uint32_t i = FirstMip; i < MipCount_; ++i) {
+		Size += (uint64_t)Mips_[i].Width * Mips_[i].Height * 4;
+	}
+	return Size;
+}
+
+uint64_t GLTexture::GetMipRangeSize(uint32_t FirstMip) const {
+	uint64_t Size = 0;
+	for (uint32_t i = FirstMip; i < MipCount_; ++i) {
+		Size += Mips_[i].Size;
+	}
+	return Size;
+}
+
+bool GLTexture::SetResidentMip(uint32_t FirstMip) {
+	if (FirstMip >= MipCount_ || !Source_) {
+		return false;
+	}
+	if (FirstMip == ResidentMip_) {
+		return true;
+	}
+
+	// 不可变存储无法增减层级，重新分配后复制
+	const uint32_t Levels = MipCount_ - FirstMip;
+	GLuint NewTexture = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &NewTexture);
+	glTextureStorage2D(NewTexture, Levels, GetInternalFormat(Format_), Mips_[FirstMip].Width, Mips_[FirstMip].Height);
+
+	GLTextureStreamer& Streamer = GLTextureStreamer::Instance();
+	MappedFile Mapping;
+	for (uint32_t Mip = FirstMip; Mip < MipCount_; ++Mip) {
+		const TextureMipDesc& MipDesc = Mips_[Mip];
+		if (TextureID_ != 0 && Mip >= ResidentMip_) {
+			glCopyImageSubData(TextureID_, GL_TEXTURE_2D, Mip - ResidentMip_, 0, 0, 0,
+				NewTexture, GL_TEXTURE_2D, Mip - FirstMip, 0, 0, 0, MipDesc.Width, MipDesc.Height, 1);
+			continue;
+		}
+
+		const uint8_t* Pixels = GetMipData(Mip, Mapping);
+		if (!Pixels) {
+			glDeleteTextures(1, &NewTexture);
+			return false;
+		}
+		Streamer.Upload(NewTexture, Mip - FirstMip, Format_, MipDesc.Width, MipDesc.Height, Pixels, MipDesc.Size);
+	}
+
+	glTextureParameteri(NewTexture, GL_TEXTURE_MIN_FILTER, Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTextureParameteri(NewTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(NewTexture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(NewTexture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	if (TextureID_ != 0) {
+		ReleaseBindlessHandle();
+		glDeleteTextures(1, &TextureID_);
+	}
+	TextureID_ = NewTexture;
+	ResidentMip_ = FirstMip;
+
+	// 引用旧句柄的材质表项需要更新
+	GLMaterialTable::Instance().OnTextureChanged(this);
+	return true;
+}
+
+const uint8_t* GLTexture::GetMipData(uint32_t Level, MappedFile& Mapping) {
+	const TextureMipDesc& Mip = Mips_[Level];
+	if (Mip.Offset >= SourceOffset_ && Mip.Offset - SourceOffset_ + Mip.Size <= Source_->size()) {
+		return Source_->data() + (Mip.Offset - SourceOffset_);
+	}
+	if (CookedPath_.empty()) {
+		return nullptr;
+	}
+
+	// 同一次换入的多个Mip共用一次映射，文件在加载后被重新烘焙时放弃换入
+	if (!Mapping.IsOpen() && !Mapping.Open(CookedPath_)) {
+		LOG_WARN << "Texture '" << Name_ << "' stream in failed: " << Mapping.GetLastError();
+		return nullptr;
+	}
+	if (Mapping.GetSize() != CookedSize_) {
+		LOG_WARN << "Texture '" << Name_ << "' stream in failed, cooked file '" << CookedPath_ << "' changed since load.";
+		return nullptr;
+	}
+
+	GLTextureStreamer::Instance().RecordFileRead(Mip.Size);
+	return Mapping.GetData() + Mip.Offset;
+}
+
+GLuint64 GLTexture::GetBindlessHandle() {
+	if (BindlessHandle_ == 0 && TextureID_ != 0) {
+		// 取得句柄后纹理参数和存储不可再修改
+		BindlessHandle_ = glGetTextureHandleARB(TextureID_);
+		glMakeTextureHandleResidentARB(BindlessHandle_);
+	}
+	return BindlessHandle_;
+}
+
+void GLTexture::AddToTextureArray() {
+	GLTextureArrays& TextureArrays = GLTextureArrays::Instance();
+	RemoveFromTextureArray();
+	if (!TextureArrays.IsEnabled()) {
+		return;
+	}
+
+	const TextureMipDesc& Base = Mips_[PersistentMip_];
+	GLTextureArrayLayer Layer = TextureArrays.Allocate(Format_, Base.Width, Base.Height, MipCount_ - PersistentMip_);
+	if (!Layer.IsValid()) {
+		return;
+	}
+
+	MappedFile Mapping;
+	for (uint32_t Mip = PersistentMip_; Mip < MipCount_; ++Mip) {
+		const TextureMipDesc& MipDesc = Mips_[Mip];
+		const uint8_t* Pixels = GetMipData(Mip, Mapping);
+		if (!Pixels) {
+			TextureArrays.Free(Layer);
+			return;
+		}
+		TextureArrays.Upload(Layer, Mip - PersistentMip_, MipDesc.Width, MipDesc.Height, Pixels, MipDesc.Size);
+	}
+
+	ArrayLayer_ = Layer;
+	GLMaterialTable::Instance().OnTextureChanged(this);
+}
+
+void GLTexture::RemoveFromTextureArray() {
+	if (!ArrayLayer_.IsValid()) {
+		return;
+	}
+
+	GLTextureArrays::Instance().Free(ArrayLayer_);
+	ArrayLayer_ = GLTextureArrayLayer();
+	GLMaterialTable::Instance().OnTextureChanged(this);
+}
+
+void GLTexture::ReleaseBindlessHandle() {
+	if (BindlessHandle_ != 0) {
+		glMakeTextureHandleNonResidentARB(BindlessHandle_);
+		BindlessHandle_ = 0;
+	}
+}
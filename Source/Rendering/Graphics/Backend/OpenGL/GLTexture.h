@@ -1,22 +1,80 @@
 ﻿#pragma once
 #include "Resource/ITexture.h"
 #include "glad/glad.h"
+#include "GLTextureArrays.h"
 
+class MappedFile;
+
+/**
+ * 支持Mip流式加载的纹理。
+ * 不超过TEXTURE_STREAMING_MIN_SIZE的低Mip始终驻留，更高的Mip由GLTextureStreamer按屏幕尺寸换入换出。
+ * 驻留范围变化时重新分配不可变存储，已驻留的Mip在显存中复制，缺少的Mip从CPU像素数据上传。
+ * 烘焙纹理在内存中只保留常驻Mip，更高的Mip换入时映射烘焙文件读取；
+ * 解码得到的纹理无法廉价地重新生成，保留完整Mip链，计入GetCPUMemorySize。
+ * 块压缩格式的Mip数据按原样上传，不做转码。
+ * 不支持无绑定纹理时常驻Mip另存一份到GLTextureArrays，只驻留常驻Mip时由Shader从纹理数组采样。
+ */
 class GLTexture : public ITexture {
 public:
 	GLTexture();
-	GLTexture(const std::string& AssetPath);
+	GLTexture(const TextureDesc& Desc);
 	virtual ~GLTexture();
 
 public:
 	// 使用和管理
-	virtual bool Load(const std::string& AssetPath) override;
+	virtual bool Load(const TextureDesc& Desc) override;
 	virtual void Unload() override;
 	virtual void Bind(uint32_t binding) const override;
 	virtual void Unbind() const override;
-	virtual void* GetNativeHandle() const { return nullptr; };
+	virtual void* GetNativeHandle() const override { return (void*)(uintptr_t)TextureID_; }
+
+	virtual uint64_t GetCPUMemorySize() const override;
+	virtual uint64_t GetGPUMemorySize() const override;
+
+public:
+	// 流式加载
+	uint32_t GetResidentMip() const { return ResidentMip_; }
+	uint32_t GetPersistentMip() const { return PersistentMip_; }
+	const TextureMipDesc& GetMip(uint32_t Level) const { return Mips_[Level]; }
+	// [FirstMip, MipCount)的数据量
+	uint64_t GetMipRangeSize(uint32_t FirstMip) const;
+	// 同样的Mip以RGBA8存储时的数据量
+	uint64_t GetUncompressedSize(uint32_t FirstMip) const;
+	TextureFormat GetFormat() const { return Format_; }
+	// 使[FirstMip, MipCount)驻留
+	bool SetResidentMip(uint32_t FirstMip);
+
+	// 无绑定纹理句柄，首次获取时创建并常驻，纹理存储重新分配后失效
+	GLuint64 GetBindlessHandle();
+
+	// 只驻留常驻Mip且常驻Mip在纹理数组中时，Shader从数组采样，不必绑定纹理单元
+	bool IsInTextureArray() const { return ArrayLayer_.IsValid() && ResidentMip_ >= PersistentMip_; }
+	const GLTextureArrayLayer& GetArrayLayer() const { return ArrayLayer_; }
+
+	static GLenum GetInternalFormat(TextureFormat Format);
 
 private:
-	GLuint TextureID;
+	void ReleaseBindlessHandle();
+	void AddToTextureArray();
+	void RemoveFromTextureArray();
+	// Mip像素数据，不在内存中时映射烘焙文件读取，失败返回nullptr
+	const uint8_t* GetMipData(uint32_t Level, MappedFile& Mapping);
+
+private:
+	TextureFormat Format_;
+	GLuint TextureID_;
+	uint32_t ResidentMip_;
+	uint32_t PersistentMip_;
+	mutable uint32_t BoundUnit_;
+	GLuint64 BindlessHandle_;
+	GLTextureArrayLayer ArrayLayer_;
+
+	std::vector<TextureMipDesc> Mips_;
+	// 保留在内存中的Mip像素数据，从SourceOffset_开始，换入时从这里上传
+	std::shared_ptr<const std::vector<uint8_t>> Source_;
+	uint64_t SourceOffset_;
+	// 烘焙文件路径和大小，不在内存中的Mip从文件读取
+	std::string CookedPath_;
+	uint64_t CookedSize_;
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,155 @@
+﻿#include "GLTextureArrays.h"
+#include "GLTexture.h"
+#include "RenderModuleAPI.h"
+#include <Logger.hpp>
+
+#include <algorithm>
+
+static const uint32_t TEXTURE_ARRAY_INITIAL_LAYERS = 16;
+
+GLTextureArrays& GLTextureArrays::Instance() {
+	static GLTextureArrays TextureArrays;
+	return TextureArrays;
+}
+
+GLTextureArrays::GLTextureArrays() {
+	Enabled_ = false;
+	MaxLayers_ = 0;
+	Rejected_ = 0;
+}
+
+bool GLTextureArrays::Initialize(bool Enabled) {
+	Enabled_ = Enabled;
+	Pools_.clear();
+	Rejected_ = 0;
+
+	GLint MaxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &MaxLayers);
+	MaxLayers_ = (uint32_t)std::max(MaxLayers, 1);
+	return true;
+}
+
+void GLTextureArrays::Destroy() {
+	if (Enabled_) {
+		LogStats();
+	}
+
+	for (Pool& Target : Pools_) {
+		if (Target.Texture != 0) {
+			glDeleteTextures(1, &Target.Texture);
+		}
+	}
+	Pools_.clear();
+	Enabled_ = false;
+}
+
+GLTextureArrayLayer GLTextureArrays::Allocate(TextureFormat Format, uint32_t Width, uint32_t Height, uint32_t Levels) {
+	GLTextureArrayLayer Result;
+	if (!Enabled_) {
+		return Result;
+	}
+
+	auto It = std::find_if(Pools_.begin(), Pools_.end(), [&](const Pool& Target) {
+		return Target.Format == Format && Target.Width == Width && Target.Height == Height && Target.Levels == Levels;
+	});
+	if (It == Pools_.end()) {
+		if (Pools_.size() >= RENDER_TEXTURE_ARRAY_COUNT) {
+			++Rejected_;
+			return Result;
+		}
+
+		Pool NewPool;
+		NewPool.Format = Format;
+		NewPool.Width = Width;
+		NewPool.Height = Height;
+		NewPool.Levels = Levels;
+		Pools_.push_back(NewPool);
+		It = Pools_.end() - 1;
+		LOG_INFO << "Texture array " << Pools_.size() - 1 << " created for " << Width << "x" << Height << " "
+			<< TextureLayout::GetFormatName(Format) << ", " << Levels << " mips.";
+	}
+
+	Pool& Target = *It;
+	if (!Target.FreeLayers.empty()) {
+		Result.Layer = Target.FreeLayers.back();
+		Target.FreeLayers.pop_back();
+	}
+	else {
+		if (Target.Count == Target.Capacity && !Grow(Target)) {
+			++Rejected_;
+			return Result;
+		}
+		Result.Layer = Target.Count++;
+	}
+
+	Result.Array = (uint32_t)(It - Pools_.begin());
+	return Result;
+}
+
+void GLTextureArrays::Free(const GLTextureArrayLayer& Layer) {
+	// 数组已销毁时直接忽略
+	if (!Layer.IsValid() || Layer.Array >= Pools_.size()) {
+		return;
+	}
+	Pools_[Layer.Array].FreeLayers.push_back(Layer.Layer);
+}
+
+void GLTextureArrays::Upload(const GLTextureArrayLayer& Layer, uint32_t Level, uint32_t Width, uint32_t Height, const uint8_t* Pixels, uint64_t Size) {
+	if (!Layer.IsValid() || Layer.Array >= Pools_.size()) {
+		return;
+	}
+
+	const Pool& Target = Pools_[Layer.Array];
+	if (TextureLayout::IsCompressed(Target.Format)) {
+		glCompressedTextureSubImage3D(Target.Texture, Level, 0, 0, Layer.Layer, Width, Height, 1,
+			GLTexture::GetInternalFormat(Target.Format), (GLsizei)Size, Pixels);
+	}
+	else {
+		glTextureSubImage3D(Target.Texture, Level, 0, 0, Layer.Layer, Width, Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, Pixels);
+	}
+}
+
+void GLTextureArrays::Bind() const {
+	for (uint32_t i = 0; i < (uint32_t)Pools_.size(); ++i) {
+		glBindTextureUnit(RENDER_TEXTURE_ARRAY_FIRST_UNIT + i, Pools_[i].Texture);
+	}
+}
+
+bool GLTextureArrays::Grow(Pool& Target) {
+	const uint32_t NewCapacity = std::min(std::max(Target.Capacity * 2, TEXTURE_ARRAY_INITIAL_LAYERS), MaxLayers_);
+	if (NewCapacity <= Target.Capacity) {
+		return false;
+	}
+
+	// 不可变存储无法增加层数，新建后复制已有的层，层号保持不变
+	GLuint NewTexture = 0;
+	glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &NewTexture);
+	glTextureStorage3D(NewTexture, Target.Levels, GLTexture::GetInternalFormat(Target.Format), Target.Width, Target.Height, NewCapacity);
+	glTextureParameteri(NewTexture, GL_TEXTURE_MIN_FILTER, Target.Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTextureParameteri(NewTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(NewTexture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTextureParameteri(NewTexture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	if (Target.Texture != 0) {
+		for (uint32_t Level = 0; Level < Target.Levels; ++Level) {
+			const uint32_t Width = std::max(Target.Width >> Level, 1u);
+			const uint32_t Height = std::max(Target.Height >> Level, 1u);
+			glCopyImageSubData(Target.Texture, GL_TEXTURE_2D_ARRAY, Level, 0, 0, 0,
+				NewTexture, GL_TEXTURE_2D_ARRAY, Level, 0, 0, 0, Width, Height, Target.Count);
+		}
+		glDeleteTextures(1, &Target.Texture);
+	}
+
+	Target.Texture = NewTexture;
+	Target.Capacity = NewCapacity;
+	return true;
+}
+
+void GLTextureArrays::LogStats() const {
+	uint32_t Layers = 0;
+	for (const Pool& Target : Pools_) {
+		Layers += Target.Count - (uint32_t)Target.FreeLayers.size();
+	}
+	LOG_INFO << "Texture arrays: " << Pools_.size() << " arrays, " << Layers << " layers in use, "
+		<< Rejected_ << " textures bound per slot.";
+}
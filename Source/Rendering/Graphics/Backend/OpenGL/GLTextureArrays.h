@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include "Resource/TextureFormat.h"
+
+#include <cstdint>
+#include <vector>
+
+// 纹理在纹理数组中的位置
+struct GLTextureArrayLayer {
+	uint32_t Array = UINT32_MAX;
+	uint32_t Layer = 0;
+
+	bool IsValid() const { return Array != UINT32_MAX; }
+};
+
+/**
+ * 不支持无绑定纹理时的回退。
+ * 格式、尺寸和Mip数相同的纹理把常驻Mip各放进同一个GL_TEXTURE_2D_ARRAY的一层，
+ * 各数组固定绑定到RENDER_TEXTURE_ARRAY_FIRST_UNIT起的纹理单元，材质表记录(数组, 层)，
+ * Shader从数组采样，切换材质时不再绑定这些纹理。
+ * 纹理换入更高Mip后仍按槽位单独绑定，换出回常驻Mip后重新使用数组。
+ * 数组数量受纹理单元限制，放不下的格式/尺寸组合同样按槽位绑定。
+ */
+class GLTextureArrays {
+public:
+	static GLTextureArrays& Instance();
+
+public:
+	bool Initialize(bool Enabled);
+	void Destroy();
+
+	bool IsEnabled() const { return Enabled_; }
+
+	// 分配一层，没有空闲的数组或层数超出限制时返回无效位置
+	GLTextureArrayLayer Allocate(TextureFormat Format, uint32_t Width, uint32_t Height, uint32_t Levels);
+	void Free(const GLTextureArrayLayer& Layer);
+	// 块压缩格式原样上传
+	void Upload(const GLTextureArrayLayer& Layer, uint32_t Level, uint32_t Width, uint32_t Height, const uint8_t* Pixels, uint64_t Size);
+
+	// 把所有数组绑定到各自的纹理单元
+	void Bind() const;
+
+	void LogStats() const;
+
+private:
+	GLTextureArrays();
+
+	struct Pool {
+		TextureFormat Format = TextureFormat::eRGBA8;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint32_t Levels = 0;
+		GLuint Texture = 0;
+		uint32_t Capacity = 0;
+		uint32_t Count = 0;
+		std::vector<uint32_t> FreeLayers;
+	};
+
+	bool Grow(Pool& Target);
+
+private:
+	bool Enabled_;
+	uint32_t MaxLayers_;
+	std::vector<Pool> Pools_;
+	// 放不进数组而按槽位绑定的纹理数
+	uint32_t Rejected_;
+};
@@ -0,0 +1,234 @@
+﻿#include "GLTextureStreamer.h"
+#include "GLTexture.h"
+#include "RenderModuleAPI.h"
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+GLTextureStreamer& GLTextureStreamer::Instance() {
+	static GLTextureStreamer GlobalTextureStreamer;
+	return GlobalTextureStreamer;
+}
+
+GLTextureStreamer::GLTextureStreamer() {
+	FrameIndex_ = 0;
+	FrameUploadBytes_ = 0;
+}
+
+bool GLTextureStreamer::Initialize() {
+	Stats_ = TextureStreamingStats();
+	Stats_.BudgetBytes = TEXTURE_STREAMING_BUDGET;
+	FrameIndex_ = 0;
+	FrameUploadBytes_ = 0;
+
+	if (!GLAD_GL_EXT_texture_compression_s3tc) {
+		LOG_WARN << "S3TC not supported, BC1/BC3 textures can not be uploaded.";
+	}
+	if (!Staging_.Initialize(TEXTURE_STREAMING_UPLOAD_SIZE, 3)) {
+		LOG_WARN << "Create texture staging buffer failed, upload from client memory.";
+		return false;
+	}
+	return true;
+}
+
+void GLTextureStreamer::Destroy() {
+	LogStats();
+	Staging_.Destroy();
+	Textures_.clear();
+}
+
+void GLTextureStreamer::Register(GLTexture* Texture) {
+	StreamingState& State = Textures_[Texture];
+	State.WantedMip = Texture->GetPersistentMip();
+	State.LastRequestFrame = FrameIndex_;
+}
+
+void GLTextureStreamer::Unregister(GLTexture* Texture) {
+	Textures_.erase(Texture);
+}
+
+void GLTextureStreamer::Request(GLTexture* Texture, float ScreenSize) {
+	auto It = Textures_.find(Texture);
+	if (It == Textures_.end()) {
+		return;
+	}
+
+	It->second.ScreenSize = std::max(It->second.ScreenSize, ScreenSize);
+}
+
+uint32_t GLTextureStreamer::ComputeWantedMip(const GLTexture* Texture, const StreamingState& State) const {
+	if (State.ScreenSize <= 0.0f) {
+		// 长时间未被绘制时回退到常驻Mip
+		return FrameIndex_ - State.LastRequestFrame > TEXTURE_STREAMING_IDLE_FRAMES ? Texture->GetPersistentMip() : State.WantedMip;
+	}
+
+	// 一个纹素约覆盖一个像素时的Mip
+	const float TextureSize = (float)std::max(Texture->GetWidth(), Texture->GetHeight());
+	const float Ratio = TextureSize / State.ScreenSize;
+	const uint32_t Mip = Ratio > 1.0f ? (uint32_t)std::floor(std::log2(Ratio)) : 0;
+	return std::min(Mip, Texture->GetPersistentMip());
+}
+
+void GLTextureStreamer::Update() {
+	FrameIndex_++;
+	FrameUploadBytes_ = 0;
+
+	std::vector<GLTexture*> StreamIn;
+	Stats_.CompressedTextures = 0;
+	uint64_t ResidentBytes = 0;
+	uint64_t CPUBytes = 0;
+	uint64_t WantedBytes = 0;
+	uint64_t UncompressedBytes = 0;
+	uint32_t PendingMips = 0;
+
+	for (auto& [Texture, State] : Textures_) {
+		if (State.ScreenSize > 0.0f) {
+			State.LastRequestFrame = FrameIndex_;
+		}
+		State.WantedMip = ComputeWantedMip(Texture, State);
+		State.ScreenSize = 0.0f;
+
+		// 超出需要的Mip直接换出，释放显存
+		const uint32_t ResidentMip = Texture->GetResidentMip();
+		if (ResidentMip < State.WantedMip && Texture->SetResidentMip(State.WantedMip)) {
+			Stats_.StreamedOutMips += State.WantedMip - ResidentMip;
+		}
+
+		if (Texture->GetResidentMip() > State.WantedMip) {
+			if (!State.Waiting) {
+				State.Waiting = true;
+				State.RequestTime = std::chrono::high_resolution_clock::now();
+			}
+			StreamIn.push_back(Texture);
+		}
+
+		ResidentBytes += Texture->GetGPUMemorySize();
+		CPUBytes += Texture->GetCPUMemorySize();
+		WantedBytes += Texture->GetMipRangeSize(State.WantedMip);
+		UncompressedBytes += Texture->GetUncompressedSize(State.WantedMip);
+		Stats_.CompressedTextures += TextureLayout::IsCompressed(Texture->GetFormat()) ? 1 : 0;
+	}
+
+	// 缺少的Mip越多越优先
+	std::sort(StreamIn.begin(), StreamIn.end(), [this](GLTexture* A, GLTexture* B) {
+		return A->GetResidentMip() - Textures_[A].WantedMip > B->GetResidentMip() - Textures_[B].WantedMip;
+	});
+
+	bool BudgetLimited = false;
+	bool UploadLimited = false;
+	for (GLTexture* Texture : StreamIn) {
+		StreamingState& State = Textures_[Texture];
+		const uint32_t ResidentMip = Texture->GetResidentMip();
+
+		// 从低到高逐级累加，单帧至少允许上传一个Mip，避免大Mip永远无法换入
+		uint32_t TargetMip = ResidentMip;
+		uint64_t UploadBytes = 0;
+		while (TargetMip > State.WantedMip) {
+			const uint64_t MipSize = Texture->GetMip(TargetMip - 1).Size;
+			if (ResidentBytes + UploadBytes + MipSize > TEXTURE_STREAMING_BUDGET) {
+				BudgetLimited = true;
+				break;
+			}
+			if (FrameUploadBytes_ + UploadBytes + MipSize > TEXTURE_STREAMING_UPLOAD_SIZE && FrameUploadBytes_ + UploadBytes > 0) {
+				UploadLimited = true;
+				break;
+			}
+			UploadBytes += MipSize;
+			TargetMip--;
+		}
+
+		if (TargetMip == ResidentMip || !Texture->SetResidentMip(TargetMip)) {
+			PendingMips += ResidentMip - State.WantedMip;
+			continue;
+		}
+
+		ResidentBytes += UploadBytes;
+		Stats_.StreamedInMips += ResidentMip - TargetMip;
+		PendingMips += TargetMip - State.WantedMip;
+
+		if (TargetMip == State.WantedMip && State.Waiting) {
+			State.Waiting = false;
+			const double LatencyMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - State.RequestTime).count();
+			Stats_.CompletedRequests++;
+			Stats_.TotalLatencyMs += LatencyMs;
+			Stats_.MaxLatencyMs = std::max(Stats_.MaxLatencyMs, LatencyMs);
+		}
+	}
+
+	// 请求在换入前被撤销时不计入延迟
+	for (auto& [Texture, State] : Textures_) {
+		if (State.Waiting && Texture->GetResidentMip() <= State.WantedMip) {
+			State.Waiting = false;
+		}
+	}
+
+	const bool WasPending = Stats_.PendingMips > 0;
+	Stats_.BudgetLimitedFrames += BudgetLimited ? 1 : 0;
+	Stats_.UploadLimitedFrames += UploadLimited ? 1 : 0;
+	Stats_.TextureCount = (uint32_t)Textures_.size();
+	Stats_.PendingMips = PendingMips;
+	Stats_.ResidentBytes = ResidentBytes;
+	Stats_.CPUBytes = CPUBytes;
+	Stats_.WantedBytes = WantedBytes;
+	Stats_.WantedUncompressedBytes = UncompressedBytes;
+	Stats_.PeakResidentBytes = std::max(Stats_.PeakResidentBytes, ResidentBytes);
+
+	if (WasPending && PendingMips == 0) {
+		LogStats();
+	}
+}
+
+void GLTextureStreamer::EndFrame() {
+	Staging_.EndFrame();
+}
+
+void GLTextureStreamer::Upload(GLuint Texture, uint32_t Level, TextureFormat Format, uint32_t Width, uint32_t Height, const uint8_t* Pixels, uint64_t Size) {
+	FrameUploadBytes_ += Size;
+	Stats_.UploadedBytes += Size;
+
+	// 有PBO绑定时像素指针为Buffer内偏移
+	const void* Source = Pixels;
+	TransientAllocation Staging = Staging_.Allocate(Size, 16);
+	if (Staging.IsValid()) {
+		memcpy(Staging.Data, Pixels, Size);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, Staging.Buffer);
+		Source = (const void*)(uintptr_t)Staging.Offset;
+	}
+	else {
+		Stats_.DirectUploads++;
+	}
+
+	if (TextureLayout::IsCompressed(Format)) {
+		glCompressedTextureSubImage2D(Texture, Level, 0, 0, Width, Height, GLTexture::GetInternalFormat(Format), (GLsizei)Size, Source);
+	}
+	else {
+		glTextureSubImage2D(Texture, Level, 0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, Source);
+	}
+
+	if (Staging.IsValid()) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+}
+
+void GLTextureStreamer::RecordFileRead(uint64_t Size) {
+	Stats_.FileReads++;
+	Stats_.FileReadBytes += Size;
+}
+
+TextureStreamingStats GLTextureStreamer::GetStats() const {
+	return Stats_;
+}
+
+void GLTextureStreamer::LogStats() const {
+	LOG_INFO << "Texture streaming: " << Stats_.TextureCount << " textures (" << Stats_.CompressedTextures << " compressed), resident "
+		<< Stats_.ResidentBytes / 1024 << " KB / wanted " << Stats_.WantedBytes / 1024 << " KB (" << Stats_.WantedUncompressedBytes / 1024
+		<< " KB as RGBA8) / budget " << Stats_.BudgetBytes / 1024 << " KB, peak " << Stats_.PeakResidentBytes / 1024
+		<< " KB, CPU " << Stats_.CPUBytes / 1024 << " KB, " << Stats_.PendingMips << " mips pending, " << Stats_.StreamedInMips << " in / " << Stats_.StreamedOutMips
+		<< " out, uploaded " << Stats_.UploadedBytes / 1024 << " KB (" << Stats_.DirectUploads << " direct, " << Stats_.FileReads
+		<< " mips / " << Stats_.FileReadBytes / 1024 << " KB read from cooked files), latency avg "
+		<< Stats_.GetAverageLatencyMs() << " ms, max " << Stats_.MaxLatencyMs << " ms, " << Stats_.BudgetLimitedFrames
+		<< " budget limited / " << Stats_.UploadLimitedFrames << " upload limited frames.";
+}
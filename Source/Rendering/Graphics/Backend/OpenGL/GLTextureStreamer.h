@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include "glad/glad.h"
+#include "GLRingBuffer.h"
+#include "Graphics/RenderStats.h"
+#include "Resource/TextureFormat.h"
+
+#include <chrono>
+#include <unordered_map>
+
+class GLTexture;
+
+/**
+ * 纹理Mip流式加载。
+ * 绘制时按网格的屏幕尺寸请求Mip，每帧开始时在显存预算和单帧上传上限内，
+ * 按缺少的Mip数从多到少换入，超出需要或长时间未使用的Mip换出到常驻Mip。
+ * 上传经由持久映射的暂存环形Buffer（PBO），空间不足时直接从客户端内存上传。
+ */
+class GLTextureStreamer {
+public:
+	static GLTextureStreamer& Instance();
+
+public:
+	bool Initialize();
+	void Destroy();
+
+	void Register(GLTexture* Texture);
+	void Unregister(GLTexture* Texture);
+
+	// 记录纹理在屏幕上的像素尺寸，同一帧内取最大值
+	void Request(GLTexture* Texture, float ScreenSize);
+
+	// 每帧开始时调用，换入/换出Mip
+	void Update();
+	// 每帧结束时调用，保护本帧的暂存区域
+	void EndFrame();
+
+	// 块压缩格式以glCompressedTextureSubImage2D原样上传
+	void Upload(GLuint Texture, uint32_t Level, TextureFormat Format, uint32_t Width, uint32_t Height, const uint8_t* Pixels, uint64_t Size);
+	// 记录换入时从烘焙文件读取的Mip
+	void RecordFileRead(uint64_t Size);
+
+	TextureStreamingStats GetStats() const;
+	void LogStats() const;
+
+private:
+	GLTextureStreamer();
+
+	struct StreamingState {
+		float ScreenSize = 0.0f;
+		uint32_t WantedMip = 0;
+		uint64_t LastRequestFrame = 0;
+		// 从请求更高Mip到驻留完成的延迟
+		bool Waiting = false;
+		std::chrono::high_resolution_clock::time_point RequestTime;
+	};
+
+	uint32_t ComputeWantedMip(const GLTexture* Texture, const StreamingState& State) const;
+
+private:
+	GLRingBuffer Staging_;
+	std::unordered_map<GLTexture*, StreamingState> Textures_;
+	uint64_t FrameIndex_;
+	uint64_t FrameUploadBytes_;
+	TextureStreamingStats Stats_;
+};
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
 #include "GraphicsAPI.h"
+#include "TransientAllocation.h"
+#include "RenderStats.h"
+#include "RenderTarget.h"
 #include <memory>
 #include <string>
 
@@ -14,16 +17,38 @@ class CommandList;
 class IGraphicsDevice {
 public:
 	virtual bool Initialize(Window* Win) = 0;
+	virtual void BeginFrame() = 0;
 	virtual void ExecuteCommandList(const CommandList& cmdList) =0;
 	virtual void MakeCurrent() = 0;
+	// 上下文切换到其他线程前在当前线程释放
+	virtual void ReleaseCurrent() = 0;
 	virtual void SwapBuffers() = 0;
 	virtual void Destroy() = 0;
 
 public:
 	virtual std::shared_ptr<IMesh> CreateMesh(const struct MeshDesc& AssetDesc) = 0;
+	virtual std::shared_ptr<IMesh> CreateMesh(struct MeshDesc&& AssetDesc) = 0;
 	virtual std::shared_ptr<IMaterial> CreateMaterial(const struct MaterialDesc& AssetPath) = 0;
 	virtual std::shared_ptr<IShader> CreateShader(const struct ShaderDesc& AssetDesc) = 0;
-	virtual std::shared_ptr<ITexture> CreateTexture(const std::string& AssetPath) = 0;
+	virtual std::shared_ptr<ITexture> CreateTexture(const struct TextureDesc& AssetDesc) = 0;
+
+public:
+	// 渲染目标，返回的句柄不为0；0表示后台缓冲
+	virtual uint32_t CreateRenderTarget(const RenderTargetDesc& Desc) = 0;
+	virtual void DestroyRenderTarget(uint32_t Target) = 0;
+	virtual void GetBackbufferSize(uint32_t& Width, uint32_t& Height) const = 0;
+
+	// 瞬态内存分配，按用途对齐
+	virtual TransientAllocation AllocateTransient(uint64_t Size, TransientUsage Usage = TransientUsage::eUniform) = 0;
+	virtual TransientBufferStats GetTransientStats() const = 0;
+
+	// 合并兼容的绘制为MultiDrawIndirect
+	virtual void SetMultiDrawIndirect(bool Enable) = 0;
+	virtual bool IsMultiDrawIndirectEnabled() const = 0;
+	virtual const RenderStats& GetRenderStats() const = 0;
+	virtual GeometryMemoryStats GetGeometryStats() const = 0;
+	virtual ShaderCompileStats GetShaderCompileStats() const = 0;
+	virtual TextureStreamingStats GetTextureStreamingStats() const = 0;
 
 public:
 	BackendAPI GetBackendAPI() { return BackendAPI_; }
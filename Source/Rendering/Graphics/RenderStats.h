@@ -0,0 +1,193 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include <cstdint>
+
+// 单帧提交统计
+struct RenderStats {
+	uint32_t DrawCommands = 0;       // 命令列表中的绘制命令数
+	uint32_t DrawCalls = 0;          // 实际发出的API绘制调用数
+	uint32_t MultiDrawBatches = 0;   // 其中MultiDrawIndirect调用数
+	uint32_t MaterialBinds = 0;      // 材质切换次数
+	uint32_t FallbackDraws = 0;      // Shader未编译完成而使用内建材质的绘制数
+	uint32_t TextureBinds = 0;       // 纹理单元绑定次数，无绑定纹理时为0
+	bool BindlessTextures = false;   // 是否通过材质表使用无绑定纹理
+	bool TextureArrays = false;      // 不支持无绑定纹理时是否从纹理数组采样常驻Mip
+	double SubmitTimeMs = 0.0;       // ExecuteCommandList的CPU耗时
+};
+
+// 视锥剔除统计
+struct CullingStats {
+	uint32_t TotalObjects = 0;       // 参与剔除的对象数
+	uint32_t VisibleObjects = 0;
+	uint32_t CulledObjects = 0;      // 完全在视锥外的对象数（含场景层次结构剔除的）
+	uint32_t OccludedObjects = 0;    // 在视锥内但被遮挡体完全挡住的对象数，不计入VisibleObjects
+	double CullTimeMs = 0.0;         // 剔除测试的CPU耗时
+	double OcclusionTimeMs = 0.0;    // 遮挡测试的CPU耗时，不含遮挡体光栅化
+};
+
+// 遮挡剔除统计
+struct OcclusionStats {
+	uint32_t Occluders = 0;          // 本帧光栅化的遮挡体数
+	uint32_t SkippedOccluders = 0;   // 超出三角形预算未光栅化的遮挡体数
+	uint32_t OccluderTriangles = 0;  // 近平面裁剪后光栅化的三角形数
+	uint32_t TestedObjects = 0;
+	uint32_t OccludedObjects = 0;
+	double RasterTimeMs = 0.0;       // 遮挡体光栅化与构建层次深度的CPU耗时
+};
+
+// 网格LOD选择统计
+struct MeshLODStats {
+	uint32_t DrawnMeshes = 0;
+	uint32_t MeshesPerLOD[MESH_MAX_LOD_COUNT] = {};
+	uint32_t LODSwitches = 0;        // 与上一帧所选LOD不同的网格数
+	uint64_t Triangles = 0;          // 所选LOD的三角形数
+	uint64_t FullDetailTriangles = 0; // 全部使用LOD0时的三角形数
+
+	float GetTriangleRatio() const { return FullDetailTriangles ? (float)Triangles / FullDetailTriangles : 1.0f; }
+};
+
+// 游戏线程与渲染线程的帧流水线统计，单线程时同样统计
+struct FramePipelineStats {
+	bool Threaded = false;            // 最近一帧是否在渲染线程执行
+	uint64_t Frames = 0;              // 已执行（含SwapBuffers）的帧数
+	double ElapsedMs = 0.0;           // 第一帧到最近一帧执行完的时间
+	double SubmitTimeMs = 0.0;        // 执行帧命令的耗时总和
+	double WaitTimeMs = 0.0;          // 游戏线程等待渲染线程空出帧包的耗时总和
+	double LatencyMs = 0.0;           // 采样输入到该帧呈现的延迟总和
+	double MaxLatencyMs = 0.0;
+
+	double GetFPS() const { return Frames > 1 && ElapsedMs > 0.0 ? (Frames - 1) * 1000.0 / ElapsedMs : 0.0; }
+	double GetAverageSubmitMs() const { return Frames ? SubmitTimeMs / Frames : 0.0; }
+	double GetAverageWaitMs() const { return Frames ? WaitTimeMs / Frames : 0.0; }
+	double GetAverageLatencyMs() const { return Frames ? LatencyMs / Frames : 0.0; }
+};
+
+// 帧图编译统计
+struct FrameGraphStats {
+	uint32_t Passes = 0;
+	uint32_t CulledPasses = 0;        // 输出未被使用而跳过的Pass数
+	uint32_t TransientTargets = 0;    // 存活Pass使用的瞬态渲染目标数
+	uint32_t PhysicalTargets = 0;     // 本帧实际占用的物理渲染目标数
+	uint32_t PooledTargets = 0;       // 渲染目标池中的目标总数
+	uint32_t CreatedTargets = 0;      // 本帧新创建的物理目标数
+	uint64_t TransientBytes = 0;      // 每个瞬态目标单独分配时的显存
+	uint64_t AllocatedBytes = 0;      // 复用后本帧实际占用的显存
+	uint64_t PooledBytes = 0;
+	double CompileTimeMs = 0.0;
+
+	uint64_t GetAliasedBytes() const { return TransientBytes > AllocatedBytes ? TransientBytes - AllocatedBytes : 0; }
+};
+
+// 异步Shader编译统计
+struct ShaderCompileStats {
+	bool ParallelCompile = false;    // 驱动是否支持并行编译
+	uint32_t Submitted = 0;          // 提交编译的程序数
+	uint32_t Pending = 0;            // 仍在编译中的程序数
+	uint32_t Completed = 0;          // 编译链接成功的程序数
+	uint32_t Failed = 0;             // 编译或链接失败的程序数
+	double TotalCompileMs = 0.0;     // 从提交到完成的耗时总和（含等待的帧）
+	double MaxCompileMs = 0.0;
+
+	double GetAverageCompileMs() const { return Completed + Failed > 0 ? TotalCompileMs / (Completed + Failed) : 0.0; }
+};
+
+// 纹理流式加载统计
+struct TextureStreamingStats {
+	uint32_t TextureCount = 0;
+	uint32_t CompressedTextures = 0;  // 使用块压缩格式的纹理数
+	uint32_t PendingMips = 0;         // 期望驻留但尚未上传的Mip数
+	uint64_t BudgetBytes = 0;
+	uint64_t ResidentBytes = 0;       // 已驻留Mip的显存占用
+	uint64_t CPUBytes = 0;            // 为换入保留在内存中的像素数据（烘焙纹理只含常驻Mip）
+	uint64_t WantedBytes = 0;         // 按屏幕尺寸期望驻留的显存占用
+	uint64_t WantedUncompressedBytes = 0; // 同样的Mip以RGBA8驻留时的显存占用
+	uint64_t PeakResidentBytes = 0;
+	uint64_t UploadedBytes = 0;       // 累计上传的纹理数据量
+	uint32_t StreamedInMips = 0;
+	uint32_t StreamedOutMips = 0;
+	uint32_t BudgetLimitedFrames = 0; // 因显存预算无法满足请求的帧数
+	uint32_t UploadLimitedFrames = 0; // 因单帧上传上限推迟请求的帧数
+	uint32_t DirectUploads = 0;       // 暂存空间不足时直接从客户端内存上传的次数
+	uint32_t FileReads = 0;           // 换入时从烘焙文件读取的Mip数
+	uint64_t FileReadBytes = 0;
+	uint32_t CompletedRequests = 0;   // 从请求更高Mip到驻留完成的次数
+	double TotalLatencyMs = 0.0;
+	double MaxLatencyMs = 0.0;
+
+	double GetAverageLatencyMs() const { return CompletedRequests > 0 ? TotalLatencyMs / CompletedRequests : 0.0; }
+};
+
+// 共享几何Buffer的内存统计
+struct GeometryMemoryStats {
+	uint64_t VertexCapacityBytes = 0;
+	uint64_t VertexUsedBytes = 0;
+	uint64_t IndexCapacityBytes = 0;
+	uint64_t IndexUsedBytes = 0;
+	uint32_t AllocationCount = 0;     // 已分配的Mesh区间数
+	uint32_t FreeBlockCount = 0;      // 顶点和索引Buffer中的空闲块数
+	float VertexFragmentation = 0.0f; // 1 - 最大空闲块 / 总空闲空间
+	float IndexFragmentation = 0.0f;
+};
+
+// Mesh在内存中的CPU副本统计
+struct MeshMemoryStats {
+	uint32_t MeshCount = 0;
+	uint32_t CPUResidentMeshes = 0;   // 仍保留CPU副本的Mesh数
+	uint64_t GeometryBytes = 0;       // 所有Mesh的顶点+索引数据量
+	uint64_t StandardGeometryBytes = 0; // 全部使用标准顶点格式时的数据量
+	uint64_t CPUBytes = 0;            // CPU副本实际占用
+	uint64_t CPUBytesSaved = 0;       // 释放CPU副本节省的内存
+};
+
+// 异步资源加载统计
+struct ResourceStreamingStats {
+	uint32_t Requested = 0;
+	uint32_t Completed = 0;
+	uint32_t Failed = 0;
+	uint32_t InFlight = 0;            // 导入中或等待上传的请求数
+	uint32_t UploadFrames = 0;        // 有上传工作的帧数
+	double PrepareTimeMs = 0.0;       // 工作线程上读取/导入耗时总和
+	double UploadTimeMs = 0.0;        // 渲染线程上创建GPU对象耗时总和
+	double MaxFrameUploadMs = 0.0;    // 单帧上传耗时峰值
+	uint32_t BlockingLoads = 0;       // 同步加载次数
+	double MaxBlockingLoadMs = 0.0;   // 同步加载单次耗时峰值，即阻塞路径造成的帧时间尖峰
+};
+
+// 资源驻留统计
+struct ResidencyStats {
+	uint64_t BudgetBytes = 0;         // 0表示不限制
+	uint64_t ResidentBytes = 0;       // CPU + GPU
+	uint64_t ResidentCPUBytes = 0;
+	uint64_t ResidentGPUBytes = 0;
+	uint64_t PeakResidentBytes = 0;
+	uint32_t ResidentCount = 0;
+	uint32_t EvictableCount = 0;      // 无引用且可从文件重新加载的资源数
+	uint32_t Evictions = 0;
+	uint64_t EvictedBytes = 0;
+	uint32_t Reloads = 0;             // 被驱逐后再次加载的次数
+	uint32_t ReloadFailures = 0;
+	double ReloadTimeMs = 0.0;        // 获取时按需重新加载的耗时总和
+};
+
+// 批量加载的依赖去重统计
+struct BatchLoadStats {
+	uint32_t MeshRequests = 0;        // 请求的网格文件数（含重复）
+	uint32_t UniqueMeshes = 0;
+	uint32_t MaterialReferences = 0;  // 网格引用材质的次数
+	uint32_t UniqueMaterials = 0;
+	uint32_t ShaderReferences = 0;    // 材质引用Shader的次数
+	uint32_t UniqueShaders = 0;
+	uint32_t TextureReferences = 0;
+	uint32_t UniqueTextures = 0;
+	uint32_t AlreadyLoaded = 0;       // 已在资源表中、无需再加载的节点数
+	uint32_t Failed = 0;
+	double PrepareTimeMs = 0.0;       // 各层并行导入耗时
+	double CreateTimeMs = 0.0;        // 在调用线程创建资源的耗时
+
+	// 逐个加载时会重复发生的查找和加载次数
+	uint32_t GetRedundantLoadsAvoided() const {
+		return (MeshRequests - UniqueMeshes) + (MaterialReferences - UniqueMaterials)
+			+ (ShaderReferences - UniqueShaders) + (TextureReferences - UniqueTextures);
+	}
+};
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Core/BaseMath.h"
+#include <cstdint>
+
+// 渲染目标格式
+enum class RenderTargetFormat : uint8_t {
+	eRGBA8 = 0,
+	eRGBA16F,
+	eR11G11B10F,
+	eRG16F,
+	eR8,
+	eR32F,
+	eDepth24Stencil8,
+	eDepth32F,
+	eCount
+};
+
+// 渲染目标描述，宽高和格式都相同的目标可以互相复用
+struct RenderTargetDesc {
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	RenderTargetFormat Format = RenderTargetFormat::eRGBA8;
+
+	RenderTargetDesc() = default;
+	RenderTargetDesc(uint32_t W, uint32_t H, RenderTargetFormat F) : Width(W), Height(H), Format(F) {}
+
+	bool IsDepth() const {
+		return Format == RenderTargetFormat::eDepth24Stencil8 || Format == RenderTargetFormat::eDepth32F;
+	}
+
+	uint32_t GetBytesPerPixel() const {
+		switch (Format) {
+		case RenderTargetFormat::eRGBA16F: return 8;
+		case RenderTargetFormat::eR8: return 1;
+		default: return 4;
+		}
+	}
+
+	uint64_t GetSize() const { return (uint64_t)Width * Height * GetBytesPerPixel(); }
+
+	bool operator==(const RenderTargetDesc& Other) const {
+		return Width == Other.Width && Height == Other.Height && Format == Other.Format;
+	}
+	bool operator!=(const RenderTargetDesc& Other) const { return !(*this == Other); }
+};
+
+// 后台缓冲的渲染目标句柄，后端创建的渲染目标句柄均不为0
+static const uint32_t BACKBUFFER_RENDER_TARGET = 0;
+
+// 渲染通道：绑定的渲染目标及开始时的清除操作
+struct RenderPassDesc {
+	uint32_t ColorTargets[RENDER_PASS_MAX_COLOR_TARGETS] = {};
+	uint32_t ColorCount = 0;
+	uint32_t DepthTarget = BACKBUFFER_RENDER_TARGET;
+	bool HasDepth = false;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+
+	bool ClearColor = false;
+	bool ClearDepth = false;
+	FVector4 Color = FVector4(0.0f, 0.0f, 0.0f, 1.0f);
+	float Depth = 1.0f;
+};
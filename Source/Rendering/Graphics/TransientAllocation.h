@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// 瞬态内存用途，决定分配时的对齐要求
+enum class TransientUsage {
+	eUniform = 0,    // 常量Buffer
+	eStorage,        // 存储Buffer
+	eIndirect        // 间接绘制参数
+};
+
+// 瞬态分配：只在当前帧有效的GPU可见内存，录制命令时可直接写入
+struct TransientAllocation {
+	void* Data = nullptr;        // CPU可写指针
+	uint32_t Buffer = 0;         // 后端Buffer句柄
+	uint64_t Offset = 0;         // 在Buffer中的偏移
+	uint64_t Size = 0;
+
+	bool IsValid() const { return Data != nullptr; }
+};
+
+// 瞬态Buffer统计，用于观察CPU/GPU同步等待
+struct TransientBufferStats {
+	uint64_t FrameCapacity = 0;     // 每帧可用字节数
+	uint64_t FrameBytes = 0;        // 上一帧已分配字节数
+	uint64_t PeakFrameBytes = 0;    // 单帧分配峰值
+	uint32_t OverflowCount = 0;     // 空间不足导致的分配失败次数
+
+	uint64_t FenceWaits = 0;        // 等待Fence次数
+	uint64_t FenceStalls = 0;       // GPU未完成，CPU实际阻塞的次数
+	double LastWaitMs = 0.0;        // 最近一次等待耗时
+	double MaxWaitMs = 0.0;         // 最长等待耗时
+	double TotalWaitMs = 0.0;       // 累计等待耗时
+};
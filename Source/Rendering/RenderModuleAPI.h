@@ -33,3 +33,100 @@
 #ifndef TEXTURE_ASSET_PATH
 #define TEXTURE_ASSET_PATH "../Assets/Textures"
 #endif
+#ifndef DERIVED_DATA_CACHE_PATH
+#define DERIVED_DATA_CACHE_PATH "../Intermediate/DerivedDataCache"
+#endif
+
+// 资源常驻内存预算（CPU + GPU，字节），0表示不限制
+#ifndef RESOURCE_MEMORY_BUDGET
+#define RESOURCE_MEMORY_BUDGET (1024ull * 1024 * 1024)
+#endif
+
+// 纹理流式加载的显存预算（字节）
+#ifndef TEXTURE_STREAMING_BUDGET
+#define TEXTURE_STREAMING_BUDGET (256ull * 1024 * 1024)
+#endif
+// 每帧通过PBO上传的纹理数据上限（字节）
+#ifndef TEXTURE_STREAMING_UPLOAD_SIZE
+#define TEXTURE_STREAMING_UPLOAD_SIZE (8ull * 1024 * 1024)
+#endif
+// 不超过该尺寸的低Mip始终驻留
+#ifndef TEXTURE_STREAMING_MIN_SIZE
+#define TEXTURE_STREAMING_MIN_SIZE 64
+#endif
+// 连续多少帧未被请求后回退到常驻Mip
+#ifndef TEXTURE_STREAMING_IDLE_FRAMES
+#define TEXTURE_STREAMING_IDLE_FRAMES 120
+#endif
+
+// 录制绘制命令前按世界空间包围盒做视锥剔除
+#ifndef RENDER_FRUSTUM_CULLING
+#define RENDER_FRUSTUM_CULLING 1
+#endif
+
+// 视锥剔除后用CPU光栅化的遮挡体深度做遮挡剔除
+#ifndef RENDER_OCCLUSION_CULLING
+#define RENDER_OCCLUSION_CULLING 1
+#endif
+// 遮挡深度缓冲分辨率
+#ifndef RENDER_OCCLUSION_BUFFER_WIDTH
+#define RENDER_OCCLUSION_BUFFER_WIDTH 256
+#endif
+#ifndef RENDER_OCCLUSION_BUFFER_HEIGHT
+#define RENDER_OCCLUSION_BUFFER_HEIGHT 128
+#endif
+// 每帧光栅化的遮挡体三角形上限，按屏幕占比从大到小选取遮挡体
+#ifndef RENDER_OCCLUSION_TRIANGLE_BUDGET
+#define RENDER_OCCLUSION_TRIANGLE_BUDGET 16384
+#endif
+
+// 导入时生成的网格LOD级数上限（含LOD0）
+#ifndef MESH_MAX_LOD_COUNT
+#define MESH_MAX_LOD_COUNT 8
+#endif
+// 录制时按包围球的屏幕尺寸选择网格LOD
+#ifndef RENDER_MESH_LOD
+#define RENDER_MESH_LOD 1
+#endif
+// LOD切换的滞后比例，屏幕尺寸需越过阈值该比例才切换，避免在阈值附近来回跳变
+#ifndef RENDER_MESH_LOD_HYSTERESIS
+#define RENDER_MESH_LOD_HYSTERESIS 0.1f
+#endif
+
+// 帧图：每帧编译时剔除无输出的Pass，生命周期不重叠的瞬态渲染目标复用同一个物理目标
+#ifndef RENDER_FRAME_GRAPH_ALIASING
+#define RENDER_FRAME_GRAPH_ALIASING 1
+#endif
+// 渲染目标池中连续多少帧未被使用的目标会被释放
+#ifndef RENDER_FRAME_GRAPH_IDLE_FRAMES
+#define RENDER_FRAME_GRAPH_IDLE_FRAMES 60
+#endif
+// 单个渲染通道最多绑定的颜色目标数
+#ifndef RENDER_PASS_MAX_COLOR_TARGETS
+#define RENDER_PASS_MAX_COLOR_TARGETS 4
+#endif
+
+// 渲染线程拥有图形上下文并执行游戏线程提交的帧包，下一帧的模拟与上一帧的提交并行
+#ifndef RENDER_THREAD
+#define RENDER_THREAD 1
+#endif
+// 渲染线程上未执行完的帧数上限，1即双缓冲：一帧在渲染线程执行时游戏线程录制下一帧
+#ifndef RENDER_THREAD_FRAMES_IN_FLIGHT
+#define RENDER_THREAD_FRAMES_IN_FLIGHT 1
+#endif
+
+// 驱动支持ARB_bindless_texture时，Shader从材质表取纹理句柄而不绑定纹理单元
+#ifndef RENDER_BINDLESS_TEXTURES
+#define RENDER_BINDLESS_TEXTURES 1
+#endif
+// 不支持无绑定纹理时，格式和尺寸相同的纹理把常驻Mip放进同一个纹理数组，切换材质不必重新绑定
+#ifndef RENDER_TEXTURE_ARRAYS
+#define RENDER_TEXTURE_ARRAYS 1
+#endif
+// 纹理数组占用的第一个纹理单元和数组数，需与Shader中TextureArrays的binding和长度一致
+#ifndef RENDER_TEXTURE_ARRAY_FIRST_UNIT
+#define RENDER_TEXTURE_ARRAY_FIRST_UNIT 12
+#endif
+#ifndef RENDER_TEXTURE_ARRAY_COUNT
+#define RENDER_TEXTURE_ARRAY_COUNT 4
+#endif
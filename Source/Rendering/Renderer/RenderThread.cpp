@@ -0,0 +1,194 @@
+﻿#include "RenderThread.h"
+
+#include <Logger.hpp>
+#include <algorithm>
+
+RenderThread& RenderThread::Instance() {
+	static RenderThread GlobalRenderThread;
+	return GlobalRenderThread;
+}
+
+bool RenderThread::Start(uint32_t MaxFramesInFlight) {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	if (Running_) {
+		return true;
+	}
+
+	MaxFramesInFlight_ = std::max(MaxFramesInFlight, 1u);
+	FramesInFlight_ = 0;
+	Stopping_ = false;
+	Running_ = true;
+	// 线程先取锁才开始执行任务，此时ThreadId_已写入
+	Thread_ = std::thread(&RenderThread::ThreadLoop, this);
+	ThreadId_ = Thread_.get_id();
+
+	LOG_INFO << "Render thread started, " << MaxFramesInFlight_ << " frame(s) in flight.";
+	return true;
+}
+
+void RenderThread::Stop() {
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_);
+		if (!Thread_.joinable()) {
+			return;
+		}
+		Stopping_ = true;
+	}
+	TaskCondition_.notify_all();
+	Thread_.join();
+
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	ThreadId_ = std::thread::id();
+	Stopping_ = false;
+	LOG_INFO << "Render thread stopped.";
+}
+
+bool RenderThread::IsRunning() const {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	return Running_;
+}
+
+bool RenderThread::IsRenderThread() const {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	return Running_ && ThreadId_ == std::this_thread::get_id();
+}
+
+void RenderThread::Enqueue(Task T) {
+	if (!T) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> Lock(Mutex_);
+		// 未运行时同步执行
+		if (!Running_) {
+			Lock.unlock();
+			T();
+			return;
+		}
+		Tasks_.push_back(std::move(T));
+	}
+	TaskCondition_.notify_one();
+}
+
+void RenderThread::ExecuteAndWait(const Task& T) {
+	RunAndWait(T, true);
+}
+
+void RenderThread::Flush() {
+	RunAndWait([]() {}, false);
+}
+
+void RenderThread::RunAndWait(const Task& T, bool Urgent) {
+	if (!IsRunning() || IsRenderThread()) {
+		T();
+		return;
+	}
+
+	bool Done = false;
+	auto Wrapped = [this, &T, &Done]() {
+		T();
+		{
+			std::lock_guard<std::mutex> Lock(Mutex_);
+			Done = true;
+		}
+		DoneCondition_.notify_all();
+	};
+
+	std::unique_lock<std::mutex> Lock(Mutex_);
+	if (!Running_) {
+		Lock.unlock();
+		T();
+		return;
+	}
+	if (Urgent) {
+		Tasks_.push_front(Wrapped);
+	}
+	else {
+		Tasks_.push_back(Wrapped);
+	}
+	TaskCondition_.notify_one();
+	DoneCondition_.wait(Lock, [&Done]() { return Done; });
+}
+
+void RenderThread::SubmitFrame(Task FrameTask, Clock::time_point InputTime) {
+	if (!IsRunning() || IsRenderThread()) {
+		RunFrame(FrameTask, InputTime);
+		return;
+	}
+
+	auto WaitStart = Clock::now();
+	std::unique_lock<std::mutex> Lock(Mutex_);
+	// 双缓冲：前一帧执行完之前不能提交新的帧包
+	DoneCondition_.wait(Lock, [this]() { return !Running_ || FramesInFlight_ < MaxFramesInFlight_; });
+	const double WaitMs = std::chrono::duration<double, std::milli>(Clock::now() - WaitStart).count();
+	if (!Running_) {
+		Lock.unlock();
+		RunFrame(FrameTask, InputTime);
+		return;
+	}
+
+	FramesInFlight_++;
+	Tasks_.push_back([this, FrameTask, InputTime]() {
+		RunFrame(FrameTask, InputTime);
+		{
+			std::lock_guard<std::mutex> FrameLock(Mutex_);
+			FramesInFlight_--;
+		}
+		DoneCondition_.notify_all();
+	});
+	Lock.unlock();
+	TaskCondition_.notify_one();
+
+	std::lock_guard<std::mutex> StatsLock(StatsMutex_);
+	Stats_.WaitTimeMs += WaitMs;
+}
+
+void RenderThread::RunFrame(const Task& FrameTask, Clock::time_point InputTime) {
+	const bool Threaded = IsRenderThread();
+	auto Start = Clock::now();
+	FrameTask();
+	auto End = Clock::now();
+
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	if (Stats_.Frames == 0) {
+		FirstFrameEnd_ = End;
+	}
+	const double LatencyMs = std::chrono::duration<double, std::milli>(End - InputTime).count();
+	Stats_.Threaded = Threaded;
+	Stats_.Frames++;
+	Stats_.ElapsedMs = std::chrono::duration<double, std::milli>(End - FirstFrameEnd_).count();
+	Stats_.SubmitTimeMs += std::chrono::duration<double, std::milli>(End - Start).count();
+	Stats_.LatencyMs += LatencyMs;
+	Stats_.MaxLatencyMs = std::max(Stats_.MaxLatencyMs, LatencyMs);
+}
+
+FramePipelineStats RenderThread::GetStats() const {
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	return Stats_;
+}
+
+void RenderThread::ResetStats() {
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	Stats_ = FramePipelineStats();
+}
+
+void RenderThread::ThreadLoop() {
+	for (;;) {
+		Task T;
+		{
+			std::unique_lock<std::mutex> Lock(Mutex_);
+			TaskCondition_.wait(Lock, [this]() { return Stopping_ || !Tasks_.empty(); });
+			// 退出前先把队列中的任务执行完
+			if (Tasks_.empty()) {
+				Running_ = false;
+				break;
+			}
+			T = std::move(Tasks_.front());
+			Tasks_.pop_front();
+		}
+		T();
+	}
+	// 等待中的提交改为同步执行
+	DoneCondition_.notify_all();
+}
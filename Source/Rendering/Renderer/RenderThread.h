@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Graphics/RenderStats.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * 渲染线程：按提交顺序执行任务，图形上下文只在该线程上使用。
+ * 1. 游戏线程每帧通过SubmitFrame提交帧包的执行任务，未执行完的帧达到上限时阻塞；
+ * 2. 资源创建等需要结果的任务通过ExecuteAndWait插到队首同步执行，只等待正在执行的任务；
+ * 3. 资源销毁通过Enqueue排在之前提交的帧之后，执行中的帧不会访问已销毁的资源。
+ * 未启动时所有任务在调用线程直接执行。
+ */
+class RenderThread {
+public:
+	using Task = std::function<void()>;
+	using Clock = std::chrono::high_resolution_clock;
+
+	ENGINE_RENDERING_API static RenderThread& Instance();
+
+public:
+	ENGINE_RENDERING_API bool Start(uint32_t MaxFramesInFlight = RENDER_THREAD_FRAMES_IN_FLIGHT);
+	// 执行完已提交的任务后退出
+	ENGINE_RENDERING_API void Stop();
+	ENGINE_RENDERING_API bool IsRunning() const;
+	ENGINE_RENDERING_API bool IsRenderThread() const;
+
+	ENGINE_RENDERING_API void Enqueue(Task T);
+	ENGINE_RENDERING_API void ExecuteAndWait(const Task& T);
+	// 等待已提交的任务全部执行完
+	ENGINE_RENDERING_API void Flush();
+
+	// InputTime为该帧采样输入的时间，帧任务执行完（含SwapBuffers）时统计输入到呈现的延迟
+	ENGINE_RENDERING_API void SubmitFrame(Task FrameTask, Clock::time_point InputTime);
+
+	ENGINE_RENDERING_API FramePipelineStats GetStats() const;
+	ENGINE_RENDERING_API void ResetStats();
+
+private:
+	RenderThread() : Running_(false), Stopping_(false), MaxFramesInFlight_(1), FramesInFlight_(0) {}
+	~RenderThread() { Stop(); }
+
+	// 禁止拷贝
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	void ThreadLoop();
+	void RunAndWait(const Task& T, bool Urgent);
+	void RunFrame(const Task& FrameTask, Clock::time_point InputTime);
+
+private:
+	std::thread Thread_;
+	std::thread::id ThreadId_;
+	std::deque<Task> Tasks_;
+	mutable std::mutex Mutex_;
+	std::condition_variable TaskCondition_;
+	std::condition_variable DoneCondition_;
+	bool Running_;
+	bool Stopping_;
+	uint32_t MaxFramesInFlight_;
+	uint32_t FramesInFlight_;
+
+	mutable std::mutex StatsMutex_;
+	FramePipelineStats Stats_;
+	Clock::time_point FirstFrameEnd_;
+};
@@ -10,6 +10,25 @@
 
 Renderer::Renderer() {
 	GraphicsDevice_ = nullptr;
+	FrameNumber_ = 0;
+	InputSampled_ = false;
+}
+
+// 资源的最后一个引用释放时在渲染线程销毁，排在之前提交的帧之后
+template<typename T>
+static std::shared_ptr<T> WrapRenderResource(std::shared_ptr<T> Resource) {
+	if (!Resource) {
+		return Resource;
+	}
+
+	T* Raw = Resource.get();
+	return std::shared_ptr<T>(Raw, [Holder = std::move(Resource)](T*) mutable {
+		RenderThread& Thread = RenderThread::Instance();
+		if (Thread.IsRunning() && !Thread.IsRenderThread()) {
+			Thread.Enqueue([Released = std::move(Holder)]() mutable { Released.reset(); });
+		}
+		Holder.reset();
+	});
 }
 
 Renderer::~Renderer() {
@@ -46,32 +65,111 @@ bool Renderer::Initialize(Window* Win, BackendAPI Type) {
 	} return false;
 	}
 
+	FrameGraph_.SetDevice(GraphicsDevice_.get());
 	GlobalRenderer = this;
 	return true;
 }
 
 void Renderer::BeginCommand(CommandList& CmdList) {
 	CmdList.Begin();
+	if (!InputSampled_) {
+		InputTime_ = RenderThread::Clock::now();
+	}
 
-	// TODO: 拆分清除指令
-	CmdList.Clear(FVector4(0.2f, 0.3f, 0.3f, 1.0f));
-
+	// 渲染线程模式下设备只在渲染线程访问
+	if (!RenderThread::Instance().IsRunning()) {
+		GraphicsDevice_->BeginFrame();
+	}
+	LODSelector_.BeginFrame();
+	CmdList.SetLODSelector(&LODSelector_);
+
+	uint32_t Width = 0, Height = 0;
+	GraphicsDevice_->GetBackbufferSize(Width, Height);
+	FrameGraph_.Reset();
+	Backbuffer_ = FrameGraph_.Import("Backbuffer", RenderTargetDesc(Width, Height, RenderTargetFormat::eRGBA8), BACKBUFFER_RENDER_TARGET);
+	BackbufferDepth_ = FrameGraph_.Import("BackbufferDepth", RenderTargetDesc(Width, Height, RenderTargetFormat::eDepth24Stencil8), BACKBUFFER_RENDER_TARGET);
 }
 
 void Renderer::Draw() {
 	CommandList CmdList;
-	CmdList.Begin();
+	BeginCommand(CmdList);
+
+	// 只清除后台缓冲
+	FrameGraph_.AddPass("Clear",
+		[&](FrameGraphBuilder& Builder) {
+			Builder.Write(Backbuffer_);
+			Builder.Write(BackbufferDepth_);
+			Builder.SetClearColor(FVector4(0.2f, 0.3f, 0.3f, 1.0f));
+			Builder.SetClearDepth(1.0f);
+		}, nullptr);
+
+	DrawScene(CmdList);
+	EndCommand(CmdList);
+}
 
-	// 清除指令
-	CmdList.Clear(FVector4(0.2f, 0.3f, 0.3f, 1.0f));
+void Renderer::DrawScene(CommandList& CmdList) {
+	FrameGraph_.Compile();
+	FrameGraph_.Execute(CmdList);
+
+	// 按材质/Mesh排序，便于后端合并绘制（只在同一渲染通道内的连续绘制之间排序）
+	CmdList.Sort();
+
+	// 打包后交给渲染线程，游戏线程继续下一帧的模拟
+	std::shared_ptr<FramePacket> Packet = std::make_shared<FramePacket>();
+	Packet->CmdList = std::move(CmdList);
+	Packet->FrameNumber = FrameNumber_++;
+	Packet->InputTime = InputTime_;
+	InputSampled_ = false;
+
+	const bool Threaded = RenderThread::Instance().IsRunning();
+	RenderThread::Instance().SubmitFrame([this, Packet, Threaded]() {
+		if (Threaded) {
+			GraphicsDevice_->BeginFrame();
+		}
+		ExecuteFrame(*Packet);
+	}, Packet->InputTime);
+}
 
+void Renderer::ExecuteFrame(FramePacket& Packet) {
+	GraphicsDevice_->ExecuteCommandList(Packet.CmdList);
 
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	RenderStats_ = GraphicsDevice_->GetRenderStats();
+	TransientStats_ = GraphicsDevice_->GetTransientStats();
+	GeometryStats_ = GraphicsDevice_->GetGeometryStats();
+	TextureStreamingStats_ = GraphicsDevice_->GetTextureStreamingStats();
+}
+
+void Renderer::SetRenderThread(bool Enable) {
+	RenderThread& Thread = RenderThread::Instance();
+	if (!GraphicsDevice_ || Enable == Thread.IsRunning()) {
+		return;
+	}
+
+	if (Enable) {
+		GraphicsDevice_->ReleaseCurrent();
+		Thread.Start();
+		Thread.ExecuteAndWait([this]() { GraphicsDevice_->MakeCurrent(); });
+	}
+	else {
+		Thread.Flush();
+		Thread.ExecuteAndWait([this]() { GraphicsDevice_->ReleaseCurrent(); });
+		Thread.Stop();
+		GraphicsDevice_->MakeCurrent();
+	}
 
-	GraphicsDevice_->ExecuteCommandList(CmdList);
+	const FramePipelineStats Stats = Thread.GetStats();
+	if (Stats.Frames > 0) {
+		LOG_INFO << "Frame pipeline (" << (Stats.Threaded ? "render thread" : "single thread") << "): " << Stats.Frames << " frames, "
+			<< Stats.GetFPS() << " fps, input latency avg " << Stats.GetAverageLatencyMs() << " ms, max " << Stats.MaxLatencyMs
+			<< " ms, submit " << Stats.GetAverageSubmitMs() << " ms, wait " << Stats.GetAverageWaitMs() << " ms.";
+	}
+	Thread.ResetStats();
 }
 
-void Renderer::DrawScene(CommandList& CmdList) {
-	GraphicsDevice_->ExecuteCommandList(CmdList);
+void Renderer::MarkInputSampled() {
+	InputTime_ = RenderThread::Clock::now();
+	InputSampled_ = true;
 }
 
 void Renderer::EndCommand(CommandList& CmdList) {
@@ -80,24 +178,78 @@ void Renderer::EndCommand(CommandList& CmdList) {
 
 void Renderer::Destroy() {
 	if (GraphicsDevice_) {
+		// 执行完渲染线程上的帧和延迟销毁
+		SetRenderThread(false);
+		FrameGraph_.Destroy();
 		GraphicsDevice_->Destroy();
 	}
 
 	LOG_INFO << "Renderer destroyed.";
 }
 
+// GPU资源在渲染线程创建，同步等待结果
 std::shared_ptr<IMesh> Renderer::CreateMesh(const struct MeshDesc& AssetDesc) {
-	return GraphicsDevice_->CreateMesh(AssetDesc);
+	std::shared_ptr<IMesh> Mesh;
+	RenderThread::Instance().ExecuteAndWait([&]() { Mesh = GraphicsDevice_->CreateMesh(AssetDesc); });
+	return WrapRenderResource(std::move(Mesh));
+}
+
+std::shared_ptr<IMesh> Renderer::CreateMesh(struct MeshDesc&& AssetDesc) {
+	std::shared_ptr<IMesh> Mesh;
+	RenderThread::Instance().ExecuteAndWait([&]() { Mesh = GraphicsDevice_->CreateMesh(std::move(AssetDesc)); });
+	return WrapRenderResource(std::move(Mesh));
 }
 
 std::shared_ptr<IMaterial> Renderer::CreateMaterial(const struct MaterialDesc& AssetDesc) {
-	return GraphicsDevice_->CreateMaterial(AssetDesc);
+	std::shared_ptr<IMaterial> Material;
+	RenderThread::Instance().ExecuteAndWait([&]() { Material = GraphicsDevice_->CreateMaterial(AssetDesc); });
+	return WrapRenderResource(std::move(Material));
 }
 
 std::shared_ptr<IShader> Renderer::CreateShader(const struct ShaderDesc& AssetDesc) {
-	return GraphicsDevice_->CreateShader(AssetDesc);
+	std::shared_ptr<IShader> Shader;
+	RenderThread::Instance().ExecuteAndWait([&]() { Shader = GraphicsDevice_->CreateShader(AssetDesc); });
+	return WrapRenderResource(std::move(Shader));
+}
+
+std::shared_ptr<ITexture> Renderer::CreateTexture(const struct TextureDesc& AssetDesc) {
+	std::shared_ptr<ITexture> Texture;
+	RenderThread::Instance().ExecuteAndWait([&]() { Texture = GraphicsDevice_->CreateTexture(AssetDesc); });
+	return WrapRenderResource(std::move(Texture));
+}
+
+TransientBufferStats Renderer::GetTransientStats() const {
+	if (!RenderThread::Instance().IsRunning()) {
+		return GraphicsDevice_->GetTransientStats();
+	}
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	return TransientStats_;
 }
 
-std::shared_ptr<ITexture> Renderer::CreateTexture(const std::string& AssetPath) {
-	return GraphicsDevice_->CreateTexture(AssetPath);
+RenderStats Renderer::GetRenderStats() const {
+	if (!RenderThread::Instance().IsRunning()) {
+		return GraphicsDevice_->GetRenderStats();
+	}
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	return RenderStats_;
+}
+
+GeometryMemoryStats Renderer::GetGeometryStats() const {
+	if (!RenderThread::Instance().IsRunning()) {
+		return GraphicsDevice_->GetGeometryStats();
+	}
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	return GeometryStats_;
 }
+
+TextureStreamingStats Renderer::GetTextureStreamingStats() const {
+	if (!RenderThread::Instance().IsRunning()) {
+		return GraphicsDevice_->GetTextureStreamingStats();
+	}
+	std::lock_guard<std::mutex> Lock(StatsMutex_);
+	return TextureStreamingStats_;
+}
+
+void Renderer::SetMultiDrawIndirect(bool Enable) {
+	RenderThread::Instance().Enqueue([this, Enable]() { GraphicsDevice_->SetMultiDrawIndirect(Enable); });
+}
\ No newline at end of file
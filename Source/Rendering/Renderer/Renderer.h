@@ -2,11 +2,20 @@
 
 #include "RenderModuleAPI.h"
 #include "Graphics/GraphicsAPI.h"
+#include "Graphics/TransientAllocation.h"
+#include "Graphics/RenderStats.h"
 #include "Command/CommandQueue.h"
+#include "Culling/FrustumCuller.h"
+#include "Culling/OcclusionCuller.h"
+#include "Culling/MeshLODSelector.h"
+#include "FrameGraph/FrameGraph.h"
+#include "RenderThread.h"
+#include "Command/CommandList.h"
 #include "Engine/Scene.h"
 
 #include <string>
 #include <memory>
+#include <mutex>
 
 class Window;
 class IGraphicsDevice;
@@ -15,6 +24,13 @@ class IMaterial;
 class IShader;
 class ITexture;
 
+// 游戏线程录制完成后交给渲染线程执行的一帧，相机矩阵随命令列表一起保存
+struct FramePacket {
+	CommandList CmdList;
+	uint64_t FrameNumber = 0;
+	RenderThread::Clock::time_point InputTime;
+};
+
 class Renderer {
 public:
 	ENGINE_RENDERING_API Renderer();
@@ -24,19 +40,76 @@ public:
 
 public:
 	ENGINE_RENDERING_API virtual bool Initialize(Window* Win, BackendAPI Type);
+	// 开始录制并重置帧图，后台缓冲作为导入资源
 	ENGINE_RENDERING_API virtual void BeginCommand(CommandList& CmdList);
 	ENGINE_RENDERING_API virtual void Draw();
+	// 编译帧图并生成命令后提交
 	ENGINE_RENDERING_API virtual void DrawScene(CommandList& CmdList);
 	ENGINE_RENDERING_API virtual void EndCommand(CommandList& CmdList);
 	ENGINE_RENDERING_API virtual void Destroy();
 
 public:
 	ENGINE_RENDERING_API std::shared_ptr<IMesh> CreateMesh(const struct MeshDesc& AssetDesc);
+	ENGINE_RENDERING_API std::shared_ptr<IMesh> CreateMesh(struct MeshDesc&& AssetDesc);
 	ENGINE_RENDERING_API std::shared_ptr<IMaterial> CreateMaterial(const struct MaterialDesc& AssetDesc);
 	ENGINE_RENDERING_API std::shared_ptr<IShader> CreateShader(const struct ShaderDesc& AssetDesc);
-	ENGINE_RENDERING_API std::shared_ptr<ITexture> CreateTexture(const std::string& AssetPath);
+	ENGINE_RENDERING_API std::shared_ptr<ITexture> CreateTexture(const struct TextureDesc& AssetDesc);
+
+public:
+	ENGINE_RENDERING_API TransientBufferStats GetTransientStats() const;
+	ENGINE_RENDERING_API RenderStats GetRenderStats() const;
+	ENGINE_RENDERING_API GeometryMemoryStats GetGeometryStats() const;
+	ENGINE_RENDERING_API TextureStreamingStats GetTextureStreamingStats() const;
+	ENGINE_RENDERING_API void SetMultiDrawIndirect(bool Enable);
+
+	// 录制前的视锥剔除和遮挡剔除
+	ENGINE_RENDERING_API FrustumCuller& GetFrustumCuller() { return FrustumCuller_; }
+	ENGINE_RENDERING_API OcclusionCuller& GetOcclusionCuller() { return OcclusionCuller_; }
+	ENGINE_RENDERING_API CullingStats GetCullingStats() const { return FrustumCuller_.GetStats(); }
+	ENGINE_RENDERING_API OcclusionStats GetOcclusionStats() const { return OcclusionCuller_.GetStats(); }
+	ENGINE_RENDERING_API void SetFrustumCulling(bool Enable) { FrustumCuller_.SetEnabled(Enable); }
+	ENGINE_RENDERING_API void SetOcclusionCulling(bool Enable) { OcclusionCuller_.SetEnabled(Enable); }
+
+	// 录制时按屏幕尺寸选择网格LOD
+	ENGINE_RENDERING_API MeshLODSelector& GetLODSelector() { return LODSelector_; }
+	ENGINE_RENDERING_API MeshLODStats GetMeshLODStats() const { return LODSelector_.GetStats(); }
+	ENGINE_RENDERING_API void SetMeshLOD(bool Enable) { LODSelector_.SetEnabled(Enable); }
+
+	// 每帧在BeginCommand之后声明Pass
+	ENGINE_RENDERING_API FrameGraph& GetFrameGraph() { return FrameGraph_; }
+	ENGINE_RENDERING_API FrameGraphResource GetBackbuffer() const { return Backbuffer_; }
+	ENGINE_RENDERING_API FrameGraphResource GetBackbufferDepth() const { return BackbufferDepth_; }
+	ENGINE_RENDERING_API FrameGraphStats GetFrameGraphStats() const { return FrameGraph_.GetStats(); }
+	ENGINE_RENDERING_API void SetFrameGraphAliasing(bool Enable) { FrameGraph_.SetAliasing(Enable); }
+
+	// 渲染线程：接管图形上下文，执行DrawScene提交的帧包；关闭时等待执行完并把上下文交还给调用线程
+	ENGINE_RENDERING_API void SetRenderThread(bool Enable);
+	ENGINE_RENDERING_API bool IsRenderThreadEnabled() const { return RenderThread::Instance().IsRunning(); }
+	// 游戏线程采样输入后调用，用于统计输入到呈现的延迟
+	ENGINE_RENDERING_API void MarkInputSampled();
+	ENGINE_RENDERING_API FramePipelineStats GetFramePipelineStats() const { return RenderThread::Instance().GetStats(); }
+
+private:
+	// 在渲染线程执行一帧，并保存设备统计供游戏线程读取
+	void ExecuteFrame(FramePacket& Packet);
 
 protected:
 	std::unique_ptr<IGraphicsDevice> GraphicsDevice_;
+	FrustumCuller FrustumCuller_;
+	OcclusionCuller OcclusionCuller_;
+	MeshLODSelector LODSelector_;
+	FrameGraph FrameGraph_;
+	FrameGraphResource Backbuffer_;
+	FrameGraphResource BackbufferDepth_;
+
+	uint64_t FrameNumber_;
+	RenderThread::Clock::time_point InputTime_;
+	bool InputSampled_;
+	// 渲染线程运行时，设备统计在每帧执行后复制一份
+	mutable std::mutex StatsMutex_;
+	RenderStats RenderStats_;
+	TransientBufferStats TransientStats_;
+	GeometryMemoryStats GeometryStats_;
+	TextureStreamingStats TextureStreamingStats_;
 	static Renderer* GlobalRenderer;
 };
\ No newline at end of file
@@ -46,7 +46,7 @@ public:
 
 public:
 	// 纹理贴图管理
-	void SetTexture(TextureSlot slot, std::shared_ptr<ITexture> texture) {
+	virtual void SetTexture(TextureSlot slot, std::shared_ptr<ITexture> texture) {
 		Textures_[slot] = texture;
 	}
 
@@ -55,12 +55,19 @@ public:
 		return (it != Textures_.end()) ? it->second : nullptr;
 	}
 
-	void RemoveTexture(TextureSlot slot) {
+	virtual void RemoveTexture(TextureSlot slot) {
 		Textures_.erase(slot);
 	}
 
-	std::shared_ptr<IShader> GetShader() { return Shader_; }
-	std::unordered_map<std::string, MaterialValue> GetUniforms()const { return Uniforms_; }
+	const std::unordered_map<TextureSlot, std::shared_ptr<ITexture>>& GetTextures() const { return Textures_; }
+
+	const std::shared_ptr<IShader>& GetShader() const { return Shader_; }
+	const std::unordered_map<std::string, MaterialValue>& GetUniforms() const { return Uniforms_; }
+	// 后端材质表中的索引，写入逐绘制数据供Shader查表
+	uint32_t GetMaterialIndex() const { return MaterialIndex_; }
+
+	// 修改材质参数，后端在此时重新打包常量数据
+	virtual void SetUniform(const std::string& Name, const MaterialValue& Value) { Uniforms_[Name] = Value; }
 
 protected:
 	// 材质参数
@@ -69,4 +76,6 @@ protected:
 	std::shared_ptr<IShader> Shader_;
 	// 纹理引用（共享所有权）
 	std::unordered_map<TextureSlot, std::shared_ptr<ITexture>> Textures_;
+	// 0表示未分配
+	uint32_t MaterialIndex_ = 0;
 };
\ No newline at end of file
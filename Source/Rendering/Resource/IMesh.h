@@ -2,19 +2,14 @@
 
 #include "IResource.h"
 #include "Core/BaseMath.h"
+#include "Core/Bounds.h"
+#include "VertexFormat.h"
+#include <algorithm>
 #include <vector>
 
 class IMaterial;
 struct MaterialDesc;
 
-struct Vertex {
-	FVector3 position;
-	FVector3 normal;
-	FVector2 texCoord;
-	FVector3 tangent;
-	FVector3 bitangent;
-};
-
 struct SubMeshDesc {
 	uint32_t BaseVertex;      // 顶点在全局 Vertices 数组中的起始索引
 	uint32_t BaseIndex;       // 索引在全局 Indices 数组中的起始索引
@@ -23,48 +18,182 @@ struct SubMeshDesc {
 	std::string Name;         // SubMesh 名称
 };
 
+// 一级LOD，各级共享顶点数据，SubMeshes与LOD0一一对应、指向各自的索引区间
+struct MeshLODDesc {
+	float ScreenSize = 0.0f;  // 包围球直径占视口高度的比例低于该值时使用此级
+	float Error = 0.0f;       // 局部空间的简化误差
+	std::vector<SubMeshDesc> SubMeshes;
+};
+
+// CPU端顶点数据的驻留策略
+enum class MeshResidency {
+	eGPUOnly = 0,      // 上传后释放CPU副本（默认）
+	eKeepCPUData       // 保留CPU副本，供物理碰撞、拾取等使用
+};
+
 struct MeshDesc : public IResourceDesc {
 	std::vector<Vertex> Vertices;
 	std::vector<uint32_t> Indices;
+
+	// 顶点格式。非eStandard时可直接提供打包好的PackedVertices，否则在加载时由Vertices转换
+	VertexFormat Format = VertexFormat::eStandard;
+	std::vector<uint8_t> PackedVertices;
+	// 量化位置的反量化参数：Position = Normalized * PositionScale + PositionBias
+	FVector3 PositionScale = FVector3::Ones();
+	FVector3 PositionBias = FVector3::Zero();
+
 	std::vector<SubMeshDesc> SubMeshes;
+	std::vector<MeshLODDesc> LODs;   // LOD1及之后的各级，按ScreenSize从大到小排列
 	std::vector<MaterialDesc> Materials;
 
-	// AABB 包围盒（可选）
-	FVector3 BoundsMin;
-	FVector3 BoundsMax;
+	// 局部空间AABB包围盒（可选，未提供时由顶点计算）
+	FVector3 BoundsMin = FVector3::Constant(FLT_MAX);
+	FVector3 BoundsMax = FVector3::Constant(-FLT_MAX);
+
+	MeshResidency Residency = MeshResidency::eGPUOnly;
+
+	// 外部数据视图（如内存映射的烘焙文件），设置后代替上面的数组直接上传，仅在加载期间有效
+	const void* VertexView = nullptr;      // 已按Format排布的顶点数据
+	const uint32_t* IndexView = nullptr;
+	uint32_t ViewVertexCount = 0;
+	uint32_t ViewIndexCount = 0;
+
+	bool HasDataView() const { return VertexView != nullptr && IndexView != nullptr; }
+
+	uint32_t GetVertexCount() const {
+		if (HasDataView()) {
+			return ViewVertexCount;
+		}
+		return PackedVertices.empty() ? (uint32_t)Vertices.size() : (uint32_t)(PackedVertices.size() / VertexLayout::GetStride(Format));
+	}
 };
 
 class IMesh : public IResource {
 public:
-	IMesh() { Type_ = ResourceType::eMesh; }
+	IMesh() : VertexCount_(0), IndexCount_(0), Residency_(MeshResidency::eGPUOnly), CPUDataRefCount_(0),
+		Format_(VertexFormat::eStandard), PositionScale_(FVector3::Ones()), PositionBias_(FVector3::Zero()) {
+		Type_ = ResourceType::eMesh;
+	}
 
 public:
 	virtual bool Load(const struct MeshDesc& AssetDesc) = 0;
+	// 接管描述中的顶点/索引数组，避免再复制一份
+	virtual bool Load(struct MeshDesc&& AssetDesc) = 0;
 	virtual void Bind() const = 0;
 	virtual void Unbind() const = 0;
 
-	uint32_t GetIndexCount() const { return (uint32_t)Indices_.size(); }
+	uint32_t GetVertexCount() const { return VertexCount_; }
+	uint32_t GetIndexCount() const { return IndexCount_; }
 
-	// 获取原始数据（用于物理碰撞等）
+	/**
+	 * CPU副本的引用计数。物理碰撞、拾取等需要访问顶点数据时先调用RetainCPUData，
+	 * 若副本已释放则从GPU读回；全部ReleaseCPUData后，eGPUOnly的Mesh会再次释放副本。
+	 */
+	bool RetainCPUData() {
+		if (!HasCPUData() && !ReadbackCPUData()) {
+			return false;
+		}
+		CPUDataRefCount_++;
+		return true;
+	}
+
+	void ReleaseCPUData() {
+		if (CPUDataRefCount_ > 0) {
+			CPUDataRefCount_--;
+		}
+		if (CPUDataRefCount_ == 0 && Residency_ == MeshResidency::eGPUOnly) {
+			DropCPUData();
+		}
+	}
+
+	MeshResidency GetResidency() const { return Residency_; }
+	bool HasCPUData() const { return (!Vertices_.empty() || !PackedVertices_.empty()) && !Indices_.empty(); }
+	virtual uint64_t GetCPUMemorySize() const override {
+		return Vertices_.capacity() * sizeof(Vertex) + PackedVertices_.capacity() + Indices_.capacity() * sizeof(uint32_t);
+	}
+	virtual uint64_t GetGPUMemorySize() const override { return GetGeometrySize(); }
+	uint64_t GetGeometrySize() const { return (uint64_t)VertexCount_ * GetVertexStride() + (uint64_t)IndexCount_ * sizeof(uint32_t); }
+
+	// 顶点格式
+	VertexFormat GetVertexFormat() const { return Format_; }
+	uint32_t GetVertexStride() const { return VertexLayout::GetStride(Format_); }
+	const FVector3& GetPositionScale() const { return PositionScale_; }
+	const FVector3& GetPositionBias() const { return PositionBias_; }
+
+	// 将CPU副本解码为标准顶点，压缩格式的Mesh通过它访问顶点
+	bool DecodeVertices(std::vector<Vertex>& OutVertices) const {
+		if (Format_ == VertexFormat::eStandard) {
+			OutVertices = Vertices_;
+			return !OutVertices.empty();
+		}
+
+		const uint32_t Stride = GetVertexStride();
+		OutVertices.resize(PackedVertices_.size() / Stride);
+		for (size_t i = 0; i < OutVertices.size(); ++i) {
+			VertexPacker::UnpackVertex(Format_, PackedVertices_.data() + i * Stride, PositionScale_, PositionBias_, OutVertices[i]);
+		}
+		return !OutVertices.empty();
+	}
+
+	// 获取原始数据（用于物理碰撞等），eGPUOnly的Mesh需先RetainCPUData
 	const std::vector<Vertex>& GetVertices() const { return Vertices_; }
+	const std::vector<uint8_t>& GetPackedVertices() const { return PackedVertices_; }
 	const std::vector<unsigned int>& GetIndices() const { return Indices_; }
 	const std::vector<SubMeshDesc>& GetSubMeshes() const { return SubMeshes_; }
+
+	// LOD，0为原始网格
+	uint32_t GetLODCount() const { return 1 + (uint32_t)LODs_.size(); }
+	const std::vector<SubMeshDesc>& GetSubMeshes(uint32_t LOD) const {
+		return LOD == 0 || LODs_.empty() ? SubMeshes_ : LODs_[std::min<size_t>(LOD, LODs_.size()) - 1].SubMeshes;
+	}
+	const std::vector<MeshLODDesc>& GetLODs() const { return LODs_; }
+	// 屏幕尺寸对应的最粗一级
+	uint32_t SelectLOD(float ScreenSize) const {
+		uint32_t LOD = 0;
+		while (LOD < LODs_.size() && ScreenSize < LODs_[LOD].ScreenSize) {
+			LOD++;
+		}
+		return LOD;
+	}
 	std::shared_ptr<IMaterial> GetMaterial(uint64_t i) { return i < Materials_.size() ? Materials_[i] : nullptr; }
+	// 绘制录制使用，不复制shared_ptr
+	IMaterial* GetMaterialPtr(uint64_t i) const { return i < Materials_.size() ? Materials_[i].get() : nullptr; }
 	const std::vector<std::shared_ptr<IMaterial>>& GetMaterials() const { return Materials_; }
 	uint64_t GetMaterialCount() const { return Materials_.size(); }
 
-	// 包围盒
-	FVector3 GetCenter() const { return (BoundsMin + BoundsMax) * 0.5f; }
-	FVector3 GetExtent() const { return BoundsMax - BoundsMin; }
-	float GetRadius() const { return (GetExtent() * 0.5f).norm(); }
-	bool IsValid() const { return BoundsMin[0] != FLT_MAX && BoundsMax[0] != -FLT_MAX; }
+	// 局部空间包围盒
+	const FBoundingBox& GetBounds() const { return Bounds_; }
+	FVector3 GetCenter() const { return Bounds_.GetCenter(); }
+	FVector3 GetExtent() const { return Bounds_.Max - Bounds_.Min; }
+	float GetRadius() const { return Bounds_.GetRadius(); }
+	bool HasBounds() const { return Bounds_.IsValid(); }
+
+protected:
+	// 从GPU读回顶点/索引数据，可在任意线程调用，由后端切换到拥有图形上下文的线程
+	virtual bool ReadbackCPUData() = 0;
+
+	void DropCPUData() {
+		std::vector<Vertex>().swap(Vertices_);
+		std::vector<uint8_t>().swap(PackedVertices_);
+		std::vector<uint32_t>().swap(Indices_);
+	}
 
 protected:
 	std::vector<Vertex> Vertices_;
+	std::vector<uint8_t> PackedVertices_;   // 非eStandard格式的顶点数据
 	std::vector<uint32_t> Indices_;
 	std::vector<std::shared_ptr<IMaterial>> Materials_;
 	std::vector<SubMeshDesc> SubMeshes_;
+	std::vector<MeshLODDesc> LODs_;
+
+	FBoundingBox Bounds_;
+
+	uint32_t VertexCount_;
+	uint32_t IndexCount_;
+	MeshResidency Residency_;
+	uint32_t CPUDataRefCount_;
 
-	FVector3 BoundsMin;
-	FVector3 BoundsMax;
+	VertexFormat Format_;
+	FVector3 PositionScale_;
+	FVector3 PositionBias_;
 };
\ No newline at end of file
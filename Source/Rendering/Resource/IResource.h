@@ -3,6 +3,7 @@
 #include "RenderModuleAPI.h"
 #include "Core/UniqueID.h"
 #include "Core/DynamicCast.h"
+#include <atomic>
 #include <string>
 
 struct IResourceDesc {
@@ -19,7 +20,7 @@ enum class ResourceType {
 
 class IResource {
 public:
-	IResource() : UniqueID_(UUID::Generate()), RefCount(0), IsValid_(false){}
+	IResource() : UniqueID_(UUID::Generate()), RefCount(0), HandleValue_(0), LastUsed_(0), IsValid_(false){}
 	virtual void Unload() = 0;
 
 public:
@@ -32,9 +33,23 @@ public:
 	uint32_t Refer() { return ++RefCount; }
 	uint32_t Release() { return --RefCount; }
 
+	// 资源表中的句柄值（Handle<T>），注册时由ResourceManager写入
+	uint32_t GetHandleValue() const { return HandleValue_; }
+	void SetHandleValue(uint32_t Value) { HandleValue_ = Value; }
+
+	// 最近使用时间（递增计数），供驻留管理按LRU驱逐，可在任意线程更新
+	uint64_t GetLastUsed() const { return LastUsed_.load(std::memory_order_relaxed); }
+	void SetLastUsed(uint64_t Tick) { LastUsed_.store(Tick, std::memory_order_relaxed); }
+
+	// 内存占用估计，供驻留管理按预算驱逐
+	virtual uint64_t GetCPUMemorySize() const { return 0; }
+	virtual uint64_t GetGPUMemorySize() const { return 0; }
+
 protected:
 	uint64_t UniqueID_;
-	uint32_t RefCount;
+	std::atomic<uint32_t> RefCount;
+	uint32_t HandleValue_;
+	std::atomic<uint64_t> LastUsed_;
 
 	std::string Name_;
 	bool IsValid_;
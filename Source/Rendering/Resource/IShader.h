@@ -4,6 +4,8 @@
 #include "IMaterial.h"
 #include "Core/BaseMath.h"
 
+#include <vector>
+
 enum class ShaderStage {
 	eVertex = 0,
 	eFragment,
@@ -17,9 +19,9 @@ struct UniformInfo {
 };
 
 struct ShaderUniformLayout {
-	uint32_t blockIndex; // UBO block 编号
-	uint32_t binding;    // layout(binding = X)
-	int blockSize; // UBO 总字节大小
+	uint32_t blockIndex = 0; // UBO block 编号
+	uint32_t binding = 0;    // layout(binding = X)
+	int blockSize = 0; // UBO 总字节大小
 	std::unordered_map<std::string, UniformInfo> uniforms;
 };
 
@@ -37,6 +39,10 @@ public:
 	virtual void Bind() = 0;
 	virtual void Unbind() = 0;
 
+	// 后台编译中的Shader尚不可用于绘制，WaitUntilReady阻塞至编译完成
+	virtual bool IsReady() const { return true; }
+	virtual bool WaitUntilReady() { return IsValid(); }
+
 	// Uniform设置
 	virtual void SetInt(const std::string& name, int value) = 0;
 	virtual void SetFloat(const std::string& name, float value) = 0;
@@ -45,5 +51,11 @@ public:
 	virtual void SetVec4(const std::string& name, const FVector4& value) = 0;
 	virtual void SetMat3(const std::string& name, const FMatrix3& value) = 0;
 	virtual void SetMat4(const std::string& name, const FMatrix4& value) = 0;
-	virtual void UploadMaterial(const IMaterial& Mat) = 0;
+
+	// 按材质块布局把材质参数打包成std140数据
+	virtual bool PackMaterial(const IMaterial& Mat, std::vector<uint8_t>& OutBlock) const = 0;
+	const ShaderUniformLayout& GetMaterialLayout() const { return MaterialLayout_; }
+
+protected:
+	ShaderUniformLayout MaterialLayout_;
 };
\ No newline at end of file
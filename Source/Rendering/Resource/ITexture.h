@@ -1,6 +1,10 @@
 ﻿#pragma once
 
 #include "IResource.h"
+#include "TextureFormat.h"
+
+#include <memory>
+#include <vector>
 
 enum class TextureSlot : uint32_t {
 	eAlbedo = 0,      // 基础颜色
@@ -20,16 +24,44 @@ enum class TextureSlot : uint32_t {
 	// ...
 };
 
+// 单个Mip在像素数据中的位置，Mip 0为最高分辨率
+struct TextureMipDesc {
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	uint64_t Offset = 0;
+	uint64_t Size = 0;
+};
+
+struct TextureDesc : public IResourceDesc {
+	TextureFormat Format = TextureFormat::eRGBA8;
+	uint32_t Width = 0;
+	uint32_t Height = 0;
+	std::vector<TextureMipDesc> Mips;
+	// 全部Mip的像素数据，共享给后端用于流式加载，复制描述时不复制像素
+	std::shared_ptr<const std::vector<uint8_t>> Data;
+	// 烘焙文件的完整路径，Mip偏移即文件内偏移。非空时后端只保留常驻Mip，高Mip换入时从文件重新读取
+	std::string CookedPath;
+};
+
 class ITexture : public IResource{
 public:
-	ITexture() { Type_ = ResourceType::eTexture; }
+	ITexture() : Width_(0), Height_(0), MipCount_(0) { Type_ = ResourceType::eTexture; }
 
 public:
-	virtual bool Load(const std::string& path) = 0;
+	virtual bool Load(const TextureDesc& Desc) = 0;
 	virtual void Unload() = 0;
 
 	virtual void Bind(uint32_t binding) const = 0;
 	virtual void Unbind() const = 0;
 
 	virtual void* GetNativeHandle() const = 0;
+
+	uint32_t GetWidth() const { return Width_; }
+	uint32_t GetHeight() const { return Height_; }
+	uint32_t GetMipCount() const { return MipCount_; }
+
+protected:
+	uint32_t Width_;
+	uint32_t Height_;
+	uint32_t MipCount_;
 };
\ No newline at end of file
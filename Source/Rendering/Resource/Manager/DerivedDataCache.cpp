@@ -0,0 +1,144 @@
+﻿#include "DerivedDataCache.h"
+#include "Loader/CookedMesh.h"
+#include <Logger.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+bool DerivedDataKey::AppendFile(const std::string& FilePath) {
+	std::ifstream Input(FilePath, std::ios::binary);
+	if (!Input) {
+		return false;
+	}
+
+	char Buffer[64 * 1024];
+	while (Input) {
+		Input.read(Buffer, sizeof(Buffer));
+		AppendBytes(Buffer, (size_t)Input.gcount());
+	}
+	return true;
+}
+
+DerivedDataCache& DerivedDataCache::Instance() {
+	static DerivedDataCache GlobalDerivedDataCache;
+	return GlobalDerivedDataCache;
+}
+
+bool DerivedDataCache::Initialize(const std::string& Directory) {
+	Directory_ = Directory;
+	Enabled_ = false;
+
+	std::error_code Error;
+	for (size_t i = 0; i < (size_t)DerivedDataType::eCount; ++i) {
+		std::filesystem::create_directories(Directory_ + "/" + GetTypeName((DerivedDataType)i), Error);
+		if (Error) {
+			LOG_WARN << "Create derived data cache directory '" << Directory_ << "' failed, cache disabled: " << Error.message();
+			return false;
+		}
+	}
+
+	Enabled_ = true;
+	LOG_INFO << "Derived data cache at '" << Directory_ << "'.";
+	return true;
+}
+
+const char* DerivedDataCache::GetTypeName(DerivedDataType Type) {
+	switch (Type) {
+	case DerivedDataType::eMesh: return "Meshes";
+	case DerivedDataType::eMaterial: return "Materials";
+	case DerivedDataType::eShader: return "Shaders";
+	case DerivedDataType::eShaderProgram: return "ShaderPrograms";
+	default: return "Unknown";
+	}
+}
+
+std::string DerivedDataCache::GetEntryPath(DerivedDataType Type, uint64_t Key) const {
+	std::ostringstream Path;
+	Path << Directory_ << "/" << GetTypeName(Type) << "/" << std::hex << std::setw(16) << std::setfill('0') << Key
+		<< (Type == DerivedDataType::eMesh ? COOKED_MESH_EXTENSION : ".ddc");
+	return Path.str();
+}
+
+bool DerivedDataCache::Contains(DerivedDataType Type, uint64_t Key) const {
+	std::error_code Error;
+	return Enabled_ && std::filesystem::is_regular_file(GetEntryPath(Type, Key), Error);
+}
+
+bool DerivedDataCache::Load(DerivedDataType Type, uint64_t Key, std::vector<uint8_t>& OutData) const {
+	if (!Enabled_) {
+		return false;
+	}
+
+	std::ifstream Input(GetEntryPath(Type, Key), std::ios::binary | std::ios::ate);
+	if (!Input) {
+		return false;
+	}
+
+	const std::streamsize Size = Input.tellg();
+	Input.seekg(0, std::ios::beg);
+	OutData.resize((size_t)Size);
+	return Size > 0 && Input.read((char*)OutData.data(), Size).good();
+}
+
+bool DerivedDataCache::Store(DerivedDataType Type, uint64_t Key, const std::vector<uint8_t>& Data) {
+	if (!Enabled_ || Data.empty()) {
+		return false;
+	}
+
+	const std::string EntryPath = GetEntryPath(Type, Key);
+	// 不同线程可能同时写同一条目，临时文件按线程区分
+	std::ostringstream TempName;
+	TempName << EntryPath << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+	const std::string TempPath = TempName.str();
+	{
+		std::ofstream Output(TempPath, std::ios::binary | std::ios::trunc);
+		if (!Output || !Output.write((const char*)Data.data(), (std::streamsize)Data.size())) {
+			LOG_WARN << "Write derived data '" << TempPath << "' failed.";
+			return false;
+		}
+	}
+
+	std::error_code Error;
+	std::filesystem::rename(TempPath, EntryPath, Error);
+	if (Error) {
+		std::filesystem::remove(TempPath, Error);
+		LOG_WARN << "Commit derived data '" << EntryPath << "' failed.";
+		return false;
+	}
+
+	MutexGuard Guard(StatsMutex_);
+	Stats_[(size_t)Type].Writes++;
+	return true;
+}
+
+void DerivedDataCache::RecordHit(DerivedDataType Type, double TimeMs) {
+	MutexGuard Guard(StatsMutex_);
+	Stats_[(size_t)Type].Hits++;
+	Stats_[(size_t)Type].HitTimeMs += TimeMs;
+}
+
+void DerivedDataCache::RecordMiss(DerivedDataType Type, double TimeMs) {
+	MutexGuard Guard(StatsMutex_);
+	Stats_[(size_t)Type].Misses++;
+	Stats_[(size_t)Type].MissTimeMs += TimeMs;
+}
+
+DerivedDataStats DerivedDataCache::GetStats(DerivedDataType Type) {
+	MutexGuard Guard(StatsMutex_);
+	return Stats_[(size_t)Type];
+}
+
+void DerivedDataCache::LogStats() {
+	MutexGuard Guard(StatsMutex_);
+	for (size_t i = 0; i < (size_t)DerivedDataType::eCount; ++i) {
+		const DerivedDataStats& Stats = Stats_[i];
+		if (Stats.Hits + Stats.Misses == 0) {
+			continue;
+		}
+		LOG_INFO << "Derived data cache [" << GetTypeName((DerivedDataType)i) << "]: hit rate "
+			<< Stats.GetHitRate() * 100.0f << "% (" << Stats.Hits << " hits " << Stats.HitTimeMs << " ms, "
+			<< Stats.Misses << " misses " << Stats.MissTimeMs << " ms), " << Stats.Writes << " writes.";
+	}
+}
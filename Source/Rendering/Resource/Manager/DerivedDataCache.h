@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Core/Mutex.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 派生数据类别，各自存放在缓存目录的子目录中
+enum class DerivedDataType : uint8_t {
+	eMesh = 0,         // 烘焙网格（.smesh）
+	eMaterial,         // 材质描述
+	eShader,           // Shader描述
+	eShaderProgram,    // 链接后的程序二进制和反射布局，与驱动相关
+	eCount
+};
+
+struct DerivedDataStats {
+	uint64_t Hits = 0;
+	uint64_t Misses = 0;
+	uint64_t Writes = 0;
+	double HitTimeMs = 0.0;     // 命中时加载耗时总和
+	double MissTimeMs = 0.0;    // 未命中时导入+写缓存耗时总和
+
+	float GetHitRate() const { return Hits + Misses > 0 ? (float)Hits / (Hits + Misses) : 0.0f; }
+};
+
+// FNV-1a 64位增量哈希，由源文件内容、导入器版本和导入参数组成缓存键
+class DerivedDataKey {
+public:
+	DerivedDataKey& AppendBytes(const void* Data, size_t Size) {
+		const uint8_t* Bytes = (const uint8_t*)Data;
+		for (size_t i = 0; i < Size; ++i) {
+			Hash_ = (Hash_ ^ Bytes[i]) * 0x100000001B3ull;
+		}
+		return *this;
+	}
+
+	template<typename T>
+	DerivedDataKey& Append(const T& Value) {
+		return AppendBytes(&Value, sizeof(T));
+	}
+
+	DerivedDataKey& AppendString(const std::string& Value) {
+		Append((uint32_t)Value.size());
+		return AppendBytes(Value.data(), Value.size());
+	}
+
+	// 追加文件内容，文件不存在时返回false
+	ENGINE_RENDERING_API bool AppendFile(const std::string& FilePath);
+
+	uint64_t Get() const { return Hash_; }
+
+private:
+	uint64_t Hash_ = 0xCBF29CE484222325ull;
+};
+
+/**
+ * 持久化的派生数据缓存（DDC）。导入结果按缓存键写入磁盘，
+ * 源文件或导入参数不变时下次启动直接读取，跳过重新导入。可在工作线程中使用。
+ */
+class DerivedDataCache {
+public:
+	ENGINE_RENDERING_API static DerivedDataCache& Instance();
+
+public:
+	ENGINE_RENDERING_API bool Initialize(const std::string& Directory = DERIVED_DATA_CACHE_PATH);
+
+	ENGINE_RENDERING_API void SetEnabled(bool Enabled) { Enabled_ = Enabled; }
+	ENGINE_RENDERING_API bool IsEnabled() const { return Enabled_; }
+
+	ENGINE_RENDERING_API std::string GetEntryPath(DerivedDataType Type, uint64_t Key) const;
+	ENGINE_RENDERING_API bool Contains(DerivedDataType Type, uint64_t Key) const;
+	ENGINE_RENDERING_API bool Load(DerivedDataType Type, uint64_t Key, std::vector<uint8_t>& OutData) const;
+	// 先写临时文件再重命名，进程中断时不会留下半个条目
+	ENGINE_RENDERING_API bool Store(DerivedDataType Type, uint64_t Key, const std::vector<uint8_t>& Data);
+
+	// 统计
+	ENGINE_RENDERING_API void RecordHit(DerivedDataType Type, double TimeMs);
+	ENGINE_RENDERING_API void RecordMiss(DerivedDataType Type, double TimeMs);
+	ENGINE_RENDERING_API DerivedDataStats GetStats(DerivedDataType Type);
+	ENGINE_RENDERING_API void LogStats();
+
+	static const char* GetTypeName(DerivedDataType Type);
+
+private:
+	DerivedDataCache() : Enabled_(false) {}
+
+private:
+	std::string Directory_;
+	bool Enabled_;
+	Mutex StatsMutex_;
+	DerivedDataStats Stats_[(size_t)DerivedDataType::eCount];
+};
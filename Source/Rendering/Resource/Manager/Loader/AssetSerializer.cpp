@@ -0,0 +1,141 @@
+﻿#include "AssetSerializer.h"
+#include "Resource/IMaterial.h"
+#include "Resource/IShader.h"
+
+void AssetSerializer::WriteMaterial(BinaryWriter& Writer, const MaterialDesc& Desc) {
+	Writer.WriteString(Desc.Name);
+	Writer.WriteString(Desc.FilePath);
+	Writer.WriteString(Desc.ShaderPath);
+
+	Writer.Write((uint32_t)Desc.Uniforms.size());
+	for (const auto& [Name, Value] : Desc.Uniforms) {
+		Writer.WriteString(Name);
+		Writer.Write((uint32_t)Value.type);
+		Writer.Write((uint32_t)Value.data.size());
+		Writer.WriteBytes(Value.data.data(), Value.data.size() * sizeof(float));
+	}
+
+	Writer.Write((uint32_t)Desc.TexturePaths.size());
+	for (const auto& [Slot, Path] : Desc.TexturePaths) {
+		Writer.Write((uint32_t)Slot);
+		Writer.WriteString(Path);
+	}
+}
+
+bool AssetSerializer::ReadMaterial(BinaryReader& Reader, MaterialDesc& Desc) {
+	if (!Reader.ReadString(Desc.Name) || !Reader.ReadString(Desc.FilePath) || !Reader.ReadString(Desc.ShaderPath)) {
+		return false;
+	}
+
+	uint32_t UniformCount = 0;
+	if (!Reader.Read(UniformCount)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < UniformCount; ++i) {
+		std::string Name;
+		uint32_t Type = 0;
+		uint32_t FloatCount = 0;
+		// 最大为Matrix4
+		if (!Reader.ReadString(Name) || !Reader.Read(Type) || !Reader.Read(FloatCount) || FloatCount > 16) {
+			return false;
+		}
+
+		MaterialValue Value;
+		Value.type = (MaterialValue::Type)Type;
+		Value.data.resize(FloatCount);
+		if (!Reader.ReadBytes(Value.data.data(), FloatCount * sizeof(float))) {
+			return false;
+		}
+		Desc.Uniforms[Name] = std::move(Value);
+	}
+
+	uint32_t TextureCount = 0;
+	if (!Reader.Read(TextureCount)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < TextureCount; ++i) {
+		uint32_t Slot = 0;
+		std::string Path;
+		if (!Reader.Read(Slot) || !Reader.ReadString(Path)) {
+			return false;
+		}
+		Desc.TexturePaths[(TextureSlot)Slot] = Path;
+	}
+	return true;
+}
+
+void AssetSerializer::WriteShader(BinaryWriter& Writer, const ShaderDesc& Desc) {
+	Writer.WriteString(Desc.Name);
+	Writer.WriteString(Desc.FilePath);
+
+	Writer.Write((uint32_t)Desc.Stages.size());
+	for (const auto& [Stage, Source] : Desc.Stages) {
+		Writer.Write((uint32_t)Stage);
+		Writer.WriteString(Source);
+	}
+}
+
+bool AssetSerializer::ReadShader(BinaryReader& Reader, ShaderDesc& Desc) {
+	if (!Reader.ReadString(Desc.Name) || !Reader.ReadString(Desc.FilePath)) {
+		return false;
+	}
+
+	uint32_t StageCount = 0;
+	if (!Reader.Read(StageCount)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < StageCount; ++i) {
+		uint32_t Stage = 0;
+		std::string Source;
+		if (!Reader.Read(Stage) || !Reader.ReadString(Source)) {
+			return false;
+		}
+		Desc.Stages[(ShaderStage)Stage] = Source;
+	}
+	return true;
+}
+
+void AssetSerializer::WriteShaderLayout(BinaryWriter& Writer, const ShaderUniformLayout& Layout) {
+	Writer.Write(Layout.blockIndex);
+	Writer.Write(Layout.binding);
+	Writer.Write((int32_t)Layout.blockSize);
+
+	Writer.Write((uint32_t)Layout.uniforms.size());
+	for (const auto& [Name, Info] : Layout.uniforms) {
+		Writer.WriteString(Name);
+		Writer.Write((int32_t)Info.offset);
+		Writer.Write((int32_t)Info.size);
+		Writer.Write((uint32_t)Info.type);
+	}
+}
+
+bool AssetSerializer::ReadShaderLayout(BinaryReader& Reader, ShaderUniformLayout& Layout) {
+	int32_t BlockSize = 0;
+	uint32_t UniformCount = 0;
+	if (!Reader.Read(Layout.blockIndex) || !Reader.Read(Layout.binding) || !Reader.Read(BlockSize) || !Reader.Read(UniformCount)) {
+		return false;
+	}
+	Layout.blockSize = BlockSize;
+
+	for (uint32_t i = 0; i < UniformCount; ++i) {
+		std::string Name;
+		int32_t Offset = 0;
+		int32_t Size = 0;
+		uint32_t Type = 0;
+		if (!Reader.ReadString(Name) || !Reader.Read(Offset) || !Reader.Read(Size) || !Reader.Read(Type)) {
+			return false;
+		}
+
+		// 偏移越界说明数据已损坏
+		if (Offset < 0 || Size <= 0 || Offset + Size > BlockSize) {
+			return false;
+		}
+
+		UniformInfo Info;
+		Info.offset = Offset;
+		Info.size = Size;
+		Info.type = (MaterialValue::Type)Type;
+		Layout.uniforms[Name] = Info;
+	}
+	return true;
+}
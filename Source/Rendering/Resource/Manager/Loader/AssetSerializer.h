@@ -0,0 +1,95 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct MaterialDesc;
+struct ShaderDesc;
+struct ShaderUniformLayout;
+
+// 追加写入的二进制缓冲，用于烘焙文件和派生数据缓存
+class BinaryWriter {
+public:
+	explicit BinaryWriter(std::vector<uint8_t>& Buffer) : Buffer_(Buffer) {}
+
+	void WriteBytes(const void* Data, size_t Size) {
+		const uint8_t* Bytes = (const uint8_t*)Data;
+		Buffer_.insert(Buffer_.end(), Bytes, Bytes + Size);
+	}
+
+	template<typename T>
+	void Write(const T& Value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only POD values can be written.");
+		WriteBytes(&Value, sizeof(T));
+	}
+
+	void WriteString(const std::string& Value) {
+		Write((uint32_t)Value.size());
+		WriteBytes(Value.data(), Value.size());
+	}
+
+	// 按Alignment补零对齐
+	void Align(uint64_t Alignment) {
+		Buffer_.resize((Buffer_.size() + Alignment - 1) & ~(Alignment - 1), 0);
+	}
+
+	uint64_t GetSize() const { return Buffer_.size(); }
+
+private:
+	std::vector<uint8_t>& Buffer_;
+};
+
+// 读取时检查越界，数据损坏时返回false而不是读出范围
+class BinaryReader {
+public:
+	BinaryReader(const uint8_t* Data, uint64_t Size) : Data_(Data), Size_(Size), Offset_(0) {}
+
+	bool ReadBytes(void* Data, uint64_t Size) {
+		if (Size > Size_ - Offset_) {
+			return false;
+		}
+		memcpy(Data, Data_ + Offset_, Size);
+		Offset_ += Size;
+		return true;
+	}
+
+	template<typename T>
+	bool Read(T& Value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only POD values can be read.");
+		return ReadBytes(&Value, sizeof(T));
+	}
+
+	bool ReadString(std::string& Value) {
+		uint32_t Length = 0;
+		if (!Read(Length) || Length > Size_ - Offset_) {
+			return false;
+		}
+		Value.assign((const char*)Data_ + Offset_, Length);
+		Offset_ += Length;
+		return true;
+	}
+
+	bool IsEnd() const { return Offset_ == Size_; }
+
+private:
+	const uint8_t* Data_;
+	uint64_t Size_;
+	uint64_t Offset_;
+};
+
+// 资源描述的二进制序列化
+class AssetSerializer {
+public:
+	ENGINE_RENDERING_API static void WriteMaterial(BinaryWriter& Writer, const MaterialDesc& Desc);
+	ENGINE_RENDERING_API static bool ReadMaterial(BinaryReader& Reader, MaterialDesc& Desc);
+
+	ENGINE_RENDERING_API static void WriteShader(BinaryWriter& Writer, const ShaderDesc& Desc);
+	ENGINE_RENDERING_API static bool ReadShader(BinaryReader& Reader, ShaderDesc& Desc);
+
+	ENGINE_RENDERING_API static void WriteShaderLayout(BinaryWriter& Writer, const ShaderUniformLayout& Layout);
+	ENGINE_RENDERING_API static bool ReadShaderLayout(BinaryReader& Reader, ShaderUniformLayout& Layout);
+};
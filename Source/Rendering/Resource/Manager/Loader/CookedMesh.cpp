@@ -0,0 +1,270 @@
+﻿#include "CookedMesh.h"
+#include "AssetSerializer.h"
+#include "Resource/IMesh.h"
+#include "Resource/IMaterial.h"
+#include "Platform/File/File.h"
+#include "Platform/File/MappedFile.h"
+#include <Logger.hpp>
+#include <cstring>
+
+static_assert(sizeof(CookedMeshHeader) == 144, "CookedMeshHeader layout changed, bump COOKED_MESH_VERSION.");
+static_assert(sizeof(CookedSubMesh) == 16, "CookedSubMesh layout changed, bump COOKED_MESH_VERSION.");
+static_assert(sizeof(CookedMeshLOD) == 16, "CookedMeshLOD layout changed, bump COOKED_MESH_VERSION.");
+
+namespace {
+
+	constexpr uint64_t BlockAlignment = 16;
+
+	bool IsBlockInFile(uint64_t Offset, uint64_t Size, uint64_t FileSize) {
+		return Offset % BlockAlignment == 0 && Offset <= FileSize && Size <= FileSize - Offset;
+	}
+
+	// 子网格的索引区间、顶点基址、材质索引以及其中每个索引都必须落在文件中的数据范围内
+	bool IsSubMeshValid(const CookedSubMesh& SubMesh, const CookedMeshHeader& Header, const uint32_t* Indices) {
+		if ((uint64_t)SubMesh.BaseIndex + SubMesh.IndexCount > Header.IndexCount ||
+			SubMesh.BaseVertex >= Header.VertexCount || SubMesh.MaterialIndex >= Header.MaterialCount) {
+			return false;
+		}
+
+		const uint64_t MaxIndex = (uint64_t)Header.VertexCount - SubMesh.BaseVertex;
+		for (uint32_t i = 0; i < SubMesh.IndexCount; ++i) {
+			if (Indices[SubMesh.BaseIndex + i] >= MaxIndex) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+}
+
+bool CookedMesh::Serialize(const MeshDesc& Desc, std::vector<uint8_t>& Buffer) {
+	const VertexFormat Format = Desc.Format;
+	const uint32_t Stride = VertexLayout::GetStride(Format);
+
+	// 顶点数据：标准格式直接写Vertices，其它格式写打包后的数据
+	std::vector<uint8_t> Packed;
+	FVector3 PositionScale = Desc.PositionScale;
+	FVector3 PositionBias = Desc.PositionBias;
+	const void* VertexData = nullptr;
+	uint64_t VertexBytes = 0;
+	if (Format == VertexFormat::eStandard) {
+		VertexData = Desc.Vertices.data();
+		VertexBytes = Desc.Vertices.size() * sizeof(Vertex);
+	}
+	else if (!Desc.PackedVertices.empty()) {
+		VertexData = Desc.PackedVertices.data();
+		VertexBytes = Desc.PackedVertices.size();
+	}
+	else {
+		VertexPacker::PackVertices(Format, Desc.Vertices, Packed, PositionScale, PositionBias);
+		VertexData = Packed.data();
+		VertexBytes = Packed.size();
+	}
+
+	if (VertexBytes == 0 || VertexBytes % Stride != 0 || Desc.Indices.empty() || Desc.SubMeshes.empty()) {
+		LOG_ERROR << "Cook mesh '" << Desc.Name << "' failed, invalid vertex data.";
+		return false;
+	}
+
+	CookedMeshHeader Header = {};
+	Header.Magic = COOKED_MESH_MAGIC;
+	Header.Version = COOKED_MESH_VERSION;
+	Header.Format = (uint32_t)Format;
+	Header.Stride = Stride;
+	Header.VertexCount = (uint32_t)(VertexBytes / Stride);
+	Header.IndexCount = (uint32_t)Desc.Indices.size();
+	Header.SubMeshCount = (uint32_t)Desc.SubMeshes.size();
+	Header.MaterialCount = (uint32_t)Desc.Materials.size();
+	Header.LODCount = (uint32_t)Desc.LODs.size();
+	for (int i = 0; i < 3; ++i) {
+		Header.BoundsMin[i] = Desc.BoundsMin[i];
+		Header.BoundsMax[i] = Desc.BoundsMax[i];
+		Header.PositionScale[i] = PositionScale[i];
+		Header.PositionBias[i] = PositionBias[i];
+	}
+
+	Buffer.clear();
+	Buffer.reserve(sizeof(CookedMeshHeader) + VertexBytes + Desc.Indices.size() * sizeof(uint32_t) + 4096);
+	BinaryWriter Writer(Buffer);
+	Writer.Write(Header);
+
+	// SubMesh表
+	Writer.Align(BlockAlignment);
+	Header.SubMeshOffset = Buffer.size();
+	for (const SubMeshDesc& SubMesh : Desc.SubMeshes) {
+		CookedSubMesh Record = { SubMesh.BaseVertex, SubMesh.BaseIndex, SubMesh.IndexCount, SubMesh.MaterialIndex };
+		Writer.Write(Record);
+	}
+	for (const MeshLODDesc& LOD : Desc.LODs) {
+		for (const SubMeshDesc& SubMesh : LOD.SubMeshes) {
+			CookedSubMesh Record = { SubMesh.BaseVertex, SubMesh.BaseIndex, SubMesh.IndexCount, SubMesh.MaterialIndex };
+			Writer.Write(Record);
+		}
+		Header.LODSubMeshCount += (uint32_t)LOD.SubMeshes.size();
+	}
+
+	// LOD表
+	Writer.Align(BlockAlignment);
+	Header.LODOffset = Buffer.size();
+	uint32_t FirstSubMesh = Header.SubMeshCount;
+	for (const MeshLODDesc& LOD : Desc.LODs) {
+		CookedMeshLOD Record = { LOD.ScreenSize, LOD.Error, FirstSubMesh, (uint32_t)LOD.SubMeshes.size() };
+		Writer.Write(Record);
+		FirstSubMesh += Record.SubMeshCount;
+	}
+
+	// 元数据：名称与材质描述
+	Writer.Align(BlockAlignment);
+	Header.MetaOffset = Buffer.size();
+	Writer.WriteString(Desc.Name);
+	Writer.WriteString(Desc.FilePath);
+	for (const SubMeshDesc& SubMesh : Desc.SubMeshes) {
+		Writer.WriteString(SubMesh.Name);
+	}
+	for (const MaterialDesc& Material : Desc.Materials) {
+		AssetSerializer::WriteMaterial(Writer, Material);
+	}
+	Header.MetaSize = Buffer.size() - Header.MetaOffset;
+
+	// 顶点与索引数据
+	Writer.Align(BlockAlignment);
+	Header.VertexOffset = Buffer.size();
+	Writer.WriteBytes(VertexData, VertexBytes);
+	Writer.Align(BlockAlignment);
+	Header.IndexOffset = Buffer.size();
+	Writer.WriteBytes(Desc.Indices.data(), Desc.Indices.size() * sizeof(uint32_t));
+	Header.FileSize = Buffer.size();
+
+	memcpy(Buffer.data(), &Header, sizeof(CookedMeshHeader));
+	return true;
+}
+
+bool CookedMesh::Write(const std::string& FilePath, const MeshDesc& Desc) {
+	std::vector<uint8_t> Buffer;
+	if (!Serialize(Desc, Buffer)) {
+		return false;
+	}
+
+	File Output(FilePath);
+	if (!Output.WriteBytes((const char*)Buffer.data(), Buffer.size(), std::ios::out | std::ios::binary | std::ios::trunc)) {
+		LOG_ERROR << "Write cooked mesh '" << FilePath << "' failed.";
+		return false;
+	}
+
+	LOG_INFO << "Cooked mesh '" << Desc.Name << "' -> '" << FilePath << "', " << Desc.GetVertexCount() << " vertices ("
+		<< VertexPacker::GetFormatName(Desc.Format) << "), " << Desc.Indices.size() << " indices, " << Desc.LODs.size() + 1 << " LODs, "
+		<< Buffer.size() << " bytes.";
+	return true;
+}
+
+bool CookedMesh::Load(const std::string& FilePath, MeshDesc& Desc, MappedFile& Mapping) {
+	if (!Mapping.Open(FilePath)) {
+		LOG_ERROR << Mapping.GetLastError();
+		return false;
+	}
+
+	const uint8_t* Data = Mapping.GetData();
+	const uint64_t Size = Mapping.GetSize();
+	CookedMeshHeader Header;
+	if (Size < sizeof(CookedMeshHeader)) {
+		LOG_ERROR << "Cooked mesh '" << FilePath << "' is truncated.";
+		return false;
+	}
+	memcpy(&Header, Data, sizeof(CookedMeshHeader));
+
+	if (Header.Magic != COOKED_MESH_MAGIC || Header.Version != COOKED_MESH_VERSION) {
+		LOG_ERROR << "Cooked mesh '" << FilePath << "' has unsupported version " << Header.Version << ", recook it.";
+		return false;
+	}
+	if (Header.Format >= (uint32_t)VertexFormat::eCount || Header.Stride != VertexLayout::GetStride((VertexFormat)Header.Format)) {
+		LOG_ERROR << "Cooked mesh '" << FilePath << "' has invalid vertex format.";
+		return false;
+	}
+	if (Header.FileSize != Size ||
+		!IsBlockInFile(Header.SubMeshOffset, ((uint64_t)Header.SubMeshCount + Header.LODSubMeshCount) * sizeof(CookedSubMesh), Size) ||
+		!IsBlockInFile(Header.LODOffset, (uint64_t)Header.LODCount * sizeof(CookedMeshLOD), Size) ||
+		!IsBlockInFile(Header.MetaOffset, Header.MetaSize, Size) ||
+		!IsBlockInFile(Header.VertexOffset, (uint64_t)Header.VertexCount * Header.Stride, Size) ||
+		!IsBlockInFile(Header.IndexOffset, (uint64_t)Header.IndexCount * sizeof(uint32_t), Size)) {
+		LOG_ERROR << "Cooked mesh '" << FilePath << "' is corrupted.";
+		return false;
+	}
+
+	// 元数据
+	BinaryReader Reader(Data + Header.MetaOffset, Header.MetaSize);
+	if (!Reader.ReadString(Desc.Name) || !Reader.ReadString(Desc.FilePath)) {
+		LOG_ERROR << "Cooked mesh '" << FilePath << "' has corrupted metadata.";
+		return false;
+	}
+
+	const CookedSubMesh* SubMeshes = (const CookedSubMesh*)(Data + Header.SubMeshOffset);
+	const uint32_t* Indices = (const uint32_t*)(Data + Header.IndexOffset);
+	for (uint32_t i = 0; i < Header.SubMeshCount + Header.LODSubMeshCount; ++i) {
+		if (!IsSubMeshValid(SubMeshes[i], Header, Indices)) {
+			LOG_ERROR << "Cooked mesh '" << FilePath << "' has corrupted submesh " << i << ".";
+			return false;
+		}
+	}
+
+	Desc.SubMeshes.resize(Header.SubMeshCount);
+	for (uint32_t i = 0; i < Header.SubMeshCount; ++i) {
+		SubMeshDesc& SubMesh = Desc.SubMeshes[i];
+		SubMesh.BaseVertex = SubMeshes[i].BaseVertex;
+		SubMesh.BaseIndex = SubMeshes[i].BaseIndex;
+		SubMesh.IndexCount = SubMeshes[i].IndexCount;
+		SubMesh.MaterialIndex = SubMeshes[i].MaterialIndex;
+		if (!Reader.ReadString(SubMesh.Name)) {
+			LOG_ERROR << "Cooked mesh '" << FilePath << "' has corrupted metadata.";
+			return false;
+		}
+	}
+
+	// LOD子网格沿用LOD0的名称
+	const CookedMeshLOD* LODs = (const CookedMeshLOD*)(Data + Header.LODOffset);
+	Desc.LODs.resize(Header.LODCount);
+	for (uint32_t i = 0; i < Header.LODCount; ++i) {
+		MeshLODDesc& LOD = Desc.LODs[i];
+		LOD.ScreenSize = LODs[i].ScreenSize;
+		LOD.Error = LODs[i].Error;
+		if (LODs[i].FirstSubMesh < Header.SubMeshCount || LODs[i].SubMeshCount != Header.SubMeshCount ||
+			(uint64_t)LODs[i].FirstSubMesh + LODs[i].SubMeshCount > (uint64_t)Header.SubMeshCount + Header.LODSubMeshCount) {
+			LOG_ERROR << "Cooked mesh '" << FilePath << "' has corrupted LOD table.";
+			return false;
+		}
+
+		LOD.SubMeshes.resize(LODs[i].SubMeshCount);
+		for (uint32_t j = 0; j < LODs[i].SubMeshCount; ++j) {
+			const CookedSubMesh& Record = SubMeshes[LODs[i].FirstSubMesh + j];
+			SubMeshDesc& SubMesh = LOD.SubMeshes[j];
+			SubMesh.BaseVertex = Record.BaseVertex;
+			SubMesh.BaseIndex = Record.BaseIndex;
+			SubMesh.IndexCount = Record.IndexCount;
+			SubMesh.MaterialIndex = Record.MaterialIndex;
+			SubMesh.Name = Desc.SubMeshes[j].Name;
+		}
+	}
+
+	Desc.Materials.resize(Header.MaterialCount);
+	for (uint32_t i = 0; i < Header.MaterialCount; ++i) {
+		if (!AssetSerializer::ReadMaterial(Reader, Desc.Materials[i])) {
+			LOG_ERROR << "Cooked mesh '" << FilePath << "' has corrupted material data.";
+			return false;
+		}
+	}
+
+	Desc.Format = (VertexFormat)Header.Format;
+	Desc.BoundsMin = FVector3(Header.BoundsMin[0], Header.BoundsMin[1], Header.BoundsMin[2]);
+	Desc.BoundsMax = FVector3(Header.BoundsMax[0], Header.BoundsMax[1], Header.BoundsMax[2]);
+	Desc.PositionScale = FVector3(Header.PositionScale[0], Header.PositionScale[1], Header.PositionScale[2]);
+	Desc.PositionBias = FVector3(Header.PositionBias[0], Header.PositionBias[1], Header.PositionBias[2]);
+
+	// 顶点/索引直接指向映射内存
+	Desc.Vertices.clear();
+	Desc.PackedVertices.clear();
+	Desc.Indices.clear();
+	Desc.VertexView = Data + Header.VertexOffset;
+	Desc.IndexView = Indices;
+	Desc.ViewVertexCount = Header.VertexCount;
+	Desc.ViewIndexCount = Header.IndexCount;
+	return true;
+}
@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MappedFile;
+struct MeshDesc;
+
+#define COOKED_MESH_MAGIC 0x48534D53u   // 'SMSH'
+#define COOKED_MESH_VERSION 2u
+#define COOKED_MESH_EXTENSION ".smesh"
+
+/**
+ * 烘焙网格文件布局（小端，各数据块16字节对齐）：
+ * [Header][SubMesh表][LOD表][元数据：名称/材质描述][顶点数据][索引数据]
+ * SubMesh表先是LOD0的SubMeshCount项，随后是各级LOD的子网格，LOD子网格沿用LOD0的名称。
+ * 顶点数据已按VertexFormat排布，加载时映射文件后直接上传，不做逐顶点转换。
+ */
+struct CookedMeshHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t Format;           // VertexFormat
+	uint32_t Stride;
+	uint32_t VertexCount;
+	uint32_t IndexCount;
+	uint32_t SubMeshCount;
+	uint32_t MaterialCount;
+	float BoundsMin[3];
+	float BoundsMax[3];
+	float PositionScale[3];
+	float PositionBias[3];
+	uint64_t SubMeshOffset;
+	uint64_t MetaOffset;
+	uint64_t MetaSize;
+	uint64_t VertexOffset;
+	uint64_t IndexOffset;
+	uint64_t FileSize;
+	uint32_t LODCount;         // LOD1及之后的级数
+	uint32_t LODSubMeshCount;  // SubMesh表中LOD子网格的项数
+	uint64_t LODOffset;
+};
+
+struct CookedSubMesh {
+	uint32_t BaseVertex;
+	uint32_t BaseIndex;
+	uint32_t IndexCount;
+	uint32_t MaterialIndex;
+};
+
+struct CookedMeshLOD {
+	float ScreenSize;
+	float Error;
+	uint32_t FirstSubMesh;     // 在SubMesh表中的起始项
+	uint32_t SubMeshCount;
+};
+
+class CookedMesh {
+public:
+	// 将Desc序列化为烘焙文件内容，非标准格式且只有标准顶点时先打包
+	ENGINE_RENDERING_API static bool Serialize(const MeshDesc& Desc, std::vector<uint8_t>& OutBuffer);
+	ENGINE_RENDERING_API static bool Write(const std::string& FilePath, const MeshDesc& Desc);
+
+	// 映射烘焙文件并填充Desc，顶点/索引以视图形式指向映射内存，Mapping需在上传完成前保持打开
+	ENGINE_RENDERING_API static bool Load(const std::string& FilePath, MeshDesc& Desc, MappedFile& Mapping);
+
+	static bool IsCookedPath(const std::string& FilePath) {
+		const std::string Extension = COOKED_MESH_EXTENSION;
+		return FilePath.size() > Extension.size() &&
+			FilePath.compare(FilePath.size() - Extension.size(), Extension.size(), Extension) == 0;
+	}
+};
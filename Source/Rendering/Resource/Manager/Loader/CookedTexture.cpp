@@ -0,0 +1,145 @@
+﻿#include "CookedTexture.h"
+#include "AssetSerializer.h"
+#include "Resource/ITexture.h"
+#include "Platform/File/File.h"
+#include "Platform/File/MappedFile.h"
+#include <Logger.hpp>
+#include <cstring>
+
+static_assert(sizeof(CookedTextureHeader) == 64, "CookedTextureHeader layout changed, bump COOKED_TEXTURE_VERSION.");
+static_assert(sizeof(CookedTextureLevel) == 24, "CookedTextureLevel layout changed, bump COOKED_TEXTURE_VERSION.");
+
+namespace {
+
+	constexpr uint64_t BlockAlignment = 16;
+
+	bool IsBlockInFile(uint64_t Offset, uint64_t Size, uint64_t FileSize) {
+		return Offset <= FileSize && Size <= FileSize - Offset;
+	}
+
+}
+
+bool CookedTexture::Serialize(const TextureDesc& Desc, std::vector<uint8_t>& Buffer) {
+	if (!Desc.Data || Desc.Mips.empty() || Desc.Format >= TextureFormat::eCount) {
+		LOG_ERROR << "Cook texture '" << Desc.Name << "' failed, invalid pixel data.";
+		return false;
+	}
+
+	CookedTextureHeader Header = {};
+	Header.Magic = COOKED_TEXTURE_MAGIC;
+	Header.Version = COOKED_TEXTURE_VERSION;
+	Header.Format = (uint32_t)Desc.Format;
+	Header.Width = Desc.Width;
+	Header.Height = Desc.Height;
+	Header.MipCount = (uint32_t)Desc.Mips.size();
+
+	Buffer.clear();
+	Buffer.reserve(sizeof(CookedTextureHeader) + Desc.Data->size() + Desc.Mips.size() * (sizeof(CookedTextureLevel) + BlockAlignment) + 256);
+	BinaryWriter Writer(Buffer);
+	Writer.Write(Header);
+
+	// Level表占位，写完数据后回填
+	Writer.Align(BlockAlignment);
+	Header.LevelOffset = Buffer.size();
+	std::vector<CookedTextureLevel> Levels(Desc.Mips.size());
+	for (const CookedTextureLevel& Level : Levels) {
+		Writer.Write(Level);
+	}
+
+	Header.NameOffset = Buffer.size();
+	Writer.WriteString(Desc.Name);
+	Header.NameSize = Buffer.size() - Header.NameOffset;
+
+	// 最小的Mip在前
+	Writer.Align(BlockAlignment);
+	Header.DataOffset = Buffer.size();
+	for (size_t i = Desc.Mips.size(); i-- > 0;) {
+		const TextureMipDesc& Mip = Desc.Mips[i];
+		if (Mip.Offset + Mip.Size > Desc.Data->size() || Mip.Size != TextureLayout::GetMipSize(Desc.Format, Mip.Width, Mip.Height)) {
+			LOG_ERROR << "Cook texture '" << Desc.Name << "' failed, invalid mip " << i << ".";
+			return false;
+		}
+
+		Writer.Align(BlockAlignment);
+		Levels[i] = { Buffer.size(), Mip.Size, Mip.Width, Mip.Height };
+		Writer.WriteBytes(Desc.Data->data() + Mip.Offset, Mip.Size);
+	}
+	Header.FileSize = Buffer.size();
+
+	memcpy(Buffer.data(), &Header, sizeof(CookedTextureHeader));
+	memcpy(Buffer.data() + Header.LevelOffset, Levels.data(), Levels.size() * sizeof(CookedTextureLevel));
+	return true;
+}
+
+bool CookedTexture::Write(const std::string& FilePath, const TextureDesc& Desc) {
+	std::vector<uint8_t> Buffer;
+	if (!Serialize(Desc, Buffer)) {
+		return false;
+	}
+
+	File Output(FilePath);
+	if (!Output.WriteBytes((const char*)Buffer.data(), Buffer.size(), std::ios::out | std::ios::binary | std::ios::trunc)) {
+		LOG_ERROR << "Write cooked texture '" << FilePath << "' failed.";
+		return false;
+	}
+
+	LOG_INFO << "Cooked texture '" << Desc.Name << "' -> '" << FilePath << "', " << Desc.Width << "x" << Desc.Height << " ("
+		<< TextureLayout::GetFormatName(Desc.Format) << "), " << Desc.Mips.size() << " mips, " << Buffer.size() << " bytes.";
+	return true;
+}
+
+bool CookedTexture::Load(const std::string& FilePath, TextureDesc& Desc) {
+	MappedFile Mapping;
+	if (!Mapping.Open(FilePath)) {
+		LOG_ERROR << Mapping.GetLastError();
+		return false;
+	}
+
+	const uint8_t* Data = Mapping.GetData();
+	const uint64_t Size = Mapping.GetSize();
+	CookedTextureHeader Header;
+	if (Size < sizeof(CookedTextureHeader)) {
+		LOG_ERROR << "Cooked texture '" << FilePath << "' is truncated.";
+		return false;
+	}
+	memcpy(&Header, Data, sizeof(CookedTextureHeader));
+
+	if (Header.Magic != COOKED_TEXTURE_MAGIC || Header.Version != COOKED_TEXTURE_VERSION) {
+		LOG_ERROR << "Cooked texture '" << FilePath << "' has unsupported version " << Header.Version << ", recook it.";
+		return false;
+	}
+	if (Header.Format >= (uint32_t)TextureFormat::eCount || Header.MipCount == 0 || Header.FileSize != Size ||
+		!IsBlockInFile(Header.LevelOffset, (uint64_t)Header.MipCount * sizeof(CookedTextureLevel), Size) ||
+		!IsBlockInFile(Header.NameOffset, Header.NameSize, Size)) {
+		LOG_ERROR << "Cooked texture '" << FilePath << "' is corrupted.";
+		return false;
+	}
+
+	BinaryReader Reader(Data + Header.NameOffset, Header.NameSize);
+	if (!Reader.ReadString(Desc.Name)) {
+		LOG_ERROR << "Cooked texture '" << FilePath << "' has corrupted metadata.";
+		return false;
+	}
+
+	const TextureFormat Format = (TextureFormat)Header.Format;
+	std::vector<CookedTextureLevel> Levels(Header.MipCount);
+	memcpy(Levels.data(), Data + Header.LevelOffset, Levels.size() * sizeof(CookedTextureLevel));
+
+	Desc.Mips.resize(Header.MipCount);
+	for (uint32_t i = 0; i < Header.MipCount; ++i) {
+		const CookedTextureLevel& Level = Levels[i];
+		if (!IsBlockInFile(Level.Offset, Level.Size, Size) || Level.Size != TextureLayout::GetMipSize(Format, Level.Width, Level.Height)) {
+			LOG_ERROR << "Cooked texture '" << FilePath << "' has corrupted mip " << i << ".";
+			return false;
+		}
+		Desc.Mips[i] = { Level.Width, Level.Height, Level.Offset, Level.Size };
+	}
+
+	// 整体复制一次，纹理创建后只保留常驻Mip，高Mip按需从文件读取
+	Desc.Format = Format;
+	Desc.Width = Header.Width;
+	Desc.Height = Header.Height;
+	Desc.Data = std::make_shared<const std::vector<uint8_t>>(Data, Data + Size);
+	Desc.CookedPath = FilePath;
+	return true;
+}
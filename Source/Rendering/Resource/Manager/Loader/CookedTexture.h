@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct TextureDesc;
+
+#define COOKED_TEXTURE_MAGIC 0x58455453u   // 'STEX'
+#define COOKED_TEXTURE_VERSION 1u
+#define COOKED_TEXTURE_EXTENSION ".stex"
+
+/**
+ * 烘焙纹理文件布局（小端，参照KTX2）：
+ * [Header][Level表（Mip 0在前）][名称][Mip数据（最小的Mip在前，各级16字节对齐）]
+ * Mip数据已是GPU格式（BCn块或RGBA8），加载后直接上传，不做任何转码。
+ * 低Mip集中在文件前部，流式加载只需要读取靠前的一段。
+ */
+struct CookedTextureHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t Format;           // TextureFormat
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t MipCount;
+	uint64_t LevelOffset;
+	uint64_t NameOffset;
+	uint64_t NameSize;
+	uint64_t DataOffset;
+	uint64_t FileSize;
+};
+
+struct CookedTextureLevel {
+	uint64_t Offset;           // 相对于文件开头
+	uint64_t Size;
+	uint32_t Width;
+	uint32_t Height;
+};
+
+class CookedTexture {
+public:
+	ENGINE_RENDERING_API static bool Serialize(const TextureDesc& Desc, std::vector<uint8_t>& OutBuffer);
+	ENGINE_RENDERING_API static bool Write(const std::string& FilePath, const TextureDesc& Desc);
+
+	// 读取整个文件，Desc.Data直接持有文件内容，Mip偏移指向其中；Desc.CookedPath记录文件路径供之后按需重新读取
+	ENGINE_RENDERING_API static bool Load(const std::string& FilePath, TextureDesc& Desc);
+
+	static bool IsCookedPath(const std::string& FilePath) {
+		const std::string Extension = COOKED_TEXTURE_EXTENSION;
+		return FilePath.size() > Extension.size() &&
+			FilePath.compare(FilePath.size() - Extension.size(), Extension.size(), Extension) == 0;
+	}
+};
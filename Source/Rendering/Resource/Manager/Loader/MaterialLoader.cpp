@@ -3,6 +3,28 @@
 #include "Platform/File/JsonObject.h"
 #include <Logger.hpp>
 
+// 配置中的纹理槽位名
+static bool ParseTextureSlot(const std::string& Name, TextureSlot& Slot) {
+	static const std::pair<const char*, TextureSlot> Slots[] = {
+		{ "albedo", TextureSlot::eAlbedo },
+		{ "normal", TextureSlot::eNormal },
+		{ "metallic", TextureSlot::eMetallic },
+		{ "roughness", TextureSlot::eRoughness },
+		{ "ao", TextureSlot::eAO },
+		{ "emissive", TextureSlot::eEmissive },
+		{ "height", TextureSlot::eHeight },
+		{ "opacity", TextureSlot::eOpacity },
+	};
+
+	for (const auto& [SlotName, SlotValue] : Slots) {
+		if (Name == SlotName) {
+			Slot = SlotValue;
+			return true;
+		}
+	}
+	return false;
+}
+
 bool MaterialLoader::Load(const std::string& FilePath, struct MaterialDesc& Desc) {
 	File MaterialAsset(MATERIAL_CONFIG_PATH + FilePath);
 	if (!MaterialAsset.IsExist()) {
@@ -41,5 +63,18 @@ bool MaterialLoader::Load(const std::string& FilePath, struct MaterialDesc& Desc
 		Desc.Uniforms[MKey] = MatVal;
 	}
 
+	// 纹理为可选项，路径相对于TEXTURE_ASSET_PATH
+	if (Content.HasKey("Textures")) {
+		JsonObject Textures = Content.Get("Textures");
+		for (const std::string& Key : Textures.GetKeys()) {
+			TextureSlot Slot;
+			if (!ParseTextureSlot(Key, Slot)) {
+				LOG_WARN << "Unknown texture slot '" << Key << "' in material '" << Desc.Name << "'.";
+				continue;
+			}
+			Desc.TexturePaths[Slot] = Textures.Get(Key).GetString();
+		}
+	}
+
 	return true;
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 
 class IMaterial;
 
+// 导入逻辑变化会影响输出时递增，使派生数据缓存失效
+#define MATERIAL_IMPORTER_VERSION 2
+
 class MaterialLoader{
 public:
 	static bool Load(const std::string& FilePath, struct MaterialDesc& Desc);
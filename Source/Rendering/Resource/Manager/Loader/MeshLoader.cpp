@@ -1,9 +1,15 @@
 ﻿#include "MeshLoader.h"
+#include "MeshSimplifier.h"
 #include "Resource/IMesh.h"
 #include "Resource/IMaterial.h"
+#include "CookedMesh.h"
+#include "Resource/Manager/DerivedDataCache.h"
+#include "Platform/File/JsonObject.h"
 #include <Logger.hpp>
+#include <chrono>
 
-bool MeshLoader::Load(const std::string& FilePath, struct MeshDesc& Desc, uint32_t Flags) {
+bool MeshLoader::Load(const std::string& FilePath, struct MeshDesc& Desc, uint32_t Flags,
+	const MeshOptimizeSettings* Settings, MeshOptimizeStats* OutStats) {
 	if (Flags == 0) {
 		Flags = GetDefaultFlags();
 	}
@@ -33,28 +39,179 @@ bool MeshLoader::Load(const std::string& FilePath, struct MeshDesc& Desc, uint32
 		);
 	}
 
+	// 非标准格式直接写入打包后的顶点流
+	Desc.Vertices.clear();
+	Desc.PackedVertices.clear();
+	Desc.LODs.clear();
+	Desc.PositionScale = FVector3::Ones();
+	Desc.PositionBias = FVector3::Zero();
+	if (Desc.Format == VertexFormat::eCompactQuantized) {
+		ComputeQuantization(scene, Desc);
+	}
+
 	// 递归处理节点
-	ProcessNode(scene->mRootNode, scene, Desc, Directory);
+	MeshOptimizeStats Stats;
+	ProcessNode(scene->mRootNode, scene, Desc, Directory, Settings, Stats);
+
+	if (Settings && Stats.TriangleCount > 0) {
+		LOG_INFO << "Mesh '" << FilePath << "' optimized in " << Stats.OptimizeTimeMs << " ms, ACMR "
+			<< Stats.GetACMRBefore() << " -> " << Stats.GetACMRAfter() << ", ATVR "
+			<< Stats.GetATVRBefore() << " -> " << Stats.GetATVRAfter();
+	}
+	if (Settings) {
+		ComputeLODScreenSizes(Desc, *Settings);
+	}
+	if (!Desc.LODs.empty()) {
+		LOG_INFO << "Mesh '" << FilePath << "' generated " << Desc.LODs.size() << " LODs in " << Stats.SimplifyTimeMs
+			<< " ms, triangles " << GetLODTriangleCount(Desc, 0) << " -> " << GetLODTriangleCount(Desc, (uint32_t)Desc.LODs.size())
+			<< ", max error " << Desc.LODs.back().Error;
+	}
+	if (OutStats) {
+		*OutStats = Stats;
+	}
+
+	return true;
+}
+
+bool MeshLoader::ComputeCacheKey(const std::string& FilePath, VertexFormat Format,
+	const MeshOptimizeSettings* Settings, uint64_t& OutKey) {
+	DerivedDataKey Key;
+	Key.Append((uint32_t)MESH_IMPORTER_VERSION);
+	Key.Append((uint32_t)COOKED_MESH_VERSION);
+	Key.Append(GetDefaultFlags());
+	Key.Append((uint32_t)Format);
+	Key.Append(Settings != nullptr);
+	if (Settings) {
+		Key.Append(Settings->VertexCache);
+		Key.Append(Settings->VertexFetch);
+		Key.Append(Settings->Overdraw);
+		Key.Append(Settings->OverdrawThreshold);
+		Key.Append(Settings->CacheSize);
+		Key.Append(Settings->LODCount);
+		Key.Append(Settings->LODReduction);
+		Key.Append(Settings->LODMaxError);
+		Key.Append(Settings->LODPixelError);
+	}
+
+	Key.AppendString(FilePath);
+	if (!Key.AppendFile(MESH_ASSET_PATH + FilePath)) {
+		return false;
+	}
+
+	std::vector<std::string> Dependencies;
+	GatherDependencies(FilePath, Dependencies);
+	for (const std::string& Dependency : Dependencies) {
+		Key.AppendString(Dependency);
+		// 缺失的依赖也参与哈希，补上文件后缓存键随之变化
+		Key.Append(Key.AppendFile(MESH_ASSET_PATH + Dependency));
+	}
 
+	OutKey = Key.Get();
 	return true;
 }
 
+void MeshLoader::GatherDependencies(const std::string& FilePath, std::vector<std::string>& OutDependencies) {
+	const size_t ExtensionPos = FilePath.find_last_of('.');
+	if (ExtensionPos == std::string::npos || FilePath.compare(ExtensionPos, std::string::npos, ".gltf") != 0) {
+		return;
+	}
+
+	// glTF的几何数据在buffers引用的外部文件中
+	File Source(MESH_ASSET_PATH + FilePath);
+	if (!Source.IsExist()) {
+		return;
+	}
+
+	JsonObject Content = JsonObject(Source.ReadBytes());
+	if (!Content.HasKey("buffers")) {
+		return;
+	}
+
+	const size_t DirectoryPos = FilePath.find_last_of('/');
+	const std::string Directory = DirectoryPos == std::string::npos ? "" : FilePath.substr(0, DirectoryPos + 1);
+	JsonObject Buffers = Content.Get("buffers");
+	for (size_t i = 0; i < Buffers.Size(); ++i) {
+		JsonObject Buffer = Buffers.ArrayItemAt(i);
+		if (!Buffer.HasKey("uri")) {
+			continue;
+		}
+
+		// 内嵌的data URI已包含在源文件内容中
+		const std::string Uri = Buffer.Get("uri").GetString();
+		if (Uri.compare(0, 5, "data:") != 0) {
+			OutDependencies.push_back(Directory + Uri);
+		}
+	}
+}
+
+uint32_t MeshLoader::GetLODTriangleCount(const MeshDesc& Desc, uint32_t LOD) {
+	const std::vector<SubMeshDesc>& SubMeshes = LOD == 0 ? Desc.SubMeshes : Desc.LODs[LOD - 1].SubMeshes;
+	uint32_t IndexCount = 0;
+	for (const SubMeshDesc& SubMesh : SubMeshes) {
+		IndexCount += SubMesh.IndexCount;
+	}
+	return IndexCount / 3;
+}
+
+void MeshLoader::ComputeLODScreenSizes(MeshDesc& Desc, const MeshOptimizeSettings& Settings) {
+	// 去掉所有子网格都沿用上一级区间的末尾几级
+	while (!Desc.LODs.empty()) {
+		const std::vector<SubMeshDesc>& Last = Desc.LODs.back().SubMeshes;
+		const std::vector<SubMeshDesc>& Previous = Desc.LODs.size() > 1 ? Desc.LODs[Desc.LODs.size() - 2].SubMeshes : Desc.SubMeshes;
+		bool Reused = Last.size() == Previous.size();
+		for (size_t i = 0; Reused && i < Last.size(); ++i) {
+			Reused = Last[i].BaseIndex == Previous[i].BaseIndex;
+		}
+		if (!Reused) {
+			break;
+		}
+		Desc.LODs.pop_back();
+	}
+
+	// 阈值随级数单调递减
+	const float Radius = 0.5f * (Desc.BoundsMax - Desc.BoundsMin).norm();
+	float Previous = 1.0f;
+	for (MeshLODDesc& LOD : Desc.LODs) {
+		LOD.ScreenSize = std::min(MeshSimplifier::ComputeLODScreenSize(LOD.Error, Radius, Settings.LODPixelError), Previous);
+		Previous = LOD.ScreenSize;
+	}
+}
+
+void MeshLoader::ComputeQuantization(const aiScene* scene, MeshDesc& meshDesc) {
+	FVector3 BoundsMin = FVector3::Constant(std::numeric_limits<float>::max());
+	FVector3 BoundsMax = FVector3::Constant(std::numeric_limits<float>::lowest());
+	for (uint32_t i = 0; i < scene->mNumMeshes; i++) {
+		const aiMesh* mesh = scene->mMeshes[i];
+		for (uint32_t j = 0; j < mesh->mNumVertices; j++) {
+			const FVector3 Position(mesh->mVertices[j].x, mesh->mVertices[j].y, mesh->mVertices[j].z);
+			BoundsMin = BoundsMin.cwiseMin(Position);
+			BoundsMax = BoundsMax.cwiseMax(Position);
+		}
+	}
+
+	if (BoundsMin.x() <= BoundsMax.x()) {
+		VertexPacker::ComputeQuantization(BoundsMin, BoundsMax, meshDesc.PositionScale, meshDesc.PositionBias);
+	}
+}
+
 void MeshLoader::ProcessNode(aiNode* node, const aiScene* scene,
-	MeshDesc& meshDesc, const std::string& directory) {
+	MeshDesc& meshDesc, const std::string& directory,
+	const MeshOptimizeSettings* settings, MeshOptimizeStats& stats) {
 	// 处理当前节点的所有网格
 	for (uint32_t i = 0; i < node->mNumMeshes; i++) {
 		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		ProcessMesh(mesh, scene, meshDesc, directory);
+		ProcessMesh(mesh, scene, meshDesc, directory, settings, stats);
 	}
 
 	// 递归处理子节点
 	for (uint32_t i = 0; i < node->mNumChildren; i++) {
-		ProcessNode(node->mChildren[i], scene, meshDesc, directory);
+		ProcessNode(node->mChildren[i], scene, meshDesc, directory, settings, stats);
 	}
 }
 
 void MeshLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene,
-	MeshDesc& meshDesc, const std::string& directory) {
+	MeshDesc& meshDesc, const std::string& directory,
+	const MeshOptimizeSettings* settings, MeshOptimizeStats& stats) {
 	// 这两个参数
 	(void)scene;
 	/*	directory：在下面场景可以使用
@@ -65,10 +222,16 @@ void MeshLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene,
 
 	SubMeshDesc subMesh;
 	subMesh.Name = mesh->mName.C_Str();
-	subMesh.BaseVertex = static_cast<uint32_t>(meshDesc.Vertices.size());
+	subMesh.BaseVertex = meshDesc.GetVertexCount();
 	subMesh.BaseIndex = static_cast<uint32_t>(meshDesc.Indices.size());
 	subMesh.MaterialIndex = mesh->mMaterialIndex;
 
+	// 先生成局部的标准顶点和索引，优化后再写入Desc
+	std::vector<Vertex> Vertices;
+	std::vector<uint32_t> Indices;
+	Vertices.reserve(mesh->mNumVertices);
+	Indices.reserve((size_t)mesh->mNumFaces * 3);
+
 	// 处理顶点
 	for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
 		Vertex vertex;
@@ -82,7 +245,7 @@ void MeshLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene,
 
 		// 更新包围盒
 		meshDesc.BoundsMin = meshDesc.BoundsMin.cwiseMin(vertex.position);
-		meshDesc.BoundsMax = meshDesc.BoundsMin.cwiseMax(vertex.position);
+		meshDesc.BoundsMax = meshDesc.BoundsMax.cwiseMax(vertex.position);
 
 		// 法线
 		if (mesh->HasNormals()) {
@@ -92,6 +255,9 @@ void MeshLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene,
 				mesh->mNormals[i].z
 			);
 		}
+		else {
+			vertex.normal = FVector3(0.0f, 0.0f, 1.0f);
+		}
 
 		// 纹理坐标
 		if (mesh->mTextureCoords[0]) {
@@ -104,34 +270,97 @@ void MeshLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene,
 			vertex.texCoord = FVector2(0.0f, 0.0f);
 		}
 
-		// 切线
+		// 切线，副切线只保留方向（w = ±1）
 		if (mesh->HasTangentsAndBitangents()) {
-			vertex.tangent = FVector3(
+			const FVector3 Tangent(
 				mesh->mTangents[i].x,
 				mesh->mTangents[i].y,
 				mesh->mTangents[i].z
 			);
 
-			vertex.bitangent = FVector3(
+			const FVector3 Bitangent(
 				mesh->mBitangents[i].x,
 				mesh->mBitangents[i].y,
 				mesh->mBitangents[i].z
 			);
+
+			const float Handedness = vertex.normal.cross(Tangent).dot(Bitangent) < 0.0f ? -1.0f : 1.0f;
+			vertex.tangent = FVector4(Tangent.x(), Tangent.y(), Tangent.z(), Handedness);
+		}
+		else {
+			vertex.tangent = FVector4(1.0f, 0.0f, 0.0f, 1.0f);
 		}
 
-		meshDesc.Vertices.push_back(vertex);
+		Vertices.push_back(vertex);
 	}
 
 	// 处理索引
+	bool AllTriangles = true;
 	for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
 		aiFace face = mesh->mFaces[i];
+		AllTriangles = AllTriangles && face.mNumIndices == 3;
 		for (uint32_t j = 0; j < face.mNumIndices; j++) {
-			meshDesc.Indices.push_back(face.mIndices[j] + subMesh.BaseVertex);
+			Indices.push_back(face.mIndices[j]);
+		}
+	}
+
+	// 优化只针对纯三角形网格
+	if (settings && AllTriangles) {
+		stats.Accumulate(MeshOptimizer::Optimize(Vertices, Indices, *settings));
+	}
+
+	// LOD链由优化后的LOD0简化得到，共享顶点
+	const uint32_t LODCount = settings ? std::min<uint32_t>(settings->LODCount, MESH_MAX_LOD_COUNT) : 1;
+	std::vector<MeshLODLevel> LODLevels;
+	if (LODCount > 1 && AllTriangles) {
+		auto Start = std::chrono::high_resolution_clock::now();
+		MeshSimplifier::GenerateLODs(Vertices, Indices, LODCount, settings->LODReduction, settings->LODMaxError, LODLevels);
+		if (settings->VertexCache) {
+			for (MeshLODLevel& Level : LODLevels) {
+				MeshOptimizer::OptimizeVertexCache(Level.Indices.data(), Level.Indices.size(), (uint32_t)Vertices.size());
+			}
+		}
+		stats.SimplifyTimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - Start).count();
+	}
+
+	if (meshDesc.Format == VertexFormat::eStandard) {
+		meshDesc.Vertices.insert(meshDesc.Vertices.end(), Vertices.begin(), Vertices.end());
+	}
+	else {
+		const uint32_t Stride = VertexLayout::GetStride(meshDesc.Format);
+		size_t Offset = meshDesc.PackedVertices.size();
+		meshDesc.PackedVertices.resize(Offset + Vertices.size() * Stride);
+		for (const Vertex& V : Vertices) {
+			VertexPacker::PackVertex(meshDesc.Format, V, meshDesc.PositionScale, meshDesc.PositionBias,
+				meshDesc.PackedVertices.data() + Offset);
+			Offset += Stride;
 		}
 	}
 
+	meshDesc.Indices.reserve(meshDesc.Indices.size() + Indices.size());
+	for (uint32_t Index : Indices) {
+		meshDesc.Indices.push_back(Index + subMesh.BaseVertex);
+	}
+
 	subMesh.IndexCount = static_cast<uint32_t>(meshDesc.Indices.size()) - subMesh.BaseIndex;
 	meshDesc.SubMeshes.push_back(subMesh);
+
+	// 各级索引追加在LOD0之后，无法继续简化的子网格沿用上一级区间
+	if (LODCount > 1) {
+		meshDesc.LODs.resize(LODCount - 1);
+		SubMeshDesc LODSubMesh = subMesh;
+		for (size_t i = 0; i < meshDesc.LODs.size(); ++i) {
+			if (i < LODLevels.size()) {
+				LODSubMesh.BaseIndex = static_cast<uint32_t>(meshDesc.Indices.size());
+				LODSubMesh.IndexCount = static_cast<uint32_t>(LODLevels[i].Indices.size());
+				for (uint32_t Index : LODLevels[i].Indices) {
+					meshDesc.Indices.push_back(Index + subMesh.BaseVertex);
+				}
+				meshDesc.LODs[i].Error = std::max(meshDesc.LODs[i].Error, LODLevels[i].Error);
+			}
+			meshDesc.LODs[i].SubMeshes.push_back(LODSubMesh);
+		}
+	}
 }
 
 MaterialDesc MeshLoader::ProcessMaterial(aiMaterial* material,
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "RenderModuleAPI.h"
+#include "MeshOptimizer.h"
 #include <string>
 #include <vector>
 
@@ -8,6 +9,9 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+// 导入逻辑变化会影响输出时递增，使派生数据缓存失效
+#define MESH_IMPORTER_VERSION 3
+
 #ifndef BUILTIN_SHADER_CONFIG_PATH
 #define BUILTIN_SHADER_CONFIG_PATH "/Builtin/Builtin.json"
 #endif 
@@ -18,14 +22,32 @@ enum class TextureSlot : uint32_t;
 
 class MeshLoader {
 public:
-	static bool Load(const std::string& FilePath, struct MeshDesc& Desc, uint32_t Flags = 0);
+	// 按Desc.Format直接生成对应格式的顶点流，Settings为nullptr时跳过网格优化
+	ENGINE_RENDERING_API static bool Load(const std::string& FilePath, struct MeshDesc& Desc, uint32_t Flags = 0,
+		const MeshOptimizeSettings* Settings = nullptr, MeshOptimizeStats* OutStats = nullptr);
+
+	// 由源文件及其依赖（如glTF的.bin）内容和导入参数计算派生数据缓存键，源文件不存在时返回false
+	ENGINE_RENDERING_API static bool ComputeCacheKey(const std::string& FilePath, VertexFormat Format,
+		const MeshOptimizeSettings* Settings, uint64_t& OutKey);
+
+	// 源文件引用的外部文件，相对于网格资源目录
+	static void GatherDependencies(const std::string& FilePath, std::vector<std::string>& OutDependencies);
 
 private:
+	// 量化格式需要预先得到整个场景的包围盒
+	static void ComputeQuantization(const aiScene* scene, MeshDesc& meshDesc);
+
+	// 去掉没有进一步简化的LOD，并按简化误差计算各级的切换屏幕尺寸
+	static void ComputeLODScreenSizes(MeshDesc& Desc, const MeshOptimizeSettings& Settings);
+	static uint32_t GetLODTriangleCount(const MeshDesc& Desc, uint32_t LOD);
+
 	static void ProcessNode(aiNode* node, const aiScene* scene,
-		MeshDesc& meshDesc, const std::string& directory);
+		MeshDesc& meshDesc, const std::string& directory,
+		const MeshOptimizeSettings* settings, MeshOptimizeStats& stats);
 
 	static void ProcessMesh(aiMesh* mesh, const aiScene* scene,
-		MeshDesc& meshDesc, const std::string& directory);
+		MeshDesc& meshDesc, const std::string& directory,
+		const MeshOptimizeSettings* settings, MeshOptimizeStats& stats);
 
 	static MaterialDesc ProcessMaterial(aiMaterial* material,
 		const std::string& directory);
@@ -0,0 +1,300 @@
+﻿#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Forsyth算法参数，见 "Linear-Speed Vertex Cache Optimisation"
+static const int32_t FORSYTH_CACHE_SIZE = 32;
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float FORSYTH_LAST_TRI_SCORE = 0.75f;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+static float ComputeVertexScore(int32_t CachePosition, uint32_t RemainingValence) {
+	// 没有剩余三角形的顶点不再参与
+	if (RemainingValence == 0) {
+		return -1.0f;
+	}
+
+	float Score = 0.0f;
+	if (CachePosition >= 0) {
+		// 刚使用过的三个顶点得分固定，避免总是选择相邻三角形造成条带
+		if (CachePosition < 3) {
+			Score = FORSYTH_LAST_TRI_SCORE;
+		}
+		else {
+			const float Scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+			Score = std::pow(1.0f - (CachePosition - 3) * Scaler, FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+
+	// 剩余三角形越少越优先，尽快清理孤立顶点
+	Score += FORSYTH_VALENCE_BOOST_SCALE * std::pow((float)RemainingValence, -FORSYTH_VALENCE_BOOST_POWER);
+	return Score;
+}
+
+MeshOptimizeStats MeshOptimizer::Optimize(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices,
+	const MeshOptimizeSettings& Settings) {
+	auto Start = std::chrono::high_resolution_clock::now();
+
+	MeshOptimizeStats Stats;
+	Stats.TriangleCount = Indices.size() / 3;
+	Stats.VertexCount = Vertices.size();
+	Stats.TransformsBefore = CountTransforms(Indices.data(), Indices.size(), (uint32_t)Vertices.size(), Settings.CacheSize);
+
+	if (Settings.VertexCache) {
+		OptimizeVertexCache(Indices.data(), Indices.size(), (uint32_t)Vertices.size());
+	}
+	if (Settings.Overdraw) {
+		OptimizeOverdraw(Indices.data(), Indices.size(), Vertices, Settings.OverdrawThreshold, Settings.CacheSize);
+	}
+	if (Settings.VertexFetch) {
+		OptimizeVertexFetch(Vertices, Indices);
+	}
+
+	Stats.TransformsAfter = CountTransforms(Indices.data(), Indices.size(), (uint32_t)Vertices.size(), Settings.CacheSize);
+
+	auto End = std::chrono::high_resolution_clock::now();
+	Stats.OptimizeTimeMs = std::chrono::duration<double, std::milli>(End - Start).count();
+	return Stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* Indices, size_t IndexCount, uint32_t VertexCount) {
+	const size_t TriangleCount = IndexCount / 3;
+	if (TriangleCount == 0 || VertexCount == 0) {
+		return;
+	}
+
+	// 顶点 -> 三角形邻接表（CSR），已输出的三角形被交换到各自区间末尾
+	std::vector<uint32_t> Valence(VertexCount, 0);
+	for (size_t i = 0; i < TriangleCount * 3; ++i) {
+		Valence[Indices[i]]++;
+	}
+
+	std::vector<uint32_t> AdjacencyOffset(VertexCount + 1, 0);
+	for (uint32_t v = 0; v < VertexCount; ++v) {
+		AdjacencyOffset[v + 1] = AdjacencyOffset[v] + Valence[v];
+	}
+
+	std::vector<uint32_t> Adjacency(TriangleCount * 3);
+	std::vector<uint32_t> Cursor(AdjacencyOffset.begin(), AdjacencyOffset.end() - 1);
+	for (size_t t = 0; t < TriangleCount; ++t) {
+		for (int k = 0; k < 3; ++k) {
+			Adjacency[Cursor[Indices[t * 3 + k]]++] = (uint32_t)t;
+		}
+	}
+
+	std::vector<uint32_t> Remaining = Valence;
+	std::vector<int32_t> CachePosition(VertexCount, -1);
+	std::vector<float> VertexScore(VertexCount);
+	for (uint32_t v = 0; v < VertexCount; ++v) {
+		VertexScore[v] = ComputeVertexScore(-1, Remaining[v]);
+	}
+
+	std::vector<float> TriangleScore(TriangleCount);
+	std::vector<bool> Emitted(TriangleCount, false);
+	int64_t BestTriangle = -1;
+	float BestScore = -1.0f;
+	for (size_t t = 0; t < TriangleCount; ++t) {
+		TriangleScore[t] = VertexScore[Indices[t * 3]] + VertexScore[Indices[t * 3 + 1]] + VertexScore[Indices[t * 3 + 2]];
+		if (TriangleScore[t] > BestScore) {
+			BestScore = TriangleScore[t];
+			BestTriangle = (int64_t)t;
+		}
+	}
+
+	std::vector<uint32_t> Result;
+	Result.reserve(TriangleCount * 3);
+	std::vector<uint32_t> Cache;
+	std::vector<uint32_t> NewCache;
+	Cache.reserve(FORSYTH_CACHE_SIZE + 3);
+	NewCache.reserve(FORSYTH_CACHE_SIZE + 3);
+	size_t ScanCursor = 0;
+
+	while (Result.size() < TriangleCount * 3) {
+		// 缓存中没有可用三角形时顺序查找下一个未输出的三角形
+		if (BestTriangle < 0) {
+			while (ScanCursor < TriangleCount && Emitted[ScanCursor]) {
+				ScanCursor++;
+			}
+			BestTriangle = (int64_t)ScanCursor;
+		}
+
+		const size_t Triangle = (size_t)BestTriangle;
+		const uint32_t* Tri = Indices + Triangle * 3;
+		Emitted[Triangle] = true;
+
+		NewCache.clear();
+		for (int k = 0; k < 3; ++k) {
+			const uint32_t V = Tri[k];
+			Result.push_back(V);
+			NewCache.push_back(V);
+
+			// 从邻接表的有效区间中移除该三角形
+			uint32_t* Begin = Adjacency.data() + AdjacencyOffset[V];
+			uint32_t* End = Begin + Remaining[V];
+			uint32_t* Found = std::find(Begin, End, (uint32_t)Triangle);
+			if (Found != End) {
+				std::swap(*Found, *(End - 1));
+				Remaining[V]--;
+			}
+		}
+
+		for (uint32_t V : Cache) {
+			if (V != Tri[0] && V != Tri[1] && V != Tri[2]) {
+				NewCache.push_back(V);
+			}
+		}
+
+		// 更新缓存位置和得分，被挤出缓存的顶点也需要更新
+		for (size_t i = 0; i < NewCache.size(); ++i) {
+			const uint32_t V = NewCache[i];
+			CachePosition[V] = i < (size_t)FORSYTH_CACHE_SIZE ? (int32_t)i : -1;
+			VertexScore[V] = ComputeVertexScore(CachePosition[V], Remaining[V]);
+		}
+
+		BestTriangle = -1;
+		BestScore = -1.0f;
+		for (uint32_t V : NewCache) {
+			const uint32_t* Begin = Adjacency.data() + AdjacencyOffset[V];
+			for (uint32_t i = 0; i < Remaining[V]; ++i) {
+				const uint32_t T = Begin[i];
+				const float Score = VertexScore[Indices[T * 3]] + VertexScore[Indices[T * 3 + 1]] + VertexScore[Indices[T * 3 + 2]];
+				TriangleScore[T] = Score;
+				if (Score > BestScore) {
+					BestScore = Score;
+					BestTriangle = (int64_t)T;
+				}
+			}
+		}
+
+		if (NewCache.size() > (size_t)FORSYTH_CACHE_SIZE) {
+			NewCache.resize(FORSYTH_CACHE_SIZE);
+		}
+		Cache.swap(NewCache);
+	}
+
+	std::copy(Result.begin(), Result.end(), Indices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* Indices, size_t IndexCount, const std::vector<Vertex>& Vertices,
+	float Threshold, uint32_t CacheSize) {
+	const size_t TriangleCount = IndexCount / 3;
+	const uint32_t VertexCount = (uint32_t)Vertices.size();
+	if (TriangleCount < 2) {
+		return;
+	}
+
+	// 在缓存断点（三个顶点都未命中）处切分簇，簇内保持原有缓存友好的顺序
+	std::vector<size_t> ClusterStarts;
+	std::vector<uint32_t> CacheTimestamp(VertexCount, 0);
+	uint32_t Time = CacheSize + 1;
+	for (size_t t = 0; t < TriangleCount; ++t) {
+		uint32_t Misses = 0;
+		for (int k = 0; k < 3; ++k) {
+			const uint32_t V = Indices[t * 3 + k];
+			if (Time - CacheTimestamp[V] > CacheSize) {
+				CacheTimestamp[V] = Time++;
+				Misses++;
+			}
+		}
+		if (t == 0 || Misses == 3) {
+			ClusterStarts.push_back(t);
+		}
+	}
+	ClusterStarts.push_back(TriangleCount);
+
+	const size_t ClusterCount = ClusterStarts.size() - 1;
+	if (ClusterCount < 2) {
+		return;
+	}
+
+	// 簇的面积加权中心和法线
+	FVector3 MeshCentroid = FVector3::Zero();
+	float MeshArea = 0.0f;
+	std::vector<FVector3> ClusterCentroid(ClusterCount, FVector3::Zero());
+	std::vector<FVector3> ClusterNormal(ClusterCount, FVector3::Zero());
+	for (size_t c = 0; c < ClusterCount; ++c) {
+		float ClusterArea = 0.0f;
+		for (size_t t = ClusterStarts[c]; t < ClusterStarts[c + 1]; ++t) {
+			const FVector3& P0 = Vertices[Indices[t * 3]].position;
+			const FVector3& P1 = Vertices[Indices[t * 3 + 1]].position;
+			const FVector3& P2 = Vertices[Indices[t * 3 + 2]].position;
+			const FVector3 Normal = (P1 - P0).cross(P2 - P0);
+			const float Area = Normal.norm();
+			const FVector3 Center = (P0 + P1 + P2) / 3.0f;
+
+			ClusterCentroid[c] += Center * Area;
+			ClusterNormal[c] += Normal;
+			ClusterArea += Area;
+		}
+
+		MeshCentroid += ClusterCentroid[c];
+		MeshArea += ClusterArea;
+		if (ClusterArea > 0.0f) {
+			ClusterCentroid[c] /= ClusterArea;
+		}
+	}
+	if (MeshArea > 0.0f) {
+		MeshCentroid /= MeshArea;
+	}
+
+	// 朝外且远离中心的簇更可能遮挡其他簇，优先绘制
+	std::vector<float> SortKey(ClusterCount);
+	std::vector<size_t> Order(ClusterCount);
+	for (size_t c = 0; c < ClusterCount; ++c) {
+		const float Length = ClusterNormal[c].norm();
+		SortKey[c] = Length > 0.0f ? (ClusterCentroid[c] - MeshCentroid).dot(ClusterNormal[c] / Length) : 0.0f;
+		Order[c] = c;
+	}
+	std::stable_sort(Order.begin(), Order.end(), [&SortKey](size_t A, size_t B) {
+		return SortKey[A] > SortKey[B];
+	});
+
+	std::vector<uint32_t> Result;
+	Result.reserve(TriangleCount * 3);
+	for (size_t c : Order) {
+		Result.insert(Result.end(), Indices + ClusterStarts[c] * 3, Indices + ClusterStarts[c + 1] * 3);
+	}
+
+	// 缓存效率下降过多时放弃
+	const uint64_t Before = CountTransforms(Indices, TriangleCount * 3, VertexCount, CacheSize);
+	const uint64_t After = CountTransforms(Result.data(), Result.size(), VertexCount, CacheSize);
+	if ((float)After <= (float)Before * Threshold) {
+		std::copy(Result.begin(), Result.end(), Indices);
+	}
+}
+
+uint32_t MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices) {
+	const uint32_t Unassigned = UINT32_MAX;
+	std::vector<uint32_t> Remap(Vertices.size(), Unassigned);
+	std::vector<Vertex> Result;
+	Result.reserve(Vertices.size());
+
+	for (uint32_t& Index : Indices) {
+		if (Remap[Index] == Unassigned) {
+			Remap[Index] = (uint32_t)Result.size();
+			Result.push_back(Vertices[Index]);
+		}
+		Index = Remap[Index];
+	}
+
+	Vertices.swap(Result);
+	return (uint32_t)Vertices.size();
+}
+
+uint64_t MeshOptimizer::CountTransforms(const uint32_t* Indices, size_t IndexCount, uint32_t VertexCount, uint32_t CacheSize) {
+	// 以时间戳模拟FIFO：命中不刷新位置
+	std::vector<uint32_t> CacheTimestamp(VertexCount, 0);
+	uint32_t Time = CacheSize + 1;
+	uint64_t Transforms = 0;
+	for (size_t i = 0; i < IndexCount; ++i) {
+		const uint32_t V = Indices[i];
+		if (Time - CacheTimestamp[V] > CacheSize) {
+			CacheTimestamp[V] = Time++;
+			Transforms++;
+		}
+	}
+	return Transforms;
+}
@@ -0,0 +1,66 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Resource/VertexFormat.h"
+#include <cstdint>
+#include <vector>
+
+struct MeshOptimizeSettings {
+	bool VertexCache = true;          // 三角形重排以提高顶点后变换缓存命中
+	bool VertexFetch = true;          // 顶点按首次使用顺序重排以提高读取局部性
+	bool Overdraw = false;            // 按簇重排三角形以减少过度绘制
+	float OverdrawThreshold = 1.05f;  // 允许的ACMR退化比例
+	uint32_t CacheSize = 16;          // 统计ACMR时模拟的FIFO缓存大小
+
+	// LOD链：各级共享LOD0的顶点，只追加简化后的索引
+	uint32_t LODCount = 5;            // 含LOD0的级数，1表示不生成
+	float LODReduction = 0.4f;        // 每级相对上一级的目标三角形比例
+	float LODMaxError = 0.05f;        // 允许的最大简化误差，相对于子网格包围盒对角线
+	float LODPixelError = 1.0f;       // 切换阈值：简化误差在1080p下投影不超过该像素数
+};
+
+// ACMR = 顶点变换次数 / 三角形数，ATVR = 顶点变换次数 / 顶点数（理想值为1）
+struct MeshOptimizeStats {
+	uint64_t TriangleCount = 0;
+	uint64_t VertexCount = 0;
+	uint64_t TransformsBefore = 0;
+	uint64_t TransformsAfter = 0;
+	double OptimizeTimeMs = 0.0;
+	double SimplifyTimeMs = 0.0;      // 生成LOD链的耗时
+
+	float GetACMRBefore() const { return TriangleCount ? (float)TransformsBefore / TriangleCount : 0.0f; }
+	float GetACMRAfter() const { return TriangleCount ? (float)TransformsAfter / TriangleCount : 0.0f; }
+	float GetATVRBefore() const { return VertexCount ? (float)TransformsBefore / VertexCount : 0.0f; }
+	float GetATVRAfter() const { return VertexCount ? (float)TransformsAfter / VertexCount : 0.0f; }
+
+	void Accumulate(const MeshOptimizeStats& Other) {
+		TriangleCount += Other.TriangleCount;
+		VertexCount += Other.VertexCount;
+		TransformsBefore += Other.TransformsBefore;
+		TransformsAfter += Other.TransformsAfter;
+		OptimizeTimeMs += Other.OptimizeTimeMs;
+		SimplifyTimeMs += Other.SimplifyTimeMs;
+	}
+};
+
+/**
+ * 加载时的网格优化：
+ * 1. Forsyth线性时间算法重排三角形，提高顶点后变换缓存命中率；
+ * 2. 按缓存断点切分三角形簇，外侧朝外的簇优先绘制以减少过度绘制（可选）；
+ * 3. 按索引中首次出现的顺序重排顶点，提高顶点读取局部性。
+ * 索引均为相对于传入顶点数组的局部索引。
+ */
+class MeshOptimizer {
+public:
+	ENGINE_RENDERING_API static MeshOptimizeStats Optimize(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices,
+		const MeshOptimizeSettings& Settings = MeshOptimizeSettings());
+
+	ENGINE_RENDERING_API static void OptimizeVertexCache(uint32_t* Indices, size_t IndexCount, uint32_t VertexCount);
+	ENGINE_RENDERING_API static void OptimizeOverdraw(uint32_t* Indices, size_t IndexCount, const std::vector<Vertex>& Vertices,
+		float Threshold, uint32_t CacheSize);
+	// 返回重排后的顶点数，未被引用的顶点会被移除
+	ENGINE_RENDERING_API static uint32_t OptimizeVertexFetch(std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices);
+
+	// FIFO缓存模拟下的顶点变换次数
+	ENGINE_RENDERING_API static uint64_t CountTransforms(const uint32_t* Indices, size_t IndexCount, uint32_t VertexCount, uint32_t CacheSize);
+};
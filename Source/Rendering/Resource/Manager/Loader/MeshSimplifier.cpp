@@ -0,0 +1,443 @@
+﻿#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// 边界边约束平面的权重，越大边界轮廓越不容易被简化
+static const double SIMPLIFY_BORDER_WEIGHT = 10.0;
+// 每轮允许的误差上限相对于本轮目标折叠处误差的倍数
+static const float SIMPLIFY_PASS_ERROR_SCALE = 1.5f;
+// 折叠前后三角形法线夹角的余弦低于该值时视为翻转
+static const float SIMPLIFY_FLIP_THRESHOLD = 0.25f;
+// 某级索引数超过上一级的该比例时认为无法继续简化
+static const float SIMPLIFY_MIN_REDUCTION = 0.95f;
+// LOD切换阈值按该视口高度下的像素误差计算
+static const float SIMPLIFY_REFERENCE_HEIGHT = 1080.0f;
+
+namespace {
+
+	// 二次误差 Q(p) = p^T A p + 2 b·p + c，W为累计的面积权重
+	struct Quadric {
+		double A00 = 0.0, A11 = 0.0, A22 = 0.0, A01 = 0.0, A02 = 0.0, A12 = 0.0;
+		double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+		double C = 0.0;
+		double W = 0.0;
+
+		// 平面 N·p + D = 0，N为单位向量
+		void AddPlane(const FVector3& N, double D, double Weight) {
+			const double X = N.x(), Y = N.y(), Z = N.z();
+			A00 += Weight * X * X; A11 += Weight * Y * Y; A22 += Weight * Z * Z;
+			A01 += Weight * X * Y; A02 += Weight * X * Z; A12 += Weight * Y * Z;
+			B0 += Weight * X * D; B1 += Weight * Y * D; B2 += Weight * Z * D;
+			C += Weight * D * D;
+		}
+
+		void Add(const Quadric& Other) {
+			A00 += Other.A00; A11 += Other.A11; A22 += Other.A22;
+			A01 += Other.A01; A02 += Other.A02; A12 += Other.A12;
+			B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+			C += Other.C;
+			W += Other.W;
+		}
+
+		double Evaluate(const FVector3& P) const {
+			const double X = P.x(), Y = P.y(), Z = P.z();
+			const double R = A00 * X * X + A11 * Y * Y + A22 * Z * Z
+				+ 2.0 * (A01 * X * Y + A02 * X * Z + A12 * Y * Z)
+				+ 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+			return std::fabs(R);
+		}
+	};
+
+	enum class VertexKind : uint8_t {
+		eManifold,   // 内部顶点，可以向任意方向折叠
+		eBorder,     // 恰有一条入边界边和一条出边界边，只能沿边界折叠
+		eLocked      // 非流形或孤立顶点，不作为折叠源
+	};
+
+	struct Collapse {
+		uint32_t From;
+		uint32_t To;
+		float Error;   // 距离平方
+	};
+
+	// 按位置分组：Remap指向组内第一个顶点，Wedge为组内的循环链表
+	void BuildPositionRemap(const std::vector<Vertex>& Vertices, std::vector<uint32_t>& Remap, std::vector<uint32_t>& Wedge) {
+		const uint32_t VertexCount = (uint32_t)Vertices.size();
+		std::vector<uint32_t> Order(VertexCount);
+		std::iota(Order.begin(), Order.end(), 0u);
+		std::sort(Order.begin(), Order.end(), [&](uint32_t A, uint32_t B) {
+			const FVector3& PA = Vertices[A].position;
+			const FVector3& PB = Vertices[B].position;
+			if (PA.x() != PB.x()) return PA.x() < PB.x();
+			if (PA.y() != PB.y()) return PA.y() < PB.y();
+			if (PA.z() != PB.z()) return PA.z() < PB.z();
+			return A < B;
+		});
+
+		Remap.resize(VertexCount);
+		Wedge.resize(VertexCount);
+		uint32_t Begin = 0;
+		while (Begin < VertexCount) {
+			uint32_t End = Begin + 1;
+			while (End < VertexCount && Vertices[Order[End]].position == Vertices[Order[Begin]].position) {
+				End++;
+			}
+			for (uint32_t i = Begin; i < End; ++i) {
+				Remap[Order[i]] = Order[Begin];
+				Wedge[Order[i]] = Order[i + 1 < End ? i + 1 : Begin];
+			}
+			Begin = End;
+		}
+	}
+
+	// 以位置为单位的顶点-三角形邻接表（CSR）
+	struct Adjacency {
+		std::vector<uint32_t> Offsets;
+		std::vector<uint32_t> Triangles;
+
+		void Build(const std::vector<uint32_t>& Indices, const std::vector<uint32_t>& Remap) {
+			const size_t VertexCount = Remap.size();
+			Offsets.assign(VertexCount + 1, 0);
+			for (uint32_t Index : Indices) {
+				Offsets[Remap[Index] + 1]++;
+			}
+			for (size_t i = 0; i < VertexCount; ++i) {
+				Offsets[i + 1] += Offsets[i];
+			}
+
+			Triangles.resize(Indices.size());
+			std::vector<uint32_t> Cursor(Offsets.begin(), Offsets.end() - 1);
+			for (size_t i = 0; i < Indices.size(); ++i) {
+				Triangles[Cursor[Remap[Indices[i]]]++] = (uint32_t)(i / 3);
+			}
+		}
+
+		// 是否存在有向边 A->B（位置）
+		bool HasEdge(const std::vector<uint32_t>& Indices, const std::vector<uint32_t>& Remap, uint32_t A, uint32_t B) const {
+			for (uint32_t i = Offsets[A]; i < Offsets[A + 1]; ++i) {
+				const uint32_t* Tri = &Indices[Triangles[i] * 3];
+				for (int k = 0; k < 3; ++k) {
+					if (Remap[Tri[k]] == A && Remap[Tri[(k + 1) % 3]] == B) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+	};
+
+	void ClassifyVertices(const std::vector<uint32_t>& Indices, const std::vector<uint32_t>& Remap,
+		const Adjacency& Adj, std::vector<VertexKind>& Kinds) {
+		const uint32_t VertexCount = (uint32_t)Remap.size();
+		Kinds.assign(VertexCount, VertexKind::eLocked);
+		for (uint32_t V = 0; V < VertexCount; ++V) {
+			if (Remap[V] != V || Adj.Offsets[V] == Adj.Offsets[V + 1]) {
+				continue;
+			}
+
+			uint32_t OutBorders = 0;
+			uint32_t InBorders = 0;
+			for (uint32_t i = Adj.Offsets[V]; i < Adj.Offsets[V + 1]; ++i) {
+				const uint32_t* Tri = &Indices[Adj.Triangles[i] * 3];
+				for (int k = 0; k < 3; ++k) {
+					if (Remap[Tri[k]] != V) {
+						continue;
+					}
+					const uint32_t Next = Remap[Tri[(k + 1) % 3]];
+					const uint32_t Prev = Remap[Tri[(k + 2) % 3]];
+					OutBorders += !Adj.HasEdge(Indices, Remap, Next, V);
+					InBorders += !Adj.HasEdge(Indices, Remap, V, Prev);
+				}
+			}
+
+			if (OutBorders == 0 && InBorders == 0) {
+				Kinds[V] = VertexKind::eManifold;
+			}
+			else if (OutBorders == 1 && InBorders == 1) {
+				Kinds[V] = VertexKind::eBorder;
+			}
+		}
+	}
+
+	void BuildQuadrics(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices,
+		const std::vector<uint32_t>& Remap, const Adjacency& Adj, std::vector<Quadric>& Quadrics) {
+		Quadrics.assign(Vertices.size(), Quadric());
+		for (size_t i = 0; i < Indices.size(); i += 3) {
+			const uint32_t V[3] = { Remap[Indices[i]], Remap[Indices[i + 1]], Remap[Indices[i + 2]] };
+			const FVector3& P0 = Vertices[V[0]].position;
+			FVector3 Normal = (Vertices[V[1]].position - P0).cross(Vertices[V[2]].position - P0);
+			const float DoubleArea = Normal.norm();
+			if (DoubleArea <= 0.0f) {
+				continue;
+			}
+			Normal /= DoubleArea;
+
+			Quadric Plane;
+			Plane.AddPlane(Normal, -Normal.dot(P0), DoubleArea * 0.5);
+			Plane.W = DoubleArea * 0.5;
+			for (int k = 0; k < 3; ++k) {
+				Quadrics[V[k]].Add(Plane);
+			}
+
+			// 边界边加一个垂直于三角形的约束平面，保持轮廓
+			for (int k = 0; k < 3; ++k) {
+				const uint32_t A = V[k];
+				const uint32_t B = V[(k + 1) % 3];
+				if (Adj.HasEdge(Indices, Remap, B, A)) {
+					continue;
+				}
+
+				const FVector3 Edge = Vertices[B].position - Vertices[A].position;
+				const float Length = Edge.norm();
+				if (Length <= 0.0f) {
+					continue;
+				}
+				const FVector3 EdgeNormal = Edge.cross(Normal) / Length;
+				Quadric Border;
+				Border.AddPlane(EdgeNormal, -EdgeNormal.dot(Vertices[A].position), SIMPLIFY_BORDER_WEIGHT * Length * Length);
+				Quadrics[A].Add(Border);
+				Quadrics[B].Add(Border);
+			}
+		}
+	}
+
+	float GetCollapseError(const std::vector<Vertex>& Vertices, const std::vector<Quadric>& Quadrics, uint32_t From, uint32_t To) {
+		Quadric Q = Quadrics[From];
+		Q.Add(Quadrics[To]);
+		const double Error = Q.Evaluate(Vertices[To].position);
+		return (float)(Q.W > 0.0 ? Error / Q.W : Error);
+	}
+
+	// 折叠后From周围的三角形是否翻转，CollapseRemap为本轮已折叠的位置映射
+	bool HasTriangleFlips(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices,
+		const std::vector<uint32_t>& Remap, const std::vector<uint32_t>& CollapseRemap, const Adjacency& Adj,
+		uint32_t From, uint32_t To) {
+		const FVector3& Source = Vertices[From].position;
+		const FVector3& Target = Vertices[To].position;
+		for (uint32_t i = Adj.Offsets[From]; i < Adj.Offsets[From + 1]; ++i) {
+			const uint32_t* Tri = &Indices[Adj.Triangles[i] * 3];
+			uint32_t V[3];
+			int Corner = 0;
+			for (int k = 0; k < 3; ++k) {
+				V[k] = CollapseRemap[Remap[Tri[k]]];
+				Corner = V[k] == From ? k : Corner;
+			}
+
+			// 已退化或将被移除的三角形
+			if (V[0] == V[1] || V[1] == V[2] || V[0] == V[2] || V[0] == To || V[1] == To || V[2] == To) {
+				continue;
+			}
+
+			const FVector3& A = Vertices[V[(Corner + 1) % 3]].position;
+			const FVector3& B = Vertices[V[(Corner + 2) % 3]].position;
+			const FVector3 Before = (A - Source).cross(B - Source);
+			const FVector3 After = (A - Target).cross(B - Target);
+			if (Before.dot(After) <= SIMPLIFY_FLIP_THRESHOLD * Before.norm() * After.norm()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * 为From组内每个被引用的顶点找到To组内与它共享三角形的顶点，保证接缝两侧的属性不混用。
+	 * 找不到或存在多个候选时不能折叠。
+	 */
+	bool MapWedges(const std::vector<uint32_t>& Indices, const std::vector<uint32_t>& Remap, const std::vector<uint32_t>& Wedge,
+		const Adjacency& Adj, uint32_t From, uint32_t To, std::vector<uint32_t>& WedgeRemap) {
+		uint32_t W = From;
+		do {
+			bool Referenced = false;
+			uint32_t Partner = UINT32_MAX;
+			for (uint32_t i = Adj.Offsets[From]; i < Adj.Offsets[From + 1]; ++i) {
+				const uint32_t* Tri = &Indices[Adj.Triangles[i] * 3];
+				if (Tri[0] != W && Tri[1] != W && Tri[2] != W) {
+					continue;
+				}
+				Referenced = true;
+				for (int k = 0; k < 3; ++k) {
+					if (Remap[Tri[k]] != To) {
+						continue;
+					}
+					if (Partner != UINT32_MAX && Partner != Tri[k]) {
+						return false;
+					}
+					Partner = Tri[k];
+				}
+			}
+
+			if (Referenced) {
+				if (Partner == UINT32_MAX) {
+					return false;
+				}
+				WedgeRemap[W] = Partner;
+			}
+			W = Wedge[W];
+		} while (W != From);
+		return true;
+	}
+
+}
+
+float MeshSimplifier::Simplify(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices,
+	size_t TargetIndexCount, float TargetError, std::vector<uint32_t>& OutIndices) {
+	OutIndices = Indices;
+	const uint32_t VertexCount = (uint32_t)Vertices.size();
+	if (VertexCount == 0 || Indices.size() % 3 != 0 || TargetIndexCount >= Indices.size()) {
+		return 0.0f;
+	}
+
+	std::vector<uint32_t> Remap;
+	std::vector<uint32_t> Wedge;
+	BuildPositionRemap(Vertices, Remap, Wedge);
+
+	Adjacency Adj;
+	Adj.Build(OutIndices, Remap);
+	std::vector<Quadric> Quadrics;
+	BuildQuadrics(Vertices, OutIndices, Remap, Adj, Quadrics);
+
+	const size_t TargetTriangles = TargetIndexCount / 3;
+	const float TargetErrorSq = TargetError * TargetError;
+	size_t TriangleCount = OutIndices.size() / 3;
+	float MaxErrorSq = 0.0f;
+
+	std::vector<VertexKind> Kinds;
+	std::vector<Collapse> Collapses;
+	std::vector<uint32_t> CollapseRemap(VertexCount);
+	std::vector<uint32_t> WedgeRemap(VertexCount);
+	std::vector<uint8_t> Touched(VertexCount);
+
+	while (TriangleCount > TargetTriangles) {
+		ClassifyVertices(OutIndices, Remap, Adj, Kinds);
+
+		// 候选边：内部边只取一个方向的三角形边，边界边只出现一次
+		Collapses.clear();
+		for (size_t i = 0; i < OutIndices.size(); i += 3) {
+			for (int k = 0; k < 3; ++k) {
+				const uint32_t A = Remap[OutIndices[i + k]];
+				const uint32_t B = Remap[OutIndices[i + (k + 1) % 3]];
+				const bool BorderEdge = !Adj.HasEdge(OutIndices, Remap, B, A);
+				if (A == B || (A > B && !BorderEdge)) {
+					continue;
+				}
+
+				auto CanCollapse = [&](uint32_t From, uint32_t To) {
+					if (Kinds[From] == VertexKind::eLocked) {
+						return false;
+					}
+					return Kinds[From] == VertexKind::eManifold || (BorderEdge && Kinds[To] != VertexKind::eManifold);
+				};
+
+				const bool AB = CanCollapse(A, B);
+				const bool BA = CanCollapse(B, A);
+				if (!AB && !BA) {
+					continue;
+				}
+				const float ErrorAB = AB ? GetCollapseError(Vertices, Quadrics, A, B) : FLT_MAX;
+				const float ErrorBA = BA ? GetCollapseError(Vertices, Quadrics, B, A) : FLT_MAX;
+				Collapses.push_back(ErrorAB <= ErrorBA ? Collapse{ A, B, ErrorAB } : Collapse{ B, A, ErrorBA });
+			}
+		}
+		if (Collapses.empty()) {
+			break;
+		}
+		std::sort(Collapses.begin(), Collapses.end(), [](const Collapse& A, const Collapse& B) { return A.Error < B.Error; });
+
+		// 每次内部折叠约减少两个三角形，本轮误差上限取目标折叠数处误差的若干倍
+		const size_t Goal = std::min((TriangleCount - TargetTriangles) / 2, Collapses.size() - 1);
+		const float PassErrorLimit = std::min(TargetErrorSq, Collapses[Goal].Error * SIMPLIFY_PASS_ERROR_SCALE * SIMPLIFY_PASS_ERROR_SCALE);
+
+		std::iota(CollapseRemap.begin(), CollapseRemap.end(), 0u);
+		std::iota(WedgeRemap.begin(), WedgeRemap.end(), 0u);
+		std::fill(Touched.begin(), Touched.end(), 0);
+		size_t Performed = 0;
+		for (const Collapse& C : Collapses) {
+			if (C.Error > PassErrorLimit || TriangleCount <= TargetTriangles) {
+				break;
+			}
+			if (Touched[C.From] || Touched[C.To]) {
+				continue;
+			}
+			if (HasTriangleFlips(Vertices, OutIndices, Remap, CollapseRemap, Adj, C.From, C.To) ||
+				!MapWedges(OutIndices, Remap, Wedge, Adj, C.From, C.To, WedgeRemap)) {
+				continue;
+			}
+
+			// 同时包含两端的三角形折叠后退化
+			size_t Removed = 0;
+			for (uint32_t i = Adj.Offsets[C.From]; i < Adj.Offsets[C.From + 1]; ++i) {
+				const uint32_t* Tri = &OutIndices[Adj.Triangles[i] * 3];
+				Removed += CollapseRemap[Remap[Tri[0]]] == C.To || CollapseRemap[Remap[Tri[1]]] == C.To || CollapseRemap[Remap[Tri[2]]] == C.To;
+			}
+
+			CollapseRemap[C.From] = C.To;
+			Quadrics[C.To].Add(Quadrics[C.From]);
+			Touched[C.From] = Touched[C.To] = 1;
+			TriangleCount -= std::min(Removed, TriangleCount);
+			MaxErrorSq = std::max(MaxErrorSq, C.Error);
+			Performed++;
+		}
+		if (Performed == 0) {
+			break;
+		}
+
+		// 应用折叠并移除退化三角形
+		size_t Write = 0;
+		for (size_t i = 0; i < OutIndices.size(); i += 3) {
+			const uint32_t I0 = WedgeRemap[OutIndices[i]];
+			const uint32_t I1 = WedgeRemap[OutIndices[i + 1]];
+			const uint32_t I2 = WedgeRemap[OutIndices[i + 2]];
+			const uint32_t P0 = Remap[I0], P1 = Remap[I1], P2 = Remap[I2];
+			if (P0 == P1 || P1 == P2 || P0 == P2) {
+				continue;
+			}
+			OutIndices[Write++] = I0;
+			OutIndices[Write++] = I1;
+			OutIndices[Write++] = I2;
+		}
+		OutIndices.resize(Write);
+		TriangleCount = Write / 3;
+		Adj.Build(OutIndices, Remap);
+	}
+
+	return std::sqrt(MaxErrorSq);
+}
+
+float MeshSimplifier::ComputeLODScreenSize(float Error, float Radius, float PixelError) {
+	// 屏幕尺寸为S时误差投影为 Error / Radius * S * Height / 2 个像素
+	if (Error <= 0.0f) {
+		return FLT_MAX;
+	}
+	return 2.0f * PixelError * Radius / (Error * SIMPLIFY_REFERENCE_HEIGHT);
+}
+
+void MeshSimplifier::GenerateLODs(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices,
+	uint32_t LODCount, float Reduction, float MaxError, std::vector<MeshLODLevel>& OutLevels) {
+	OutLevels.clear();
+	if (Indices.empty()) {
+		return;
+	}
+
+	FVector3 BoundsMin = FVector3::Constant(FLT_MAX);
+	FVector3 BoundsMax = FVector3::Constant(-FLT_MAX);
+	for (uint32_t Index : Indices) {
+		BoundsMin = BoundsMin.cwiseMin(Vertices[Index].position);
+		BoundsMax = BoundsMax.cwiseMax(Vertices[Index].position);
+	}
+	const float TargetError = MaxError * (BoundsMax - BoundsMin).norm();
+
+	size_t PreviousCount = Indices.size();
+	for (uint32_t LOD = 1; LOD < LODCount; ++LOD) {
+		const size_t TargetCount = (size_t)(Indices.size() * std::pow(Reduction, (float)LOD)) / 3 * 3;
+		MeshLODLevel Level;
+		Level.Error = Simplify(Vertices, Indices, TargetCount, TargetError, Level.Indices);
+		if (Level.Indices.empty() || Level.Indices.size() > PreviousCount * SIMPLIFY_MIN_REDUCTION) {
+			break;
+		}
+
+		PreviousCount = Level.Indices.size();
+		OutLevels.push_back(std::move(Level));
+	}
+}
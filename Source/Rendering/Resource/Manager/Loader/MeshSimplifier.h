@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Resource/VertexFormat.h"
+#include <cstdint>
+#include <vector>
+
+// 一级LOD的简化结果，索引仍指向原顶点数组
+struct MeshLODLevel {
+	std::vector<uint32_t> Indices;
+	float Error = 0.0f;        // 局部空间的几何误差
+};
+
+/**
+ * 基于二次误差度量（QEM）的半边折叠简化，只生成新的索引，顶点数组保持不变，各级LOD共享顶点数据：
+ * 1. 位置相同的顶点（UV/法线接缝）作为一组折叠，接缝两侧的顶点只能沿接缝折叠；
+ * 2. 边界顶点只能沿边界边折叠到边界顶点，非流形顶点锁定不动；
+ * 3. 每轮按误差从小到大贪心折叠，同一轮内折叠过的顶点不再参与，折叠导致三角形翻转时放弃。
+ */
+class MeshSimplifier {
+public:
+	// 简化到不超过TargetIndexCount个索引或误差将超过TargetError（局部空间距离）为止，返回实际误差
+	ENGINE_RENDERING_API static float Simplify(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices,
+		size_t TargetIndexCount, float TargetError, std::vector<uint32_t>& OutIndices);
+
+	/**
+	 * 生成LOD1及之后的各级，每级三角形数为上一级的Reduction倍，均由LOD0简化得到以免误差累积。
+	 * MaxError相对于网格包围盒对角线；某级无法明显减少三角形时停止，OutLevels可能少于LODCount - 1级。
+	 */
+	ENGINE_RENDERING_API static void GenerateLODs(const std::vector<Vertex>& Vertices, const std::vector<uint32_t>& Indices,
+		uint32_t LODCount, float Reduction, float MaxError, std::vector<MeshLODLevel>& OutLevels);
+
+	// 误差在1080p下投影不超过PixelError像素时的最大屏幕尺寸（包围球直径占视口高度的比例），误差为0时返回FLT_MAX
+	ENGINE_RENDERING_API static float ComputeLODScreenSize(float Error, float Radius, float PixelError);
+};
@@ -5,6 +5,9 @@
 
 enum class ShaderStage;
 
+// 导入逻辑变化会影响输出时递增，使派生数据缓存失效
+#define SHADER_IMPORTER_VERSION 1
+
 class ShaderLoader {
 public:
 	static bool Load(const std::string& FilePath, struct ShaderDesc& Desc);
@@ -0,0 +1,352 @@
+﻿#include "TextureCompressor.h"
+#include "Resource/ITexture.h"
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+	// 主成分轴（幂迭代），Channels为3或4
+	void ComputePrincipalAxis(const uint8_t Block[64], uint32_t Channels, float Mean[4], float Axis[4]) {
+		for (uint32_t c = 0; c < 4; ++c) {
+			Mean[c] = 0.0f;
+			Axis[c] = 0.0f;
+		}
+		for (uint32_t i = 0; i < 16; ++i) {
+			for (uint32_t c = 0; c < Channels; ++c) {
+				Mean[c] += Block[i * 4 + c];
+			}
+		}
+		for (uint32_t c = 0; c < Channels; ++c) {
+			Mean[c] /= 16.0f;
+		}
+
+		float Covariance[4][4] = {};
+		for (uint32_t i = 0; i < 16; ++i) {
+			for (uint32_t a = 0; a < Channels; ++a) {
+				for (uint32_t b = 0; b < Channels; ++b) {
+					Covariance[a][b] += (Block[i * 4 + a] - Mean[a]) * (Block[i * 4 + b] - Mean[b]);
+				}
+			}
+		}
+
+		// 以对角线为初值迭代，收敛很快
+		for (uint32_t c = 0; c < Channels; ++c) {
+			Axis[c] = Covariance[c][c];
+		}
+		for (uint32_t Iteration = 0; Iteration < 8; ++Iteration) {
+			float Next[4] = {};
+			float Length = 0.0f;
+			for (uint32_t a = 0; a < Channels; ++a) {
+				for (uint32_t b = 0; b < Channels; ++b) {
+					Next[a] += Covariance[a][b] * Axis[b];
+				}
+				Length += Next[a] * Next[a];
+			}
+			if (Length < 1e-12f) {
+				break;
+			}
+			Length = std::sqrt(Length);
+			for (uint32_t c = 0; c < Channels; ++c) {
+				Axis[c] = Next[c] / Length;
+			}
+		}
+	}
+
+	// 沿主轴投影的两个端点（浮点，0-255）
+	void ComputeEndpoints(const uint8_t Block[64], uint32_t Channels, float Min[4], float Max[4]) {
+		float Mean[4], Axis[4];
+		ComputePrincipalAxis(Block, Channels, Mean, Axis);
+
+		float MinT = 0.0f, MaxT = 0.0f;
+		for (uint32_t i = 0; i < 16; ++i) {
+			float T = 0.0f;
+			for (uint32_t c = 0; c < Channels; ++c) {
+				T += (Block[i * 4 + c] - Mean[c]) * Axis[c];
+			}
+			MinT = std::min(MinT, T);
+			MaxT = std::max(MaxT, T);
+		}
+
+		for (uint32_t c = 0; c < 4; ++c) {
+			Min[c] = c < Channels ? std::clamp(Mean[c] + Axis[c] * MinT, 0.0f, 255.0f) : 255.0f;
+			Max[c] = c < Channels ? std::clamp(Mean[c] + Axis[c] * MaxT, 0.0f, 255.0f) : 255.0f;
+		}
+	}
+
+	uint16_t PackRGB565(const float Color[4]) {
+		const uint32_t R = (uint32_t)std::lround(Color[0] * 31.0f / 255.0f);
+		const uint32_t G = (uint32_t)std::lround(Color[1] * 63.0f / 255.0f);
+		const uint32_t B = (uint32_t)std::lround(Color[2] * 31.0f / 255.0f);
+		return (uint16_t)((R << 11) | (G << 5) | B);
+	}
+
+	void UnpackRGB565(uint16_t Packed, int32_t Color[3]) {
+		const int32_t R = (Packed >> 11) & 31;
+		const int32_t G = (Packed >> 5) & 63;
+		const int32_t B = Packed & 31;
+		Color[0] = (R << 3) | (R >> 2);
+		Color[1] = (G << 2) | (G >> 4);
+		Color[2] = (B << 3) | (B >> 2);
+	}
+
+	// 按位写入128位块，低位在前
+	struct BlockBitWriter {
+		uint8_t* Data;
+		uint32_t Position = 0;
+
+		void Write(uint32_t Value, uint32_t Bits) {
+			for (uint32_t i = 0; i < Bits; ++i, ++Position) {
+				if ((Value >> i) & 1) {
+					Data[Position >> 3] |= (uint8_t)(1u << (Position & 7));
+				}
+			}
+		}
+	};
+
+	// 从图像中取4x4块，超出边缘的像素取最近的边缘像素
+	void FetchBlock(const uint8_t* Pixels, uint32_t Width, uint32_t Height, uint32_t BlockX, uint32_t BlockY, uint8_t Block[64]) {
+		for (uint32_t y = 0; y < 4; ++y) {
+			const uint32_t SrcY = std::min(BlockY * 4 + y, Height - 1);
+			for (uint32_t x = 0; x < 4; ++x) {
+				const uint32_t SrcX = std::min(BlockX * 4 + x, Width - 1);
+				memcpy(Block + (y * 4 + x) * 4, Pixels + ((uint64_t)SrcY * Width + SrcX) * 4, 4);
+			}
+		}
+	}
+
+}
+
+void TextureCompressor::EncodeBC1(const uint8_t Block[64], uint8_t* Out) {
+	float Min[4], Max[4];
+	ComputeEndpoints(Block, 3, Min, Max);
+
+	uint16_t Color0 = PackRGB565(Max);
+	uint16_t Color1 = PackRGB565(Min);
+	// Color0 > Color1时为4色模式，BC3中始终按4色解码
+	if (Color0 < Color1) {
+		std::swap(Color0, Color1);
+	}
+
+	int32_t Palette[4][3];
+	UnpackRGB565(Color0, Palette[0]);
+	UnpackRGB565(Color1, Palette[1]);
+	for (uint32_t c = 0; c < 3; ++c) {
+		Palette[2][c] = (2 * Palette[0][c] + Palette[1][c]) / 3;
+		Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c]) / 3;
+	}
+
+	uint32_t Indices = 0;
+	if (Color0 != Color1) {
+		for (uint32_t i = 0; i < 16; ++i) {
+			uint32_t BestIndex = 0;
+			int32_t BestError = INT32_MAX;
+			for (uint32_t p = 0; p < 4; ++p) {
+				int32_t Error = 0;
+				for (uint32_t c = 0; c < 3; ++c) {
+					const int32_t Delta = Block[i * 4 + c] - Palette[p][c];
+					Error += Delta * Delta;
+				}
+				if (Error < BestError) {
+					BestError = Error;
+					BestIndex = p;
+				}
+			}
+			Indices |= BestIndex << (i * 2);
+		}
+	}
+
+	memcpy(Out, &Color0, 2);
+	memcpy(Out + 2, &Color1, 2);
+	memcpy(Out + 4, &Indices, 4);
+}
+
+void TextureCompressor::EncodeBC4(const uint8_t* Values, uint32_t Stride, uint8_t* Out) {
+	uint8_t Min = 255, Max = 0;
+	for (uint32_t i = 0; i < 16; ++i) {
+		Min = std::min(Min, Values[i * Stride]);
+		Max = std::max(Max, Values[i * Stride]);
+	}
+
+	// Max > Min时为8值模式：0为Max，1为Min，2-7在两者之间等分
+	int32_t Palette[8] = { Max, Min };
+	for (int32_t k = 1; k <= 6; ++k) {
+		Palette[k + 1] = ((7 - k) * Max + k * Min + 3) / 7;
+	}
+
+	uint64_t Bits = (uint64_t)Max | ((uint64_t)Min << 8);
+	if (Max != Min) {
+		for (uint32_t i = 0; i < 16; ++i) {
+			uint32_t BestIndex = 0;
+			int32_t BestError = INT32_MAX;
+			for (uint32_t p = 0; p < 8; ++p) {
+				const int32_t Error = std::abs((int32_t)Values[i * Stride] - Palette[p]);
+				if (Error < BestError) {
+					BestError = Error;
+					BestIndex = p;
+				}
+			}
+			Bits |= (uint64_t)BestIndex << (16 + i * 3);
+		}
+	}
+
+	memcpy(Out, &Bits, 8);
+}
+
+void TextureCompressor::EncodeBC3(const uint8_t Block[64], uint8_t* Out) {
+	EncodeBC4(Block + 3, 4, Out);
+	EncodeBC1(Block, Out + 8);
+}
+
+void TextureCompressor::EncodeBC5(const uint8_t Block[64], uint8_t* Out) {
+	EncodeBC4(Block, 4, Out);
+	EncodeBC4(Block + 1, 4, Out + 8);
+}
+
+void TextureCompressor::EncodeBC7(const uint8_t Block[64], uint8_t* Out) {
+	static const int32_t Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	float Endpoints[2][4];
+	ComputeEndpoints(Block, 4, Endpoints[0], Endpoints[1]);
+
+	// 端点为7位 + 共享的P位，两种P位取量化误差较小者
+	uint32_t Quantized[2][4];
+	uint32_t PBits[2];
+	int32_t Colors[2][4];
+	for (uint32_t e = 0; e < 2; ++e) {
+		float BestError = FLT_MAX;
+		for (uint32_t p = 0; p < 2; ++p) {
+			uint32_t Candidate[4];
+			float Error = 0.0f;
+			for (uint32_t c = 0; c < 4; ++c) {
+				Candidate[c] = (uint32_t)std::clamp((int32_t)std::lround((Endpoints[e][c] - p) * 0.5f), 0, 127);
+				const float Delta = Endpoints[e][c] - (float)((Candidate[c] << 1) | p);
+				Error += Delta * Delta;
+			}
+			if (Error < BestError) {
+				BestError = Error;
+				PBits[e] = p;
+				memcpy(Quantized[e], Candidate, sizeof(Candidate));
+			}
+		}
+		for (uint32_t c = 0; c < 4; ++c) {
+			Colors[e][c] = (int32_t)((Quantized[e][c] << 1) | PBits[e]);
+		}
+	}
+
+	int32_t Palette[16][4];
+	for (uint32_t i = 0; i < 16; ++i) {
+		for (uint32_t c = 0; c < 4; ++c) {
+			Palette[i][c] = ((64 - Weights[i]) * Colors[0][c] + Weights[i] * Colors[1][c] + 32) >> 6;
+		}
+	}
+
+	uint32_t Indices[16];
+	for (uint32_t i = 0; i < 16; ++i) {
+		uint32_t BestIndex = 0;
+		int32_t BestError = INT32_MAX;
+		for (uint32_t p = 0; p < 16; ++p) {
+			int32_t Error = 0;
+			for (uint32_t c = 0; c < 4; ++c) {
+				const int32_t Delta = Block[i * 4 + c] - Palette[p][c];
+				Error += Delta * Delta;
+			}
+			if (Error < BestError) {
+				BestError = Error;
+				BestIndex = p;
+			}
+		}
+		Indices[i] = BestIndex;
+	}
+
+	// 第一个像素的索引最高位隐含为0，否则交换端点并翻转索引
+	if (Indices[0] & 8) {
+		std::swap(Quantized[0], Quantized[1]);
+		std::swap(PBits[0], PBits[1]);
+		for (uint32_t i = 0; i < 16; ++i) {
+			Indices[i] = 15 - Indices[i];
+		}
+	}
+
+	memset(Out, 0, 16);
+	BlockBitWriter Writer{ Out };
+	Writer.Write(1u << 6, 7);
+	for (uint32_t c = 0; c < 4; ++c) {
+		Writer.Write(Quantized[0][c], 7);
+		Writer.Write(Quantized[1][c], 7);
+	}
+	Writer.Write(PBits[0], 1);
+	Writer.Write(PBits[1], 1);
+	Writer.Write(Indices[0], 3);
+	for (uint32_t i = 1; i < 16; ++i) {
+		Writer.Write(Indices[i], 4);
+	}
+}
+
+void TextureCompressor::CompressImage(TextureFormat Format, uint32_t Width, uint32_t Height,
+	const uint8_t* Pixels, std::vector<uint8_t>& OutData) {
+	const uint32_t BlockBytes = TextureLayout::GetBlockBytes(Format);
+	const uint32_t BlocksX = (Width + 3) / 4;
+	const uint32_t BlocksY = (Height + 3) / 4;
+
+	size_t Offset = OutData.size();
+	OutData.resize(Offset + (size_t)BlocksX * BlocksY * BlockBytes);
+
+	uint8_t Block[64];
+	for (uint32_t by = 0; by < BlocksY; ++by) {
+		for (uint32_t bx = 0; bx < BlocksX; ++bx, Offset += BlockBytes) {
+			FetchBlock(Pixels, Width, Height, bx, by, Block);
+			switch (Format)
+			{
+			case TextureFormat::eBC1:
+				EncodeBC1(Block, OutData.data() + Offset);
+				break;
+			case TextureFormat::eBC3:
+				EncodeBC3(Block, OutData.data() + Offset);
+				break;
+			case TextureFormat::eBC5:
+				EncodeBC5(Block, OutData.data() + Offset);
+				break;
+			case TextureFormat::eBC7:
+				EncodeBC7(Block, OutData.data() + Offset);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+bool TextureCompressor::Compress(TextureDesc& Desc, TextureFormat Format, TextureCompressStats* OutStats) {
+	if (Desc.Format != TextureFormat::eRGBA8 || !Desc.Data || !TextureLayout::IsCompressed(Format)) {
+		LOG_ERROR << "Compress texture '" << Desc.Name << "' failed, source must be RGBA8.";
+		return false;
+	}
+
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<std::vector<uint8_t>> Data = std::make_shared<std::vector<uint8_t>>();
+	Data->reserve(Desc.Data->size() / 2);
+
+	std::vector<TextureMipDesc> Mips = Desc.Mips;
+	for (TextureMipDesc& Mip : Mips) {
+		const uint8_t* Pixels = Desc.Data->data() + Mip.Offset;
+		Mip.Offset = Data->size();
+		CompressImage(Format, Mip.Width, Mip.Height, Pixels, *Data);
+		Mip.Size = Data->size() - Mip.Offset;
+	}
+
+	if (OutStats) {
+		OutStats->UncompressedBytes = Desc.Data->size();
+		OutStats->CompressedBytes = Data->size();
+		OutStats->CompressTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - StartTime).count();
+	}
+
+	Desc.Format = Format;
+	Desc.Mips = std::move(Mips);
+	Desc.Data = Data;
+	return true;
+}
@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Resource/TextureFormat.h"
+#include <cstdint>
+#include <vector>
+
+struct TextureCompressStats {
+	uint64_t UncompressedBytes = 0;   // RGBA8 Mip链数据量
+	uint64_t CompressedBytes = 0;
+	double CompressTimeMs = 0.0;
+
+	float GetRatio() const { return CompressedBytes ? (float)UncompressedBytes / CompressedBytes : 0.0f; }
+};
+
+/**
+ * BCn块压缩编码，离线烘焙使用：
+ * BC1/BC3颜色端点取主成分轴上投影的两端，BC4（BC3 Alpha、BC5）取最小/最大值；
+ * BC7只使用模式6（单子集RGBA，7位端点 + P位，4位索引）。
+ * 每块输入为16个RGBA8像素（行优先）。
+ */
+class TextureCompressor {
+public:
+	// 将RGBA8的TextureDesc逐级压缩为Format，Mip布局和尺寸不变
+	ENGINE_RENDERING_API static bool Compress(struct TextureDesc& Desc, TextureFormat Format, TextureCompressStats* OutStats = nullptr);
+
+	// 压缩一级Mip，OutData追加写入
+	ENGINE_RENDERING_API static void CompressImage(TextureFormat Format, uint32_t Width, uint32_t Height,
+		const uint8_t* Pixels, std::vector<uint8_t>& OutData);
+
+	ENGINE_RENDERING_API static void EncodeBC1(const uint8_t Block[64], uint8_t* Out);
+	ENGINE_RENDERING_API static void EncodeBC3(const uint8_t Block[64], uint8_t* Out);
+	ENGINE_RENDERING_API static void EncodeBC5(const uint8_t Block[64], uint8_t* Out);
+	ENGINE_RENDERING_API static void EncodeBC7(const uint8_t Block[64], uint8_t* Out);
+
+private:
+	// 单通道BC4块，Stride为相邻像素间隔（字节）
+	static void EncodeBC4(const uint8_t* Values, uint32_t Stride, uint8_t* Out);
+};
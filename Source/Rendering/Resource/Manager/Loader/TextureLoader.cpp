@@ -0,0 +1,83 @@
+﻿#include "TextureLoader.h"
+#include "CookedTexture.h"
+#include "Resource/ITexture.h"
+#include <Logger.hpp>
+#include <algorithm>
+#include <cstring>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+bool TextureLoader::Load(const std::string& FilePath, TextureDesc& Desc) {
+	const std::string FullPath = TEXTURE_ASSET_PATH + FilePath;
+	if (CookedTexture::IsCookedPath(FilePath)) {
+		if (!CookedTexture::Load(FullPath, Desc)) {
+			return false;
+		}
+		Desc.Name = FilePath;
+		Desc.FilePath = FilePath;
+		return true;
+	}
+
+	int Width = 0, Height = 0, Channels = 0;
+	stbi_uc* Pixels = stbi_load(FullPath.c_str(), &Width, &Height, &Channels, STBI_rgb_alpha);
+	if (!Pixels) {
+		LOG_WARN << "Decode texture '" << FullPath << "' failed: " << stbi_failure_reason();
+		return false;
+	}
+
+	Desc.Name = FilePath;
+	Desc.FilePath = FilePath;
+	GenerateMips((uint32_t)Width, (uint32_t)Height, Pixels, Desc);
+	stbi_image_free(Pixels);
+	return true;
+}
+
+void TextureLoader::GenerateMips(uint32_t Width, uint32_t Height, const uint8_t* Pixels, TextureDesc& Desc) {
+	Desc.Format = TextureFormat::eRGBA8;
+	Desc.Width = Width;
+	Desc.Height = Height;
+	Desc.Mips.clear();
+
+	// 先计算每级的位置，一次分配
+	uint64_t TotalSize = 0;
+	for (uint32_t W = Width, H = Height;; W = std::max(W / 2, 1u), H = std::max(H / 2, 1u)) {
+		TextureMipDesc Mip;
+		Mip.Width = W;
+		Mip.Height = H;
+		Mip.Offset = TotalSize;
+		Mip.Size = (uint64_t)W * H * 4;
+		Desc.Mips.push_back(Mip);
+		TotalSize += Mip.Size;
+		if (W == 1 && H == 1) {
+			break;
+		}
+	}
+
+	std::shared_ptr<std::vector<uint8_t>> Data = std::make_shared<std::vector<uint8_t>>(TotalSize);
+	memcpy(Data->data(), Pixels, Desc.Mips[0].Size);
+
+	for (size_t Level = 1; Level < Desc.Mips.size(); ++Level) {
+		const TextureMipDesc& Src = Desc.Mips[Level - 1];
+		const TextureMipDesc& Dst = Desc.Mips[Level];
+		const uint8_t* SrcPixels = Data->data() + Src.Offset;
+		uint8_t* DstPixels = Data->data() + Dst.Offset;
+
+		// 奇数尺寸时边缘像素重复采样
+		for (uint32_t y = 0; y < Dst.Height; ++y) {
+			const uint32_t y0 = std::min(y * 2, Src.Height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, Src.Height - 1);
+			for (uint32_t x = 0; x < Dst.Width; ++x) {
+				const uint32_t x0 = std::min(x * 2, Src.Width - 1);
+				const uint32_t x1 = std::min(x * 2 + 1, Src.Width - 1);
+				for (uint32_t c = 0; c < 4; ++c) {
+					const uint32_t Sum = SrcPixels[(y0 * Src.Width + x0) * 4 + c] + SrcPixels[(y0 * Src.Width + x1) * 4 + c]
+						+ SrcPixels[(y1 * Src.Width + x0) * 4 + c] + SrcPixels[(y1 * Src.Width + x1) * 4 + c];
+					DstPixels[(y * Dst.Width + x) * 4 + c] = (uint8_t)((Sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	Desc.Data = Data;
+}
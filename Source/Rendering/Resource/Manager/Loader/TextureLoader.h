@@ -0,0 +1,21 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include <cstdint>
+#include <string>
+
+// 导入逻辑变化会影响输出时递增，使派生数据缓存失效
+#define TEXTURE_IMPORTER_VERSION 1
+
+/**
+ * 纹理导入：解码图片（PNG/JPG/TGA/BMP等）为RGBA8并在CPU生成完整Mip链；
+ * 烘焙纹理（.stex）已包含GPU格式的Mip链，直接读取。
+ * 不访问图形API，可在工作线程调用。
+ */
+class TextureLoader {
+public:
+	ENGINE_RENDERING_API static bool Load(const std::string& FilePath, struct TextureDesc& Desc);
+
+	// 由Mip 0的像素数据生成完整Mip链（2x2盒式滤波）
+	ENGINE_RENDERING_API static void GenerateMips(uint32_t Width, uint32_t Height, const uint8_t* Pixels, struct TextureDesc& Desc);
+};
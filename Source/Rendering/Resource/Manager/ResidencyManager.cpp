@@ -0,0 +1,161 @@
+﻿#include "ResidencyManager.h"
+#include <Logger.hpp>
+#include <algorithm>
+
+ResidencyManager::ResidencyManager() : Clock_(0) {
+	Stats_.BudgetBytes = RESOURCE_MEMORY_BUDGET;
+}
+
+void ResidencyManager::Track(const std::shared_ptr<IResource>& Resource, const std::string& Name) {
+	if (!Resource || Entries_.find(Resource->GetID()) != Entries_.end()) {
+		return;
+	}
+
+	Entry& E = Entries_[Resource->GetID()];
+	E.Resource = Resource;
+	E.Name = Name;
+	Touch(Resource.get());
+
+	auto It = Evicted_.find(GetKey(Resource->GetResourceType(), Name));
+	if (It != Evicted_.end()) {
+		// 沿用驱逐前的来源
+		E.SourceFile = It->second;
+		Evicted_.erase(It);
+		Stats_.Reloads++;
+	}
+}
+
+void ResidencyManager::Untrack(IResource* Resource) {
+	auto It = Entries_.find(Resource->GetID());
+	if (It != Entries_.end()) {
+		Entries_.erase(It);
+	}
+}
+
+void ResidencyManager::SetSource(IResource* Resource, const std::string& SourceFile) {
+	auto It = Entries_.find(Resource->GetID());
+	if (It == Entries_.end()) {
+		return;
+	}
+
+	// 作为其他资源的一部分创建时保留最先记录的来源
+	if (!It->second.Pinned && It->second.SourceFile.empty()) {
+		It->second.SourceFile = SourceFile;
+	}
+	Touch(Resource);
+}
+
+bool ResidencyManager::HasSource(IResource* Resource) const {
+	auto It = Entries_.find(Resource->GetID());
+	return It != Entries_.end() && !It->second.SourceFile.empty();
+}
+
+void ResidencyManager::Pin(IResource* Resource) {
+	auto It = Entries_.find(Resource->GetID());
+	if (It == Entries_.end()) {
+		return;
+	}
+	It->second.Pinned = true;
+	It->second.SourceFile.clear();
+}
+
+void ResidencyManager::CollectEvictions(std::vector<uint64_t>& OutIDs) {
+	const ResidencyStats& Stats = GetStats();
+	if (Stats_.BudgetBytes == 0 || Stats.ResidentBytes <= Stats_.BudgetBytes) {
+		return;
+	}
+
+	// 候选按最近使用时间从旧到新排序
+	std::vector<std::pair<uint64_t, std::shared_ptr<IResource>>> Candidates;
+	for (auto& Pair : Entries_) {
+		if (Pair.second.SourceFile.empty() || !IsUnreferenced(Pair.second)) {
+			continue;
+		}
+
+		std::shared_ptr<IResource> Resource = Pair.second.Resource.lock();
+		if (Resource) {
+			Candidates.emplace_back(Resource->GetLastUsed(), Resource);
+		}
+	}
+	std::sort(Candidates.begin(), Candidates.end(), [](const auto& A, const auto& B) { return A.first < B.first; });
+
+	uint64_t ResidentBytes = Stats.ResidentBytes;
+	for (size_t i = 0; i < Candidates.size() && ResidentBytes > Stats_.BudgetBytes; ++i) {
+		ResidentBytes -= std::min(ResidentBytes, GetResourceSize(*Candidates[i].second));
+		OutIDs.push_back(Candidates[i].second->GetID());
+	}
+
+	if (ResidentBytes > Stats_.BudgetBytes) {
+		LOG_WARN << "Resident resources use " << ResidentBytes / 1024 << " KB after eviction, over budget "
+			<< Stats_.BudgetBytes / 1024 << " KB (the rest is referenced or not reloadable).";
+	}
+}
+
+void ResidencyManager::OnEvicted(IResource* Resource) {
+	auto It = Entries_.find(Resource->GetID());
+	if (It == Entries_.end()) {
+		return;
+	}
+
+	const uint64_t Size = GetResourceSize(*Resource);
+	Evicted_[GetKey(Resource->GetResourceType(), It->second.Name)] = It->second.SourceFile;
+	Stats_.Evictions++;
+	Stats_.EvictedBytes += Size;
+	LOG_INFO << "Evict resource '" << It->second.Name << "' (" << Size / 1024 << " KB), least recently used.";
+}
+
+bool ResidencyManager::FindEvicted(ResourceType Type, const std::string& Name, std::string& OutSourceFile) const {
+	auto It = Evicted_.find(GetKey(Type, Name));
+	if (It == Evicted_.end()) {
+		return false;
+	}
+	OutSourceFile = It->second;
+	return true;
+}
+
+void ResidencyManager::OnReloadFailed(ResourceType Type, const std::string& Name) {
+	Evicted_.erase(GetKey(Type, Name));
+	Stats_.ReloadFailures++;
+}
+
+const ResidencyStats& ResidencyManager::GetStats() {
+	Stats_.ResidentCPUBytes = 0;
+	Stats_.ResidentGPUBytes = 0;
+	Stats_.ResidentCount = 0;
+	Stats_.EvictableCount = 0;
+	for (auto& Pair : Entries_) {
+		std::shared_ptr<IResource> Resource = Pair.second.Resource.lock();
+		if (!Resource) {
+			continue;
+		}
+
+		Stats_.ResidentCPUBytes += Resource->GetCPUMemorySize();
+		Stats_.ResidentGPUBytes += Resource->GetGPUMemorySize();
+		Stats_.ResidentCount++;
+		// 此处lock持有一个引用
+		if (!Pair.second.SourceFile.empty() && Resource.use_count() == 2 && Resource->GetReferCount() == 0) {
+			Stats_.EvictableCount++;
+		}
+	}
+
+	Stats_.ResidentBytes = Stats_.ResidentCPUBytes + Stats_.ResidentGPUBytes;
+	Stats_.PeakResidentBytes = std::max(Stats_.PeakResidentBytes, Stats_.ResidentBytes);
+	return Stats_;
+}
+
+void ResidencyManager::Clear() {
+	Entries_.clear();
+	Evicted_.clear();
+}
+
+std::string ResidencyManager::GetKey(ResourceType Type, const std::string& Name) {
+	return std::to_string((int)Type) + ":" + Name;
+}
+
+bool ResidencyManager::IsUnreferenced(const Entry& E) {
+	if (E.Resource.use_count() != 1) {
+		return false;
+	}
+	std::shared_ptr<IResource> Resource = E.Resource.lock();
+	return Resource && Resource->GetReferCount() == 0;
+}
@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include "Resource/IResource.h"
+#include "Graphics/RenderStats.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * 资源驻留管理：记录每个资源的CPU/GPU内存占用和最近使用时间，
+ * 超出预算时按LRU选出无引用的资源驱逐。只有知道来源文件的资源才会被驱逐，
+ * 驱逐后保留来源，再次获取时由ResourceManager重新加载。
+ * Touch可在任意线程调用，其余接口由ResourceManager在注册锁内调用。
+ */
+class ResidencyManager {
+public:
+	ResidencyManager();
+
+	void SetBudget(uint64_t Bytes) { Stats_.BudgetBytes = Bytes; }
+	uint64_t GetBudget() const { return Stats_.BudgetBytes; }
+
+	// 注册时调用，同名资源若曾被驱逐则计为一次重新加载
+	void Track(const std::shared_ptr<IResource>& Resource, const std::string& Name);
+	void Untrack(IResource* Resource);
+	// 记录来源文件，之后资源可被驱逐
+	void SetSource(IResource* Resource, const std::string& SourceFile);
+	bool HasSource(IResource* Resource) const;
+	// 固定常驻，不参与驱逐
+	void Pin(IResource* Resource);
+	// 标记为最近使用，只写资源上的原子时间戳
+	void Touch(IResource* Resource) { Resource->SetLastUsed(Clock_.fetch_add(1, std::memory_order_relaxed) + 1); }
+
+	// 按最久未使用的顺序选出需要驱逐的资源，使常驻内存回到预算内
+	void CollectEvictions(std::vector<uint64_t>& OutIDs);
+	// 资源卸载前调用，保留来源以便之后重新加载
+	void OnEvicted(IResource* Resource);
+
+	bool FindEvicted(ResourceType Type, const std::string& Name, std::string& OutSourceFile) const;
+	void OnReloadFailed(ResourceType Type, const std::string& Name);
+	void AddReloadTime(double TimeMs) { Stats_.ReloadTimeMs += TimeMs; }
+
+	const ResidencyStats& GetStats();
+	void Clear();
+
+private:
+	struct Entry {
+		std::weak_ptr<IResource> Resource;
+		std::string Name;
+		std::string SourceFile;
+		bool Pinned = false;
+	};
+
+	static std::string GetKey(ResourceType Type, const std::string& Name);
+	static uint64_t GetResourceSize(const IResource& Resource) { return Resource.GetCPUMemorySize() + Resource.GetGPUMemorySize(); }
+	// 只剩资源表一个引用且没有句柄持有者
+	static bool IsUnreferenced(const Entry& E);
+
+private:
+	std::unordered_map<uint64_t, Entry> Entries_;
+	std::atomic<uint64_t> Clock_;
+	// 被驱逐资源：类型:名称 -> 来源文件
+	std::unordered_map<std::string, std::string> Evicted_;
+	ResidencyStats Stats_;
+
+};
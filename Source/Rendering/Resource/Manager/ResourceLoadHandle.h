@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "Resource/IResource.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+enum class ResourceLoadState : uint8_t {
+	eLoading = 0,      // 工作线程导入中或等待上传
+	eReady,            // GPU对象已创建
+	eFailed            // 加载失败，继续使用占位资源
+};
+
+struct PreparedResource;
+
+// 异步加载请求的共享状态，由ResourceManager写入
+struct ResourceLoadRequest {
+	ResourceType Type = ResourceType::eMesh;
+	std::string FileName;
+	std::atomic<ResourceLoadState> State{ ResourceLoadState::eLoading };
+
+	std::shared_ptr<IResource> Resource;          // 就绪后有效，只在渲染线程访问
+	std::shared_ptr<IResource> Placeholder;       // 就绪前使用的内建资源
+	std::shared_ptr<PreparedResource> Prepared;   // 工作线程的导入结果，上传后释放
+	double PrepareTimeMs = 0.0;
+};
+
+/**
+ * LoadResourceAsync返回的句柄。就绪前Get返回占位资源，
+ * 调用方每帧检查IsDone后替换为真正的资源即可。
+ */
+class ResourceLoadHandle {
+public:
+	ResourceLoadHandle() = default;
+	explicit ResourceLoadHandle(std::shared_ptr<ResourceLoadRequest> Request) : Request_(std::move(Request)) {}
+
+	bool IsValid() const { return Request_ != nullptr; }
+	ResourceLoadState GetState() const {
+		return Request_ ? Request_->State.load(std::memory_order_acquire) : ResourceLoadState::eFailed;
+	}
+	bool IsReady() const { return GetState() == ResourceLoadState::eReady; }
+	bool IsDone() const { return GetState() != ResourceLoadState::eLoading; }
+
+	std::shared_ptr<IResource> Get() const {
+		if (!Request_) {
+			return nullptr;
+		}
+		return IsReady() ? Request_->Resource : Request_->Placeholder;
+	}
+
+	template<typename T>
+	std::shared_ptr<T> Get() const { return DynamicCast<T>(Get()); }
+
+	const std::string& GetFileName() const {
+		static const std::string Empty;
+		return Request_ ? Request_->FileName : Empty;
+	}
+
+private:
+	std::shared_ptr<ResourceLoadRequest> Request_;
+};
@@ -2,10 +2,57 @@
 #include "Rendering/Renderer/Renderer.h"
 #include "Platform/File/JsonObject.h"
 #include "Resource/IShader.h"
+#include "Resource/IMesh.h"
+#include "Resource/IMaterial.h"
+#include "Resource/ITexture.h"
 #include "Loader/MaterialLoader.h"
 #include <Logger.hpp>
 #include "Loader/MeshLoader.h"
 #include "Loader/ShaderLoader.h"
+#include "Loader/TextureLoader.h"
+#include "Loader/CookedMesh.h"
+#include "Loader/AssetSerializer.h"
+#include "DerivedDataCache.h"
+#include "Platform/File/MappedFile.h"
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
+
+// 导入阶段的结果，从工作线程交给渲染线程
+struct PreparedResource {
+	virtual ~PreparedResource() = default;
+
+	std::string FileName;
+	bool Cacheable = false;
+	bool IsCacheHit = false;
+	double PrepareTimeMs = 0.0;
+};
+
+struct PreparedMesh : public PreparedResource {
+	MeshDesc Desc;
+	// 烘焙文件或派生数据的映射，需保持到上传完成
+	MappedFile Mapping;
+	bool IsCooked = false;
+};
+
+struct PreparedMaterial : public PreparedResource {
+	MaterialDesc Desc;
+	// 工作线程预先解码的纹理，创建材质前先创建
+	std::vector<std::pair<std::string, std::shared_ptr<PreparedResource>>> Textures;
+};
+
+struct PreparedShader : public PreparedResource {
+	ShaderDesc Desc;
+};
+
+struct PreparedTexture : public PreparedResource {
+	TextureDesc Desc;
+};
+
+static double GetElapsedMs(const std::chrono::high_resolution_clock::time_point& StartTime) {
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - StartTime).count();
+}
 
 ResourceManager& ResourceManager::Instance() {
 	static ResourceManager GlobalResourceSys;
@@ -13,54 +60,379 @@ ResourceManager& ResourceManager::Instance() {
 }
 
 bool ResourceManager::Initialize() {
+	// 缓存目录不可用时仍可正常导入，只是每次都会重新导入
+	DerivedDataCache::Instance().Initialize();
+
 	GenerateBuiltinTexture();
 	GenerateBuiltinShader();
 	GenerateBuiltinMaterial();
 	GenerateBuiltinMesh();
 
+	// 内建资源用作回退和占位，常驻不驱逐
+	MutexGuard Guard(RegisterMutex_);
+	for (ResourceType Type : { ResourceType::eMesh, ResourceType::eMaterial, ResourceType::eShader, ResourceType::eTexture }) {
+		std::shared_ptr<IResource> Builtin = GetPlaceholder(Type);
+		if (Builtin) {
+			Residency_.Pin(Builtin.get());
+		}
+	}
+
 	return true;
 }
 
 
 void ResourceManager::Shutdown() {
-	MeshNameMap_.clear();
-	MaterialNameMap_.clear();
-	ShaderNameMap_.clear();
-	TextureNameMap_.clear();
+	// 等待工作线程上的导入结束，未上传的结果直接丢弃
+	JobSystem::Instance().WaitIdle();
+	{
+		MutexGuard Guard(UploadMutex_);
+		PreparedQueue_.clear();
+		InFlightRequests_.clear();
+	}
 
-	for (auto& Res : Resources_) {
-		if (Res.second) {
-			Res.second.reset();
-		}
+	LogResidencyStats();
+	{
+		MutexGuard Guard(RegisterMutex_);
+		MeshPool_.Clear();
+		MaterialPool_.Clear();
+		ShaderPool_.Clear();
+		TexturePool_.Clear();
+		Residency_.Clear();
 	}
-	Resources_.clear();
+	Registry_.Clear();
 
+	DerivedDataCache::Instance().LogStats();
 	LOG_INFO << "Resource system shutdown.";
 }
 
 std::shared_ptr<IResource> ResourceManager::LoadResource(ResourceType Type, const std::string& filename) {
+	// 同一文件已加载过时直接返回，不再读取和解析
+	std::shared_ptr<IResource> Resource = FindResource(Type, filename);
+	if (Resource) {
+		Residency_.Touch(Resource.get());
+		return Resource;
+	}
+
+	const auto StartTime = std::chrono::high_resolution_clock::now();
 	switch (Type)
 	{
 	case ResourceType::eMesh:
-		return LoadMeshResource(filename);
+		Resource = LoadMeshResource(filename);
 		break;
 	case ResourceType::eMaterial:
-		return LoadMaterialResource(filename);
+		Resource = LoadMaterialResource(filename);
 		break;
 	case ResourceType::eShader:
-		return LoadShaderResource(filename);
+		Resource = LoadShaderResource(filename);
 		break;
 	case ResourceType::eTexture:
-		return LoadTextureResource(filename);
+		Resource = LoadTextureResource(filename);
 		break;
 	}
 
-	return nullptr;
+	// 同步加载阻塞调用线程，记录其耗时峰值以便与异步路径比较
+	{
+		MutexGuard Guard(UploadMutex_);
+		StreamingStats_.BlockingLoads++;
+		StreamingStats_.MaxBlockingLoadMs = std::max(StreamingStats_.MaxBlockingLoadMs, GetElapsedMs(StartTime));
+	}
+
+	if (Resource) {
+		OnResourceLoaded(Type, filename, Resource);
+		EnforceResidencyBudget();
+	}
+	return Resource;
+}
+
+ResourceLoadHandle ResourceManager::LoadResourceAsync(ResourceType Type, const std::string& filename, bool UsePlaceholder) {
+	// 相同文件的进行中请求直接复用
+	const std::string RequestKey = std::to_string((int)Type) + ":" + filename;
+	std::shared_ptr<ResourceLoadRequest> Request;
+	{
+		MutexGuard Guard(UploadMutex_);
+		auto It = InFlightRequests_.find(RequestKey);
+		if (It != InFlightRequests_.end()) {
+			return ResourceLoadHandle(It->second);
+		}
+
+		Request = std::make_shared<ResourceLoadRequest>();
+		Request->Type = Type;
+		Request->FileName = filename;
+		Request->Placeholder = UsePlaceholder ? GetPlaceholder(Type) : nullptr;
+		InFlightRequests_[RequestKey] = Request;
+		StreamingStats_.Requested++;
+		StreamingStats_.InFlight = (uint32_t)InFlightRequests_.size();
+	}
+
+	JobSystem::Instance().Submit([this, Request]() {
+		const auto StartTime = std::chrono::high_resolution_clock::now();
+		Request->Prepared = PrepareResource(Request->Type, Request->FileName);
+		if (Request->Prepared && Request->Type == ResourceType::eMaterial) {
+			PrepareMaterialTextures(*Request->Prepared);
+		}
+		Request->PrepareTimeMs = GetElapsedMs(StartTime);
+
+		MutexGuard Guard(UploadMutex_);
+		PreparedQueue_.push_back(Request);
+	});
+
+	return ResourceLoadHandle(Request);
+}
+
+void ResourceManager::ProcessUploads(double BudgetMs) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	uint32_t Uploaded = 0;
+	for (;;) {
+		// 每帧至少处理一个请求，保证预算很小时也能推进
+		if (Uploaded > 0 && GetElapsedMs(StartTime) >= BudgetMs) {
+			break;
+		}
+
+		std::shared_ptr<ResourceLoadRequest> Request;
+		{
+			MutexGuard Guard(UploadMutex_);
+			if (PreparedQueue_.empty()) {
+				break;
+			}
+			Request = PreparedQueue_.front();
+			PreparedQueue_.pop_front();
+		}
+
+		if (Request->Prepared) {
+			Request->Resource = CreatePreparedResource(Request->Type, *Request->Prepared);
+		}
+		if (Request->Resource) {
+			OnResourceLoaded(Request->Type, Request->FileName, Request->Resource);
+		}
+		// 释放映射和CPU端数据
+		Request->Prepared.reset();
+		Request->State.store(Request->Resource ? ResourceLoadState::eReady : ResourceLoadState::eFailed, std::memory_order_release);
+		if (!Request->Resource) {
+			LOG_WARN << "Async load '" << Request->FileName << "' failed, keep using placeholder.";
+		}
+
+		{
+			MutexGuard Guard(UploadMutex_);
+			Request->Resource ? StreamingStats_.Completed++ : StreamingStats_.Failed++;
+			StreamingStats_.PrepareTimeMs += Request->PrepareTimeMs;
+			InFlightRequests_.erase(std::to_string((int)Request->Type) + ":" + Request->FileName);
+		}
+		Uploaded++;
+	}
+
+	if (Uploaded == 0) {
+		return;
+	}
+
+	EnforceResidencyBudget();
+
+	const double UploadTimeMs = GetElapsedMs(StartTime);
+	MutexGuard Guard(UploadMutex_);
+	StreamingStats_.UploadFrames++;
+	StreamingStats_.UploadTimeMs += UploadTimeMs;
+	StreamingStats_.MaxFrameUploadMs = std::max(StreamingStats_.MaxFrameUploadMs, UploadTimeMs);
+	StreamingStats_.InFlight = (uint32_t)InFlightRequests_.size();
+
+	if (InFlightRequests_.empty()) {
+		LOG_INFO << "Resource streaming idle: " << StreamingStats_.Completed << " loaded, " << StreamingStats_.Failed
+			<< " failed over " << StreamingStats_.UploadFrames << " frames, worker import " << StreamingStats_.PrepareTimeMs
+			<< " ms, upload " << StreamingStats_.UploadTimeMs << " ms (max " << StreamingStats_.MaxFrameUploadMs
+			<< " ms/frame); blocking loads " << StreamingStats_.BlockingLoads << " (max " << StreamingStats_.MaxBlockingLoadMs << " ms).";
+	}
+}
+
+ResourceStreamingStats ResourceManager::GetStreamingStats() {
+	MutexGuard Guard(UploadMutex_);
+	return StreamingStats_;
+}
+
+BatchLoadStats ResourceManager::LoadResourceBatch(const std::vector<std::string>& MeshFiles, std::vector<std::shared_ptr<IResource>>& OutMeshes) {
+	BatchLoadStats Stats;
+	Stats.MeshRequests = (uint32_t)MeshFiles.size();
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	JobSystem& Jobs = JobSystem::Instance();
+
+	// 第一层：网格文件去重，已加载的不再展开
+	std::vector<std::string> MeshQueue;
+	std::unordered_map<std::string, size_t> MeshIndices;
+	for (const std::string& MeshFile : MeshFiles) {
+		if (MeshIndices.emplace(MeshFile, MeshQueue.size()).second) {
+			MeshQueue.push_back(MeshFile);
+		}
+	}
+	Stats.UniqueMeshes = (uint32_t)MeshQueue.size();
+
+	std::vector<std::shared_ptr<IResource>> Meshes(MeshQueue.size());
+	std::vector<std::shared_ptr<PreparedResource>> PreparedMeshes(MeshQueue.size());
+	std::vector<uint32_t> PendingMeshes;
+	for (uint32_t i = 0; i < (uint32_t)MeshQueue.size(); ++i) {
+		Meshes[i] = FindResource(ResourceType::eMesh, MeshQueue[i]);
+		if (Meshes[i]) {
+			Stats.AlreadyLoaded++;
+		}
+		else {
+			PendingMeshes.push_back(i);
+		}
+	}
+	Jobs.ParallelFor((uint32_t)PendingMeshes.size(), [&](uint32_t i) {
+		PreparedMeshes[PendingMeshes[i]] = PrepareResource(ResourceType::eMesh, MeshQueue[PendingMeshes[i]]);
+	});
+
+	// 第二层：材质按名称去重
+	std::vector<MaterialDesc*> PendingMaterials;
+	std::unordered_set<std::string> MaterialNames;
+	for (auto& Prepared : PreparedMeshes) {
+		if (!Prepared) {
+			continue;
+		}
+
+		for (MaterialDesc& Material : static_cast<PreparedMesh&>(*Prepared).Desc.Materials) {
+			Stats.MaterialReferences++;
+			if (!MaterialNames.insert(Material.Name).second) {
+				continue;
+			}
+			if (FindResource(ResourceType::eMaterial, Material.Name)) {
+				Stats.AlreadyLoaded++;
+			}
+			else {
+				PendingMaterials.push_back(&Material);
+			}
+		}
+	}
+	Stats.UniqueMaterials = (uint32_t)MaterialNames.size();
+
+	// 第三层：Shader和纹理按文件去重
+	std::vector<std::string> ShaderQueue;
+	std::vector<std::string> TextureQueue;
+	std::unordered_set<std::string> ShaderFiles;
+	std::unordered_set<std::string> TextureFiles;
+	for (const MaterialDesc* Material : PendingMaterials) {
+		Stats.ShaderReferences++;
+		if (ShaderFiles.insert(Material->ShaderPath).second) {
+			if (FindResource(ResourceType::eShader, Material->ShaderPath)) {
+				Stats.AlreadyLoaded++;
+			}
+			else {
+				ShaderQueue.push_back(Material->ShaderPath);
+			}
+		}
+		for (auto& Texture : Material->TexturePaths) {
+			Stats.TextureReferences++;
+			if (!TextureFiles.insert(Texture.second).second) {
+				continue;
+			}
+			if (FindResource(ResourceType::eTexture, Texture.second)) {
+				Stats.AlreadyLoaded++;
+			}
+			else {
+				TextureQueue.push_back(Texture.second);
+			}
+		}
+	}
+	Stats.UniqueShaders = (uint32_t)ShaderFiles.size();
+	Stats.UniqueTextures = (uint32_t)TextureFiles.size();
+
+	// Shader和纹理互不依赖，在同一批任务中导入
+	const uint32_t ShaderCount = (uint32_t)ShaderQueue.size();
+	std::vector<std::shared_ptr<PreparedResource>> PreparedShaders(ShaderCount);
+	std::vector<std::shared_ptr<PreparedResource>> PreparedTextures(TextureQueue.size());
+	Jobs.ParallelFor(ShaderCount + (uint32_t)TextureQueue.size(), [&](uint32_t i) {
+		if (i < ShaderCount) {
+			PreparedShaders[i] = PrepareResource(ResourceType::eShader, ShaderQueue[i]);
+		}
+		else {
+			PreparedTextures[i - ShaderCount] = PrepareResource(ResourceType::eTexture, TextureQueue[i - ShaderCount]);
+		}
+	});
+	Stats.PrepareTimeMs = GetElapsedMs(StartTime);
+
+	// 按依赖的逆序创建，材质和网格加载时依赖已在资源表中
+	const auto CreateStartTime = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < ShaderQueue.size(); ++i) {
+		std::shared_ptr<IResource> Shader = PreparedShaders[i] ? CreatePreparedResource(ResourceType::eShader, *PreparedShaders[i]) : nullptr;
+		if (!Shader) {
+			Stats.Failed++;
+			continue;
+		}
+		OnResourceLoaded(ResourceType::eShader, ShaderQueue[i], Shader);
+	}
+	for (size_t i = 0; i < TextureQueue.size(); ++i) {
+		std::shared_ptr<IResource> Texture = PreparedTextures[i] ? CreatePreparedResource(ResourceType::eTexture, *PreparedTextures[i]) : nullptr;
+		// 释放CPU端像素数据的引用
+		PreparedTextures[i].reset();
+		if (!Texture) {
+			Stats.Failed++;
+			continue;
+		}
+		OnResourceLoaded(ResourceType::eTexture, TextureQueue[i], Texture);
+	}
+	for (MaterialDesc* Material : PendingMaterials) {
+		if (!LoadResourceFromDescriptor(ResourceType::eMaterial, Material)) {
+			Stats.Failed++;
+		}
+	}
+	for (uint32_t Index : PendingMeshes) {
+		if (PreparedMeshes[Index]) {
+			Meshes[Index] = CreatePreparedResource(ResourceType::eMesh, *PreparedMeshes[Index]);
+			// 释放映射和CPU端数据
+			PreparedMeshes[Index].reset();
+		}
+		if (!Meshes[Index]) {
+			Stats.Failed++;
+			continue;
+		}
+		OnResourceLoaded(ResourceType::eMesh, MeshQueue[Index], Meshes[Index]);
+	}
+	Stats.CreateTimeMs = GetElapsedMs(CreateStartTime);
+
+	OutMeshes.resize(MeshFiles.size());
+	for (size_t i = 0; i < MeshFiles.size(); ++i) {
+		OutMeshes[i] = Meshes[MeshIndices[MeshFiles[i]]];
+	}
+	EnforceResidencyBudget();
+
+	LOG_INFO << "Batch load: " << Stats.MeshRequests << " mesh requests (" << Stats.UniqueMeshes << " unique), "
+		<< Stats.MaterialReferences << " material refs (" << Stats.UniqueMaterials << " unique), "
+		<< Stats.ShaderReferences << " shader refs (" << Stats.UniqueShaders << " unique), "
+		<< Stats.TextureReferences << " texture refs (" << Stats.UniqueTextures << " unique); "
+		<< Stats.GetRedundantLoadsAvoided() << " redundant loads avoided, " << Stats.AlreadyLoaded << " already loaded, "
+		<< Stats.Failed << " failed. Prepare " << Stats.PrepareTimeMs << " ms on " << Jobs.GetWorkerCount()
+		<< " workers, create " << Stats.CreateTimeMs << " ms.";
+	// 整批加载完成后统计一次，逐个网格统计需要遍历全部网格
+	if (!PendingMeshes.empty()) {
+		LogMeshMemoryStats();
+	}
+	return Stats;
+}
+
+void ResourceManager::OnResourceLoaded(ResourceType Type, const std::string& filename, const std::shared_ptr<IResource>& Resource) {
+	// 加载失败时返回的内建资源不记录
+	if (Resource == GetPlaceholder(Type)) {
+		return;
+	}
+
+	MutexGuard Guard(RegisterMutex_);
+	Residency_.SetSource(Resource.get(), filename);
+	Registry_.AddAlias(filename, Resource);
+}
+
+std::shared_ptr<IResource> ResourceManager::GetPlaceholder(ResourceType Type) {
+	switch (Type) {
+	case ResourceType::eMesh:
+		return Registry_.Find(Type, BUILTIN_RECTANGLE_MESH);
+	case ResourceType::eMaterial:
+		return Registry_.Find(Type, BUILTIN_PBR_MATERIAL);
+	case ResourceType::eShader:
+		return Registry_.Find(Type, BUILTIN_PBR_SHADER);
+	case ResourceType::eTexture:
+		return Registry_.Find(Type, BUILTIN_WHITE_TEXTURE);
+	default:
+		return nullptr;
+	}
 }
 
 std::shared_ptr<IResource> ResourceManager::LoadResourceFromDescriptor(ResourceType Type, IResourceDesc* Desc) {
-	uint64_t ID = INVALID_ID;
-	std::shared_ptr<IResource> Resource = Acquire(Type, Desc->Name);
+	std::shared_ptr<IResource> Resource = FindResource(Type, Desc->Name);
 	if (Resource) {
 		LOG_INFO << "Resource '" << Desc->Name << "' already exist.";
 		return Resource;
@@ -74,14 +446,6 @@ std::shared_ptr<IResource> ResourceManager::LoadResourceFromDescriptor(ResourceT
 		if (!MDesc) return nullptr;
 
 		Resource = Renderer::Instance()->CreateMesh(*MDesc);
-		if (!Resource || !Resource->IsValid()) {
-			return nullptr;
-		}
-
-		ID = Resource->GetID();
-		if (ID == INVALID_ID) return nullptr;
-
-		MeshNameMap_[Desc->Name] = ID;
 	} break;
 	case ResourceType::eMaterial:
 	{
@@ -89,102 +453,305 @@ std::shared_ptr<IResource> ResourceManager::LoadResourceFromDescriptor(ResourceT
 		if (!MDesc) return nullptr;
 
 		Resource = Renderer::Instance()->CreateMaterial(*MDesc);
-		if (!Resource || !Resource->IsValid()) {
-			return nullptr;
-		}
-
-		ID = Resource->GetID();
-		if (ID == INVALID_ID) return nullptr;
-
-		MaterialNameMap_[Desc->Name] = ID;
 	} break;
 	case ResourceType::eShader: {
 		const ShaderDesc* MDesc = (ShaderDesc*)Desc;
 		if (!MDesc) return nullptr;
 
 		Resource = Renderer::Instance()->CreateShader(*MDesc);
-		if (!Resource || !Resource->IsValid()) {
-			return nullptr;
-		}
-
-		ID = Resource->GetID();
-		if (ID == INVALID_ID) return nullptr;
+	} break;
+	case ResourceType::eTexture: {
+		const TextureDesc* TDesc = (TextureDesc*)Desc;
+		if (!TDesc) return nullptr;
 
-		ShaderNameMap_[Desc->Name] = ID;
+		Resource = Renderer::Instance()->CreateTexture(*TDesc);
 	} break;
-	/*case ResourceType::eTexture:
+	}
 
-		break;*/
+	if (!Resource || !Resource->IsValid()) {
+		return nullptr;
 	}
+	return RegisterResource(Desc->Name, Resource);
+}
 
-	Resources_[ID] = Resource;
-	return Resource;
+std::shared_ptr<IResource> ResourceManager::LoadMeshFromDescriptor(MeshDesc&& Desc) {
+	std::shared_ptr<IResource> Resource = FindResource(ResourceType::eMesh, Desc.Name);
+	if (Resource) {
+		LOG_INFO << "Resource '" << Desc.Name << "' already exist.";
+		return Resource;
+	}
+
+	const std::string Name = Desc.Name;
+	Resource = Renderer::Instance()->CreateMesh(std::move(Desc));
+	if (!Resource || !Resource->IsValid()) {
+		return nullptr;
+	}
+	return RegisterResource(Name, Resource);
 }
 
 std::shared_ptr<IResource> ResourceManager::Acquire(ResourceType Type, const std::string& Name) {
-	uint64_t ResourceID = 0xFF;
+	std::shared_ptr<IResource> Resource = FindResource(Type, Name);
+	if (Resource) {
+		Residency_.Touch(Resource.get());
+		return Resource;
+	}
+	return ReloadEvicted(Type, Name);
+}
 
-	switch (Type)
+std::shared_ptr<IResource> ResourceManager::Acquire(uint64_t ID) {
+	std::shared_ptr<IResource> Resource = Registry_.Find(ID);
+	if (Resource) {
+		Residency_.Touch(Resource.get());
+	}
+	return Resource;
+}
+
+std::shared_ptr<IResource> ResourceManager::FindResource(ResourceType Type, const std::string& Name) {
+	return Registry_.Find(Type, Name);
+}
+
+void ResourceManager::Release(uint64_t ID) {
+	std::shared_ptr<IResource> Unloaded;
+	bool KeepResident = false;
 	{
-	case ResourceType::eMesh: {
-		if (MaterialNameMap_.find(Name) == MaterialNameMap_.end()) {
-			return nullptr;
+		MutexGuard Guard(RegisterMutex_);
+		std::shared_ptr<IResource> Resource = Registry_.Find(ID);
+		if (!Resource) {
+			return;
 		}
-		else {
-			ResourceID = MeshNameMap_[Name];
+
+		// 注册表之外的引用数，含这里的临时引用
+		const long UseCount = Registry_.GetExternalUseCount(ID);
+		LOG_INFO << "Resource '" << Resource->GetName() << "' current reference count: " << UseCount;
+		// 仍有其他引用或句柄持有者时保留
+		if (UseCount > 1 || Resource->GetReferCount() > 0) {
+			return;
 		}
-	} break;
-	case ResourceType::eMaterial:
-		if (MaterialNameMap_.find(Name) == MaterialNameMap_.end()) {
-			return nullptr;
+
+		// 可重新加载的资源留在LRU中，由预算决定何时驱逐
+		if (Residency_.HasSource(Resource.get())) {
+			Residency_.Touch(Resource.get());
+			KeepResident = true;
 		}
 		else {
-			ResourceID = MaterialNameMap_[Name];
+			Unloaded = UnregisterResource(Resource.get());
+			LOG_WARN << "Unloading the resource cause the reference count has reached 0!";
 		}
+	}
+
+	// 在锁外卸载
+	Unloaded.reset();
+	if (KeepResident) {
+		EnforceResidencyBudget();
+	}
+}
+
+MeshHandle ResourceManager::FindMesh(const std::string& Name) const {
+	std::shared_ptr<IResource> Resource = Registry_.Find(ResourceType::eMesh, Name);
+	return Resource ? MeshHandle::FromValue(Resource->GetHandleValue()) : MeshHandle();
+}
+
+MaterialHandle ResourceManager::FindMaterial(const std::string& Name) const {
+	std::shared_ptr<IResource> Resource = Registry_.Find(ResourceType::eMaterial, Name);
+	return Resource ? MaterialHandle::FromValue(Resource->GetHandleValue()) : MaterialHandle();
+}
+
+ShaderHandle ResourceManager::FindShader(const std::string& Name) const {
+	std::shared_ptr<IResource> Resource = Registry_.Find(ResourceType::eShader, Name);
+	return Resource ? ShaderHandle::FromValue(Resource->GetHandleValue()) : ShaderHandle();
+}
+
+TextureHandle ResourceManager::FindTexture(const std::string& Name) const {
+	std::shared_ptr<IResource> Resource = Registry_.Find(ResourceType::eTexture, Name);
+	return Resource ? TextureHandle::FromValue(Resource->GetHandleValue()) : TextureHandle();
+}
+
+bool ResourceManager::AddRef(MeshHandle Handle) {
+	IMesh* Mesh = MeshPool_.Get(Handle);
+	if (!Mesh) {
+		return false;
+	}
+	Mesh->Refer();
+	return true;
+}
+
+void ResourceManager::Release(MeshHandle Handle) {
+	IMesh* Mesh = MeshPool_.Get(Handle);
+	if (!Mesh || Mesh->GetReferCount() == 0) {
+		return;
+	}
+	if (Mesh->Release() == 0) {
+		Release(Mesh->GetID());
+	}
+}
+
+std::shared_ptr<IResource> ResourceManager::RegisterResource(const std::string& Name, const std::shared_ptr<IResource>& Resource) {
+	if (Resource->GetID() == INVALID_ID) {
+		return nullptr;
+	}
+
+	MutexGuard Guard(RegisterMutex_);
+	// 其他线程可能已注册同名资源，以先注册的为准
+	std::shared_ptr<IResource> Existing = Registry_.Find(Resource->GetResourceType(), Name);
+	if (Existing) {
+		return Existing;
+	}
+
+	uint32_t HandleValue = 0;
+	switch (Resource->GetResourceType()) {
+	case ResourceType::eMesh:
+		HandleValue = MeshPool_.Insert(static_cast<IMesh*>(Resource.get())).GetValue();
+		break;
+	case ResourceType::eMaterial:
+		HandleValue = MaterialPool_.Insert(static_cast<IMaterial*>(Resource.get())).GetValue();
 		break;
 	case ResourceType::eShader:
-		if (ShaderNameMap_.find(Name) == ShaderNameMap_.end()) {
-			return nullptr;
-		}
-		else {
-			ResourceID = ShaderNameMap_[Name];
-		}
+		HandleValue = ShaderPool_.Insert(static_cast<IShader*>(Resource.get())).GetValue();
 		break;
 	case ResourceType::eTexture:
+		HandleValue = TexturePool_.Insert(static_cast<ITexture*>(Resource.get())).GetValue();
 		break;
 	default:
-		LOG_ERROR << "ResourceSystem::Acquire - Acquire resource failed!";
 		return nullptr;
 	}
 
-	if (ResourceID == 0xFF || Resources_.find(ResourceID) == Resources_.end()) {
+	if (HandleValue == 0) {
+		LOG_ERROR << "Resource '" << Name << "' register failed, handle table is full!";
 		return nullptr;
 	}
 
-	return Resources_[ResourceID];
+	// 句柄值在发布到注册表之前写入，读者查到资源时句柄已可用
+	Resource->SetHandleValue(HandleValue);
+	Registry_.Insert(Name, Resource);
+	Residency_.Track(Resource, Name);
+	return Resource;
 }
 
-void ResourceManager::Release(uint64_t ID) {
-	if (Resources_.find(ID) == Resources_.end()) {
-		return;
+std::shared_ptr<IResource> ResourceManager::UnregisterResource(IResource* Resource) {
+	switch (Resource->GetResourceType()) {
+	case ResourceType::eMesh:
+		MeshPool_.Remove(MeshHandle::FromValue(Resource->GetHandleValue()));
+		break;
+	case ResourceType::eMaterial:
+		MaterialPool_.Remove(MaterialHandle::FromValue(Resource->GetHandleValue()));
+		break;
+	case ResourceType::eShader:
+		ShaderPool_.Remove(ShaderHandle::FromValue(Resource->GetHandleValue()));
+		break;
+	case ResourceType::eTexture:
+		TexturePool_.Remove(TextureHandle::FromValue(Resource->GetHandleValue()));
+		break;
+	default:
+		break;
 	}
 
-	long UseCount = Resources_[ID].use_count();
-	LOG_INFO << "Resource '" << Resources_[ID]->GetName() << "' current reference count: " << UseCount;
-	if (UseCount == 1) {
-		Resources_[ID].reset();
-		Resources_.erase(ID);
-		LOG_WARN << "Unloading the resource cause the reference count has reached 0!";
+	Resource->SetHandleValue(0);
+	Residency_.Untrack(Resource);
+	// 同时移除名称映射，之后可以按同名重新加载
+	return Registry_.Remove(Resource->GetID());
+}
+
+MeshMemoryStats ResourceManager::GetMeshMemoryStats() {
+	MeshMemoryStats Stats;
+	std::vector<std::shared_ptr<IResource>> Meshes;
+	Registry_.GetAll(ResourceType::eMesh, Meshes);
+	for (auto& Resource : Meshes) {
+		std::shared_ptr<IMesh> Mesh = DynamicCast<IMesh>(Resource);
+		if (!Mesh) {
+			continue;
+		}
+
+		const uint64_t GeometryBytes = Mesh->GetGeometrySize();
+		const uint64_t CPUBytes = Mesh->GetCPUMemorySize();
+		Stats.MeshCount++;
+		Stats.CPUResidentMeshes += Mesh->HasCPUData() ? 1 : 0;
+		Stats.GeometryBytes += GeometryBytes;
+		Stats.StandardGeometryBytes += (uint64_t)Mesh->GetVertexCount() * sizeof(Vertex) + (uint64_t)Mesh->GetIndexCount() * sizeof(uint32_t);
+		Stats.CPUBytes += CPUBytes;
+		Stats.CPUBytesSaved += GeometryBytes > CPUBytes ? GeometryBytes - CPUBytes : 0;
+	}
+	return Stats;
+}
+
+void ResourceManager::LogMeshMemoryStats() {
+	const MeshMemoryStats Stats = GetMeshMemoryStats();
+	LOG_INFO << "Mesh memory: " << Stats.MeshCount << " meshes (" << Stats.CPUResidentMeshes
+		<< " keep CPU data), geometry " << Stats.GeometryBytes / 1024 << " KB (standard format "
+		<< Stats.StandardGeometryBytes / 1024 << " KB), CPU "
+		<< Stats.CPUBytes / 1024 << " KB, saved " << Stats.CPUBytesSaved / 1024 << " KB.";
+}
+
+void ResourceManager::SetResidencyBudget(uint64_t Bytes) {
+	{
+		MutexGuard Guard(RegisterMutex_);
+		Residency_.SetBudget(Bytes);
 	}
+	EnforceResidencyBudget();
+}
+
+ResidencyStats ResourceManager::GetResidencyStats() {
+	MutexGuard Guard(RegisterMutex_);
+	return Residency_.GetStats();
+}
+
+void ResourceManager::LogResidencyStats() {
+	const ResidencyStats Stats = GetResidencyStats();
+	LOG_INFO << "Resource residency: " << Stats.ResidentCount << " resident (" << Stats.EvictableCount << " evictable), "
+		<< Stats.ResidentBytes / 1024 << " KB (CPU " << Stats.ResidentCPUBytes / 1024 << " KB, GPU " << Stats.ResidentGPUBytes / 1024
+		<< " KB, peak " << Stats.PeakResidentBytes / 1024 << " KB) of budget " << Stats.BudgetBytes / 1024 << " KB; "
+		<< Stats.Evictions << " evictions (" << Stats.EvictedBytes / 1024 << " KB), " << Stats.Reloads << " reloads ("
+		<< Stats.ReloadFailures << " failed, " << Stats.ReloadTimeMs << " ms).";
+}
+
+void ResourceManager::EnforceResidencyBudget() {
+	std::vector<std::shared_ptr<IResource>> Evicted;
+	{
+		MutexGuard Guard(RegisterMutex_);
+		std::vector<uint64_t> Evictions;
+		Residency_.CollectEvictions(Evictions);
+		for (uint64_t ID : Evictions) {
+			std::shared_ptr<IResource> Resource = Registry_.Find(ID);
+			if (!Resource) {
+				continue;
+			}
+
+			Residency_.OnEvicted(Resource.get());
+			Evicted.push_back(UnregisterResource(Resource.get()));
+		}
+	}
+
+	// 在锁外卸载
+	Evicted.clear();
+}
+
+std::shared_ptr<IResource> ResourceManager::ReloadEvicted(ResourceType Type, const std::string& Name) {
+	std::string SourceFile;
+	{
+		MutexGuard Guard(RegisterMutex_);
+		if (!Residency_.FindEvicted(Type, Name, SourceFile)) {
+			return nullptr;
+		}
+	}
+
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<IResource> Resource = LoadResource(Type, SourceFile);
+
+	MutexGuard Guard(RegisterMutex_);
+	Residency_.AddReloadTime(GetElapsedMs(StartTime));
+	if (!Resource) {
+		LOG_WARN << "Reload evicted resource '" << Name << "' from '" << SourceFile << "' failed!";
+		Residency_.OnReloadFailed(Type, Name);
+	}
+	return Resource;
 }
 
 void ResourceManager::GenerateBuiltinMesh() {
 	// 内建窗口
 	MeshDesc BuiltinRectangleDesc;
-	Vertex V1 = { FVector3(-1.0f,  1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(0, 0), FVector3(0.0f, 0.0f, 0.0f) };
-	Vertex V2 = { FVector3(-1.0f, -1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(0, 1), FVector3(0.0f, 0.0f, 0.0f) };
-	Vertex V3 = { FVector3(1.0f, -1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(1, 0), FVector3(0.0f, 0.0f, 0.0f) };
-	Vertex V4 = { FVector3(1.0f,  1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(1, 1), FVector3(0.0f, 0.0f, 0.0f) };
+	Vertex V1 = { FVector3(-1.0f,  1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(0, 0), FVector4(1.0f, 0.0f, 0.0f, 1.0f) };
+	Vertex V2 = { FVector3(-1.0f, -1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(0, 1), FVector4(1.0f, 0.0f, 0.0f, 1.0f) };
+	Vertex V3 = { FVector3(1.0f, -1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(1, 0), FVector4(1.0f, 0.0f, 0.0f, 1.0f) };
+	Vertex V4 = { FVector3(1.0f,  1.0f, 0.0f), FVector3(0.0f, 0.0f, -1.0f), FVector2(1, 1), FVector4(1.0f, 0.0f, 0.0f, 1.0f) };
 	SubMeshDesc RectangleSubMesh;
 	RectangleSubMesh.BaseVertex = 0;
 	RectangleSubMesh.BaseIndex = 0;
@@ -196,10 +763,10 @@ void ResourceManager::GenerateBuiltinMesh() {
 	BuiltinRectangleDesc.Indices = { 0, 1, 2, 0, 2, 3 };
 	BuiltinRectangleDesc.Name = BUILTIN_RECTANGLE_MESH;
 	BuiltinRectangleDesc.BoundsMin = FVector3(-1.0f, -1.0f, 0.0f);
-	BuiltinRectangleDesc.BoundsMin = FVector3(1.0f, 1.0f, 0.0f);
+	BuiltinRectangleDesc.BoundsMax = FVector3(1.0f, 1.0f, 0.0f);
 	BuiltinRectangleDesc.Materials = { {BUILTIN_PBR_MATERIAL }};
 	BuiltinRectangleDesc.SubMeshes = { RectangleSubMesh };
-	if (LoadResourceFromDescriptor(ResourceType::eMesh, &BuiltinRectangleDesc)){
+	if (LoadMeshFromDescriptor(std::move(BuiltinRectangleDesc))){
 		LOG_INFO << "Built-in mesh '" << BUILTIN_RECTANGLE_MESH << "' has created.";
 	}
 }
@@ -228,13 +795,23 @@ void ResourceManager::GenerateBuiltinShader(){
 		{ShaderStage::eFragment, "/Builtin/Builtin.frag"}
 	};
 
-	if (LoadResourceFromDescriptor(ResourceType::eShader, &BuiltinShaderDesc)) {
+	// 内建Shader是其他Shader编译期间的回退，必须立即可用
+	std::shared_ptr<IShader> BuiltinShader = DynamicCast<IShader>(LoadResourceFromDescriptor(ResourceType::eShader, &BuiltinShaderDesc));
+	if (BuiltinShader && BuiltinShader->WaitUntilReady()) {
 		LOG_INFO << "Built-in shader '" << BUILTIN_PBR_SHADER << "' has created.";
 	}
 }
 
 void ResourceManager::GenerateBuiltinTexture() {
+	// 1x1白色纹理，用作纹理加载失败或未就绪时的占位
+	const uint8_t WhitePixel[4] = { 255, 255, 255, 255 };
+	TextureDesc BuiltinTextureDesc;
+	TextureLoader::GenerateMips(1, 1, WhitePixel, BuiltinTextureDesc);
+	BuiltinTextureDesc.Name = BUILTIN_WHITE_TEXTURE;
 
+	if (LoadResourceFromDescriptor(ResourceType::eTexture, &BuiltinTextureDesc)) {
+		LOG_INFO << "Built-in texture '" << BUILTIN_WHITE_TEXTURE << "' has created.";
+	}
 }
 
 std::shared_ptr<IResource> ResourceManager::LoadMeshResource(const std::string& filename) {
@@ -245,18 +822,17 @@ std::shared_ptr<IResource> ResourceManager::LoadMeshResource(const std::string&
 
 	JsonObject Content = JsonObject(MeshSrc.ReadBytes());
 	const std::string& Name = Content.Get("Name").GetString();
-	if (MeshNameMap_.find(Name) != MeshNameMap_.end()) {
-		LOG_WARN << "Resource mesh '" << Name << "' already exist.";
-		return nullptr;
+	std::shared_ptr<IResource> Existing = Registry_.Find(ResourceType::eMesh, Name);
+	if (Existing) {
+		LOG_INFO << "Resource mesh '" << Name << "' already exist.";
+		return Existing;
 	}
 
-	// MeshAsset
-	MeshDesc Desc;
-	if (!MeshLoader::Load(Content.Get("MeshAsset").GetString(), Desc)) {
-		LOG_WARN << "Load mesh '" << filename << "' failed!";
+	std::shared_ptr<PreparedResource> Prepared = PrepareMesh(filename, Content);
+	if (!Prepared) {
+		return nullptr;
 	}
-
-	return LoadResourceFromDescriptor(ResourceType::eMesh, &Desc);
+	return CreatePreparedResource(ResourceType::eMesh, *Prepared);
 }
 
 std::shared_ptr<IResource> ResourceManager::LoadMaterialResource(const std::string& filename) {
@@ -267,43 +843,300 @@ std::shared_ptr<IResource> ResourceManager::LoadMaterialResource(const std::stri
 
 	JsonObject Content = JsonObject(MaterialSrc.ReadBytes());
 	const std::string& Name = Content.Get("Name").GetString();
-	if (MaterialNameMap_.find(Name) != MaterialNameMap_.end()) {
-		LOG_WARN << "Resource material '" << Name << "' already exist.";
-		return nullptr;
+	std::shared_ptr<IResource> Existing = Registry_.Find(ResourceType::eMaterial, Name);
+	if (Existing) {
+		LOG_INFO << "Resource material '" << Name << "' already exist.";
+		return Existing;
 	}
 
-	MaterialDesc Desc;
-	if (!MaterialLoader::Load(filename, Desc)) {
+	std::shared_ptr<PreparedResource> Prepared = PrepareMaterial(filename);
+	if (!Prepared) {
 		LOG_WARN << "Load material '" << filename << "' failed! Use built-in material.";
-		return Resources_[MaterialNameMap_[BUILTIN_PBR_MATERIAL]];
+		return GetPlaceholder(ResourceType::eMaterial);
 	}
-
-	return LoadResourceFromDescriptor(ResourceType::eMaterial, &Desc);
+	// 纹理在调用线程解码，只有GL对象的创建交给渲染线程
+	PrepareMaterialTextures(*Prepared);
+	return CreatePreparedResource(ResourceType::eMaterial, *Prepared);
 }
 
 std::shared_ptr<IResource> ResourceManager::LoadShaderResource(const std::string& filename) {
-	File ShaderAsset(MATERIAL_CONFIG_PATH + filename);
+	File ShaderAsset(SHADER_CONFIG_PATH + filename);
 	if (!ShaderAsset.IsExist()) {
 		return nullptr;
 	}
 
 	JsonObject Content = JsonObject(ShaderAsset.ReadBytes());
 	const std::string& Name = Content.Get("Name").GetString();
-	if (ShaderNameMap_.find(Name) != ShaderNameMap_.end()) {
+	std::shared_ptr<IResource> Existing = Registry_.Find(ResourceType::eShader, Name);
+	if (Existing) {
 		LOG_WARN << "Resource shader '" << Name << "' already exist.";
-		return Resources_[ShaderNameMap_[Name]];
+		return Existing;
 	}
 
-	ShaderDesc Desc;
-	if (!ShaderLoader::Load(filename, Desc)) {
+	std::shared_ptr<PreparedResource> Prepared = PrepareShader(filename);
+	if (!Prepared) {
 		LOG_WARN << "Load shader '" << filename << "' failed! Use built-in shader.";
-		return Resources_[ShaderNameMap_[BUILTIN_PBR_SHADER]];
+		return GetPlaceholder(ResourceType::eShader);
 	}
+	return CreatePreparedResource(ResourceType::eShader, *Prepared);
+}
 
-	return LoadResourceFromDescriptor(ResourceType::eShader, &Desc);
+std::shared_ptr<PreparedResource> ResourceManager::PrepareResource(ResourceType Type, const std::string& filename) {
+	switch (Type)
+	{
+	case ResourceType::eMesh: {
+		File MeshSrc(MESH_CONFIG_PATH + filename);
+		if (!MeshSrc.IsExist()) {
+			return nullptr;
+		}
+		return PrepareMesh(filename, JsonObject(MeshSrc.ReadBytes()));
+	}
+	case ResourceType::eMaterial:
+		return PrepareMaterial(filename);
+	case ResourceType::eShader:
+		return PrepareShader(filename);
+	case ResourceType::eTexture:
+		return PrepareTexture(filename);
+	default:
+		return nullptr;
+	}
 }
 
-std::shared_ptr<IResource> ResourceManager::LoadTextureResource(const std::string& filename) {
+std::shared_ptr<PreparedResource> ResourceManager::PrepareMesh(const std::string& filename, const JsonObject& Content) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<PreparedMesh> Prepared = std::make_shared<PreparedMesh>();
+	Prepared->FileName = filename;
+	MeshDesc& Desc = Prepared->Desc;
+
+	// 优先加载烘焙文件：映射后直接上传，映射需保持到上传完成
+	std::string CookedAsset;
+	if (Content.HasKey("CookedAsset")) {
+		CookedAsset = Content.Get("CookedAsset").GetString();
+	}
+	else if (CookedMesh::IsCookedPath(Content.Get("MeshAsset").GetString())) {
+		CookedAsset = Content.Get("MeshAsset").GetString();
+	}
+
+	if (!CookedAsset.empty()) {
+		Prepared->IsCooked = CookedMesh::Load(MESH_ASSET_PATH + CookedAsset, Desc, Prepared->Mapping);
+		if (!Prepared->IsCooked) {
+			LOG_WARN << "Load cooked mesh '" << CookedAsset << "' failed, fall back to source asset.";
+			Desc = MeshDesc();
+			Prepared->Mapping.Close();
+		}
+	}
+
+	// 可选的紧凑/量化顶点格式，由MeshLoader直接生成
+	const std::string MeshAsset = Content.Get("MeshAsset").GetString();
+	VertexFormat Format = VertexFormat::eStandard;
+	if (Content.HasKey("VertexFormat")) {
+		Format = VertexPacker::ParseFormat(Content.Get("VertexFormat").GetString());
+	}
+	// 默认开启顶点缓存/读取优化，过度绘制优化需在配置中开启
+	MeshOptimizeSettings OptimizeSettings;
+	OptimizeSettings.Overdraw = Content.HasKey("OptimizeOverdraw") && Content.Get("OptimizeOverdraw").GetBool();
+	// LOD链默认随优化一起生成，LODCount为1时关闭
+	if (Content.HasKey("LODCount")) {
+		OptimizeSettings.LODCount = (uint32_t)std::max(Content.Get("LODCount").GetInt(1), 1);
+	}
+	if (Content.HasKey("LODMaxError")) {
+		OptimizeSettings.LODMaxError = Content.Get("LODMaxError").GetFloat();
+	}
+	const bool Optimize = !Content.HasKey("OptimizeMesh") || Content.Get("OptimizeMesh").GetBool(true);
+
+	// 派生数据缓存：源文件和导入参数不变时直接映射上次的导入结果
+	DerivedDataCache& Cache = DerivedDataCache::Instance();
+	uint64_t CacheKey = 0;
+	Prepared->Cacheable = !Prepared->IsCooked && Cache.IsEnabled() &&
+		MeshLoader::ComputeCacheKey(MeshAsset, Format, Optimize ? &OptimizeSettings : nullptr, CacheKey);
+	if (Prepared->Cacheable && Cache.Contains(DerivedDataType::eMesh, CacheKey)) {
+		Prepared->IsCooked = Prepared->IsCacheHit = CookedMesh::Load(Cache.GetEntryPath(DerivedDataType::eMesh, CacheKey), Desc, Prepared->Mapping);
+		if (!Prepared->IsCooked) {
+			LOG_WARN << "Derived data of mesh '" << MeshAsset << "' is invalid, reimport it.";
+			Desc = MeshDesc();
+			Prepared->Mapping.Close();
+		}
+	}
+
+	if (!Prepared->IsCooked) {
+		// MeshAsset
+		Desc.Format = Format;
+		if (!MeshLoader::Load(MeshAsset, Desc, 0, Optimize ? &OptimizeSettings : nullptr)) {
+			LOG_WARN << "Load mesh '" << filename << "' failed!";
+			return nullptr;
+		}
+		if (Prepared->Cacheable) {
+			std::vector<uint8_t> CookedData;
+			if (CookedMesh::Serialize(Desc, CookedData)) {
+				Cache.Store(DerivedDataType::eMesh, CacheKey, CookedData);
+			}
+		}
+	}
+
+	// 物理碰撞、拾取等需要顶点数据时可在配置中声明保留CPU副本
+	if (Content.HasKey("KeepCPUData") && Content.Get("KeepCPUData").GetBool()) {
+		Desc.Residency = MeshResidency::eKeepCPUData;
+	}
+
+	Prepared->PrepareTimeMs = GetElapsedMs(StartTime);
+	return Prepared;
+}
+
+std::shared_ptr<PreparedResource> ResourceManager::PrepareMaterial(const std::string& filename) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<PreparedMaterial> Prepared = std::make_shared<PreparedMaterial>();
+	Prepared->FileName = filename;
+
+	DerivedDataCache& Cache = DerivedDataCache::Instance();
+	DerivedDataKey Key;
+	Key.Append((uint32_t)MATERIAL_IMPORTER_VERSION);
+	Key.AppendString(filename);
+	Prepared->Cacheable = Cache.IsEnabled() && Key.AppendFile(MATERIAL_CONFIG_PATH + filename);
+
+	std::vector<uint8_t> CachedData;
+	if (Prepared->Cacheable && Cache.Load(DerivedDataType::eMaterial, Key.Get(), CachedData)) {
+		BinaryReader Reader(CachedData.data(), CachedData.size());
+		Prepared->IsCacheHit = AssetSerializer::ReadMaterial(Reader, Prepared->Desc);
+		if (!Prepared->IsCacheHit) {
+			Prepared->Desc = MaterialDesc();
+		}
+	}
+
+	if (!Prepared->IsCacheHit) {
+		if (!MaterialLoader::Load(filename, Prepared->Desc)) {
+			return nullptr;
+		}
+		if (Prepared->Cacheable) {
+			CachedData.clear();
+			BinaryWriter Writer(CachedData);
+			AssetSerializer::WriteMaterial(Writer, Prepared->Desc);
+			Cache.Store(DerivedDataType::eMaterial, Key.Get(), CachedData);
+		}
+	}
+
+	Prepared->PrepareTimeMs = GetElapsedMs(StartTime);
+	return Prepared;
+}
+
+std::shared_ptr<PreparedResource> ResourceManager::PrepareShader(const std::string& filename) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<PreparedShader> Prepared = std::make_shared<PreparedShader>();
+	Prepared->FileName = filename;
+
+	DerivedDataCache& Cache = DerivedDataCache::Instance();
+	DerivedDataKey Key;
+	Key.Append((uint32_t)SHADER_IMPORTER_VERSION);
+	Key.AppendString(filename);
+	Prepared->Cacheable = Cache.IsEnabled() && Key.AppendFile(SHADER_CONFIG_PATH + filename);
+
+	std::vector<uint8_t> CachedData;
+	if (Prepared->Cacheable && Cache.Load(DerivedDataType::eShader, Key.Get(), CachedData)) {
+		BinaryReader Reader(CachedData.data(), CachedData.size());
+		Prepared->IsCacheHit = AssetSerializer::ReadShader(Reader, Prepared->Desc);
+		if (!Prepared->IsCacheHit) {
+			Prepared->Desc = ShaderDesc();
+		}
+	}
+
+	if (!Prepared->IsCacheHit) {
+		if (!ShaderLoader::Load(filename, Prepared->Desc)) {
+			return nullptr;
+		}
+		if (Prepared->Cacheable) {
+			CachedData.clear();
+			BinaryWriter Writer(CachedData);
+			AssetSerializer::WriteShader(Writer, Prepared->Desc);
+			Cache.Store(DerivedDataType::eShader, Key.Get(), CachedData);
+		}
+	}
+
+	Prepared->PrepareTimeMs = GetElapsedMs(StartTime);
+	return Prepared;
+}
+
+std::shared_ptr<PreparedResource> ResourceManager::PrepareTexture(const std::string& filename) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<PreparedTexture> Prepared = std::make_shared<PreparedTexture>();
+	Prepared->FileName = filename;
+
+	if (!TextureLoader::Load(filename, Prepared->Desc)) {
+		return nullptr;
+	}
+
+	Prepared->PrepareTimeMs = GetElapsedMs(StartTime);
+	return Prepared;
+}
+
+void ResourceManager::PrepareMaterialTextures(PreparedResource& Prepared) {
+	PreparedMaterial& Material = static_cast<PreparedMaterial&>(Prepared);
+	for (const auto& [Slot, TextureFile] : Material.Desc.TexturePaths) {
+		if (FindResource(ResourceType::eTexture, TextureFile)) {
+			continue;
+		}
+		Material.Textures.emplace_back(TextureFile, PrepareTexture(TextureFile));
+	}
+}
+
+std::shared_ptr<IResource> ResourceManager::CreatePreparedResource(ResourceType Type, PreparedResource& Prepared) {
+	const auto StartTime = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<IResource> Resource = nullptr;
+	DerivedDataType CacheType = DerivedDataType::eMesh;
+	switch (Type)
+	{
+	case ResourceType::eMesh: {
+		PreparedMesh& Mesh = static_cast<PreparedMesh&>(Prepared);
+		Resource = LoadMeshFromDescriptor(std::move(Mesh.Desc));
+		Mesh.Mapping.Close();
+		CacheType = DerivedDataType::eMesh;
+	} break;
+	case ResourceType::eMaterial: {
+		// 先创建工作线程已解码的纹理，材质加载时直接从资源表取得
+		PreparedMaterial& Material = static_cast<PreparedMaterial&>(Prepared);
+		for (auto& [TextureFile, PreparedTexture] : Material.Textures) {
+			std::shared_ptr<IResource> Texture = PreparedTexture ? CreatePreparedResource(ResourceType::eTexture, *PreparedTexture) : nullptr;
+			if (Texture) {
+				OnResourceLoaded(ResourceType::eTexture, TextureFile, Texture);
+			}
+		}
+		Material.Textures.clear();
 
-	return nullptr;
+		Resource = LoadResourceFromDescriptor(ResourceType::eMaterial, &Material.Desc);
+		CacheType = DerivedDataType::eMaterial;
+	} break;
+	case ResourceType::eShader:
+		Resource = LoadResourceFromDescriptor(ResourceType::eShader, &static_cast<PreparedShader&>(Prepared).Desc);
+		CacheType = DerivedDataType::eShader;
+		break;
+	case ResourceType::eTexture:
+		Resource = LoadResourceFromDescriptor(ResourceType::eTexture, &static_cast<PreparedTexture&>(Prepared).Desc);
+		break;
+	default:
+		return nullptr;
+	}
+
+	if (!Resource) {
+		return nullptr;
+	}
+
+	// 导入与创建耗时之和，不含在队列中等待的时间
+	const double LoadTimeMs = Prepared.PrepareTimeMs + GetElapsedMs(StartTime);
+	if (Prepared.Cacheable) {
+		DerivedDataCache& Cache = DerivedDataCache::Instance();
+		Prepared.IsCacheHit ? Cache.RecordHit(CacheType, LoadTimeMs) : Cache.RecordMiss(CacheType, LoadTimeMs);
+	}
+
+	if (Type == ResourceType::eMesh) {
+		const PreparedMesh& Mesh = static_cast<const PreparedMesh&>(Prepared);
+		LOG_INFO << "Mesh '" << Prepared.FileName << "' loaded from " << (Mesh.IsCacheHit ? "derived data cache" : (Mesh.IsCooked ? "cooked asset" : "source asset"))
+			<< " in " << LoadTimeMs << " ms.";
+	}
+	return Resource;
+}
+
+std::shared_ptr<IResource> ResourceManager::LoadTextureResource(const std::string& filename) {
+	std::shared_ptr<PreparedResource> Prepared = PrepareTexture(filename);
+	if (!Prepared) {
+		return nullptr;
+	}
+	return CreatePreparedResource(ResourceType::eTexture, *Prepared);
 }
@@ -2,15 +2,28 @@
 
 #include "RenderModuleAPI.h"
 #include "Resource/IResource.h"
+#include "Resource/ResourceHandle.h"
+#include "Graphics/RenderStats.h"
+#include "ResourceLoadHandle.h"
+#include "ResidencyManager.h"
+#include "ResourceRegistry.h"
+#include "Core/Mutex.h"
 
+#include <deque>
 #include <memory>
 #include <unordered_map>
 
 #define BUILTIN_RECTANGLE_MESH "BuiltinRectangle"
 #define BUILTIN_PBR_SHADER "BuiltinShader"
 #define BUILTIN_PBR_MATERIAL "BuiltinMaterial"
+#define BUILTIN_WHITE_TEXTURE "BuiltinWhiteTexture"
 
 
+/**
+ * 资源查找（Acquire/Find*、句柄Get）可在任意线程并发调用，不等待注册和卸载；
+ * 注册、卸载和驱逐在注册锁内串行执行。GPU对象仍需在持有图形上下文的线程创建，
+ * 其他线程应使用LoadResourceAsync。
+ */
 class ResourceManager {
 public:
 	ENGINE_RENDERING_API static ResourceManager& Instance();
@@ -20,12 +33,59 @@ public:
 	ENGINE_RENDERING_API virtual void Shutdown();
 
 	ENGINE_RENDERING_API std::shared_ptr<IResource> LoadResource(ResourceType Type, const std::string& filename);
+	/**
+	 * 异步加载：读取、解析和导入在工作线程执行，GPU对象在ProcessUploads中于渲染线程创建。
+	 * 就绪前句柄返回对应类型的内建资源作为占位（UsePlaceholder为false时返回nullptr）。
+	 */
+	ENGINE_RENDERING_API ResourceLoadHandle LoadResourceAsync(ResourceType Type, const std::string& filename, bool UsePlaceholder = true);
+	// 每帧在渲染线程调用，在预算内创建已导入完成的资源（每帧至少处理一个）
+	ENGINE_RENDERING_API void ProcessUploads(double BudgetMs = 2.0);
+	ENGINE_RENDERING_API ResourceStreamingStats GetStreamingStats();
+
+	/**
+	 * 批量加载网格及其依赖（网格 -> 材质 -> Shader/纹理）。依赖图按层广度优先展开并去重，
+	 * 已加载的节点不再展开；每层的文件导入在工作线程并行执行，
+	 * 之后在调用线程按Shader、材质、网格的顺序创建。OutMeshes与MeshFiles一一对应。
+	 */
+	ENGINE_RENDERING_API BatchLoadStats LoadResourceBatch(const std::vector<std::string>& MeshFiles, std::vector<std::shared_ptr<IResource>>& OutMeshes);
+
 	ENGINE_RENDERING_API std::shared_ptr<IResource> LoadResourceFromDescriptor(ResourceType Type, IResourceDesc* Desc);
+	// 接管描述中的顶点数据，避免额外复制
+	ENGINE_RENDERING_API std::shared_ptr<IResource> LoadMeshFromDescriptor(struct MeshDesc&& Desc);
 
+	// 被驱逐的资源在按名称获取时从原文件重新加载
 	ENGINE_RENDERING_API std::shared_ptr<IResource> Acquire(ResourceType Type, const std::string& Name);
 	ENGINE_RENDERING_API std::shared_ptr<IResource> Acquire(uint64_t ID);
+	// 可从文件重新加载的资源在引用归零后继续常驻，超出预算时按LRU驱逐
 	ENGINE_RENDERING_API void Release(uint64_t ID);
 
+	/**
+	 * 句柄访问：名称只在加载或初始化时通过Find*解析一次，之后用句柄O(1)取得裸指针，
+	 * 不产生shared_ptr引用计数和DynamicCast开销。资源卸载后旧句柄返回nullptr。
+	 */
+	ENGINE_RENDERING_API MeshHandle FindMesh(const std::string& Name) const;
+	ENGINE_RENDERING_API MaterialHandle FindMaterial(const std::string& Name) const;
+	ENGINE_RENDERING_API ShaderHandle FindShader(const std::string& Name) const;
+	ENGINE_RENDERING_API TextureHandle FindTexture(const std::string& Name) const;
+	IMesh* Get(MeshHandle Handle) const { return MeshPool_.Get(Handle); }
+	IMaterial* Get(MaterialHandle Handle) const { return MaterialPool_.Get(Handle); }
+	IShader* Get(ShaderHandle Handle) const { return ShaderPool_.Get(Handle); }
+	ITexture* Get(TextureHandle Handle) const { return TexturePool_.Get(Handle); }
+
+	// 句柄持有者的引用计数，计数归零且无其他shared_ptr引用时卸载资源
+	ENGINE_RENDERING_API bool AddRef(MeshHandle Handle);
+	ENGINE_RENDERING_API void Release(MeshHandle Handle);
+
+	ENGINE_RENDERING_API MeshMemoryStats GetMeshMemoryStats();
+	ENGINE_RENDERING_API void LogMeshMemoryStats();
+
+	// 常驻内存预算（CPU + GPU，字节），0表示不限制
+	ENGINE_RENDERING_API void SetResidencyBudget(uint64_t Bytes);
+	ENGINE_RENDERING_API ResidencyStats GetResidencyStats();
+	ENGINE_RENDERING_API void LogResidencyStats();
+	// 驱逐最久未使用的无引用资源直到回到预算内
+	ENGINE_RENDERING_API void EnforceResidencyBudget();
+
 private:
 	void GenerateBuiltinMesh();
 	void GenerateBuiltinMaterial();
@@ -37,12 +97,46 @@ private:
 	std::shared_ptr<IResource> LoadShaderResource(const std::string& filename);
 	std::shared_ptr<IResource> LoadTextureResource(const std::string& filename);
 
-public:
-	std::unordered_map<uint64_t, std::shared_ptr<IResource>> Resources_;
+	// 导入阶段：只做文件读取、解析和导入，不访问资源表和图形API，可在工作线程调用
+	static std::shared_ptr<PreparedResource> PrepareResource(ResourceType Type, const std::string& filename);
+	static std::shared_ptr<PreparedResource> PrepareMesh(const std::string& filename, const class JsonObject& Content);
+	static std::shared_ptr<PreparedResource> PrepareMaterial(const std::string& filename);
+	static std::shared_ptr<PreparedResource> PrepareShader(const std::string& filename);
+	static std::shared_ptr<PreparedResource> PrepareTexture(const std::string& filename);
+	// 在工作线程预先解码材质引用的、尚未加载的纹理（资源表查找无锁）
+	void PrepareMaterialTextures(PreparedResource& Prepared);
+	// 创建阶段：在渲染线程创建GPU对象并注册
+	std::shared_ptr<IResource> CreatePreparedResource(ResourceType Type, PreparedResource& Prepared);
+
+	std::shared_ptr<IResource> GetPlaceholder(ResourceType Type);
+	// 记录来源文件：供驱逐后重新加载，并作为查找别名避免重复读取
+	void OnResourceLoaded(ResourceType Type, const std::string& filename, const std::shared_ptr<IResource>& Resource);
+
+	// 只查资源表，不触发重新加载
+	std::shared_ptr<IResource> FindResource(ResourceType Type, const std::string& Name);
+	std::shared_ptr<IResource> ReloadEvicted(ResourceType Type, const std::string& Name);
+
+	// 写入注册表和对应类型的句柄表，同名资源已存在时返回已有资源
+	std::shared_ptr<IResource> RegisterResource(const std::string& Name, const std::shared_ptr<IResource>& Resource);
+	// 需持有RegisterMutex_，返回被移除的资源以便在锁外卸载
+	std::shared_ptr<IResource> UnregisterResource(IResource* Resource);
+
+private:
+	ResourceRegistry Registry_;
+
+	// 保护句柄表和驻留管理的写入
+	Mutex RegisterMutex_;
+	ResourcePool<IMesh> MeshPool_;
+	ResourcePool<IMaterial> MaterialPool_;
+	ResourcePool<IShader> ShaderPool_;
+	ResourcePool<ITexture> TexturePool_;
+	ResidencyManager Residency_;
 
-	std::unordered_map<std::string, uint64_t> MeshNameMap_;
-	std::unordered_map<std::string, uint64_t> MaterialNameMap_;
-	std::unordered_map<std::string, uint64_t> ShaderNameMap_;
-	std::unordered_map<std::string, uint64_t> TextureNameMap_;
+	// 工作线程导入完成、等待上传的请求
+	Mutex UploadMutex_;
+	std::deque<std::shared_ptr<ResourceLoadRequest>> PreparedQueue_;
+	// 进行中的请求，相同文件的请求合并（由UploadMutex_保护）
+	std::unordered_map<std::string, std::shared_ptr<ResourceLoadRequest>> InFlightRequests_;
+	ResourceStreamingStats StreamingStats_;
 
 };
\ No newline at end of file
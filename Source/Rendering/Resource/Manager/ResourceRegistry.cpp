@@ -0,0 +1,228 @@
+﻿#include "ResourceRegistry.h"
+
+ResourceRegistry::ResourceRegistry() : Epoch_(0) {
+	Readers_[0].store(0);
+	Readers_[1].store(0);
+	for (uint32_t i = 0; i < SHARD_COUNT; ++i) {
+		IDShards_[i].store(nullptr);
+		for (uint32_t Type = 0; Type < TYPE_COUNT; ++Type) {
+			NameShards_[Type][i].store(nullptr);
+		}
+	}
+}
+
+ResourceRegistry::~ResourceRegistry() {
+	Clear();
+
+	MutexGuard Guard(WriteMutex_);
+	for (uint32_t i = 0; i < SHARD_COUNT; ++i) {
+		delete IDShards_[i].exchange(nullptr);
+		for (uint32_t Type = 0; Type < TYPE_COUNT; ++Type) {
+			delete NameShards_[Type][i].exchange(nullptr);
+		}
+	}
+	ReclaimRetired();
+}
+
+std::shared_ptr<IResource> ResourceRegistry::Find(uint64_t ID) const {
+	ReadScope Scope(Epoch_, Readers_);
+	const IDTable* Table = IDShards_[GetShard(ID)].load();
+	if (!Table) {
+		return nullptr;
+	}
+
+	auto It = Table->find(ID);
+	return It != Table->end() ? It->second.lock() : nullptr;
+}
+
+std::shared_ptr<IResource> ResourceRegistry::Find(ResourceType Type, const std::string& Name) const {
+	if ((uint32_t)Type >= TYPE_COUNT) {
+		return nullptr;
+	}
+
+	ReadScope Scope(Epoch_, Readers_);
+	const NameTable* Table = NameShards_[(uint32_t)Type][GetShard(Name)].load();
+	if (!Table) {
+		return nullptr;
+	}
+
+	auto It = Table->find(Name);
+	return It != Table->end() ? It->second.lock() : nullptr;
+}
+
+void ResourceRegistry::GetAll(ResourceType Type, std::vector<std::shared_ptr<IResource>>& OutResources) const {
+	if ((uint32_t)Type >= TYPE_COUNT) {
+		return;
+	}
+
+	// 遍历ID表，名称表中有别名会重复
+	ReadScope Scope(Epoch_, Readers_);
+	for (uint32_t i = 0; i < SHARD_COUNT; ++i) {
+		const IDTable* Table = IDShards_[i].load();
+		if (!Table) {
+			continue;
+		}
+
+		for (auto& Pair : *Table) {
+			std::shared_ptr<IResource> Resource = Pair.second.lock();
+			if (Resource && Resource->GetResourceType() == Type) {
+				OutResources.push_back(Resource);
+			}
+		}
+	}
+}
+
+std::shared_ptr<IResource> ResourceRegistry::Insert(const std::string& Name, const std::shared_ptr<IResource>& Resource) {
+	if (!Resource || (uint32_t)Resource->GetResourceType() >= TYPE_COUNT) {
+		return nullptr;
+	}
+
+	MutexGuard Guard(WriteMutex_);
+	// 其他线程可能已注册同名资源
+	std::shared_ptr<IResource> Existing = Find(Resource->GetResourceType(), Name);
+	if (Existing) {
+		return Existing;
+	}
+
+	Owners_[Resource->GetID()] = { Resource, Name };
+	PublishID(Resource->GetID(), Resource);
+	PublishName(Resource->GetResourceType(), Name, Resource);
+	ReclaimRetired();
+	return Resource;
+}
+
+bool ResourceRegistry::AddAlias(const std::string& Alias, const std::shared_ptr<IResource>& Resource) {
+	if (!Resource) {
+		return false;
+	}
+
+	MutexGuard Guard(WriteMutex_);
+	auto It = Owners_.find(Resource->GetID());
+	if (It == Owners_.end() || Find(Resource->GetResourceType(), Alias)) {
+		return false;
+	}
+
+	It->second.Aliases.push_back(Alias);
+	PublishName(Resource->GetResourceType(), Alias, Resource);
+	ReclaimRetired();
+	return true;
+}
+
+std::shared_ptr<IResource> ResourceRegistry::Remove(uint64_t ID) {
+	MutexGuard Guard(WriteMutex_);
+	auto It = Owners_.find(ID);
+	if (It == Owners_.end()) {
+		return nullptr;
+	}
+
+	OwnerEntry Entry = std::move(It->second);
+	Owners_.erase(It);
+	PublishID(ID, nullptr);
+	// 名称可能已被同名的新资源占用
+	Entry.Aliases.push_back(Entry.Name);
+	for (const std::string& Name : Entry.Aliases) {
+		if (Find(Entry.Resource->GetResourceType(), Name) == Entry.Resource) {
+			PublishName(Entry.Resource->GetResourceType(), Name, nullptr);
+		}
+	}
+	ReclaimRetired();
+	return Entry.Resource;
+}
+
+long ResourceRegistry::GetExternalUseCount(uint64_t ID) {
+	MutexGuard Guard(WriteMutex_);
+	auto It = Owners_.find(ID);
+	return It != Owners_.end() ? It->second.Resource.use_count() - 1 : 0;
+}
+
+void ResourceRegistry::Clear() {
+	std::unordered_map<uint64_t, OwnerEntry> Owners;
+	{
+		MutexGuard Guard(WriteMutex_);
+		Owners.swap(Owners_);
+		for (uint32_t i = 0; i < SHARD_COUNT; ++i) {
+			const IDTable* OldID = IDShards_[i].exchange(nullptr);
+			if (OldID) RetiredIDTables_.push_back(OldID);
+			for (uint32_t Type = 0; Type < TYPE_COUNT; ++Type) {
+				const NameTable* OldName = NameShards_[Type][i].exchange(nullptr);
+				if (OldName) RetiredNameTables_.push_back(OldName);
+			}
+		}
+		ReclaimRetired();
+	}
+
+	// 在锁外释放，资源卸载时可能再次访问注册表
+	Owners.clear();
+}
+
+uint32_t ResourceRegistry::GetCount() const {
+	MutexGuard Guard(WriteMutex_);
+	return (uint32_t)Owners_.size();
+}
+
+void ResourceRegistry::PublishID(uint64_t ID, const std::shared_ptr<IResource>& Resource) {
+	std::atomic<const IDTable*>& Shard = IDShards_[GetShard(ID)];
+	const IDTable* Old = Shard.load();
+	IDTable* New = Old ? new IDTable(*Old) : new IDTable();
+	if (Resource) {
+		(*New)[ID] = Resource;
+	}
+	else {
+		New->erase(ID);
+	}
+
+	Shard.store(New);
+	if (Old) {
+		RetiredIDTables_.push_back(Old);
+	}
+}
+
+void ResourceRegistry::PublishName(ResourceType Type, const std::string& Name, const std::shared_ptr<IResource>& Resource) {
+	std::atomic<const NameTable*>& Shard = NameShards_[(uint32_t)Type][GetShard(Name)];
+	const NameTable* Old = Shard.load();
+	NameTable* New = Old ? new NameTable(*Old) : new NameTable();
+	if (Resource) {
+		(*New)[Name] = Resource;
+	}
+	else {
+		New->erase(Name);
+	}
+
+	Shard.store(New);
+	if (Old) {
+		RetiredNameTables_.push_back(Old);
+	}
+}
+
+void ResourceRegistry::ReclaimRetired() {
+	// 上一批旧表的读者未退出前不能再翻转纪元，否则新读者会计入同一侧
+	if (!DrainingIDTables_.empty() || !DrainingNameTables_.empty()) {
+		if (Readers_[DrainingEpoch_ & 1].load() != 0) {
+			return;
+		}
+		DeleteDraining();
+	}
+	if (RetiredIDTables_.empty() && RetiredNameTables_.empty()) {
+		return;
+	}
+
+	// 新表已发布，翻转纪元后进入的读者只会看到新表，
+	// 翻转前进入的读者全部退出后旧表即可回收
+	DrainingIDTables_.swap(RetiredIDTables_);
+	DrainingNameTables_.swap(RetiredNameTables_);
+	DrainingEpoch_ = Epoch_.fetch_add(1);
+	if (Readers_[DrainingEpoch_ & 1].load() == 0) {
+		DeleteDraining();
+	}
+}
+
+void ResourceRegistry::DeleteDraining() {
+	for (const IDTable* Table : DrainingIDTables_) {
+		delete Table;
+	}
+	for (const NameTable* Table : DrainingNameTables_) {
+		delete Table;
+	}
+	DrainingIDTables_.clear();
+	DrainingNameTables_.clear();
+}
@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include "Resource/IResource.h"
+#include "Core/Mutex.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * 并发资源注册表。ID和名称表按键哈希分片，每个分片是发布后不再修改的只读表：
+ * 读者原子地取得表指针后直接查找，不加锁也不等待写者；写者之间互斥，
+ * 复制所在分片修改后原子发布，旧表在发布前进入的读者全部退出后回收。
+ * 表中只存weak_ptr，所有权由Owners_持有，读者和旧表不影响use_count。
+ */
+class ResourceRegistry {
+public:
+	static constexpr uint32_t SHARD_COUNT = 16;
+	static constexpr uint32_t TYPE_COUNT = (uint32_t)ResourceType::eTexture + 1;
+
+	ENGINE_RENDERING_API ResourceRegistry();
+	ENGINE_RENDERING_API ~ResourceRegistry();
+
+	// 禁止拷贝
+	ResourceRegistry(const ResourceRegistry&) = delete;
+	ResourceRegistry& operator=(const ResourceRegistry&) = delete;
+
+	// 读路径，可在任意线程调用
+	ENGINE_RENDERING_API std::shared_ptr<IResource> Find(uint64_t ID) const;
+	ENGINE_RENDERING_API std::shared_ptr<IResource> Find(ResourceType Type, const std::string& Name) const;
+	ENGINE_RENDERING_API void GetAll(ResourceType Type, std::vector<std::shared_ptr<IResource>>& OutResources) const;
+
+	// 写路径。同名资源已存在时不插入，返回已有资源
+	ENGINE_RENDERING_API std::shared_ptr<IResource> Insert(const std::string& Name, const std::shared_ptr<IResource>& Resource);
+	// 为已注册的资源追加查找别名（如来源文件路径），别名已被占用时忽略
+	ENGINE_RENDERING_API bool AddAlias(const std::string& Alias, const std::shared_ptr<IResource>& Resource);
+	// 返回被移除的资源，由调用者释放最后一个引用
+	ENGINE_RENDERING_API std::shared_ptr<IResource> Remove(uint64_t ID);
+	// 注册表之外的引用数
+	ENGINE_RENDERING_API long GetExternalUseCount(uint64_t ID);
+	ENGINE_RENDERING_API void Clear();
+	ENGINE_RENDERING_API uint32_t GetCount() const;
+
+private:
+	using IDTable = std::unordered_map<uint64_t, std::weak_ptr<IResource>>;
+	using NameTable = std::unordered_map<std::string, std::weak_ptr<IResource>>;
+
+	struct OwnerEntry {
+		std::shared_ptr<IResource> Resource;
+		std::string Name;
+		std::vector<std::string> Aliases;
+	};
+
+	// 读者按进入时的纪元计数，写者据此判断旧表能否回收
+	class ReadScope {
+	public:
+		ReadScope(const std::atomic<uint32_t>& Epoch, std::atomic<uint32_t>* Readers) {
+			// 计数后纪元已翻转则重新登记，保证计入的是当前纪元
+			for (;;) {
+				const uint32_t Current = Epoch.load();
+				Readers_ = &Readers[Current & 1];
+				Readers_->fetch_add(1);
+				if (Epoch.load() == Current) {
+					break;
+				}
+				Readers_->fetch_sub(1);
+			}
+		}
+		~ReadScope() { Readers_->fetch_sub(1); }
+
+	private:
+		std::atomic<uint32_t>* Readers_;
+	};
+
+	static uint32_t GetShard(uint64_t ID) { return (uint32_t)(std::hash<uint64_t>()(ID) % SHARD_COUNT); }
+	static uint32_t GetShard(const std::string& Name) { return (uint32_t)(std::hash<std::string>()(Name) % SHARD_COUNT); }
+
+	// 以下只在持有WriteMutex_时调用
+	void PublishID(uint64_t ID, const std::shared_ptr<IResource>& Resource);
+	void PublishName(ResourceType Type, const std::string& Name, const std::shared_ptr<IResource>& Resource);
+	void ReclaimRetired();
+	void DeleteDraining();
+
+private:
+	mutable Mutex WriteMutex_;
+	std::unordered_map<uint64_t, OwnerEntry> Owners_;
+
+	std::atomic<const IDTable*> IDShards_[SHARD_COUNT];
+	std::atomic<const NameTable*> NameShards_[TYPE_COUNT][SHARD_COUNT];
+
+	// 两个纪元交替计数：翻转后新读者计入另一侧，持续有读者时旧表也能回收
+	std::atomic<uint32_t> Epoch_;
+	mutable std::atomic<uint32_t> Readers_[2];
+	// 当前纪元中被替换的旧表
+	std::vector<const IDTable*> RetiredIDTables_;
+	std::vector<const NameTable*> RetiredNameTables_;
+	// 纪元翻转前被替换的旧表，等待DrainingEpoch_一侧的读者退出
+	std::vector<const IDTable*> DrainingIDTables_;
+	std::vector<const NameTable*> DrainingNameTables_;
+	uint32_t DrainingEpoch_ = 0;
+
+};
@@ -0,0 +1,161 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 32位代际句柄：低20位为槽位索引，高12位为代际。
+ * 槽位释放时代际递增，过期句柄查找返回空而不会访问到新资源；代际从1开始，0为无效句柄。
+ */
+template<typename T>
+class Handle {
+public:
+	static constexpr uint32_t INDEX_BITS = 20;
+	static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	Handle() : Value_(0) {}
+	Handle(uint32_t Index, uint32_t Generation) : Value_(((Generation & GENERATION_MASK) << INDEX_BITS) | (Index & INDEX_MASK)) {}
+
+	static Handle FromValue(uint32_t Value) {
+		Handle Result;
+		Result.Value_ = Value;
+		return Result;
+	}
+
+	bool IsValid() const { return Value_ != 0; }
+	uint32_t GetIndex() const { return Value_ & INDEX_MASK; }
+	uint32_t GetGeneration() const { return Value_ >> INDEX_BITS; }
+	uint32_t GetValue() const { return Value_; }
+
+	bool operator==(const Handle& Other) const { return Value_ == Other.Value_; }
+	bool operator!=(const Handle& Other) const { return Value_ != Other.Value_; }
+
+private:
+	uint32_t Value_;
+};
+
+class IMesh;
+class IMaterial;
+class IShader;
+class ITexture;
+
+using MeshHandle = Handle<IMesh>;
+using MaterialHandle = Handle<IMaterial>;
+using ShaderHandle = Handle<IShader>;
+using TextureHandle = Handle<ITexture>;
+
+/**
+ * 按类型划分的槽位表，句柄到指针的查找为O(1)且不产生引用计数操作。
+ * 槽位按块分配且块不会移动，Get可在任意线程与写入并发调用；Insert/Remove需由调用者互斥。
+ * 只保存裸指针，资源所有权仍由ResourceManager持有；资源卸载前需先Remove。
+ */
+template<typename T>
+class ResourcePool {
+public:
+	static constexpr uint32_t CHUNK_SIZE = 1024;
+	static constexpr uint32_t CHUNK_COUNT = (Handle<T>::INDEX_MASK + 1) / CHUNK_SIZE;
+
+	ResourcePool() : NextIndex_(0), Count_(0) {
+		for (auto& Chunk : Chunks_) {
+			Chunk.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	~ResourcePool() { Clear(); }
+
+	// 禁止拷贝
+	ResourcePool(const ResourcePool&) = delete;
+	ResourcePool& operator=(const ResourcePool&) = delete;
+
+	Handle<T> Insert(T* Resource) {
+		if (!Resource) {
+			return Handle<T>();
+		}
+
+		uint32_t Index = 0;
+		if (!FreeSlots_.empty()) {
+			Index = FreeSlots_.back();
+			FreeSlots_.pop_back();
+		}
+		else {
+			if (NextIndex_ > Handle<T>::INDEX_MASK) {
+				return Handle<T>();
+			}
+			Index = NextIndex_++;
+		}
+
+		Slot* Chunk = Chunks_[Index / CHUNK_SIZE].load(std::memory_order_relaxed);
+		if (!Chunk) {
+			Chunk = new Slot[CHUNK_SIZE];
+			Chunks_[Index / CHUNK_SIZE].store(Chunk, std::memory_order_release);
+		}
+
+		// 先写指针再发布句柄值
+		Slot& S = Chunk[Index % CHUNK_SIZE];
+		const Handle<T> Result(Index, S.Generation);
+		S.Object.store(Resource, std::memory_order_release);
+		S.Value.store(Result.GetValue(), std::memory_order_release);
+		Count_++;
+		return Result;
+	}
+
+	bool Remove(Handle<T> H) {
+		Slot* S = GetSlot(H.GetIndex());
+		if (!H.IsValid() || !S || S->Value.load(std::memory_order_relaxed) != H.GetValue()) {
+			return false;
+		}
+
+		S->Value.store(0, std::memory_order_release);
+		S->Object.store(nullptr, std::memory_order_release);
+		// 跳过0，保证句柄值不为0
+		uint16_t Generation = (uint16_t)((S->Generation + 1) & Handle<T>::GENERATION_MASK);
+		S->Generation = Generation == 0 ? 1 : Generation;
+		FreeSlots_.push_back(H.GetIndex());
+		Count_--;
+		return true;
+	}
+
+	T* Get(Handle<T> H) const {
+		const Slot* S = GetSlot(H.GetIndex());
+		if (!H.IsValid() || !S || S->Value.load(std::memory_order_acquire) != H.GetValue()) {
+			return nullptr;
+		}
+
+		// 读指针期间槽位被重用时句柄值会改变
+		T* Object = S->Object.load(std::memory_order_acquire);
+		return S->Value.load(std::memory_order_acquire) == H.GetValue() ? Object : nullptr;
+	}
+
+	bool Contains(Handle<T> H) const { return Get(H) != nullptr; }
+	uint32_t GetCount() const { return Count_; }
+
+	// 只能在没有并发读者时调用
+	void Clear() {
+		for (auto& Chunk : Chunks_) {
+			delete[] Chunk.exchange(nullptr);
+		}
+		FreeSlots_.clear();
+		NextIndex_ = 0;
+		Count_ = 0;
+	}
+
+private:
+	struct Slot {
+		std::atomic<uint32_t> Value{ 0 };
+		std::atomic<T*> Object{ nullptr };
+		uint16_t Generation = 1;
+	};
+
+	Slot* GetSlot(uint32_t Index) const {
+		Slot* Chunk = Chunks_[Index / CHUNK_SIZE].load(std::memory_order_acquire);
+		return Chunk ? Chunk + Index % CHUNK_SIZE : nullptr;
+	}
+
+private:
+	std::atomic<Slot*> Chunks_[CHUNK_COUNT];
+	std::vector<uint32_t> FreeSlots_;
+	uint32_t NextIndex_;
+	uint32_t Count_;
+};
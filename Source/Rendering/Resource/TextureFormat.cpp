@@ -0,0 +1,54 @@
+﻿#include "TextureFormat.h"
+#include <Logger.hpp>
+
+uint32_t TextureLayout::GetBlockBytes(TextureFormat Format) {
+	switch (Format)
+	{
+	case TextureFormat::eBC1:
+		return 8;
+	case TextureFormat::eBC3:
+	case TextureFormat::eBC5:
+	case TextureFormat::eBC7:
+		return 16;
+	default:
+		return 4;
+	}
+}
+
+uint64_t TextureLayout::GetMipSize(TextureFormat Format, uint32_t Width, uint32_t Height) {
+	if (!IsCompressed(Format)) {
+		return (uint64_t)Width * Height * GetBlockBytes(Format);
+	}
+
+	// 不足一块的边缘按整块存储
+	const uint64_t BlocksX = (Width + 3) / 4;
+	const uint64_t BlocksY = (Height + 3) / 4;
+	return BlocksX * BlocksY * GetBlockBytes(Format);
+}
+
+TextureFormat TextureLayout::ParseFormat(const std::string& Name) {
+	for (uint32_t i = 0; i < (uint32_t)TextureFormat::eCount; ++i) {
+		if (Name == GetFormatName((TextureFormat)i)) {
+			return (TextureFormat)i;
+		}
+	}
+
+	LOG_WARN << "Unknown texture format '" << Name << "', use RGBA8.";
+	return TextureFormat::eRGBA8;
+}
+
+const char* TextureLayout::GetFormatName(TextureFormat Format) {
+	switch (Format)
+	{
+	case TextureFormat::eBC1:
+		return "BC1";
+	case TextureFormat::eBC3:
+		return "BC3";
+	case TextureFormat::eBC5:
+		return "BC5";
+	case TextureFormat::eBC7:
+		return "BC7";
+	default:
+		return "RGBA8";
+	}
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include <cstdint>
+#include <string>
+
+// 纹理像素格式，块压缩格式以4x4像素为一块
+enum class TextureFormat : uint8_t {
+	eRGBA8 = 0,           // 未压缩，4字节/像素
+	eBC1,                 // RGB，8字节/块（0.5字节/像素），用于不透明颜色
+	eBC3,                 // RGBA，BC4编码Alpha + BC1编码颜色，16字节/块
+	eBC5,                 // RG双通道，两个BC4块，16字节/块，用于法线
+	eBC7,                 // RGBA高质量，16字节/块
+	eCount
+};
+
+class TextureLayout {
+public:
+	static bool IsCompressed(TextureFormat Format) { return Format != TextureFormat::eRGBA8; }
+	// 块压缩格式每块字节数，未压缩格式为每像素字节数
+	ENGINE_RENDERING_API static uint32_t GetBlockBytes(TextureFormat Format);
+	ENGINE_RENDERING_API static uint64_t GetMipSize(TextureFormat Format, uint32_t Width, uint32_t Height);
+
+	ENGINE_RENDERING_API static TextureFormat ParseFormat(const std::string& Name);
+	ENGINE_RENDERING_API static const char* GetFormatName(TextureFormat Format);
+};
@@ -0,0 +1,301 @@
+﻿#include "VertexFormat.h"
+#include <Logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+static_assert(sizeof(Vertex) == 48, "Vertex must match the standard vertex layout.");
+static_assert(sizeof(CompactVertex) == 24, "CompactVertex must match the compact vertex layout.");
+static_assert(sizeof(QuantizedVertex) == 20, "QuantizedVertex must match the quantized vertex layout.");
+
+const VertexLayout& VertexLayout::Get(VertexFormat Format) {
+	static const VertexLayout Layouts[] = {
+		// eStandard
+		{ sizeof(Vertex), {
+			{ 0, 3, VertexAttributeType::eFloat32, offsetof(Vertex, position) },
+			{ 1, 3, VertexAttributeType::eFloat32, offsetof(Vertex, normal) },
+			{ 2, 2, VertexAttributeType::eFloat32, offsetof(Vertex, texCoord) },
+			{ 3, 4, VertexAttributeType::eFloat32, offsetof(Vertex, tangent) }
+		}},
+		// eCompact
+		{ sizeof(CompactVertex), {
+			{ 0, 3, VertexAttributeType::eFloat32, offsetof(CompactVertex, Position) },
+			{ 1, 2, VertexAttributeType::eSNorm16, offsetof(CompactVertex, Normal) },
+			{ 2, 2, VertexAttributeType::eFloat16, offsetof(CompactVertex, TexCoord) },
+			{ 3, 4, VertexAttributeType::eSNorm10_10_10_2, offsetof(CompactVertex, Tangent) }
+		}},
+		// eCompactQuantized
+		{ sizeof(QuantizedVertex), {
+			{ 0, 4, VertexAttributeType::eUNorm16, offsetof(QuantizedVertex, Position) },
+			{ 1, 2, VertexAttributeType::eSNorm16, offsetof(QuantizedVertex, Normal) },
+			{ 2, 2, VertexAttributeType::eFloat16, offsetof(QuantizedVertex, TexCoord) },
+			{ 3, 4, VertexAttributeType::eSNorm10_10_10_2, offsetof(QuantizedVertex, Tangent) }
+		}}
+	};
+	static_assert(sizeof(Layouts) / sizeof(Layouts[0]) == (size_t)VertexFormat::eCount, "Missing vertex layout.");
+
+	return Layouts[(size_t)Format];
+}
+
+uint16_t VertexPacker::FloatToHalf(float Value) {
+	uint32_t Bits;
+	memcpy(&Bits, &Value, sizeof(Bits));
+
+	const uint32_t Sign = (Bits >> 16) & 0x8000;
+	const uint32_t FloatExponent = (Bits >> 23) & 0xFF;
+	uint32_t Mantissa = Bits & 0x7FFFFF;
+
+	// Inf / NaN
+	if (FloatExponent == 0xFF) {
+		return (uint16_t)(Sign | 0x7C00 | (Mantissa ? 0x200 : 0));
+	}
+
+	const int32_t Exponent = (int32_t)FloatExponent - 127 + 15;
+	if (Exponent >= 31) {
+		return (uint16_t)(Sign | 0x7C00);
+	}
+
+	// 非规格化数，就近舍入到偶数
+	if (Exponent <= 0) {
+		if (Exponent < -10) {
+			return (uint16_t)Sign;
+		}
+
+		Mantissa |= 0x800000;
+		const uint32_t Shift = (uint32_t)(14 - Exponent);
+		uint32_t Half = Mantissa >> Shift;
+		const uint32_t Remainder = Mantissa & ((1u << Shift) - 1);
+		const uint32_t HalfWay = 1u << (Shift - 1);
+		if (Remainder > HalfWay || (Remainder == HalfWay && (Half & 1))) {
+			Half++;
+		}
+		return (uint16_t)(Sign | Half);
+	}
+
+	// 尾数进位时会自然进入指数位
+	uint32_t Half = ((uint32_t)Exponent << 10) | (Mantissa >> 13);
+	const uint32_t Remainder = Mantissa & 0x1FFF;
+	if (Remainder > 0x1000 || (Remainder == 0x1000 && (Half & 1))) {
+		Half++;
+	}
+	return (uint16_t)(Sign | Half);
+}
+
+float VertexPacker::HalfToFloat(uint16_t Value) {
+	const uint32_t Sign = (uint32_t)(Value & 0x8000) << 16;
+	uint32_t Exponent = (Value >> 10) & 0x1F;
+	uint32_t Mantissa = Value & 0x3FF;
+
+	uint32_t Bits = 0;
+	if (Exponent == 0) {
+		if (Mantissa == 0) {
+			Bits = Sign;
+		}
+		else {
+			// 非规格化数，规格化后再转换
+			Exponent = 127 - 15 + 1;
+			while ((Mantissa & 0x400) == 0) {
+				Mantissa <<= 1;
+				Exponent--;
+			}
+			Mantissa &= 0x3FF;
+			Bits = Sign | (Exponent << 23) | (Mantissa << 13);
+		}
+	}
+	else if (Exponent == 31) {
+		Bits = Sign | 0x7F800000 | (Mantissa << 13);
+	}
+	else {
+		Bits = Sign | ((Exponent + 127 - 15) << 23) | (Mantissa << 13);
+	}
+
+	float Result;
+	memcpy(&Result, &Bits, sizeof(Result));
+	return Result;
+}
+
+static float SignNotZero(float Value) {
+	return Value >= 0.0f ? 1.0f : -1.0f;
+}
+
+FVector2 VertexPacker::OctEncode(const FVector3& Dir) {
+	const float L1Norm = std::abs(Dir.x()) + std::abs(Dir.y()) + std::abs(Dir.z());
+	if (L1Norm <= 0.0f) {
+		return FVector2(0.0f, 0.0f);
+	}
+
+	const FVector3 N = Dir / L1Norm;
+	if (N.z() >= 0.0f) {
+		return FVector2(N.x(), N.y());
+	}
+
+	// 下半球折叠到外侧三角形
+	return FVector2((1.0f - std::abs(N.y())) * SignNotZero(N.x()),
+		(1.0f - std::abs(N.x())) * SignNotZero(N.y()));
+}
+
+FVector3 VertexPacker::OctDecode(const FVector2& Oct) {
+	FVector3 N(Oct.x(), Oct.y(), 1.0f - std::abs(Oct.x()) - std::abs(Oct.y()));
+	const float T = std::max(-N.z(), 0.0f);
+	N.x() += N.x() >= 0.0f ? -T : T;
+	N.y() += N.y() >= 0.0f ? -T : T;
+	return N.normalized();
+}
+
+void VertexPacker::ComputeQuantization(const FVector3& BoundsMin, const FVector3& BoundsMax,
+	FVector3& OutScale, FVector3& OutBias) {
+	OutBias = BoundsMin;
+	OutScale = (BoundsMax - BoundsMin).cwiseMax(0.0f);
+}
+
+static int16_t PackSNorm16(float Value) {
+	return (int16_t)std::lround(std::clamp(Value, -1.0f, 1.0f) * 32767.0f);
+}
+
+static float UnpackSNorm16(int16_t Value) {
+	return std::max((float)Value / 32767.0f, -1.0f);
+}
+
+static uint16_t PackUNorm16(float Value) {
+	return (uint16_t)std::lround(std::clamp(Value, 0.0f, 1.0f) * 65535.0f);
+}
+
+// x/y为八面体坐标，z保留为0，w为副切线方向
+static uint32_t PackTangent(const FVector4& Tangent) {
+	const FVector2 Oct = VertexPacker::OctEncode(Tangent.head<3>());
+	const uint32_t X = (uint32_t)std::lround(std::clamp(Oct.x(), -1.0f, 1.0f) * 511.0f) & 0x3FF;
+	const uint32_t Y = (uint32_t)std::lround(std::clamp(Oct.y(), -1.0f, 1.0f) * 511.0f) & 0x3FF;
+	const uint32_t W = Tangent.w() < 0.0f ? 0x3u : 0x1u;
+	return X | (Y << 10) | (W << 30);
+}
+
+static FVector4 UnpackTangent(uint32_t Packed) {
+	// 10位有符号数符号扩展
+	auto Extend10 = [](uint32_t Bits) { return (int32_t)(Bits << 22) >> 22; };
+	const float X = std::max((float)Extend10(Packed & 0x3FF) / 511.0f, -1.0f);
+	const float Y = std::max((float)Extend10((Packed >> 10) & 0x3FF) / 511.0f, -1.0f);
+	const FVector3 T = VertexPacker::OctDecode(FVector2(X, Y));
+	return FVector4(T.x(), T.y(), T.z(), (Packed >> 30) == 0x3u ? -1.0f : 1.0f);
+}
+
+template<typename T>
+static void PackAttributes(const Vertex& Src, T& Dst) {
+	const FVector2 Normal = VertexPacker::OctEncode(Src.normal);
+	Dst.Normal[0] = PackSNorm16(Normal.x());
+	Dst.Normal[1] = PackSNorm16(Normal.y());
+	Dst.Tangent = PackTangent(Src.tangent);
+	Dst.TexCoord[0] = VertexPacker::FloatToHalf(Src.texCoord.x());
+	Dst.TexCoord[1] = VertexPacker::FloatToHalf(Src.texCoord.y());
+}
+
+template<typename T>
+static void UnpackAttributes(const T& Src, Vertex& Dst) {
+	Dst.normal = VertexPacker::OctDecode(FVector2(UnpackSNorm16(Src.Normal[0]), UnpackSNorm16(Src.Normal[1])));
+	Dst.tangent = UnpackTangent(Src.Tangent);
+	Dst.texCoord = FVector2(VertexPacker::HalfToFloat(Src.TexCoord[0]), VertexPacker::HalfToFloat(Src.TexCoord[1]));
+}
+
+void VertexPacker::PackVertex(VertexFormat Format, const Vertex& Src,
+	const FVector3& Scale, const FVector3& Bias, uint8_t* Dst) {
+	switch (Format)
+	{
+	case VertexFormat::eStandard:
+		memcpy(Dst, &Src, sizeof(Vertex));
+		break;
+	case VertexFormat::eCompact: {
+		CompactVertex Packed;
+		Packed.Position[0] = Src.position.x();
+		Packed.Position[1] = Src.position.y();
+		Packed.Position[2] = Src.position.z();
+		PackAttributes(Src, Packed);
+		memcpy(Dst, &Packed, sizeof(Packed));
+	} break;
+	case VertexFormat::eCompactQuantized: {
+		QuantizedVertex Packed;
+		for (int i = 0; i < 3; ++i) {
+			Packed.Position[i] = Scale[i] > 0.0f ? PackUNorm16((Src.position[i] - Bias[i]) / Scale[i]) : 0;
+		}
+		Packed.Position[3] = 0;
+		PackAttributes(Src, Packed);
+		memcpy(Dst, &Packed, sizeof(Packed));
+	} break;
+	default:
+		break;
+	}
+}
+
+void VertexPacker::UnpackVertex(VertexFormat Format, const uint8_t* Src,
+	const FVector3& Scale, const FVector3& Bias, Vertex& Dst) {
+	switch (Format)
+	{
+	case VertexFormat::eStandard:
+		memcpy(static_cast<void*>(&Dst), Src, sizeof(Vertex));
+		break;
+	case VertexFormat::eCompact: {
+		CompactVertex Packed;
+		memcpy(&Packed, Src, sizeof(Packed));
+		Dst.position = FVector3(Packed.Position[0], Packed.Position[1], Packed.Position[2]);
+		UnpackAttributes(Packed, Dst);
+	} break;
+	case VertexFormat::eCompactQuantized: {
+		QuantizedVertex Packed;
+		memcpy(&Packed, Src, sizeof(Packed));
+		for (int i = 0; i < 3; ++i) {
+			Dst.position[i] = (float)Packed.Position[i] / 65535.0f * Scale[i] + Bias[i];
+		}
+		UnpackAttributes(Packed, Dst);
+	} break;
+	default:
+		break;
+	}
+}
+
+void VertexPacker::PackVertices(VertexFormat Format, const std::vector<Vertex>& Vertices,
+	std::vector<uint8_t>& OutData, FVector3& OutScale, FVector3& OutBias) {
+	OutScale = FVector3::Ones();
+	OutBias = FVector3::Zero();
+
+	if (Format == VertexFormat::eCompactQuantized && !Vertices.empty()) {
+		FVector3 BoundsMin = FVector3::Constant(std::numeric_limits<float>::max());
+		FVector3 BoundsMax = FVector3::Constant(std::numeric_limits<float>::lowest());
+		for (const Vertex& V : Vertices) {
+			BoundsMin = BoundsMin.cwiseMin(V.position);
+			BoundsMax = BoundsMax.cwiseMax(V.position);
+		}
+		ComputeQuantization(BoundsMin, BoundsMax, OutScale, OutBias);
+	}
+
+	const uint32_t Stride = VertexLayout::GetStride(Format);
+	OutData.resize(Vertices.size() * Stride);
+	for (size_t i = 0; i < Vertices.size(); ++i) {
+		PackVertex(Format, Vertices[i], OutScale, OutBias, OutData.data() + i * Stride);
+	}
+}
+
+VertexFormat VertexPacker::ParseFormat(const std::string& Name) {
+	if (Name == "Compact") {
+		return VertexFormat::eCompact;
+	}
+	if (Name == "CompactQuantized") {
+		return VertexFormat::eCompactQuantized;
+	}
+	if (Name != "Standard") {
+		LOG_WARN << "Unknown vertex format '" << Name << "', use standard format.";
+	}
+	return VertexFormat::eStandard;
+}
+
+const char* VertexPacker::GetFormatName(VertexFormat Format) {
+	switch (Format)
+	{
+	case VertexFormat::eCompact:
+		return "Compact";
+	case VertexFormat::eCompactQuantized:
+		return "CompactQuantized";
+	default:
+		return "Standard";
+	}
+}
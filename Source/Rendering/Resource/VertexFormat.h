@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include "RenderModuleAPI.h"
+#include "Core/BaseMath.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 标准顶点，切线w分量保存副切线方向（±1），副切线在Shader中由cross(N, T) * w重建
+struct Vertex {
+	FVector3 position;
+	FVector3 normal;
+	FVector2 texCoord;
+	FVector4 tangent;
+};
+
+// 顶点格式，决定顶点在GPU端（以及保留的CPU副本）中的存储方式
+enum class VertexFormat : uint8_t {
+	eStandard = 0,        // float3位置 + float3法线 + float2 UV + float4切线，48字节
+	eCompact,             // float3位置 + 八面体法线 + 八面体切线 + half2 UV，24字节
+	eCompactQuantized,    // 同eCompact，位置量化为unorm16并按Mesh包围盒反量化，20字节
+	eCount
+};
+
+// 顶点属性分量类型
+enum class VertexAttributeType : uint8_t {
+	eFloat32 = 0,
+	eFloat16,
+	eSNorm16,
+	eUNorm16,
+	eSNorm10_10_10_2      // 对应GL_INT_2_10_10_10_REV
+};
+
+struct VertexAttribute {
+	uint32_t Location;
+	uint32_t Components;
+	VertexAttributeType Type;
+	uint32_t Offset;
+};
+
+struct VertexLayout {
+	uint32_t Stride = 0;
+	std::vector<VertexAttribute> Attributes;
+
+	ENGINE_RENDERING_API static const VertexLayout& Get(VertexFormat Format);
+	static uint32_t GetStride(VertexFormat Format) { return Get(Format).Stride; }
+};
+
+// eCompact
+struct CompactVertex {
+	float Position[3];
+	int16_t Normal[2];        // 八面体编码
+	uint32_t Tangent;         // 八面体编码xy，w为副切线方向
+	uint16_t TexCoord[2];     // half
+};
+
+// eCompactQuantized
+struct QuantizedVertex {
+	uint16_t Position[4];     // unorm16，w未使用
+	int16_t Normal[2];
+	uint32_t Tangent;
+	uint16_t TexCoord[2];
+};
+
+/**
+ * 顶点格式之间的打包/解包。
+ * 量化位置按 Position = Normalized * Scale + Bias 还原，Normalized在[0, 1]之间，
+ * 非量化格式的Scale为1、Bias为0，因此Shader可以统一处理。
+ */
+class VertexPacker {
+public:
+	ENGINE_RENDERING_API static uint16_t FloatToHalf(float Value);
+	ENGINE_RENDERING_API static float HalfToFloat(uint16_t Value);
+
+	// 单位向量与[-1, 1]范围八面体坐标的互相转换
+	ENGINE_RENDERING_API static FVector2 OctEncode(const FVector3& Dir);
+	ENGINE_RENDERING_API static FVector3 OctDecode(const FVector2& Oct);
+
+	ENGINE_RENDERING_API static void ComputeQuantization(const FVector3& BoundsMin, const FVector3& BoundsMax,
+		FVector3& OutScale, FVector3& OutBias);
+
+	// Dst/Src至少为对应格式的Stride字节
+	ENGINE_RENDERING_API static void PackVertex(VertexFormat Format, const Vertex& Src,
+		const FVector3& Scale, const FVector3& Bias, uint8_t* Dst);
+	ENGINE_RENDERING_API static void UnpackVertex(VertexFormat Format, const uint8_t* Src,
+		const FVector3& Scale, const FVector3& Bias, Vertex& Dst);
+
+	// 整体打包，量化格式会先根据顶点计算包围盒
+	ENGINE_RENDERING_API static void PackVertices(VertexFormat Format, const std::vector<Vertex>& Vertices,
+		std::vector<uint8_t>& OutData, FVector3& OutScale, FVector3& OutBias);
+
+	ENGINE_RENDERING_API static VertexFormat ParseFormat(const std::string& Name);
+	ENGINE_RENDERING_API static const char* GetFormatName(VertexFormat Format);
+};
@@ -0,0 +1,374 @@
+﻿#include <Logger.hpp>
+#include "Core/Bounds.h"
+#include "Core/AABBTree.h"
+#include "Culling/FrustumCuller.h"
+#include "Culling/OcclusionCuller.h"
+#include "Command/CommandList.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+// 用法：CullingBenchmark [--objects N] [--frames N] [--tree-objects N] [--tree-frames N] [--occlusion-objects N]
+// 在随机分布的场景中对比视锥剔除各路径的耗时，以及剔除后节省的命令录制和排序耗时；
+// 再对大量运动物体测试动态AABB树的插入、更新和查询，最后在楼群场景中测试遮挡剔除
+
+using Clock = std::chrono::high_resolution_clock;
+
+static FMatrix4 MakePerspective(float FovY, float Aspect, float Near, float Far) {
+	const float F = 1.0f / std::tan(FovY * 0.5f);
+	FMatrix4 Proj = FMatrix4::Zero();
+	Proj(0, 0) = F / Aspect;
+	Proj(1, 1) = F;
+	Proj(2, 2) = (Far + Near) / (Near - Far);
+	Proj(2, 3) = 2.0f * Far * Near / (Near - Far);
+	Proj(3, 2) = -1.0f;
+	return Proj;
+}
+
+static double ElapsedMs(Clock::time_point Start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+// 录制可见对象的绘制命令并排序，返回耗时
+static double RecordDraws(const FrustumCuller& Culler, bool CullEnabled) {
+	const auto Start = Clock::now();
+	CommandList CmdList;
+	CmdList.Begin();
+	for (uint32_t i = 0; i < Culler.GetCount(); ++i) {
+		if (CullEnabled && !Culler.IsVisible(i)) {
+			continue;
+		}
+		// 只用作排序键，不会被解引用
+		IMesh* Mesh = reinterpret_cast<IMesh*>((uintptr_t)(i % 256 + 1) * 64);
+		IMaterial* Material = reinterpret_cast<IMaterial*>((uintptr_t)(i % 32 + 1) * 64);
+		CmdList.DrawIndexed(Mesh, Material, FMatrix4::Identity(), 36);
+	}
+	CmdList.Sort();
+	CmdList.End();
+	return ElapsedMs(Start);
+}
+
+// 单位立方体[-1, 1]^3，作为建筑遮挡体
+static OccluderGeometry MakeCubeOccluder() {
+	OccluderGeometry Cube;
+	for (uint32_t i = 0; i < 8; ++i) {
+		Cube.Positions.push_back(FVector3((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f));
+	}
+	Cube.Indices = {
+		0, 2, 1, 1, 2, 3,   4, 5, 6, 5, 7, 6,   0, 1, 4, 1, 5, 4,
+		2, 6, 3, 3, 6, 7,   0, 4, 2, 2, 4, 6,   1, 3, 5, 3, 7, 5,
+	};
+	return Cube;
+}
+
+static void RunOcclusionBenchmark(uint32_t ObjectCount, uint32_t Frames) {
+	// 500m见方的街区，20x20栋楼，相机在街道上2m高处看向-Z
+	std::mt19937 Random(6789);
+	std::uniform_real_distribution<float> Unit(0.0f, 1.0f);
+	const OccluderGeometry Cube = MakeCubeOccluder();
+
+	std::vector<FBoundingBox> Buildings;
+	std::vector<FMatrix4> BuildingModels;
+	for (int32_t gz = 0; gz < 20; ++gz) {
+		for (int32_t gx = 0; gx < 20; ++gx) {
+			const FVector3 HalfExtent(8.0f + Unit(Random) * 4.0f, 10.0f + Unit(Random) * 30.0f, 8.0f + Unit(Random) * 4.0f);
+			const FVector3 Center(-237.5f + gx * 25.0f, HalfExtent.y(), -20.0f - gz * 25.0f);
+			// 沿X=0留出街道
+			if (std::fabs(Center.x()) < 15.0f) {
+				continue;
+			}
+			FMatrix4 Model = FMatrix4::Identity();
+			Model.block<3, 3>(0, 0) = HalfExtent.asDiagonal();
+			Model.block<3, 1>(0, 3) = Center;
+			Buildings.push_back(FBoundingBox::FromCenterExtent(Center, HalfExtent));
+			BuildingModels.push_back(Model);
+		}
+	}
+
+	std::vector<FBoundingBox> Objects(ObjectCount);
+	for (FBoundingBox& Box : Objects) {
+		const FVector3 Center(Unit(Random) * 500.0f - 250.0f, Unit(Random) * 4.0f, -Unit(Random) * 510.0f);
+		Box = FBoundingBox::FromCenterExtent(Center, FVector3::Constant(0.5f + Unit(Random) * 1.5f));
+	}
+
+	FMatrix4 View = FMatrix4::Identity();
+	View(1, 3) = -2.0f;
+	const FMatrix4 Proj = MakePerspective(60.0f * (float)M_PI / 180.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const FMatrix4 ViewProj = Proj * View;
+	const FFrustum Frustum(ViewProj);
+
+	std::cout << "Occlusion, objects: " << ObjectCount << ", occluders: " << Buildings.size()
+		<< ", buffer " << RENDER_OCCLUSION_BUFFER_WIDTH << "x" << RENDER_OCCLUSION_BUFFER_HEIGHT << "\n";
+
+	FrustumCuller Culler;
+	Culler.Reserve(ObjectCount);
+	OcclusionCuller Occlusion;
+	uint32_t InFrustum = 0;
+	double RasterMs = 0.0;
+	double TestMs = 0.0;
+	double RecordMs = 0.0;
+	double UnoccludedRecordMs = 0.0;
+	for (uint32_t f = 0; f < Frames; ++f) {
+		Culler.Reset();
+		for (const FBoundingBox& Box : Objects) {
+			Culler.Add(Box);
+		}
+		Culler.Cull(Frustum);
+		InFrustum = Culler.GetStats().VisibleObjects;
+
+		Occlusion.BeginFrame(ViewProj);
+		for (size_t b = 0; b < Buildings.size(); ++b) {
+			if (Frustum.Intersects(Buildings[b])) {
+				Occlusion.AddOccluder(Cube, BuildingModels[b], Buildings[b]);
+			}
+		}
+		UnoccludedRecordMs += RecordDraws(Culler, true);
+
+		Occlusion.RasterizeOccluders();
+		Culler.CullOccluded(Occlusion);
+		RasterMs += Occlusion.GetStats().RasterTimeMs;
+		TestMs += Culler.GetStats().OcclusionTimeMs;
+		RecordMs += RecordDraws(Culler, true);
+	}
+
+	const OcclusionStats& Stats = Occlusion.GetStats();
+	std::cout << "  occluders: " << Stats.Occluders << " rasterized (" << Stats.OccluderTriangles << " triangles), "
+		<< Stats.SkippedOccluders << " over budget, raster + Hi-Z " << RasterMs / Frames << " ms\n";
+	std::cout << "  tests: " << Stats.TestedObjects << " in frustum, " << Stats.OccludedObjects << " occluded ("
+		<< 100.0 * Stats.OccludedObjects / std::max(1u, InFrustum) << "%), " << TestMs / Frames << " ms, "
+		<< TestMs * 1e6 / Frames / std::max(1u, Stats.TestedObjects) << " ns/test\n";
+	std::cout << "  record + sort: frustum only " << UnoccludedRecordMs / Frames << " ms, with occlusion "
+		<< RecordMs / Frames << " ms\n";
+}
+
+static void RunTreeBenchmark(uint32_t ObjectCount, uint32_t Frames) {
+	// 4km见方的场景，物体以随机速度运动
+	std::mt19937 Random(54321);
+	std::uniform_real_distribution<float> Position(-2000.0f, 2000.0f);
+	std::uniform_real_distribution<float> Size(0.5f, 4.0f);
+	std::uniform_real_distribution<float> Speed(-0.2f, 0.2f);
+	std::vector<FBoundingBox> Bounds(ObjectCount);
+	std::vector<FVector3> Velocity(ObjectCount);
+	for (uint32_t i = 0; i < ObjectCount; ++i) {
+		const FVector3 Center(Position(Random), Position(Random) * 0.05f, Position(Random));
+		Bounds[i] = FBoundingBox::FromCenterExtent(Center, FVector3(Size(Random), Size(Random), Size(Random)));
+		Velocity[i] = FVector3(Speed(Random), Speed(Random) * 0.1f, Speed(Random));
+	}
+
+	std::cout << "AABB tree, objects: " << ObjectCount << ", frames: " << Frames << "\n";
+
+	AABBTree Tree;
+	std::vector<int32_t> Proxies(ObjectCount);
+	auto Start = Clock::now();
+	for (uint32_t i = 0; i < ObjectCount; ++i) {
+		Proxies[i] = Tree.CreateProxy(Bounds[i], (void*)(uintptr_t)i);
+	}
+	std::cout << "  insert: " << ElapsedMs(Start) << " ms, height " << Tree.GetHeight()
+		<< ", area ratio " << Tree.GetAreaRatio() << "\n";
+
+	// 十分之一的物体每帧移动，其余为静态
+	const uint32_t DynamicStride = 10;
+	double UpdateMs = 0.0;
+	uint64_t Moved = 0;
+	uint64_t Reinserted = 0;
+	uint64_t Refitted = 0;
+	for (uint32_t f = 0; f < Frames; ++f) {
+		Tree.ResetCounters();
+		Start = Clock::now();
+		for (uint32_t i = 0; i < ObjectCount; i += DynamicStride) {
+			Bounds[i].Min += Velocity[i];
+			Bounds[i].Max += Velocity[i];
+			Moved += Tree.MoveProxy(Proxies[i], Bounds[i], Velocity[i]) ? 1 : 0;
+		}
+		UpdateMs += ElapsedMs(Start);
+		Reinserted += Tree.GetReinsertCount();
+		Refitted += Tree.GetRefitCount();
+	}
+	std::cout << "  update (" << (ObjectCount + DynamicStride - 1) / DynamicStride << " moving): " << UpdateMs / Frames
+		<< " ms/frame, fat bounds changed " << Moved / Frames
+		<< ", reinserted " << Reinserted / Frames << ", refitted in place " << Refitted / Frames << " per frame\n";
+
+	Start = Clock::now();
+	Tree.Refit();
+	std::cout << "  refit: " << ElapsedMs(Start) << " ms, height " << Tree.GetHeight() << ", area ratio "
+		<< Tree.GetAreaRatio() << ", valid " << (Tree.Validate() ? "yes" : "no") << "\n";
+
+	// 视锥查询，与线性SIMD剔除对比
+	const FMatrix4 Proj = MakePerspective(45.0f * (float)M_PI / 180.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const FFrustum Frustum(Proj);
+	uint32_t TreeVisible = 0;
+	Start = Clock::now();
+	for (uint32_t f = 0; f < Frames; ++f) {
+		TreeVisible = 0;
+		Tree.QueryFrustum(Frustum, [&](int32_t) { TreeVisible++; return true; });
+	}
+	const double TreeQueryMs = ElapsedMs(Start) / Frames;
+
+	FrustumCuller Culler;
+	Culler.Reserve(ObjectCount);
+	for (const FBoundingBox& Box : Bounds) {
+		Culler.Add(Box);
+	}
+	double LinearMs = 0.0;
+	for (uint32_t f = 0; f < Frames; ++f) {
+		Culler.Cull(Frustum);
+		LinearMs += Culler.GetStats().CullTimeMs;
+	}
+	std::cout << "  frustum: tree " << TreeQueryMs << " ms (" << TreeVisible << " fat candidates), linear SIMD "
+		<< LinearMs / Frames << " ms (" << Culler.GetStats().VisibleObjects << " visible)\n";
+
+	// 小范围盒查询
+	const uint32_t QueryCount = 1000;
+	uint64_t BoxHits = 0;
+	Start = Clock::now();
+	for (uint32_t q = 0; q < QueryCount; ++q) {
+		const FVector3 Center(Position(Random), 0.0f, Position(Random));
+		Tree.QueryBox(FBoundingBox::FromCenterExtent(Center, FVector3::Constant(20.0f)), [&](int32_t) { BoxHits++; return true; });
+	}
+	std::cout << "  box: " << ElapsedMs(Start) * 1000.0 / QueryCount << " us/query, " << (double)BoxHits / QueryCount << " hits\n";
+
+	// 拾取射线，取最近命中，与暴力遍历对比
+	std::vector<FRay> Rays(QueryCount);
+	for (FRay& Ray : Rays) {
+		Ray = FRay(FVector3(Position(Random), 50.0f, Position(Random)), FVector3(Speed(Random), -1.0f, Speed(Random)));
+	}
+	uint32_t TreeRayHits = 0;
+	Start = Clock::now();
+	for (const FRay& Ray : Rays) {
+		bool Hit = false;
+		Tree.RayCast(Ray, [&](int32_t Proxy, float) {
+			float Distance = 0.0f;
+			const FBoundingBox& Box = Bounds[(uintptr_t)Tree.GetUserData(Proxy)];
+			if (Box.IntersectRay(Ray.Origin, Ray.GetInvDirection(), Ray.MaxDistance, Distance)) {
+				Hit = true;
+				return Distance;
+			}
+			return Ray.MaxDistance;
+		});
+		TreeRayHits += Hit ? 1 : 0;
+	}
+	const double TreeRayMs = ElapsedMs(Start);
+
+	uint32_t BruteRayHits = 0;
+	const uint32_t BruteRays = std::min(QueryCount, 50u);
+	Start = Clock::now();
+	for (uint32_t r = 0; r < BruteRays; ++r) {
+		const FVector3 InvDirection = Rays[r].GetInvDirection();
+		bool Hit = false;
+		for (const FBoundingBox& Box : Bounds) {
+			float Distance = 0.0f;
+			Hit |= Box.IntersectRay(Rays[r].Origin, InvDirection, Rays[r].MaxDistance, Distance);
+		}
+		BruteRayHits += Hit ? 1 : 0;
+	}
+	const double BruteRayMs = ElapsedMs(Start);
+	std::cout << "  ray: tree " << TreeRayMs * 1000.0 / QueryCount << " us/ray (" << TreeRayHits << " hits), brute force "
+		<< BruteRayMs * 1000.0 / BruteRays << " us/ray (" << BruteRayHits << "/" << BruteRays << " hits)\n";
+}
+
+int main(int argc, char** argv) {
+	uint32_t ObjectCount = 100000;
+	uint32_t Frames = 100;
+	uint32_t TreeObjectCount = 1000000;
+	uint32_t TreeFrames = 10;
+	uint32_t OcclusionObjectCount = 100000;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const std::string Arg = argv[i];
+		if (Arg == "--objects") {
+			ObjectCount = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (Arg == "--frames") {
+			Frames = std::max(1u, (uint32_t)std::strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (Arg == "--tree-objects") {
+			TreeObjectCount = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (Arg == "--tree-frames") {
+			TreeFrames = std::max(1u, (uint32_t)std::strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (Arg == "--occlusion-objects") {
+			OcclusionObjectCount = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+		}
+	}
+
+	// 1km见方的场景，相机在中心看向-Z
+	std::mt19937 Random(12345);
+	std::uniform_real_distribution<float> Position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> Size(0.5f, 4.0f);
+	std::vector<FBoundingBox> Bounds(ObjectCount);
+	for (FBoundingBox& Box : Bounds) {
+		const FVector3 Center(Position(Random), Position(Random) * 0.1f, Position(Random));
+		Box = FBoundingBox::FromCenterExtent(Center, FVector3(Size(Random), Size(Random), Size(Random)));
+	}
+
+	const FMatrix4 View = FMatrix4::Identity();
+	const FMatrix4 Proj = MakePerspective(45.0f * (float)M_PI / 180.0f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	const FFrustum Frustum(Proj * View);
+
+	FrustumCuller Culler;
+	Culler.Reserve(ObjectCount);
+
+	// 每帧重新填充包围盒，与引擎中的用法一致
+	auto RunCull = [&](bool SIMD, FrustumTest Test, double& FillMs, double& CullMs) {
+		Culler.SetSIMDEnabled(SIMD);
+		FillMs = 0.0;
+		CullMs = 0.0;
+		for (uint32_t f = 0; f < Frames; ++f) {
+			const auto Start = Clock::now();
+			Culler.Reset();
+			for (const FBoundingBox& Box : Bounds) {
+				Culler.Add(Box);
+			}
+			FillMs += ElapsedMs(Start);
+
+			Culler.Cull(Frustum, Test);
+			CullMs += Culler.GetStats().CullTimeMs;
+		}
+		FillMs /= Frames;
+		CullMs /= Frames;
+	};
+
+	std::cout << "Objects: " << ObjectCount << ", frames: " << Frames << ", SIMD width: " << FrustumCuller::GetSIMDWidth() << "\n";
+
+	const struct { const char* Name; bool SIMD; FrustumTest Test; } Modes[] = {
+		{ "scalar sphere", false, FrustumTest::eSphere },
+		{ "scalar box   ", false, FrustumTest::eBox },
+		{ "SIMD sphere  ", true, FrustumTest::eSphere },
+		{ "SIMD box     ", true, FrustumTest::eBox },
+	};
+	for (const auto& Mode : Modes) {
+		double FillMs = 0.0;
+		double CullMs = 0.0;
+		RunCull(Mode.SIMD, Mode.Test, FillMs, CullMs);
+		const CullingStats& Stats = Culler.GetStats();
+		std::cout << "  " << Mode.Name << ": fill " << FillMs << " ms, cull " << CullMs << " ms, visible "
+			<< Stats.VisibleObjects << ", culled " << Stats.CulledObjects << "\n";
+	}
+
+	// 剔除后节省的录制与排序耗时（不含后端提交和GPU）
+	double CulledRecordMs = 0.0;
+	double FullRecordMs = 0.0;
+	for (uint32_t f = 0; f < Frames; ++f) {
+		CulledRecordMs += RecordDraws(Culler, true);
+		FullRecordMs += RecordDraws(Culler, false);
+	}
+	CulledRecordMs /= Frames;
+	FullRecordMs /= Frames;
+
+	const double CullMs = Culler.GetStats().CullTimeMs;
+	std::cout << "Record + sort: all " << FullRecordMs << " ms, visible only " << CulledRecordMs << " ms, saved "
+		<< FullRecordMs - CulledRecordMs - CullMs << " ms per frame after culling cost\n";
+
+	if (TreeObjectCount > 0) {
+		RunTreeBenchmark(TreeObjectCount, TreeFrames);
+	}
+	if (OcclusionObjectCount > 0) {
+		RunOcclusionBenchmark(OcclusionObjectCount, Frames);
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+﻿#include "Renderer/RenderThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// 用法：FramePipelineBenchmark [--sim MS] [--submit MS] [--frames N] [--sleep]
+// 用忙等模拟游戏线程的模拟+录制耗时和渲染线程的命令提交+SwapBuffers耗时，
+// 对比单线程顺序执行与渲染线程双缓冲流水线的帧率和输入到呈现延迟。
+// 只有一个CPU核心时忙等无法并行，--sleep改为休眠，模拟等待驱动/GPU的阻塞时间
+
+using Clock = RenderThread::Clock;
+
+static bool SleepWork = false;
+
+static void Spin(double Ms) {
+	const auto Duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(Ms));
+	if (SleepWork) {
+		std::this_thread::sleep_for(Duration);
+		return;
+	}
+	const auto End = Clock::now() + Duration;
+	while (Clock::now() < End) {
+	}
+}
+
+static FramePipelineStats Run(bool Threaded, double SimMs, double SubmitMs, uint32_t Frames) {
+	RenderThread& Thread = RenderThread::Instance();
+	if (Threaded) {
+		Thread.Start();
+	}
+	Thread.ResetStats();
+
+	for (uint32_t f = 0; f < Frames; ++f) {
+		// 帧开始时采样输入，之后模拟并录制
+		const Clock::time_point InputTime = Clock::now();
+		Spin(SimMs);
+		Thread.SubmitFrame([SubmitMs]() { Spin(SubmitMs); }, InputTime);
+	}
+	Thread.Flush();
+
+	const FramePipelineStats Stats = Thread.GetStats();
+	Thread.Stop();
+	return Stats;
+}
+
+static void Print(const std::string& Label, const FramePipelineStats& Stats) {
+	std::cout << "  " << Label << ": " << Stats.GetFPS() << " fps, latency avg " << Stats.GetAverageLatencyMs()
+		<< " ms, max " << Stats.MaxLatencyMs << " ms, game thread wait " << Stats.GetAverageWaitMs() << " ms/frame\n";
+}
+
+static void RunScenario(double SimMs, double SubmitMs, uint32_t Frames) {
+	std::cout << "Simulation " << SimMs << " ms, submission " << SubmitMs << " ms, " << Frames << " frames\n";
+	const FramePipelineStats Single = Run(false, SimMs, SubmitMs, Frames);
+	const FramePipelineStats Pipelined = Run(true, SimMs, SubmitMs, Frames);
+	Print("Single thread", Single);
+	Print("Render thread", Pipelined);
+	std::cout << "  Throughput " << Pipelined.GetFPS() / std::max(Single.GetFPS(), 1e-6) << "x, latency "
+		<< Pipelined.GetAverageLatencyMs() - Single.GetAverageLatencyMs() << " ms\n";
+}
+
+int main(int argc, char** argv) {
+	double SimMs = -1.0;
+	double SubmitMs = -1.0;
+	uint32_t Frames = 300;
+	for (int i = 1; i < argc; ++i) {
+		const std::string Arg = argv[i];
+		if (Arg == "--sim" && i + 1 < argc) {
+			SimMs = std::max(0.0, std::strtod(argv[++i], nullptr));
+		}
+		else if (Arg == "--submit" && i + 1 < argc) {
+			SubmitMs = std::max(0.0, std::strtod(argv[++i], nullptr));
+		}
+		else if (Arg == "--frames" && i + 1 < argc) {
+			Frames = std::max(2u, (uint32_t)std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (Arg == "--sleep") {
+			SleepWork = true;
+		}
+	}
+	std::cout << std::thread::hardware_concurrency() << " hardware threads, " << (SleepWork ? "sleeping" : "busy") << " workload\n";
+
+	if (SimMs >= 0.0 || SubmitMs >= 0.0) {
+		RunScenario(std::max(SimMs, 0.0), std::max(SubmitMs, 0.0), Frames);
+		return 0;
+	}
+
+	// 均衡、模拟为主、提交为主
+	RunScenario(6.0, 6.0, Frames);
+	RunScenario(8.0, 3.0, Frames);
+	RunScenario(3.0, 8.0, Frames);
+	return 0;
+}
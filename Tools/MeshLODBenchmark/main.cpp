@@ -0,0 +1,266 @@
+﻿#include <Logger.hpp>
+#include "Core/Bounds.h"
+#include "Culling/FrustumCuller.h"
+#include "Culling/MeshLODSelector.h"
+#include "Command/CommandList.h"
+#include "Resource/IMesh.h"
+#include "Resource/Manager/Loader/MeshOptimizer.h"
+#include "Resource/Manager/Loader/MeshSimplifier.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+// 用法：MeshLODBenchmark [--objects N] [--frames N] [--segments N]
+// 生成带UV接缝的球体并构建LOD链，在大量远处实例的场景中让相机前进，
+// 对比全部使用LOD0与按屏幕尺寸选择LOD时每帧提交的三角形数、顶点着色次数、LOD切换次数和录制耗时
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double ElapsedMs(Clock::time_point Start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+static FMatrix4 MakePerspective(float FovY, float Aspect, float Near, float Far) {
+	const float F = 1.0f / std::tan(FovY * 0.5f);
+	FMatrix4 Proj = FMatrix4::Zero();
+	Proj(0, 0) = F / Aspect;
+	Proj(1, 1) = F;
+	Proj(2, 2) = (Far + Near) / (Near - Far);
+	Proj(2, 3) = 2.0f * Far * Near / (Near - Far);
+	Proj(3, 2) = -1.0f;
+	return Proj;
+}
+
+// 只保存子网格和LOD信息，不创建GPU资源
+class BenchmarkMesh : public IMesh {
+public:
+	BenchmarkMesh(const MeshDesc& Desc) {
+		SubMeshes_ = Desc.SubMeshes;
+		LODs_ = Desc.LODs;
+		Bounds_ = FBoundingBox(Desc.BoundsMin, Desc.BoundsMax);
+		IndexCount_ = (uint32_t)Desc.Indices.size();
+		VertexCount_ = (uint32_t)Desc.Vertices.size();
+	}
+
+	virtual bool Load(const MeshDesc&) override { return false; }
+	virtual bool Load(MeshDesc&&) override { return false; }
+	virtual void Bind() const override {}
+	virtual void Unbind() const override {}
+	virtual void Unload() override {}
+
+protected:
+	virtual bool ReadbackCPUData() override { return false; }
+};
+
+// 单位球，经线方向有一列重复顶点作为UV接缝
+static void MakeSphere(uint32_t Segments, uint32_t Rings, std::vector<Vertex>& Vertices, std::vector<uint32_t>& Indices) {
+	for (uint32_t r = 0; r <= Rings; ++r) {
+		for (uint32_t s = 0; s <= Segments; ++s) {
+			const float Theta = (float)M_PI * r / Rings;
+			const float Phi = 2.0f * (float)M_PI * s / Segments;
+			Vertex V;
+			V.position = FVector3(std::sin(Theta) * std::cos(Phi), std::cos(Theta), std::sin(Theta) * std::sin(Phi));
+			V.normal = V.position;
+			V.texCoord = FVector2((float)s / Segments, (float)r / Rings);
+			V.tangent = FVector4(-std::sin(Phi), 0.0f, std::cos(Phi), 1.0f);
+			Vertices.push_back(V);
+		}
+	}
+	for (uint32_t r = 0; r < Rings; ++r) {
+		for (uint32_t s = 0; s < Segments; ++s) {
+			const uint32_t A = r * (Segments + 1) + s;
+			const uint32_t B = A + 1;
+			const uint32_t C = A + Segments + 1;
+			const uint32_t D = C + 1;
+			if (r > 0) {
+				Indices.insert(Indices.end(), { A, B, C });
+			}
+			if (r + 1 < Rings) {
+				Indices.insert(Indices.end(), { B, D, C });
+			}
+		}
+	}
+}
+
+// 与MeshLoader相同的流程：优化LOD0，简化出各级LOD并追加索引，再按误差计算切换阈值
+static MeshDesc BuildMesh(uint32_t Segments, std::vector<uint64_t>& OutTransforms) {
+	MeshDesc Desc;
+	std::vector<Vertex> Vertices;
+	std::vector<uint32_t> Indices;
+	MakeSphere(Segments, Segments / 2, Vertices, Indices);
+
+	MeshOptimizeSettings Settings;
+	MeshOptimizer::Optimize(Vertices, Indices, Settings);
+
+	const auto Start = Clock::now();
+	std::vector<MeshLODLevel> Levels;
+	MeshSimplifier::GenerateLODs(Vertices, Indices, Settings.LODCount, Settings.LODReduction, Settings.LODMaxError, Levels);
+	for (MeshLODLevel& Level : Levels) {
+		MeshOptimizer::OptimizeVertexCache(Level.Indices.data(), Level.Indices.size(), (uint32_t)Vertices.size());
+	}
+	const double SimplifyMs = ElapsedMs(Start);
+
+	SubMeshDesc SubMesh = { 0, 0, (uint32_t)Indices.size(), 0, "Sphere" };
+	Desc.SubMeshes.push_back(SubMesh);
+	Desc.Indices = Indices;
+	OutTransforms.push_back(MeshOptimizer::CountTransforms(Indices.data(), Indices.size(), (uint32_t)Vertices.size(), Settings.CacheSize));
+
+	const float Radius = 1.0f;
+	float Previous = 1.0f;
+	for (const MeshLODLevel& Level : Levels) {
+		MeshLODDesc LOD;
+		LOD.Error = Level.Error;
+		LOD.ScreenSize = std::min(MeshSimplifier::ComputeLODScreenSize(Level.Error, Radius, Settings.LODPixelError), Previous);
+		Previous = LOD.ScreenSize;
+		SubMesh.BaseIndex = (uint32_t)Desc.Indices.size();
+		SubMesh.IndexCount = (uint32_t)Level.Indices.size();
+		LOD.SubMeshes.push_back(SubMesh);
+		Desc.LODs.push_back(LOD);
+		Desc.Indices.insert(Desc.Indices.end(), Level.Indices.begin(), Level.Indices.end());
+		OutTransforms.push_back(MeshOptimizer::CountTransforms(Level.Indices.data(), Level.Indices.size(), (uint32_t)Vertices.size(), Settings.CacheSize));
+	}
+	Desc.Vertices = std::move(Vertices);
+	Desc.BoundsMin = FVector3::Constant(-1.0f);
+	Desc.BoundsMax = FVector3::Constant(1.0f);
+
+	std::cout << "Sphere mesh, " << Desc.Vertices.size() << " vertices, LODs generated in " << SimplifyMs << " ms\n";
+	std::cout << "  LOD0: " << Indices.size() / 3 << " triangles\n";
+	for (size_t i = 0; i < Desc.LODs.size(); ++i) {
+		std::cout << "  LOD" << i + 1 << ": " << Desc.LODs[i].SubMeshes[0].IndexCount / 3 << " triangles, error "
+			<< Desc.LODs[i].Error << ", screen size < " << Desc.LODs[i].ScreenSize << "\n";
+	}
+	return Desc;
+}
+
+struct FrameResult {
+	uint64_t Triangles = 0;
+	uint64_t FullDetailTriangles = 0;
+	uint64_t Transforms = 0;
+	uint64_t Switches = 0;
+	uint64_t Draws = 0;
+	uint64_t PerLOD[MESH_MAX_LOD_COUNT] = {};
+	double RecordMs = 0.0;
+};
+
+static FrameResult RunScene(const std::string& Label, const BenchmarkMesh& Mesh, const std::vector<uint64_t>& Transforms,
+	const std::vector<FBoundingBox>& Objects, const std::vector<FMatrix4>& Models, uint32_t Frames, bool EnableLOD, float Hysteresis) {
+	MeshLODSelector Selector;
+	Selector.SetEnabled(EnableLOD);
+	Selector.SetHysteresis(Hysteresis);
+
+	const FMatrix4 Proj = MakePerspective(60.0f * (float)M_PI / 180.0f, 16.0f / 9.0f, 0.1f, 5000.0f);
+	FrustumCuller Culler;
+	Culler.Reserve((uint32_t)Objects.size());
+	std::vector<uint32_t> CurrentLOD(Objects.size(), 0);
+	// 只用作排序键，不会被解引用
+	IMaterial* Material = reinterpret_cast<IMaterial*>((uintptr_t)64);
+
+	FrameResult Result;
+	for (uint32_t f = 0; f < Frames; ++f) {
+		// 相机沿-Z缓慢前进并前后晃动，使屏幕尺寸在阈值附近来回变化
+		FMatrix4 View = FMatrix4::Identity();
+		View(1, 3) = -2.0f;
+		View(2, 3) = f * 0.2f + 2.0f * std::sin(f * 0.3f);
+		const FFrustum Frustum(Proj * View);
+
+		Culler.Reset();
+		for (const FBoundingBox& Box : Objects) {
+			Culler.Add(Box);
+		}
+		Culler.Cull(Frustum);
+
+		const auto Start = Clock::now();
+		Selector.BeginFrame();
+		CommandList CmdList;
+		CmdList.Begin();
+		CmdList.SetViewProjection(View, Proj);
+		for (uint32_t i = 0; i < (uint32_t)Objects.size(); ++i) {
+			if (!Culler.IsVisible(i)) {
+				continue;
+			}
+			const uint32_t LOD = Selector.Select(Mesh, Objects[i], CmdList.GetViewMatrix(), CmdList.GetProjMatrix(), CurrentLOD[i]);
+			// 第一帧的选择不算切换
+			const bool Switched = f > 0 && LOD != CurrentLOD[i];
+			CurrentLOD[i] = LOD;
+			for (const SubMeshDesc& SubMesh : Mesh.GetSubMeshes(LOD)) {
+				CmdList.DrawIndexed(const_cast<BenchmarkMesh*>(&Mesh), Material, Models[i], SubMesh.IndexCount, SubMesh.BaseIndex);
+			}
+			Selector.RecordDraw(Mesh, LOD, Switched);
+			Result.Transforms += Transforms[LOD];
+		}
+		CmdList.Sort();
+		CmdList.End();
+		Result.RecordMs += ElapsedMs(Start);
+
+		const MeshLODStats& Stats = Selector.GetStats();
+		Result.Triangles += Stats.Triangles;
+		Result.FullDetailTriangles += Stats.FullDetailTriangles;
+		Result.Switches += Stats.LODSwitches;
+		Result.Draws += Stats.DrawnMeshes;
+		for (uint32_t l = 0; l < MESH_MAX_LOD_COUNT; ++l) {
+			Result.PerLOD[l] += Stats.MeshesPerLOD[l];
+		}
+	}
+
+	std::cout << "  " << Label << ": " << Result.Triangles / Frames << " triangles/frame ("
+		<< 100.0 * Result.Triangles / std::max<uint64_t>(Result.FullDetailTriangles, 1) << "% of LOD0), "
+		<< Result.Transforms / Frames << " vertex shader invocations/frame, "
+		<< (double)Result.Switches / Frames << " LOD switches/frame, record " << Result.RecordMs / Frames << " ms/frame\n";
+	std::cout << "    meshes per LOD:";
+	for (uint32_t l = 0; l < Mesh.GetLODCount(); ++l) {
+		std::cout << " " << (double)Result.PerLOD[l] / Frames;
+	}
+	std::cout << " (" << Result.Draws / Frames << " drawn/frame)\n";
+	return Result;
+}
+
+int main(int argc, char** argv) {
+	uint32_t ObjectCount = 20000;
+	uint32_t Frames = 200;
+	uint32_t Segments = 256;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const std::string Arg = argv[i];
+		if (Arg == "--objects") {
+			ObjectCount = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (Arg == "--frames") {
+			Frames = std::max(1u, (uint32_t)std::strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (Arg == "--segments") {
+			Segments = std::max(8u, (uint32_t)std::strtoul(argv[i + 1], nullptr, 10));
+		}
+	}
+
+	std::vector<uint64_t> Transforms;
+	const MeshDesc Desc = BuildMesh(Segments, Transforms);
+	const BenchmarkMesh Mesh(Desc);
+
+	// 2km x 4km的场地，物体半径0.5~3m，大部分离相机较远
+	std::mt19937 Random(2468);
+	std::uniform_real_distribution<float> Unit(0.0f, 1.0f);
+	std::vector<FBoundingBox> Objects(ObjectCount);
+	std::vector<FMatrix4> Models(ObjectCount);
+	for (uint32_t i = 0; i < ObjectCount; ++i) {
+		const float Scale = 0.5f + Unit(Random) * 2.5f;
+		const FVector3 Center(Unit(Random) * 2000.0f - 1000.0f, Scale, -Unit(Random) * 4000.0f);
+		Models[i] = FMatrix4::Identity();
+		Models[i].block<3, 3>(0, 0) *= Scale;
+		Models[i].block<3, 1>(0, 3) = Center;
+		Objects[i] = Mesh.GetBounds().Transform(Models[i]);
+	}
+
+	std::cout << "Scene: " << ObjectCount << " spheres, " << Frames << " frames, 1080p reference, "
+		<< "pixel error " << MeshOptimizeSettings().LODPixelError << "\n";
+	const FrameResult Full = RunScene("LOD0 only", Mesh, Transforms, Objects, Models, Frames, false, 0.0f);
+	RunScene("LOD, no hysteresis", Mesh, Transforms, Objects, Models, Frames, true, 0.0f);
+	const FrameResult LOD = RunScene("LOD, hysteresis " + std::to_string(RENDER_MESH_LOD_HYSTERESIS), Mesh, Transforms, Objects, Models, Frames, true, RENDER_MESH_LOD_HYSTERESIS);
+	std::cout << "Triangles reduced " << (double)Full.Triangles / std::max<uint64_t>(LOD.Triangles, 1) << "x, vertex shader work reduced "
+		<< (double)Full.Transforms / std::max<uint64_t>(LOD.Transforms, 1) << "x, record time "
+		<< Full.RecordMs / Frames << " -> " << LOD.RecordMs / Frames << " ms/frame\n";
+	return 0;
+}
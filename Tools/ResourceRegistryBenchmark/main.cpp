@@ -0,0 +1,257 @@
+﻿#include <Logger.hpp>
+#include "Resource/Manager/ResourceRegistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+// 用法：ResourceRegistryBenchmark [--readers N] [--rounds N] [--resources N] [--lookups N]
+// 1. 压力测试：多个读线程持续按ID、名称和别名查找，同时一个写线程反复注册、追加别名、移除资源，
+//    检查常驻资源总能找到且查找结果与键一致，结束后检查注册表计数和资源引用数；
+// 2. 查找基准：对比无锁注册表与互斥锁保护的unordered_map在1个和N个读线程、有无写线程时的查找吞吐。
+// 发现错误时返回非0，配合ThreadSanitizer构建可检查数据竞争
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double ElapsedMs(Clock::time_point Start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+class BenchmarkResource : public IResource {
+public:
+	BenchmarkResource(const std::string& Name, ResourceType Type) {
+		Name_ = Name;
+		Type_ = Type;
+		IsValid_ = true;
+	}
+
+	virtual void Unload() override {}
+};
+
+// 对照组：所有查找和修改都在同一把锁下进行
+class LockedRegistry {
+public:
+	std::shared_ptr<IResource> Find(const std::string& Name) {
+		std::lock_guard<std::mutex> Guard(Mutex_);
+		auto It = Resources_.find(Name);
+		return It != Resources_.end() ? It->second : nullptr;
+	}
+
+	void Insert(const std::string& Name, const std::shared_ptr<IResource>& Resource) {
+		std::lock_guard<std::mutex> Guard(Mutex_);
+		Resources_.emplace(Name, Resource);
+	}
+
+	void Remove(const std::string& Name) {
+		std::lock_guard<std::mutex> Guard(Mutex_);
+		Resources_.erase(Name);
+	}
+
+private:
+	std::mutex Mutex_;
+	std::unordered_map<std::string, std::shared_ptr<IResource>> Resources_;
+};
+
+static const uint32_t CHURN_COUNT = 256;
+
+struct ResourceSet {
+	std::vector<std::shared_ptr<IResource>> Stable;
+	std::vector<std::shared_ptr<IResource>> Churn;
+
+	explicit ResourceSet(uint32_t Count) {
+		for (uint32_t i = 0; i < Count; ++i) {
+			Stable.push_back(std::make_shared<BenchmarkResource>("Stable_" + std::to_string(i), (ResourceType)(i % ResourceRegistry::TYPE_COUNT)));
+		}
+		// 写线程循环复用同一批对象，ID固定
+		for (uint32_t i = 0; i < CHURN_COUNT; ++i) {
+			Churn.push_back(std::make_shared<BenchmarkResource>("Churn_" + std::to_string(i), ResourceType::eTexture));
+		}
+	}
+};
+
+static bool RunStressTest(const ResourceSet& Set, uint32_t Readers, uint32_t Rounds) {
+	ResourceRegistry Registry;
+	for (const auto& Resource : Set.Stable) {
+		Registry.Insert(Resource->GetName(), Resource);
+	}
+
+	std::atomic<bool> Done(false);
+	std::atomic<uint64_t> Errors(0);
+	std::atomic<uint64_t> Lookups(0);
+	std::atomic<uint64_t> ChurnHits(0);
+
+	std::vector<std::thread> Threads;
+	for (uint32_t t = 0; t < Readers; ++t) {
+		Threads.emplace_back([&, t]() {
+			std::mt19937 Random(t + 1);
+			uint64_t LocalLookups = 0, LocalErrors = 0, LocalHits = 0;
+			while (!Done.load(std::memory_order_relaxed)) {
+				const auto& Stable = Set.Stable[Random() % Set.Stable.size()];
+				if (Registry.Find(Stable->GetID()) != Stable) LocalErrors++;
+				if (Registry.Find(Stable->GetResourceType(), Stable->GetName()) != Stable) LocalErrors++;
+
+				// 写线程正在修改的资源可能存在也可能不存在，但找到时必须与键一致
+				const uint32_t Index = Random() % CHURN_COUNT;
+				const auto& Churn = Set.Churn[Index];
+				std::shared_ptr<IResource> ByID = Registry.Find(Churn->GetID());
+				std::shared_ptr<IResource> ByName = Registry.Find(ResourceType::eTexture, Churn->GetName());
+				std::shared_ptr<IResource> ByAlias = Registry.Find(ResourceType::eTexture, "Alias_" + std::to_string(Index));
+				if (ByID && ByID != Churn) LocalErrors++;
+				if (ByName && ByName != Churn) LocalErrors++;
+				if (ByAlias && ByAlias != Churn) LocalErrors++;
+				LocalHits += (ByID ? 1 : 0) + (ByName ? 1 : 0) + (ByAlias ? 1 : 0);
+				LocalLookups += 5;
+			}
+			Lookups += LocalLookups;
+			Errors += LocalErrors;
+			ChurnHits += LocalHits;
+		});
+	}
+
+	const auto Start = Clock::now();
+	uint64_t WriterErrors = 0;
+	for (uint32_t Round = 0; Round < Rounds; ++Round) {
+		const uint32_t Index = Round % CHURN_COUNT;
+		const auto& Churn = Set.Churn[Index];
+		if (Registry.Insert(Churn->GetName(), Churn) != Churn) WriterErrors++;
+		if (!Registry.AddAlias("Alias_" + std::to_string(Index), Churn)) WriterErrors++;
+		// 同名资源已存在时应返回已有资源
+		if (Round % 7 == 0 && Registry.Insert(Churn->GetName(), std::make_shared<BenchmarkResource>(Churn->GetName(), ResourceType::eTexture)) != Churn) WriterErrors++;
+		if (Registry.Remove(Churn->GetID()) != Churn) WriterErrors++;
+		if (Registry.Find(Churn->GetID()) || Registry.Find(ResourceType::eTexture, Churn->GetName())) WriterErrors++;
+	}
+	const double WriterMs = ElapsedMs(Start);
+	Done = true;
+	for (auto& Thread : Threads) {
+		Thread.join();
+	}
+
+	// 移除后注册表不再持有引用，常驻资源只有注册表和ResourceSet两处引用
+	for (const auto& Churn : Set.Churn) {
+		if (Churn.use_count() != 1) WriterErrors++;
+	}
+	for (const auto& Stable : Set.Stable) {
+		if (Registry.GetExternalUseCount(Stable->GetID()) != 1) WriterErrors++;
+	}
+	if (Registry.GetCount() != Set.Stable.size()) WriterErrors++;
+
+	std::cout << "Stress: " << Readers << " readers, " << Rounds << " insert/alias/remove rounds in " << WriterMs << " ms ("
+		<< Rounds / std::max(WriterMs, 0.001) << " rounds/ms), " << Lookups.load() << " lookups ("
+		<< ChurnHits.load() << " hits on churned resources)\n";
+	std::cout << "  wrong lookups " << Errors.load() << ", writer/ownership errors " << WriterErrors << "\n";
+	return Errors.load() == 0 && WriterErrors == 0;
+}
+
+// 返回每秒百万次查找
+template <typename FindFunc, typename ChurnFunc>
+static double RunLookups(const ResourceSet& Set, uint32_t Readers, uint64_t LookupsPerThread, bool WithWriter, FindFunc Find, ChurnFunc Churn) {
+	std::atomic<bool> Done(false);
+	std::atomic<uint64_t> Misses(0);
+	std::thread Writer;
+	if (WithWriter) {
+		Writer = std::thread([&]() {
+			for (uint32_t Round = 0; !Done.load(std::memory_order_relaxed); ++Round) {
+				Churn(Set.Churn[Round % CHURN_COUNT]);
+				std::this_thread::yield();
+			}
+		});
+	}
+
+	const auto Start = Clock::now();
+	std::vector<std::thread> Threads;
+	for (uint32_t t = 0; t < Readers; ++t) {
+		Threads.emplace_back([&, t]() {
+			std::mt19937 Random(t + 100);
+			uint64_t LocalMisses = 0;
+			for (uint64_t i = 0; i < LookupsPerThread; ++i) {
+				const auto& Resource = Set.Stable[Random() % Set.Stable.size()];
+				if (!Find(Resource)) LocalMisses++;
+			}
+			Misses += LocalMisses;
+		});
+	}
+	for (auto& Thread : Threads) {
+		Thread.join();
+	}
+	const double Ms = ElapsedMs(Start);
+	Done = true;
+	if (Writer.joinable()) {
+		Writer.join();
+	}
+
+	if (Misses.load() != 0) {
+		std::cout << "  " << Misses.load() << " lookups missed\n";
+	}
+	return (double)Readers * LookupsPerThread / std::max(Ms, 0.001) / 1000.0;
+}
+
+static void RunBenchmark(const ResourceSet& Set, uint32_t Readers, uint64_t LookupsPerThread) {
+	ResourceRegistry Registry;
+	LockedRegistry Locked;
+	for (const auto& Resource : Set.Stable) {
+		Registry.Insert(Resource->GetName(), Resource);
+		Locked.Insert(Resource->GetName(), Resource);
+	}
+
+	auto RegistryFind = [&](const std::shared_ptr<IResource>& Resource) {
+		return Registry.Find(Resource->GetResourceType(), Resource->GetName()) != nullptr;
+	};
+	auto RegistryChurn = [&](const std::shared_ptr<IResource>& Resource) {
+		Registry.Insert(Resource->GetName(), Resource);
+		Registry.Remove(Resource->GetID());
+	};
+	auto LockedFind = [&](const std::shared_ptr<IResource>& Resource) {
+		return Locked.Find(Resource->GetName()) != nullptr;
+	};
+	auto LockedChurn = [&](const std::shared_ptr<IResource>& Resource) {
+		Locked.Insert(Resource->GetName(), Resource);
+		Locked.Remove(Resource->GetName());
+	};
+
+	std::cout << "Lookup by name, " << Set.Stable.size() << " resources, " << LookupsPerThread << " lookups/thread (M lookups/s):\n";
+	std::vector<uint32_t> ThreadCounts = { 1 };
+	if (Readers > 1) {
+		ThreadCounts.push_back(Readers);
+	}
+	for (uint32_t Threads : ThreadCounts) {
+		for (bool WithWriter : { false, true }) {
+			const double LockFree = RunLookups(Set, Threads, LookupsPerThread, WithWriter, RegistryFind, RegistryChurn);
+			const double Mutex = RunLookups(Set, Threads, LookupsPerThread, WithWriter, LockedFind, LockedChurn);
+			std::cout << "  " << Threads << " reader(s)" << (WithWriter ? " + writer" : "") << ": lock-free " << LockFree
+				<< ", mutex " << Mutex << " (" << LockFree / std::max(Mutex, 0.001) << "x)\n";
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	uint32_t Readers = std::max(2u, std::thread::hardware_concurrency());
+	uint32_t Rounds = 20000;
+	uint32_t ResourceCount = 4096;
+	uint64_t Lookups = 2000000;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		const std::string Arg = argv[i];
+		if (Arg == "--readers") {
+			Readers = std::max(1u, (uint32_t)std::strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (Arg == "--rounds") {
+			Rounds = (uint32_t)std::strtoul(argv[i + 1], nullptr, 10);
+		}
+		else if (Arg == "--resources") {
+			ResourceCount = std::max(1u, (uint32_t)std::strtoul(argv[i + 1], nullptr, 10));
+		}
+		else if (Arg == "--lookups") {
+			Lookups = std::max<uint64_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+		}
+	}
+
+	const ResourceSet Set(ResourceCount);
+	const bool Passed = RunStressTest(Set, Readers, Rounds);
+	RunBenchmark(Set, Readers, Lookups);
+	return Passed ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+﻿#include <Logger.hpp>
+#include "Resource/ITexture.h"
+#include "Resource/Manager/Loader/TextureLoader.h"
+#include "Resource/Manager/Loader/TextureCompressor.h"
+#include "Resource/Manager/Loader/CookedTexture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// 用法：TextureCooker <input> <output.stex> [--format RGBA8|BC1|BC3|BC5|BC7] [--benchmark N]
+// 输入/输出路径均相对于纹理资源目录（TEXTURE_ASSET_PATH）
+
+static void PrintUsage() {
+	std::cout << "Usage: TextureCooker <input> <output" << COOKED_TEXTURE_EXTENSION << "> [options]\n"
+		<< "  --format <RGBA8|BC1|BC3|BC5|BC7>  GPU format, default BC7\n"
+		<< "                                    BC1: opaque color, BC3: color + alpha, BC5: normal maps (RG)\n"
+		<< "  --benchmark <N>                   compare source and cooked load time over N runs\n"
+		<< "Paths are relative to '" << TEXTURE_ASSET_PATH << "'.\n";
+}
+
+static void RunBenchmark(const std::string& Input, const std::string& Output, uint32_t Runs) {
+	using Clock = std::chrono::high_resolution_clock;
+	uint64_t SourceBytes = 0;
+	uint64_t CookedBytes = 0;
+
+	// 源图片：解码 + 生成Mip链，得到可上传的RGBA8数据
+	double SourceMs = 0.0;
+	for (uint32_t i = 0; i < Runs; ++i) {
+		const auto Start = Clock::now();
+		TextureDesc Desc;
+		if (!TextureLoader::Load(Input, Desc)) {
+			LOG_ERROR << "Benchmark: load source '" << Input << "' failed.";
+			return;
+		}
+		SourceBytes = Desc.Data->size();
+		SourceMs += std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+	}
+
+	// 烘焙纹理：读取后即可上传
+	double CookedMs = 0.0;
+	for (uint32_t i = 0; i < Runs; ++i) {
+		const auto Start = Clock::now();
+		TextureDesc Desc;
+		if (!TextureLoader::Load(Output, Desc)) {
+			LOG_ERROR << "Benchmark: load cooked '" << Output << "' failed.";
+			return;
+		}
+		CookedBytes = 0;
+		for (const TextureMipDesc& Mip : Desc.Mips) {
+			CookedBytes += Mip.Size;
+		}
+		CookedMs += std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+	}
+
+	SourceMs /= Runs;
+	CookedMs /= Runs;
+	LOG_INFO << "Benchmark over " << Runs << " runs:";
+	LOG_INFO << "  source '" << Input << "': " << SourceMs << " ms, " << SourceBytes << " bytes to upload";
+	LOG_INFO << "  cooked '" << Output << "': " << CookedMs << " ms, " << CookedBytes << " bytes to upload";
+	LOG_INFO << "  speedup: " << (CookedMs > 0.0 ? SourceMs / CookedMs : 0.0) << "x, memory: "
+		<< (CookedBytes > 0 ? (double)SourceBytes / CookedBytes : 0.0) << "x smaller";
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		PrintUsage();
+		return -1;
+	}
+
+	const std::string Input = argv[1];
+	const std::string Output = argv[2];
+	TextureFormat Format = TextureFormat::eBC7;
+	uint32_t BenchmarkRuns = 0;
+
+	for (int i = 3; i < argc; ++i) {
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			Format = TextureLayout::ParseFormat(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+			BenchmarkRuns = (uint32_t)std::max(1, atoi(argv[++i]));
+		}
+		else {
+			PrintUsage();
+			return -1;
+		}
+	}
+
+	// 烘焙：解码、生成Mip链、逐级压缩后一次性写出
+	TextureDesc Desc;
+	if (!TextureLoader::Load(Input, Desc)) {
+		LOG_ERROR << "Import texture '" << Input << "' failed.";
+		return -1;
+	}
+	if (TextureLayout::IsCompressed(Format)) {
+		TextureCompressStats Stats;
+		if (!TextureCompressor::Compress(Desc, Format, &Stats)) {
+			return -1;
+		}
+		LOG_INFO << "Compressed '" << Input << "' to " << TextureLayout::GetFormatName(Format) << ": " << Stats.UncompressedBytes
+			<< " -> " << Stats.CompressedBytes << " bytes (" << Stats.GetRatio() << ":1) in " << Stats.CompressTimeMs << " ms.";
+	}
+	if (!CookedTexture::Write(TEXTURE_ASSET_PATH + Output, Desc)) {
+		return -1;
+	}
+
+	if (BenchmarkRuns > 0) {
+		RunBenchmark(Input, Output, BenchmarkRuns);
+	}
+	return 0;
+}